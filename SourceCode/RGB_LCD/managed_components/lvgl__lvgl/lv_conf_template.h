@@ -113,9 +113,13 @@
 
     /*Allow buffering some shadow calculation.
     *LV_SHADOW_CACHE_SIZE is the max. shadow size to buffer, where shadow size is `shadow_width + radius`
-    *Caching has LV_SHADOW_CACHE_SIZE^2 RAM cost*/
+    *Caching has LV_SHADOW_CACHE_SIZE^2 RAM cost. The least recently used shadows are dropped
+    *if several smaller shadows don't fit into this space.*/
     #define LV_SHADOW_CACHE_SIZE 0
 
+    /*Max. number of different shadows to buffer if LV_SHADOW_CACHE_SIZE > 0*/
+    #define LV_SHADOW_CACHE_CNT 4
+
     /* Set number of maximally cached circle data.
     * The circumference of 1/4 circle are saved for anti-aliasing
     * radius * 4 bytes are used per circle (the most often used radiuses are saved)
@@ -139,6 +143,16 @@
 #define LV_LAYER_SIMPLE_BUF_SIZE          (24 * 1024)
 #define LV_LAYER_SIMPLE_FALLBACK_BUF_SIZE (3 * 1024)
 
+/*Keep the rendered image of the widgets having `LV_OBJ_FLAG_DRAW_CACHE` and redraw them by copying the image
+ *until the widget or any of its children is invalidated.
+ *LV_OBJ_DRAW_CACHE_SIZE: [bytes] the max. total size of the images. The least recently used ones are dropped first.
+ *Not fully opaque widgets are cached only with `LV_COLOR_SCREEN_TRANSP 1`.
+ *On ESP32 the images are allocated in the PSRAM if it's enabled.*/
+#define LV_USE_OBJ_DRAW_CACHE 0
+#if LV_USE_OBJ_DRAW_CACHE
+    #define LV_OBJ_DRAW_CACHE_SIZE (64 * 1024)
+#endif
+
 /*Default image cache size. Image caching keeps the images opened.
  *If only the built-in image formats are used there is no real advantage of caching. (I.e. if no new image decoder is added)
  *With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
@@ -146,14 +160,42 @@
  *0: to disable caching*/
 #define LV_IMG_CACHE_DEF_SIZE 0
 
+/*Max. total size of the decoded images kept in the image cache [bytes].
+ *The least recently used images are closed to stay below it. Used only if LV_IMG_CACHE_DEF_SIZE > 0.
+ *0: no limit, only the number of images is limited*/
+#define LV_IMG_CACHE_DEF_BYTES 0
+
+/*Decode the images which are not in the image cache in the background and draw a placeholder meanwhile.
+ *Only images which need a decoder (files and `LV_IMG_CF_RAW...` variables) are decoded in the background.
+ *The area of the image is invalidated when it's decoded. Requires LV_IMG_CACHE_DEF_SIZE > 0.*/
+#define LV_USE_IMG_DECODE_ASYNC 0
+#if LV_USE_IMG_DECODE_ASYNC
+    /*Max. number of images waiting to be decoded. If it's full the images are decoded immediately.*/
+    #define LV_IMG_DECODE_ASYNC_QUEUE_LEN 8
+
+    /*1: decode the images of the decoders marked with `lv_img_decode_async_set_thread_safe()` on a helper thread
+     *   and the others from an lv_timer. The memory allocator needs to be thread safe (LV_MEM_CUSTOM = 1 is required).
+     *0: decode one image at a time from an lv_timer between the refreshes*/
+    #define LV_IMG_DECODE_ASYNC_THREAD 0
+    #if LV_IMG_DECODE_ASYNC_THREAD
+        /*1: Use a FreeRTOS task; 0: use a POSIX thread (e.g. on a Linux host)*/
+        #define LV_IMG_DECODE_ASYNC_FREERTOS 0
+        #if LV_IMG_DECODE_ASYNC_FREERTOS
+            #define LV_IMG_DECODE_ASYNC_TASK_PRIO  3
+            #define LV_IMG_DECODE_ASYNC_STACK_SIZE 8192    /*Passed to xTaskCreate() (bytes on ESP-IDF, words elsewhere)*/
+            #define LV_IMG_DECODE_ASYNC_CORE       1       /*ESP-IDF only: pin the task to this core. -1: no affinity*/
+        #endif
+    #endif
+#endif
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #define LV_GRADIENT_MAX_STOPS 2
 
 /*Default gradient buffer size.
  *When LVGL calculates the gradient "maps" it can save them into a cache to avoid calculating them again.
- *LV_GRAD_CACHE_DEF_SIZE sets the size of this cache in bytes.
- *If the cache is too small the map will be allocated only while it's required for the drawing.
+ *LV_GRAD_CACHE_DEF_SIZE sets the size of this cache in bytes. The least recently used maps are freed if it's full.
+ *Maps larger than the cache reuse the buffer of the last such map.
  *0 mean no caching.*/
 #define LV_GRAD_CACHE_DEF_SIZE 0
 
@@ -172,6 +214,55 @@
  *Only used if software rotation is enabled in the display driver.*/
 #define LV_DISP_ROT_MAX_BUF (10*1024)
 
+/*Maximum buffer size to allocate for drawing images which are read line by line (e.g. from files).
+ *Several lines are read and drawn at once as long as they fit into this buffer.*/
+#define LV_IMG_READ_AREA_MAX_BUF (8*1024)
+
+/*Split large software blend operations into horizontal stripes and render them on helper threads too.
+ *The calling thread renders a stripe as well so with 1 worker 2 CPU cores are used (e.g. on ESP32-S3).
+ *Flushing and the object tree walk remain on the calling thread because the tree walk is not reentrant
+ *(masks, draw buffers and caches are global) so the blend operations are split, not the areas to redraw.*/
+#define LV_USE_DRAW_SW_PARALLEL 0
+#if LV_USE_DRAW_SW_PARALLEL
+    /*Number of helper threads*/
+    #define LV_DRAW_SW_PARALLEL_WORKER_CNT 1
+
+    /*Blend operations smaller than this are not split [px]*/
+    #define LV_DRAW_SW_PARALLEL_MIN_PX (4 * 1024)
+
+    /*1: Use FreeRTOS tasks; 0: use POSIX threads (e.g. on a Linux host)*/
+    #define LV_DRAW_SW_PARALLEL_FREERTOS 0
+    #if LV_DRAW_SW_PARALLEL_FREERTOS
+        #define LV_DRAW_SW_PARALLEL_TASK_PRIO  5
+        #define LV_DRAW_SW_PARALLEL_STACK_SIZE 4096    /*Passed to xTaskCreate() (bytes on ESP-IDF, words elsewhere)*/
+        #define LV_DRAW_SW_PARALLEL_CORE       1       /*ESP-IDF only: pin the workers to this core. -1: no affinity*/
+    #endif
+#endif
+
+/*Blend with SIMD instructions (SSE2/AVX2 on x86, selected in run time by the CPU's features).
+ *Used with 32 bit color depth and with 16 bit color depth if LV_COLOR_MIX_ROUND_OFS is 0.
+ *No vector kernels are included for other CPUs (e.g. the PIE of the ESP32-S3), they blend with the scalar code.
+ *Kernels for them can be added with `lv_draw_sw_blend_set_kernels()`.*/
+#define LV_USE_DRAW_SW_SIMD 0
+
+/*Let the line, angle and radius masks describe the lines as transparent, unmasked and anti-aliased runs.
+ *The blending skips the transparent runs and fills the unmasked ones without reading the mask (e.g. interior of rounded rectangles and arcs).
+ *Requires `LV_DRAW_COMPLEX = 1`*/
+#define LV_USE_DRAW_MASK_SPANS 0
+
+/*Keep the recently drawn glyphs expanded to 8 bit coverage and blend them directly from the cache.
+ *With the built-in heap (LV_MEM_CUSTOM 0) the glyphs are allocated from a pool of fixed size allocated at first use.
+ *On ESP32 the glyphs are allocated in PSRAM if it's enabled.*/
+#define LV_USE_DRAW_SW_GLYPH_CACHE 0
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    /*Max. total size of the cached glyphs [bytes]. Can be changed in run time with `lv_draw_sw_glyph_cache_set_size()`*/
+    #define LV_DRAW_SW_GLYPH_CACHE_SIZE (16 * 1024)
+#endif
+
+/*In `direct_mode` move the already rendered pixels of a scrolled object in the frame buffer
+ *and redraw only the newly exposed parts. Objects covered by other objects or drawn on layers are redrawn normally.*/
+#define LV_USE_SCROLL_BLIT 0
+
 /*-------------
  * GPU
  *-----------*/
@@ -294,6 +385,15 @@
 /*1: Draw random colored rectangles over the redrawn areas*/
 #define LV_USE_REFR_DEBUG 0
 
+/*1: Record the time spent in the phases of the refreshing and in the draw functions.
+ *Print the events with `lv_profiler_flush()` and convert them to Chrome trace JSON
+ *with `scripts/lv_profiler_trace.py`.
+ *LV_PROFILER_BUF_SIZE: number of events kept in the ring buffer. The oldest ones are overwritten.*/
+#define LV_USE_PROFILER 0
+#if LV_USE_PROFILER
+    #define LV_PROFILER_BUF_SIZE 1024
+#endif
+
 /*Change the built in (v)snprintf functions*/
 #define LV_SPRINTF_CUSTOM 0
 #if LV_SPRINTF_CUSTOM
@@ -408,6 +508,10 @@
 
 /*Enables/disables support for compressed fonts.*/
 #define LV_USE_FONT_COMPRESSED 0
+#if LV_USE_FONT_COMPRESSED
+    /*Max. total size of the decompressed glyphs to keep [bytes]. 0: decompress the glyphs each time they are drawn*/
+    #define LV_FONT_DECOMPR_CACHE_SIZE (8 * 1024)
+#endif
 
 /*Enable subpixel rendering*/
 #define LV_USE_FONT_SUBPX 0
@@ -419,6 +523,14 @@
 /*Enable drawing placeholders when glyph dsc is not found*/
 #define LV_USE_FONT_PLACEHOLDER 1
 
+/*Number of recently used kerning pairs to remember for fonts with pair based kerning.
+ *Must be a power of 2. 0: disable the cache*/
+#define LV_FONT_KERN_CACHE_SIZE 64
+
+/*Convert the kerning pairs of the fonts loaded by `lv_font_load()` to class based tables.
+ *The kern values are found faster but it might need more memory.*/
+#define LV_FONT_LOADER_KERN_CLASSES 0
+
 /*=================
  *  TEXT SETTINGS
  *=================*/
@@ -491,6 +603,7 @@
 #if LV_USE_LABEL
     #define LV_LABEL_TEXT_SELECTION 1 /*Enable selecting text of the label*/
     #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
+    #define LV_LABEL_LAYOUT_CACHE 1   /*Keep the line breaks of the labels to not calculate them in every draw*/
 #endif
 
 #define LV_USE_LINE       1
@@ -648,6 +761,13 @@
 
 /*PNG decoder library*/
 #define LV_USE_PNG 0
+#if LV_USE_PNG
+    /*1: decode the non-interlaced PNG images line by line while they are drawn instead of decoding
+     *   the whole image to a `width x height x 4` bytes buffer when it's opened.
+     *   Only the compressed data, a 32 kB window and 2 lines are kept in RAM but the image is decompressed
+     *   again on every redraw. Used with 16 and 32 bit color depth.*/
+    #define LV_PNG_STREAM 0
+#endif
 
 /*BMP decoder library*/
 #define LV_USE_BMP 0
@@ -655,6 +775,24 @@
 /* JPG + split JPG decoder library.
  * Split JPG is a custom format optimized for embedded systems. */
 #define LV_USE_SJPG 0
+#if LV_USE_SJPG
+    /*Number of decoded fragments to keep per split JPG image (width * fragment height * 3 bytes each).
+     *More fragments avoid decoding them again while a partially visible image is scrolled.*/
+    #define LV_SJPG_FRAGMENT_CACHE_CNT 1
+
+    /*1: decode the next fragment on a helper thread while the current one is drawn.
+     *   Requires LV_SJPG_FRAGMENT_CACHE_CNT >= 2, LV_MEM_CUSTOM = 1 and a thread safe file system driver.*/
+    #define LV_SJPG_DECODE_THREAD 0
+    #if LV_SJPG_DECODE_THREAD
+        /*1: Use a FreeRTOS task; 0: use a POSIX thread (e.g. on a Linux host)*/
+        #define LV_SJPG_DECODE_FREERTOS 0
+        #if LV_SJPG_DECODE_FREERTOS
+            #define LV_SJPG_DECODE_TASK_PRIO  3
+            #define LV_SJPG_DECODE_STACK_SIZE 4096    /*Passed to xTaskCreate() (bytes on ESP-IDF, words elsewhere)*/
+            #define LV_SJPG_DECODE_CORE       1       /*ESP-IDF only: pin the task to this core. -1: no affinity*/
+        #endif
+    #endif
+#endif
 
 /*GIF decoder library*/
 #define LV_USE_GIF 0
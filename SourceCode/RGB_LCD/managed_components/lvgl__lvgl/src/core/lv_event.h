@@ -270,6 +270,14 @@ bool lv_obj_remove_event_dsc(struct _lv_obj_t * obj, struct _lv_event_dsc_t * ev
  */
 void * lv_obj_get_event_user_data(struct _lv_obj_t * obj, lv_event_cb_t event_cb);
 
+/**
+ * Tell if an object has an event callback for any of the `LV_EVENT_DRAW_...` events
+ * (or for all events), i.e. if the object's appearance might be customized by the user.
+ * @param obj       pointer to an object
+ * @return          true: there is such an event callback
+ */
+bool _lv_obj_has_draw_event_cb(const struct _lv_obj_t * obj);
+
 /**
  * Get the input device passed as parameter to indev related events.
  * @param e     pointer to an event
@@ -19,6 +19,7 @@
 #include "../misc/lv_async.h"
 #include "../misc/lv_fs.h"
 #include "../misc/lv_gc.h"
+#include "../font/lv_font_fmt_txt.h"
 #include "../misc/lv_math.h"
 #include "../misc/lv_log.h"
 #include "../hal/lv_hal.h"
@@ -26,6 +27,14 @@
 #include <stdint.h>
 #include <string.h>
 
+#if LV_USE_DRAW_SW_SIMD
+    #include "../draw/sw/lv_draw_sw_blend_simd.h"
+#endif
+
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    #include "../draw/sw/lv_draw_sw_glyph_cache.h"
+#endif
+
 #if LV_USE_GPU_STM32_DMA2D
     #include "../draw/stm32_dma2d/lv_gpu_stm32_dma2d.h"
 #endif
@@ -116,8 +125,16 @@ void lv_init(void)
 
     _lv_group_init();
 
+#if LV_USE_PROFILER
+    _lv_profiler_init();
+#endif
+
     lv_draw_init();
 
+#if LV_USE_DRAW_SW_SIMD
+    _lv_draw_sw_blend_simd_init();
+#endif
+
 #if LV_USE_GPU_STM32_DMA2D
     /*Initialize DMA2D GPU*/
     lv_draw_stm32_dma2d_init();
@@ -138,6 +155,16 @@ void lv_init(void)
 #endif
 
     _lv_obj_style_init();
+#if LV_USE_OBJ_DRAW_CACHE
+    _lv_obj_draw_cache_init();
+#endif
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    _lv_draw_sw_glyph_cache_init();
+#endif
+    _lv_gradient_cache_init();
+#if LV_USE_FONT_COMPRESSED
+    _lv_font_fmt_txt_decompr_cache_init();
+#endif
     _lv_ll_init(&LV_GC_ROOT(_lv_disp_ll), sizeof(lv_disp_t));
     _lv_ll_init(&LV_GC_ROOT(_lv_indev_ll), sizeof(lv_indev_t));
 
@@ -147,6 +174,9 @@ void lv_init(void)
     _lv_img_decoder_init();
 #if LV_IMG_CACHE_DEF_SIZE
     lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+#endif
+#if LV_USE_IMG_DECODE_ASYNC
+    _lv_img_decode_async_init();
 #endif
     /*Test if the IDE has UTF-8 encoding*/
     const char * txt = "Á";
@@ -196,6 +226,9 @@ void lv_init(void)
 
 void lv_deinit(void)
 {
+    lv_gradient_free_cache();
+    _lv_font_fmt_txt_free_lookups();
+    lv_img_cache_invalidate_src(NULL);
     _lv_gc_clear_roots();
 
     lv_disp_set_default(NULL);
@@ -235,6 +268,14 @@ void lv_obj_add_flag(lv_obj_t * obj, lv_obj_flag_t f)
     /* We must invalidate the area occupied by the object before we hide it as calls to invalidate hidden objects are ignored */
     if(f & LV_OBJ_FLAG_HIDDEN) lv_obj_invalidate(obj);
 
+#if LV_USE_OBJ_DRAW_CACHE && LV_COLOR_SCREEN_TRANSP == 0
+    /*Without alpha channel in the images only the widgets covering their area can be cached*/
+    if((f & LV_OBJ_FLAG_DRAW_CACHE) && !_lv_obj_draw_cache_is_opaque(obj)) {
+        LV_LOG_WARN("the widget doesn't cover its area, caching it needs LV_COLOR_SCREEN_TRANSP 1");
+        f &= ~LV_OBJ_FLAG_DRAW_CACHE;
+    }
+#endif
+
     obj->flags |= f;
 
     if(f & LV_OBJ_FLAG_HIDDEN) {
@@ -277,6 +318,10 @@ void lv_obj_clear_flag(lv_obj_t * obj, lv_obj_flag_t f)
 
     obj->flags &= (~f);
 
+#if LV_USE_OBJ_DRAW_CACHE
+    if(f & LV_OBJ_FLAG_DRAW_CACHE) _lv_obj_draw_cache_remove(obj);
+#endif
+
     if(f & LV_OBJ_FLAG_HIDDEN) {
         lv_obj_invalidate(obj);
         if(lv_obj_is_layout_positioned(obj)) {
@@ -466,6 +511,9 @@ static void lv_obj_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     if(group) lv_group_remove_obj(obj);
 
     if(obj->spec_attr) {
+#if LV_USE_OBJ_DRAW_CACHE
+        _lv_obj_draw_cache_remove(obj);
+#endif
         if(obj->spec_attr->children) {
             lv_mem_free(obj->spec_attr->children);
             obj->spec_attr->children = NULL;
@@ -108,6 +108,7 @@ enum {
     LV_OBJ_FLAG_IGNORE_LAYOUT   = (1L << 17), /**< Make the object position-able by the layouts*/
     LV_OBJ_FLAG_FLOATING        = (1L << 18), /**< Do not scroll the object when the parent scrolls and ignore layout*/
     LV_OBJ_FLAG_OVERFLOW_VISIBLE = (1L << 19), /**< Do not clip the children's content to the parent's boundary*/
+    LV_OBJ_FLAG_DRAW_CACHE      = (1L << 20), /**< Cache the rendered image of the object and its children. Needs `LV_USE_OBJ_DRAW_CACHE`*/
 
     LV_OBJ_FLAG_LAYOUT_1        = (1L << 23), /**< Custom flag, free to use by layouts*/
     LV_OBJ_FLAG_LAYOUT_2        = (1L << 24), /**< Custom flag, free to use by layouts*/
@@ -138,6 +139,7 @@ typedef enum {
 #include "lv_obj_scroll.h"
 #include "lv_obj_style.h"
 #include "lv_obj_draw.h"
+#include "lv_obj_draw_cache.h"
 #include "lv_obj_class.h"
 #include "lv_event.h"
 #include "lv_group.h"
@@ -168,6 +170,10 @@ typedef struct {
     lv_dir_t scroll_dir : 4;                /**< The allowed scroll direction(s)*/
     uint8_t event_dsc_cnt : 6;              /**< Number of event callbacks stored in `event_dsc` array*/
     uint8_t layer_type : 2;    /**< Cache the layer type here. Element of @lv_intermediate_layer_type_t */
+
+#if LV_USE_OBJ_DRAW_CACHE
+    void * draw_cache;                  /**< The cached image of the object if `LV_OBJ_FLAG_DRAW_CACHE` is set*/
+#endif
 } _lv_obj_spec_attr_t;
 
 typedef struct _lv_obj_t {
@@ -0,0 +1,358 @@
+/**
+ * @file lv_obj_draw_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_obj.h"
+
+#if LV_USE_OBJ_DRAW_CACHE
+
+#include "lv_refr.h"
+#include "../misc/lv_gc.h"
+
+#if defined(ESP_PLATFORM) && defined(CONFIG_SPIRAM)
+    #include "esp_heap_caps.h"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define _cache_ll LV_GC_ROOT(_lv_obj_draw_cache_ll)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_obj_t * obj;
+    uint8_t * buf;
+    uint32_t buf_size;
+    lv_coord_t w;               /**< Size of the image. It's `obj->coords` + ext. draw size*/
+    lv_coord_t h;
+    lv_img_cf_t cf;
+    uint8_t rendering : 1;      /**< The image is being rendered, it can't be freed now*/
+    uint8_t stale : 1;          /**< Dropped while rendering, free it when rendering is finished*/
+} cache_entry_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static cache_entry_t * entry_create(lv_obj_t * obj, const lv_area_t * area);
+static bool entry_render(lv_draw_ctx_t * draw_ctx, cache_entry_t * entry, const lv_area_t * area);
+static void entry_drop(cache_entry_t * entry);
+static void entry_free(cache_entry_t * entry);
+static void * buf_alloc(uint32_t size);
+static void buf_free(void * buf);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint32_t cache_size;
+static uint32_t cache_used;
+static uint32_t hit_cnt;
+static uint32_t miss_cnt;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_obj_draw_cache_init(void)
+{
+    _lv_ll_init(&_cache_ll, sizeof(cache_entry_t));
+    cache_size = LV_OBJ_DRAW_CACHE_SIZE;
+    cache_used = 0;
+    hit_cnt = 0;
+    miss_cnt = 0;
+}
+
+void lv_obj_draw_cache_set_size(uint32_t size)
+{
+    cache_size = size;
+
+    /*Drop the least recently used images to fit into the new size*/
+    cache_entry_t * entry = _lv_ll_get_tail(&_cache_ll);
+    while(entry && cache_used > cache_size) {
+        cache_entry_t * prev = _lv_ll_get_prev(&_cache_ll, entry);
+        entry_drop(entry);
+        entry = prev;
+    }
+}
+
+void lv_obj_draw_cache_get_info(lv_obj_draw_cache_info_t * info)
+{
+    LV_ASSERT_NULL(info);
+
+    info->size = cache_size;
+    info->used = cache_used;
+    info->entry_cnt = _lv_ll_get_len(&_cache_ll);
+    info->hit_cnt = hit_cnt;
+    info->miss_cnt = miss_cnt;
+}
+
+void lv_obj_draw_cache_clear(void)
+{
+    cache_entry_t * entry = _lv_ll_get_head(&_cache_ll);
+    while(entry) {
+        cache_entry_t * next = _lv_ll_get_next(&_cache_ll, entry);
+        entry_drop(entry);
+        entry = next;
+    }
+
+    hit_cnt = 0;
+    miss_cnt = 0;
+}
+
+bool _lv_obj_draw_cache_draw(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
+{
+    if(!lv_obj_has_flag(obj, LV_OBJ_FLAG_DRAW_CACHE)) return false;
+
+    /*The children drawn out of the object can't be cached*/
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE)) return false;
+
+    lv_area_t area;
+    lv_coord_t ext_draw_size = _lv_obj_get_ext_draw_size(obj);
+    lv_area_copy(&area, &obj->coords);
+    lv_area_increase(&area, ext_draw_size, ext_draw_size);
+
+    /*Nothing to do if the object is not visible now*/
+    const lv_area_t * clip_area_ori = draw_ctx->clip_area;
+    lv_area_t clip_area;
+    if(!_lv_area_intersect(&clip_area, clip_area_ori, &area)) return true;
+
+    cache_entry_t * entry = obj->spec_attr ? obj->spec_attr->draw_cache : NULL;
+    if(entry && (entry->w != lv_area_get_width(&area) || entry->h != lv_area_get_height(&area))) {
+        entry_drop(entry);
+        entry = NULL;
+    }
+
+    if(entry) {
+        hit_cnt++;
+        _lv_ll_move_before(&_cache_ll, entry, _lv_ll_get_head(&_cache_ll));
+    }
+    else {
+        /*The masks of the parents would be rendered into the image too*/
+        if(lv_draw_mask_is_any(&area)) return false;
+
+        entry = entry_create(obj, &area);
+        if(entry == NULL) return false;
+
+        miss_cnt++;
+        bool res = entry_render(draw_ctx, entry, &area);
+
+        /*Something was invalidated on the object while rendering it*/
+        if(entry->stale) {
+            entry_free(entry);
+            return false;
+        }
+
+        if(!res) {
+            entry_drop(entry);
+            return false;
+        }
+    }
+
+    /*Only the area of the object is updated by `lv_obj_redraw` too, so limit the clip area to it*/
+    draw_ctx->clip_area = &clip_area;
+
+    lv_draw_img_dsc_t img_dsc;
+    lv_draw_img_dsc_init(&img_dsc);
+    lv_draw_img_decoded(draw_ctx, &img_dsc, &area, entry->buf, entry->cf);
+
+    draw_ctx->clip_area = clip_area_ori;
+    return true;
+}
+
+void _lv_obj_draw_cache_invalidate(lv_obj_t * obj)
+{
+    if(_lv_ll_get_head(&_cache_ll) == NULL) return;
+
+    while(obj) {
+        if(obj->spec_attr && obj->spec_attr->draw_cache) entry_drop(obj->spec_attr->draw_cache);
+        obj = lv_obj_get_parent(obj);
+    }
+}
+
+void _lv_obj_draw_cache_remove(lv_obj_t * obj)
+{
+    if(obj->spec_attr && obj->spec_attr->draw_cache) entry_drop(obj->spec_attr->draw_cache);
+}
+
+bool _lv_obj_draw_cache_is_opaque(lv_obj_t * obj)
+{
+    lv_area_t area;
+    lv_coord_t ext_draw_size = _lv_obj_get_ext_draw_size(obj);
+    lv_area_copy(&area, &obj->coords);
+    lv_area_increase(&area, ext_draw_size, ext_draw_size);
+
+    /*The shadow, outline, etc. drawn out of the widget are never opaque everywhere*/
+    if(!_lv_area_is_in(&area, &obj->coords, 0)) return false;
+
+    lv_cover_check_info_t info;
+    info.res = LV_COVER_RES_COVER;
+    info.area = &area;
+    lv_event_send(obj, LV_EVENT_COVER_CHECK, &info);
+    return info.res == LV_COVER_RES_COVER;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Allocate a new image for a widget. Drop the least recently used images if the size limit is reached.
+ * @param obj       pointer to a widget
+ * @param area      the area of the image (obj's coordinates + ext. draw size)
+ * @return          the new entry or NULL if the image can't be cached
+ */
+static cache_entry_t * entry_create(lv_obj_t * obj, const lv_area_t * area)
+{
+    /*If the widget doesn't cover its area the alpha channel also needs to be saved*/
+    lv_img_cf_t cf = _lv_obj_draw_cache_is_opaque(obj) ? LV_IMG_CF_TRUE_COLOR : LV_IMG_CF_TRUE_COLOR_ALPHA;
+
+#if LV_COLOR_SCREEN_TRANSP == 0
+    /*It stopped covering its area since the flag was added. It can't be rendered with alpha channel.*/
+    if(cf == LV_IMG_CF_TRUE_COLOR_ALPHA) return NULL;
+#endif
+
+    uint32_t px_size = cf == LV_IMG_CF_TRUE_COLOR_ALPHA ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    uint32_t buf_size = lv_area_get_size(area) * px_size;
+    if(buf_size > cache_size) return NULL;
+
+    /*The images being rendered (the parents of `obj`) can't be dropped*/
+    cache_entry_t * tail = _lv_ll_get_tail(&_cache_ll);
+    while(tail && cache_used + buf_size > cache_size) {
+        cache_entry_t * prev = _lv_ll_get_prev(&_cache_ll, tail);
+        if(!tail->rendering) entry_drop(tail);
+        tail = prev;
+    }
+
+    if(cache_used + buf_size > cache_size) return NULL;
+
+    uint8_t * buf = buf_alloc(buf_size);
+    if(buf == NULL) {
+        LV_LOG_WARN("couldn't allocate %"LV_PRIu32" bytes for the cached image", buf_size);
+        return NULL;
+    }
+
+    lv_obj_allocate_spec_attr(obj);
+    cache_entry_t * entry = _lv_ll_ins_head(&_cache_ll);
+    LV_ASSERT_MALLOC(entry);
+    if(entry == NULL || obj->spec_attr == NULL) {
+        if(entry) _lv_ll_remove(&_cache_ll, entry);
+        lv_mem_free(entry);
+        buf_free(buf);
+        return NULL;
+    }
+
+    entry->obj = obj;
+    entry->buf = buf;
+    entry->buf_size = buf_size;
+    entry->w = lv_area_get_width(area);
+    entry->h = lv_area_get_height(area);
+    entry->cf = cf;
+    entry->rendering = 0;
+    entry->stale = 0;
+    obj->spec_attr->draw_cache = entry;
+    cache_used += buf_size;
+
+    return entry;
+}
+
+/**
+ * Render a widget and its children into its cached image
+ * @param draw_ctx  pointer to the draw context used to refresh the display
+ * @param entry     the cache entry of the widget
+ * @param area      the area of the image
+ * @return          true: successfully rendered
+ */
+static bool entry_render(lv_draw_ctx_t * draw_ctx, cache_entry_t * entry, const lv_area_t * area)
+{
+    lv_disp_t * disp = _lv_refr_get_disp_refreshing();
+    if(disp == NULL || disp->driver->set_px_cb) return false;
+
+    void * buf_ori = draw_ctx->buf;
+    const lv_area_t * buf_area_ori = draw_ctx->buf_area;
+    const lv_area_t * clip_area_ori = draw_ctx->clip_area;
+    uint32_t screen_transp_ori = disp->driver->screen_transp;
+
+    bool has_alpha = entry->cf == LV_IMG_CF_TRUE_COLOR_ALPHA;
+    if(has_alpha) lv_memset_00(entry->buf, entry->buf_size);
+
+    /*Redirect the rendering to the image*/
+    draw_ctx->buf = entry->buf;
+    draw_ctx->buf_area = area;
+    draw_ctx->clip_area = area;
+    disp->driver->screen_transp = has_alpha ? 1 : 0;
+
+    /*The children's images and the invalidations in the draw events can drop the entry,
+     *but the buffer needs to stay valid until rendering is finished*/
+    entry->rendering = 1;
+    lv_obj_redraw(draw_ctx, entry->obj);
+    lv_draw_wait_for_finish(draw_ctx);
+    entry->rendering = 0;
+
+    draw_ctx->buf = buf_ori;
+    draw_ctx->buf_area = buf_area_ori;
+    draw_ctx->clip_area = clip_area_ori;
+    disp->driver->screen_transp = screen_transp_ori;
+
+    return true;
+}
+
+/**
+ * Remove the image from its widget and free it.
+ * If the image is being rendered only mark it as stale and let the renderer free it.
+ * @param entry     the cache entry to drop
+ */
+static void entry_drop(cache_entry_t * entry)
+{
+    if(entry->stale) return;
+
+    if(entry->obj->spec_attr) entry->obj->spec_attr->draw_cache = NULL;
+    if(entry->rendering) {
+        entry->stale = 1;
+        return;
+    }
+
+    entry_free(entry);
+}
+
+static void entry_free(cache_entry_t * entry)
+{
+    cache_used -= entry->buf_size;
+    buf_free(entry->buf);
+    _lv_ll_remove(&_cache_ll, entry);
+    lv_mem_free(entry);
+}
+
+/**
+ * Allocate the image buffers in the external RAM if it's available.
+ * They can be large and are used only as a source of a copy.
+ */
+static void * buf_alloc(uint32_t size)
+{
+#if defined(ESP_PLATFORM) && defined(CONFIG_SPIRAM)
+    void * buf = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if(buf == NULL) buf = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    return buf;
+#else
+    return lv_mem_alloc(size);
+#endif
+}
+
+static void buf_free(void * buf)
+{
+#if defined(ESP_PLATFORM) && defined(CONFIG_SPIRAM)
+    heap_caps_free(buf);
+#else
+    lv_mem_free(buf);
+#endif
+}
+
+#endif /*LV_USE_OBJ_DRAW_CACHE*/
@@ -0,0 +1,106 @@
+/**
+ * @file lv_obj_draw_cache.h
+ *
+ */
+
+#ifndef LV_OBJ_DRAW_CACHE_H
+#define LV_OBJ_DRAW_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+#include "../draw/lv_draw.h"
+
+#if LV_USE_OBJ_DRAW_CACHE
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+struct _lv_obj_t;
+
+typedef struct {
+    uint32_t size;          /**< The max. total size of the cached images in bytes*/
+    uint32_t used;          /**< The current total size of the cached images in bytes*/
+    uint32_t entry_cnt;     /**< Number of cached widgets*/
+    uint32_t hit_cnt;       /**< Number of times a widget was drawn from the cache*/
+    uint32_t miss_cnt;      /**< Number of times a widget had to be rendered into the cache*/
+} lv_obj_draw_cache_info_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the draw cache. Called by `lv_init()`.
+ */
+void _lv_obj_draw_cache_init(void);
+
+/**
+ * Set the max. total size of the cached images.
+ * The least recently used images are dropped if the new size is smaller than the current usage.
+ * @param size      the new size in bytes. 0: disable caching
+ */
+void lv_obj_draw_cache_set_size(uint32_t size);
+
+/**
+ * Get the current state of the draw cache
+ * @param info      store the result here
+ */
+void lv_obj_draw_cache_get_info(lv_obj_draw_cache_info_t * info);
+
+/**
+ * Drop all the cached images and reset the hit/miss counters.
+ */
+void lv_obj_draw_cache_clear(void);
+
+/**
+ * Draw a widget having `LV_OBJ_FLAG_DRAW_CACHE` from its cached image.
+ * If the image is not cached yet, render the widget and its children into a new image first.
+ * @param draw_ctx  pointer to a draw context
+ * @param obj       pointer to the widget to draw
+ * @return          true: the widget is drawn; false: it can't be cached, it should be drawn normally
+ */
+bool _lv_obj_draw_cache_draw(lv_draw_ctx_t * draw_ctx, struct _lv_obj_t * obj);
+
+/**
+ * Drop the cached image of a widget and of all of its parents as their appearance has changed.
+ * Called when a part of `obj` is invalidated.
+ * @param obj       pointer to a widget
+ */
+void _lv_obj_draw_cache_invalidate(struct _lv_obj_t * obj);
+
+/**
+ * Drop the cached image of only the given widget (e.g. because it's deleted)
+ * @param obj       pointer to a widget
+ */
+void _lv_obj_draw_cache_remove(struct _lv_obj_t * obj);
+
+/**
+ * Check if a widget covers its area (with the ext. draw size) with opaque pixels,
+ * i.e. its image can be cached without alpha channel.
+ * @param obj       pointer to a widget
+ * @return          true: the widget is opaque everywhere in its area
+ */
+bool _lv_obj_draw_cache_is_opaque(struct _lv_obj_t * obj);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_OBJ_DRAW_CACHE*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_OBJ_DRAW_CACHE_H*/
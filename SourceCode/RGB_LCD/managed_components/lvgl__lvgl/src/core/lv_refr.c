@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include <stddef.h>
+#include <string.h>
 #include "lv_refr.h"
 #include "lv_disp.h"
 #include "../hal/lv_hal_tick.h"
@@ -15,6 +16,7 @@
 #include "../misc/lv_mem.h"
 #include "../misc/lv_math.h"
 #include "../misc/lv_gc.h"
+#include "../misc/lv_profiler.h"
 #include "../draw/lv_draw.h"
 #include "../font/lv_font_fmt_txt.h"
 #include "../extra/others/snapshot/lv_snapshot.h"
@@ -52,8 +54,12 @@ typedef struct {
  *  STATIC PROTOTYPES
  **********************/
 static void lv_refr_join_area(void);
+static bool join_is_worth(const lv_area_t * a1, const lv_area_t * a2, lv_area_t * joined_area, uint32_t flush_cost);
 static void refr_invalid_areas(void);
 static void refr_sync_areas(void);
+#if LV_USE_SCROLL_BLIT
+    static void refr_scroll_blit(void);
+#endif
 static void refr_area(const lv_area_t * area_p);
 static void refr_area_part(lv_draw_ctx_t * draw_ctx);
 static lv_obj_t * lv_refr_get_top_obj(const lv_area_t * area_p, lv_obj_t * obj);
@@ -62,6 +68,8 @@ static void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj);
 static uint32_t get_max_row(lv_disp_t * disp, lv_coord_t area_w, lv_coord_t area_h);
 static void draw_buf_flush(lv_disp_t * disp);
 static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static bool buf_ring_is_used(lv_disp_drv_t * drv);
+static void buf_ring_wait(lv_disp_drv_t * drv, uint32_t max_in_flight);
 
 #if LV_USE_PERF_MONITOR
     static void perf_monitor_init(perf_monitor_t * perf_monitor);
@@ -216,6 +224,9 @@ void _lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
     /*Clear the invalidate buffer if the parameter is NULL*/
     if(area_p == NULL) {
         disp->inv_p = 0;
+#if LV_USE_SCROLL_BLIT
+        disp->scroll_blit_pending = 0;
+#endif
         return;
     }
 
@@ -250,12 +261,23 @@ void _lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
     /*Save the area*/
     if(disp->inv_p < LV_INV_BUF_SIZE) {
         lv_area_copy(&disp->inv_areas[disp->inv_p], &com_area);
+        disp->inv_p++;
     }
-    else {   /*If no place for the area add the screen*/
-        disp->inv_p = 0;
-        lv_area_copy(&disp->inv_areas[disp->inv_p], &scr_area);
+    else {
+        /*If there is no place for the area join it into the saved area which grows the least*/
+        uint16_t best_i = 0;
+        uint32_t best_extra = UINT32_MAX;
+        lv_area_t joined_area;
+        for(i = 0; i < disp->inv_p; i++) {
+            _lv_area_join(&joined_area, &disp->inv_areas[i], &com_area);
+            uint32_t extra = lv_area_get_size(&joined_area) - lv_area_get_size(&disp->inv_areas[i]);
+            if(extra < best_extra) {
+                best_extra = extra;
+                best_i = i;
+            }
+        }
+        _lv_area_join(&disp->inv_areas[best_i], &disp->inv_areas[best_i], &com_area);
     }
-    disp->inv_p++;
     if(disp->refr_timer) lv_timer_resume(disp->refr_timer);
 }
 
@@ -279,6 +301,47 @@ void _lv_refr_set_disp_refreshing(lv_disp_t * disp)
     disp_refr = disp;
 }
 
+#if LV_USE_SCROLL_BLIT
+void _lv_refr_scroll_blit(lv_disp_t * disp, const lv_area_t * area, lv_coord_t dx, lv_coord_t dy)
+{
+    if(!lv_disp_is_invalidation_enabled(disp)) return;
+
+    /*Only one area can be moved. If there is an other one, simply redraw it.*/
+    if(disp->scroll_blit_pending && !_lv_area_is_equal(&disp->scroll_blit_area, area)) {
+        disp->scroll_blit_pending = 0;
+        _lv_inv_area(disp, &disp->scroll_blit_area);
+    }
+
+    /*The invalid pixels on the area will be moved too, so invalidate them on their new position as well*/
+    uint16_t inv_p = disp->inv_p;
+    uint16_t i;
+    for(i = 0; i < inv_p; i++) {
+        lv_area_t moved;
+        if(!_lv_area_intersect(&moved, &disp->inv_areas[i], area)) continue;
+        lv_area_move(&moved, dx, dy);
+        if(_lv_area_intersect(&moved, &moved, area)) _lv_inv_area(disp, &moved);
+    }
+
+    if(disp->scroll_blit_pending) {
+        disp->scroll_blit_ofs.x += dx;
+        disp->scroll_blit_ofs.y += dy;
+    }
+    else {
+        disp->scroll_blit_area = *area;
+        disp->scroll_blit_ofs.x = dx;
+        disp->scroll_blit_ofs.y = dy;
+        disp->scroll_blit_pending = 1;
+    }
+
+    /*Nothing remains to move if it was scrolled by more than the size of the area*/
+    if(LV_ABS(disp->scroll_blit_ofs.x) >= lv_area_get_width(area) ||
+       LV_ABS(disp->scroll_blit_ofs.y) >= lv_area_get_height(area)) {
+        disp->scroll_blit_pending = 0;
+        _lv_inv_area(disp, area);
+    }
+}
+#endif
+
 /**
  * Called periodically to handle the refreshing
  * @param tmr pointer to the timer itself
@@ -286,6 +349,7 @@ void _lv_refr_set_disp_refreshing(lv_disp_t * disp)
 void _lv_disp_refr_timer(lv_timer_t * tmr)
 {
     REFR_TRACE("begin");
+    LV_PROFILER_BEGIN;
 
     uint32_t start = lv_tick_get();
     volatile uint32_t elaps = 0;
@@ -305,22 +369,31 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
     }
 
     /*Refresh the screen's layout if required*/
+    LV_PROFILER_BEGIN_TAG("layout");
     lv_obj_update_layout(disp_refr->act_scr);
     if(disp_refr->prev_scr) lv_obj_update_layout(disp_refr->prev_scr);
 
     lv_obj_update_layout(disp_refr->top_layer);
     lv_obj_update_layout(disp_refr->sys_layer);
+    LV_PROFILER_END_TAG("layout");
 
     /*Do nothing if there is no active screen*/
     if(disp_refr->act_scr == NULL) {
         disp_refr->inv_p = 0;
+#if LV_USE_SCROLL_BLIT
+        disp_refr->scroll_blit_pending = 0;
+#endif
         LV_LOG_WARN("there is no active screen");
         REFR_TRACE("finished");
+        LV_PROFILER_END;
         return;
     }
 
     lv_refr_join_area();
     refr_sync_areas();
+#if LV_USE_SCROLL_BLIT
+    refr_scroll_blit();
+#endif
     refr_invalid_areas();
 
     /*If refresh happened ...*/
@@ -448,6 +521,7 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
 #endif
 
     REFR_TRACE("finished");
+    LV_PROFILER_END;
 }
 
 #if LV_USE_PERF_MONITOR
@@ -475,36 +549,77 @@ uint32_t lv_refr_get_fps_avg(void)
  */
 static void lv_refr_join_area(void)
 {
-    uint32_t join_from;
-    uint32_t join_in;
-    lv_area_t joined_area;
-    for(join_in = 0; join_in < disp_refr->inv_p; join_in++) {
-        if(disp_refr->inv_area_joined[join_in] != 0) continue;
-
-        /*Check all areas to join them in 'join_in'*/
-        for(join_from = 0; join_from < disp_refr->inv_p; join_from++) {
-            /*Handle only unjoined areas and ignore itself*/
-            if(disp_refr->inv_area_joined[join_from] != 0 || join_in == join_from) {
-                continue;
-            }
+    LV_PROFILER_BEGIN;
 
-            /*Check if the areas are on each other*/
-            if(_lv_area_is_on(&disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]) == false) {
-                continue;
-            }
+    uint32_t flush_cost = disp_refr->driver->flush_cost_px;
 
-            _lv_area_join(&joined_area, &disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]);
-
-            /*Join two area only if the joined area size is smaller*/
-            if(lv_area_get_size(&joined_area) < (lv_area_get_size(&disp_refr->inv_areas[join_in]) +
-                                                 lv_area_get_size(&disp_refr->inv_areas[join_from]))) {
-                lv_area_copy(&disp_refr->inv_areas[join_in], &joined_area);
+    /*Sort the areas by `y1` (insertion sort, there are only a few areas).
+     *This way an area needs to be compared only with the next areas which are vertically close to it.*/
+    uint16_t order[LV_INV_BUF_SIZE];
+    uint32_t cnt = 0;
+    uint32_t i;
+    for(i = 0; i < disp_refr->inv_p; i++) {
+        if(disp_refr->inv_area_joined[i] != 0) continue;
+        uint32_t j = cnt;
+        while(j > 0 && disp_refr->inv_areas[order[j - 1]].y1 > disp_refr->inv_areas[i].y1) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+        cnt++;
+    }
 
-                /*Mark 'join_form' is joined into 'join_in'*/
-                disp_refr->inv_area_joined[join_from] = 1;
+    /*A joined area can reach new areas so repeat until there is nothing to join*/
+    lv_area_t joined_area;
+    bool joined_any;
+    do {
+        joined_any = false;
+        uint32_t in_i;
+        for(in_i = 0; in_i < cnt; in_i++) {
+            uint16_t join_in = order[in_i];
+            if(disp_refr->inv_area_joined[join_in] != 0) continue;
+
+            lv_area_t * area_in = &disp_refr->inv_areas[join_in];
+            uint32_t from_i;
+            for(from_i = in_i + 1; from_i < cnt; from_i++) {
+                uint16_t join_from = order[from_i];
+                if(disp_refr->inv_area_joined[join_from] != 0) continue;
+
+                /*Joining `gap` empty rows costs at least `gap * width` pixels.
+                 *The next areas start even lower so they can't be joined either.*/
+                lv_area_t * area_from = &disp_refr->inv_areas[join_from];
+                int32_t gap = area_from->y1 - area_in->y2 - 1;
+                if(gap > 0 && (uint32_t)gap * lv_area_get_width(area_in) >= flush_cost) break;
+
+                if(join_is_worth(area_in, area_from, &joined_area, flush_cost)) {
+                    lv_area_copy(area_in, &joined_area);
+
+                    /*Mark 'join_form' is joined into 'join_in'*/
+                    disp_refr->inv_area_joined[join_from] = 1;
+                    joined_any = true;
+                }
             }
         }
-    }
+    } while(joined_any);
+
+    LV_PROFILER_END;
+}
+
+/**
+ * Tell if it's worth to redraw two areas as one.
+ * @param a1            pointer to an area
+ * @param a2            pointer to an other area
+ * @param joined_area   store the joined area here
+ * @param flush_cost    the cost of a flush in pixels
+ * @return              true: the joined area is cheaper to redraw
+ */
+static bool join_is_worth(const lv_area_t * a1, const lv_area_t * a2, lv_area_t * joined_area, uint32_t flush_cost)
+{
+    _lv_area_join(joined_area, a1, a2);
+
+    /*Separate areas always have less pixels than their bounding box.
+     *So with 0 cost it's worth only if the areas overlap (as the overlapping part is drawn only once).*/
+    return lv_area_get_size(joined_area) < lv_area_get_size(a1) + lv_area_get_size(a2) + flush_cost;
 }
 
 /**
@@ -521,6 +636,8 @@ static void refr_sync_areas(void)
     /*Do not sync if no sync areas*/
     if(_lv_ll_is_empty(&disp_refr->sync_areas)) return;
 
+    LV_PROFILER_BEGIN;
+
     /*The buffers are already swapped.
      *So the active buffer is the off screen buffer where LVGL will render*/
     void * buf_off_screen = disp_refr->driver->draw_buf->buf_act;
@@ -577,8 +694,64 @@ static void refr_sync_areas(void)
 
     /*Clear sync areas*/
     _lv_ll_clear(&disp_refr->sync_areas);
+
+    LV_PROFILER_END;
 }
 
+#if LV_USE_SCROLL_BLIT
+/**
+ * Move the pixels of the scrolled area in the frame buffer.
+ * With 2 buffers copy them from the on screen buffer which has the previous frame.
+ */
+static void refr_scroll_blit(void)
+{
+    if(!disp_refr->scroll_blit_pending) return;
+    disp_refr->scroll_blit_pending = 0;
+
+    /*The previous frame is available only in direct mode*/
+    lv_disp_drv_t * drv = disp_refr->driver;
+    if(!drv->direct_mode || drv->full_refresh) return;
+
+    lv_coord_t dx = disp_refr->scroll_blit_ofs.x;
+    lv_coord_t dy = disp_refr->scroll_blit_ofs.y;
+    lv_area_t dest_area;
+    lv_area_t src_area = disp_refr->scroll_blit_area;
+    lv_area_move(&src_area, dx, dy);
+    if(!_lv_area_intersect(&dest_area, &src_area, &disp_refr->scroll_blit_area)) return;
+
+    LV_PROFILER_BEGIN;
+    src_area = dest_area;
+    lv_area_move(&src_area, -dx, -dy);
+
+    lv_disp_draw_buf_t * draw_buf = drv->draw_buf;
+    lv_coord_t stride = lv_disp_get_hor_res(disp_refr);
+    if(draw_buf->buf2) {
+        void * buf_on_screen = draw_buf->buf_act == draw_buf->buf1 ? draw_buf->buf2 : draw_buf->buf1;
+        drv->draw_ctx->buffer_copy(drv->draw_ctx, draw_buf->buf_act, stride, &dest_area,
+                                   buf_on_screen, stride, &src_area);
+
+        /*The moved pixels need to be copied to the other buffer in the next refresh*/
+        lv_area_t * sync_area = _lv_ll_ins_tail(&disp_refr->sync_areas);
+        if(sync_area) *sync_area = dest_area;
+    }
+    else {
+        /*Moving in the same buffer: start from the end if moving down to not overwrite the source*/
+        lv_color_t * buf = draw_buf->buf_act;
+        lv_coord_t w = lv_area_get_width(&dest_area);
+        lv_coord_t h = lv_area_get_height(&dest_area);
+        lv_coord_t y;
+        for(y = 0; y < h; y++) {
+            lv_coord_t row = dy > 0 ? h - 1 - y : y;
+            lv_color_t * dest = buf + (dest_area.y1 + row) * stride + dest_area.x1;
+            lv_color_t * src = buf + (src_area.y1 + row) * stride + src_area.x1;
+            memmove(dest, src, w * sizeof(lv_color_t));
+        }
+    }
+
+    LV_PROFILER_END;
+}
+#endif
+
 /**
  * Refresh the joined areas
  */
@@ -588,6 +761,8 @@ static void refr_invalid_areas(void)
 
     if(disp_refr->inv_p == 0) return;
 
+    LV_PROFILER_BEGIN;
+
     /*Find the last area which will be drawn*/
     int32_t i;
     int32_t last_i = 0;
@@ -620,6 +795,8 @@ static void refr_invalid_areas(void)
     }
 
     disp_refr->rendering_in_progress = false;
+
+    LV_PROFILER_END;
 }
 
 /**
@@ -628,6 +805,8 @@ static void refr_invalid_areas(void)
  */
 static void refr_area(const lv_area_t * area_p)
 {
+    LV_PROFILER_BEGIN;
+
     lv_draw_ctx_t * draw_ctx = disp_refr->driver->draw_ctx;
     draw_ctx->buf = disp_refr->driver->draw_buf->buf_act;
 
@@ -648,6 +827,7 @@ static void refr_area(const lv_area_t * area_p)
             draw_ctx->clip_area = area_p;
             refr_area_part(draw_ctx);
         }
+        LV_PROFILER_END;
         return;
     }
 
@@ -691,6 +871,8 @@ static void refr_area(const lv_area_t * area_p)
         disp_refr->driver->draw_buf->last_part = 1;
         refr_area_part(draw_ctx);
     }
+
+    LV_PROFILER_END;
 }
 
 static void refr_area_part(lv_draw_ctx_t * draw_ctx)
@@ -704,11 +886,17 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx)
      * In single buffered mode wait here until the buffer is freed.
      * In full double buffered mode wait here while the buffers are swapped and a buffer becomes available*/
     bool full_sized = draw_buf->size == (uint32_t)disp_refr->driver->hor_res * disp_refr->driver->ver_res;
-    if((draw_buf->buf1 && !draw_buf->buf2) ||
-       (draw_buf->buf1 && draw_buf->buf2 && full_sized)) {
+    if(buf_ring_is_used(disp_refr->driver)) {
+        /*With a buffer ring wait only until the buffer to render into is returned by the driver*/
+        buf_ring_wait(disp_refr->driver, draw_buf->buf_ring_cnt - 1);
+    }
+    else if((draw_buf->buf1 && !draw_buf->buf2) ||
+            (draw_buf->buf1 && draw_buf->buf2 && full_sized)) {
+        LV_PROFILER_BEGIN_TAG("flush_wait");
         while(draw_buf->flushing) {
             if(disp_refr->driver->wait_cb) disp_refr->driver->wait_cb(disp_refr->driver);
         }
+        LV_PROFILER_END_TAG("flush_wait");
 
         /*If the screen is transparent initialize it when the flushing is ready*/
 #if LV_COLOR_SCREEN_TRANSP
@@ -967,6 +1155,9 @@ void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
     if(lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) return;
     lv_layer_type_t layer_type = _lv_obj_get_layer_type(obj);
     if(layer_type == LV_LAYER_TYPE_NONE) {
+#if LV_USE_OBJ_DRAW_CACHE
+        if(_lv_obj_draw_cache_draw(draw_ctx, obj)) return;
+#endif
         lv_obj_redraw(draw_ctx, obj);
     }
     else {
@@ -1196,6 +1387,10 @@ static void draw_buf_rotate(lv_area_t * area, lv_color_t * color_p)
         lv_coord_t max_row = LV_MIN((lv_coord_t)((LV_DISP_ROT_MAX_BUF / sizeof(lv_color_t)) / area_w), area_h);
         lv_coord_t init_y_off;
         init_y_off = area->y1;
+
+        /*The chunks are flushed serially so wait for the buffers of the ring which are still in flight*/
+        if(buf_ring_is_used(drv)) buf_ring_wait(drv, 0);
+
         if(drv->rotated == LV_DISP_ROT_90) {
             area->y2 = drv->ver_res - area->x1 - 1;
             area->y1 = area->y2 - area_w + 1;
@@ -1250,9 +1445,11 @@ static void draw_buf_rotate(lv_area_t * area, lv_color_t * color_p)
             /*Flush the completed area to the display*/
             call_flush_cb(drv, area, rot_buf == NULL ? color_p : rot_buf);
             /*FIXME: Rotation forces legacy behavior where rendering and flushing are done serially*/
+            LV_PROFILER_BEGIN_TAG("flush_wait");
             while(draw_buf->flushing) {
                 if(drv->wait_cb) drv->wait_cb(drv);
             }
+            LV_PROFILER_END_TAG("flush_wait");
             color_p += area_w * height;
             row += height;
         }
@@ -1270,15 +1467,22 @@ static void draw_buf_flush(lv_disp_t * disp)
 
     /*Flush the rendered content to the display*/
     lv_draw_ctx_t * draw_ctx = disp->driver->draw_ctx;
-    if(draw_ctx->wait_for_finish) draw_ctx->wait_for_finish(draw_ctx);
+    if(draw_ctx->wait_for_finish) {
+        LV_PROFILER_BEGIN_TAG("draw_wait");
+        draw_ctx->wait_for_finish(draw_ctx);
+        LV_PROFILER_END_TAG("draw_wait");
+    }
 
     /* In partial double buffered mode wait until the other buffer is freed
      * and driver is ready to receive the new buffer */
     bool full_sized = draw_buf->size == (uint32_t)disp_refr->driver->hor_res * disp_refr->driver->ver_res;
-    if(draw_buf->buf1 && draw_buf->buf2 && !full_sized) {
+    bool buf_ring = buf_ring_is_used(disp->driver);
+    if(draw_buf->buf1 && draw_buf->buf2 && !full_sized && !buf_ring) {
+        LV_PROFILER_BEGIN_TAG("flush_wait");
         while(draw_buf->flushing) {
             if(disp_refr->driver->wait_cb) disp_refr->driver->wait_cb(disp_refr->driver);
         }
+        LV_PROFILER_END_TAG("flush_wait");
     }
 
     draw_buf->flushing = 1;
@@ -1298,8 +1502,14 @@ static void draw_buf_flush(lv_disp_t * disp)
         }
     }
 
+    /*With a buffer ring continue with the next buffer. It will be waited for in `refr_area_part`*/
+    if(buf_ring) {
+        draw_buf->buf_ring_act++;
+        if(draw_buf->buf_ring_act >= draw_buf->buf_ring_cnt) draw_buf->buf_ring_act = 0;
+        draw_buf->buf_act = draw_buf->buf_ring[draw_buf->buf_ring_act];
+    }
     /*If there are 2 buffers swap them. With direct mode swap only on the last area*/
-    if(draw_buf->buf1 && draw_buf->buf2 && (!disp->driver->direct_mode || flushing_last)) {
+    else if(draw_buf->buf1 && draw_buf->buf2 && (!disp->driver->direct_mode || flushing_last)) {
         if(draw_buf->buf_act == draw_buf->buf1)
             draw_buf->buf_act = draw_buf->buf2;
         else
@@ -1319,7 +1529,41 @@ static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_
         .y2 = area->y2 + drv->offset_y
     };
 
+    /*Count it before calling `flush_cb` as `lv_disp_flush_ready()` might be called from it*/
+    lv_disp_draw_buf_t * draw_buf = drv->draw_buf;
+    draw_buf->flush_sent_cnt++;
+    if(draw_buf->buf_ring) {
+        /*`lv_disp_flush_ready()` of an older buffer might have cleared it since it was set*/
+        draw_buf->flushing = 1;
+        draw_buf->flush_last_cnt = draw_buf->flushing_last ? draw_buf->flush_sent_cnt : 0;
+    }
+    LV_PROFILER_BEGIN;
     drv->flush_cb(drv, &offset_area, color_p);
+    LV_PROFILER_END;
+}
+
+/**
+ * Tell if the draw buffer ring is used. It's used only for partial rendering.
+ * In `direct_mode` and `full_refresh` the first 2 buffers of the ring work as `buf1` and `buf2`.
+ */
+static bool buf_ring_is_used(lv_disp_drv_t * drv)
+{
+    return drv->draw_buf->buf_ring && !drv->direct_mode && !drv->full_refresh;
+}
+
+/**
+ * Wait until at most `max_in_flight` buffers are being flushed.
+ * As the driver returns the buffers in order with `max_in_flight = buf_ring_cnt - 1`
+ * the active buffer is surely not in flight anymore.
+ */
+static void buf_ring_wait(lv_disp_drv_t * drv, uint32_t max_in_flight)
+{
+    lv_disp_draw_buf_t * draw_buf = drv->draw_buf;
+    LV_PROFILER_BEGIN_TAG("flush_wait");
+    while(draw_buf->flush_sent_cnt - draw_buf->flush_ready_cnt > max_in_flight) {
+        if(drv->wait_cb) drv->wait_cb(drv);
+    }
+    LV_PROFILER_END_TAG("flush_wait");
 }
 
 #if LV_USE_PERF_MONITOR
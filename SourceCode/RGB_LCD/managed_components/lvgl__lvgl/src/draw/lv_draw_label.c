@@ -13,6 +13,7 @@
 #include "../core/lv_refr.h"
 #include "../misc/lv_bidi.h"
 #include "../misc/lv_assert.h"
+#include <string.h>
 
 /*********************
  *      DEFINES
@@ -35,6 +36,17 @@ typedef uint8_t cmd_state_t;
  **********************/
 
 static uint8_t hex_char_to_num(char hex);
+static void flush_run(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, lv_draw_label_glyph_t * run,
+                      uint32_t * run_cnt);
+static lv_coord_t layout_get_max_w(lv_coord_t max_w, lv_text_flag_t flag);
+static bool layout_reserve(lv_draw_label_layout_t * layout, uint32_t line_cnt);
+static uint32_t layout_calc_line(const char * txt, uint32_t line_start, const lv_font_t * font, lv_coord_t letter_space,
+                                 lv_coord_t max_w, lv_text_flag_t flag, lv_draw_label_line_t * line);
+static bool layout_line_starts_word(const char * txt, uint32_t line_start);
+static uint32_t get_line_end(const lv_draw_label_dsc_t * dsc, const lv_draw_label_layout_t * layout, uint32_t line_i,
+                             const char * txt, uint32_t line_start, int32_t w);
+static int32_t get_line_width(const lv_draw_label_dsc_t * dsc, const lv_draw_label_layout_t * layout, uint32_t line_i,
+                              const char * txt, uint32_t line_start, uint32_t line_end);
 
 /**********************
  *  STATIC VARIABLES
@@ -101,15 +113,27 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
     bool clip_ok = _lv_area_intersect(&clipped_area, coords, draw_ctx->clip_area);
     if(!clip_ok) return;
 
+    LV_PROFILER_BEGIN;
+
     lv_text_align_t align = dsc->align;
     lv_base_dir_t base_dir = dsc->bidi_dir;
 
     lv_bidi_calculate_align(&align, &base_dir, txt);
 
+    /*Use the line breaks calculated in advance if they are still valid*/
+    const lv_draw_label_layout_t * layout = dsc->layout;
+    if(layout && !lv_draw_label_layout_is_valid(layout, txt, font, dsc->letter_space, lv_area_get_width(coords),
+                                                dsc->flag)) {
+        layout = NULL;
+    }
+
     if((dsc->flag & LV_TEXT_FLAG_EXPAND) == 0) {
         /*Normally use the label's width as width*/
         w = lv_area_get_width(coords);
     }
+    else if(layout) {
+        w = layout->max_line_w;
+    }
     else {
         /*If EXPAND is enabled then not limit the text's width to the object's width*/
         lv_point_t p;
@@ -134,8 +158,12 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
     pos.y += y_ofs;
 
     uint32_t line_start     = 0;
+    uint32_t line_i         = 0;
     int32_t last_line_start = -1;
 
+    /*The layout makes the hint needless*/
+    if(layout) hint = NULL;
+
     /*Check the hint to use the cached info*/
     if(hint && y_ofs == 0 && coords->y1 < 0) {
         /*If the label changed too much recalculate the hint.*/
@@ -151,13 +179,14 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
         pos.y += hint->y;
     }
 
-    uint32_t line_end = line_start + _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+    uint32_t line_end = get_line_end(dsc, layout, line_i, txt, line_start, w);
 
     /*Go the first visible line*/
     while(pos.y + line_height_font < draw_ctx->clip_area->y1) {
         /*Go to next line*/
         line_start = line_end;
-        line_end += _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        line_i++;
+        line_end = get_line_end(dsc, layout, line_i, txt, line_start, w);
         pos.y += line_height;
 
         /*Save at the threshold coordinate*/
@@ -167,19 +196,22 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
             hint->coord_y    = coords->y1;
         }
 
-        if(txt[line_start] == '\0') return;
+        if(txt[line_start] == '\0') {
+            LV_PROFILER_END;
+            return;
+        }
     }
 
     /*Align to middle*/
     if(align == LV_TEXT_ALIGN_CENTER) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+        line_width = get_line_width(dsc, layout, line_i, txt, line_start, line_end);
 
         pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
     }
     /*Align to the right*/
     else if(align == LV_TEXT_ALIGN_RIGHT) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+        line_width = get_line_width(dsc, layout, line_i, txt, line_start, line_end);
         pos.x += lv_area_get_width(coords) - line_width;
     }
     uint32_t sel_start = dsc->sel_start;
@@ -225,6 +257,15 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
         const char * bidi_txt = txt + line_start;
 #endif
 
+        /*Collect the letters with the same color and draw them at once.
+         *A letter is at least 1 byte so the line's length is enough.*/
+        lv_draw_label_glyph_t * run = NULL;
+        uint32_t run_cnt = 0;
+        if(draw_ctx->draw_text_run) {
+            uint32_t glyph_cnt = layout ? layout->lines[line_i].glyph_cnt : line_end - line_start;
+            run = lv_mem_buf_get(glyph_cnt * sizeof(lv_draw_label_glyph_t));
+        }
+
         while(i < line_end - line_start) {
             uint32_t logical_char_pos = 0;
             if(sel_start != 0xFFFF && sel_end != 0xFFFF) {
@@ -288,6 +329,9 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
 
             if(sel_start != 0xFFFF && sel_end != 0xFFFF) {
                 if(logical_char_pos >= sel_start && logical_char_pos < sel_end) {
+                    /*Draw the earlier letters first to not cover them with the selection*/
+                    flush_run(draw_ctx, &dsc_mod, run, &run_cnt);
+
                     lv_area_t sel_coords;
                     sel_coords.x1 = pos.x;
                     sel_coords.y1 = pos.y;
@@ -298,14 +342,28 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
                 }
             }
 
-            dsc_mod.color = color;
-            lv_draw_letter(draw_ctx, &dsc_mod, &pos, letter);
+            if(run) {
+                if(run_cnt > 0 && dsc_mod.color.full != color.full) flush_run(draw_ctx, &dsc_mod, run, &run_cnt);
+                dsc_mod.color = color;
+                run[run_cnt].pos = pos;
+                run[run_cnt].letter = letter;
+                run_cnt++;
+            }
+            else {
+                dsc_mod.color = color;
+                lv_draw_letter(draw_ctx, &dsc_mod, &pos, letter);
+            }
 
             if(letter_w > 0) {
                 pos.x += letter_w + dsc->letter_space;
             }
         }
 
+        if(run) {
+            flush_run(draw_ctx, &dsc_mod, run, &run_cnt);
+            lv_mem_buf_release(run);
+        }
+
         if(dsc->decor & LV_TEXT_DECOR_STRIKETHROUGH) {
             lv_point_t p1;
             lv_point_t p2;
@@ -334,30 +392,31 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
 #endif
         /*Go to next line*/
         line_start = line_end;
-        line_end += _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        line_i++;
+        line_end = get_line_end(dsc, layout, line_i, txt, line_start, w);
 
         pos.x = coords->x1;
         /*Align to middle*/
         if(align == LV_TEXT_ALIGN_CENTER) {
-            line_width =
-                lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+            line_width = get_line_width(dsc, layout, line_i, txt, line_start, line_end);
 
             pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
         }
         /*Align to the right*/
         else if(align == LV_TEXT_ALIGN_RIGHT) {
-            line_width =
-                lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+            line_width = get_line_width(dsc, layout, line_i, txt, line_start, line_end);
             pos.x += lv_area_get_width(coords) - line_width;
         }
 
         /*Go the next line position*/
         pos.y += line_height;
 
-        if(pos.y > draw_ctx->clip_area->y2) return;
+        if(pos.y > draw_ctx->clip_area->y2) break;
     }
 
+    LV_PROFILER_END;
+
     LV_ASSERT_MEM_INTEGRITY();
 }
 
@@ -367,10 +426,334 @@ void lv_draw_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
     draw_ctx->draw_letter(draw_ctx, dsc, pos_p, letter);
 }
 
+void lv_draw_text_run(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                      const lv_draw_label_glyph_t * glyphs, uint32_t glyph_cnt)
+{
+    if(glyph_cnt == 0) return;
+
+    if(draw_ctx->draw_text_run) {
+        draw_ctx->draw_text_run(draw_ctx, dsc, glyphs, glyph_cnt);
+        return;
+    }
+
+    uint32_t i;
+    for(i = 0; i < glyph_cnt; i++) {
+        draw_ctx->draw_letter(draw_ctx, dsc, &glyphs[i].pos, glyphs[i].letter);
+    }
+}
+
+void lv_draw_label_layout_init(lv_draw_label_layout_t * layout)
+{
+    LV_ASSERT_NULL(layout);
+    lv_memset_00(layout, sizeof(lv_draw_label_layout_t));
+}
+
+bool lv_draw_label_layout_update(lv_draw_label_layout_t * layout, const char * txt, const lv_font_t * font,
+                                 lv_coord_t letter_space, lv_coord_t max_w, lv_text_flag_t flag)
+{
+    LV_ASSERT_NULL(layout);
+
+    if(lv_draw_label_layout_is_valid(layout, txt, font, letter_space, max_w, flag)) return true;
+
+    layout->valid = 0;
+    if(txt == NULL || font == NULL) return false;
+
+    max_w = layout_get_max_w(max_w, flag);
+
+    uint32_t line_cnt = 0;
+    uint32_t line_start = 0;
+    lv_coord_t max_line_w = 0;
+    while(1) {
+        if(!layout_reserve(layout, line_cnt + 1)) return false;
+
+        lv_draw_label_line_t * line = &layout->lines[line_cnt];
+        uint32_t line_len = layout_calc_line(txt, line_start, font, letter_space, max_w, flag, line);
+
+        /*The last line only marks the end of the text*/
+        if(line_len == 0) break;
+
+        max_line_w = LV_MAX(max_line_w, line->width);
+        line_start += line_len;
+        line_cnt++;
+    }
+
+    layout->line_cnt = line_cnt;
+    layout->max_line_w = max_line_w;
+    layout->txt = txt;
+    layout->font = font;
+    layout->letter_space = letter_space;
+    layout->max_w = max_w;
+    layout->flag = flag;
+    layout->valid = 1;
+
+    return true;
+}
+
+bool lv_draw_label_layout_edit(lv_draw_label_layout_t * layout, const char * txt, uint32_t pos, uint32_t del_len,
+                               uint32_t ins_len, uint32_t * first_line, uint32_t * last_line)
+{
+    LV_ASSERT_NULL(layout);
+
+    if(!layout->valid || txt == NULL) return false;
+
+    uint32_t line_cnt = layout->line_cnt;
+    if(pos + del_len > layout->lines[line_cnt].start) {
+        layout->valid = 0;
+        return false;
+    }
+
+    /*Find the last line starting before the edit*/
+    uint32_t min = 0;
+    uint32_t max = line_cnt;
+    while(min < max) {
+        uint32_t mid = (min + max + 1) / 2;
+        if(layout->lines[mid].start <= pos) min = mid;
+        else max = mid - 1;
+    }
+
+    /*Words of the edited line might fit into the previous one now.
+     *The break of a line depends on the first word of the next line. If that word continues in the line after it
+     *(e.g. a long word broken to more lines) the edit can change it too, so go back one more line.
+     *If a line starts in the middle of a word its start depends on the previous lines too.*/
+    uint32_t first = min > 0 ? min - 1 : 0;
+    while(first > 0 && (!layout_line_starts_word(txt, layout->lines[first].start) ||
+                        !layout_line_starts_word(txt, layout->lines[first + 1].start))) {
+        first--;
+    }
+
+    /*Wrap the lines again until a line starts at the same place in the unchanged part of the text as before.
+     *The lines from there are the same, just shifted by the size change of the text.*/
+    lv_draw_label_line_t * new_lines = NULL;
+    uint32_t new_cnt = 0;
+    uint32_t new_buf_cnt = 0;
+    uint32_t old_i = first;
+    uint32_t line_start = layout->lines[first].start;
+    bool res = true;
+    while(1) {
+        if(line_start >= pos + ins_len) {
+            uint32_t old_start = line_start - ins_len + del_len;
+            while(old_i <= line_cnt && layout->lines[old_i].start < old_start) old_i++;
+            if(old_i <= line_cnt && layout->lines[old_i].start == old_start) break;
+        }
+
+        if(new_cnt >= new_buf_cnt) {
+            new_buf_cnt = new_buf_cnt ? new_buf_cnt * 2 : 4;
+            lv_draw_label_line_t * tmp = lv_mem_realloc(new_lines, new_buf_cnt * sizeof(lv_draw_label_line_t));
+            if(tmp == NULL) {
+                res = false;
+                break;
+            }
+            new_lines = tmp;
+        }
+
+        uint32_t line_len = layout_calc_line(txt, line_start, layout->font, layout->letter_space, layout->max_w,
+                                             layout->flag, &new_lines[new_cnt]);
+
+        /*The end of the text always resynchronizes so it's reached only if the layout was outdated*/
+        if(line_len == 0) {
+            res = false;
+            break;
+        }
+
+        line_start += line_len;
+        new_cnt++;
+    }
+
+    /*The old lines `first..old_i - 1` are replaced by the new ones*/
+    uint32_t old_cnt = old_i - first;
+    if(res) res = layout_reserve(layout, line_cnt - old_cnt + new_cnt + 1);
+    if(!res) {
+        lv_mem_free(new_lines);
+        layout->valid = 0;
+        return false;
+    }
+
+    /*Skip the lines before the edit which haven't changed*/
+    lv_draw_label_line_t * lines = layout->lines;
+    uint32_t same_cnt = 0;
+    while(same_cnt < new_cnt && same_cnt + 1 < old_cnt) {
+        lv_draw_label_line_t * old_line = &lines[first + same_cnt];
+        lv_draw_label_line_t * new_line = &new_lines[same_cnt];
+        uint32_t new_end = same_cnt + 1 < new_cnt ? new_lines[same_cnt + 1].start : line_start;
+        if(new_end > pos || new_end != lines[first + same_cnt + 1].start) break;
+        if(old_line->width != new_line->width || old_line->glyph_cnt != new_line->glyph_cnt) break;
+        same_cnt++;
+    }
+
+    memmove(&lines[first + new_cnt], &lines[old_i], (line_cnt - old_i + 1) * sizeof(lv_draw_label_line_t));
+    lv_memcpy(&lines[first], new_lines, new_cnt * sizeof(lv_draw_label_line_t));
+    lv_mem_free(new_lines);
+
+    line_cnt = line_cnt - old_cnt + new_cnt;
+    uint32_t i;
+    for(i = first + new_cnt; i <= line_cnt; i++) {
+        lines[i].start = lines[i].start + ins_len - del_len;
+    }
+
+    lv_coord_t max_line_w = 0;
+    for(i = 0; i < line_cnt; i++) {
+        max_line_w = LV_MAX(max_line_w, lines[i].width);
+    }
+
+    layout->line_cnt = line_cnt;
+    layout->max_line_w = max_line_w;
+    layout->txt = txt;
+
+    if(first_line) *first_line = first + same_cnt;
+    if(last_line) *last_line = first + new_cnt;
+
+    return true;
+}
+
+bool lv_draw_label_layout_is_valid(const lv_draw_label_layout_t * layout, const char * txt, const lv_font_t * font,
+                                   lv_coord_t letter_space, lv_coord_t max_w, lv_text_flag_t flag)
+{
+    LV_ASSERT_NULL(layout);
+
+    return layout->valid &&
+           layout->txt == txt &&
+           layout->font == font &&
+           layout->letter_space == letter_space &&
+           layout->flag == flag &&
+           layout->max_w == layout_get_max_w(max_w, flag);
+}
+
+void lv_draw_label_layout_invalidate(lv_draw_label_layout_t * layout)
+{
+    LV_ASSERT_NULL(layout);
+    layout->valid = 0;
+}
+
+void lv_draw_label_layout_free(lv_draw_label_layout_t * layout)
+{
+    LV_ASSERT_NULL(layout);
+    lv_mem_free(layout->lines);
+    lv_draw_label_layout_init(layout);
+}
+
+void lv_draw_label_layout_get_size(const lv_draw_label_layout_t * layout, lv_coord_t line_space,
+                                   lv_point_t * size_res)
+{
+    LV_ASSERT_NULL(layout);
+    LV_ASSERT(layout->valid);
+
+    size_res->x = layout->max_line_w;
+    size_res->y = 0;
+
+    const char * txt = layout->txt;
+    uint16_t letter_height = lv_font_get_line_height(layout->font);
+    uint32_t i;
+    for(i = 0; i < layout->line_cnt; i++) {
+        if((unsigned long)size_res->y + (unsigned long)letter_height + (unsigned long)line_space > LV_MAX_OF(lv_coord_t)) {
+            LV_LOG_WARN("integer overflow while calculating text height");
+            return;
+        }
+        size_res->y += letter_height + line_space;
+    }
+
+    /*Make the text one line taller if the last character is '\n' or '\r'*/
+    uint32_t end = layout->lines[layout->line_cnt].start;
+    if(end != 0 && (txt[end - 1] == '\n' || txt[end - 1] == '\r')) {
+        size_res->y += letter_height + line_space;
+    }
+
+    /*Correction with the last line space or set the height manually if the text is empty*/
+    if(size_res->y == 0) size_res->y = letter_height;
+    else size_res->y -= line_space;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * The width doesn't matter if the lines are broken only at new line characters
+ */
+static lv_coord_t layout_get_max_w(lv_coord_t max_w, lv_text_flag_t flag)
+{
+    if(flag & (LV_TEXT_FLAG_EXPAND | LV_TEXT_FLAG_FIT)) return LV_COORD_MAX;
+    else return max_w;
+}
+
+static bool layout_reserve(lv_draw_label_layout_t * layout, uint32_t line_cnt)
+{
+    if(line_cnt <= layout->line_buf_cnt) return true;
+
+    uint32_t new_cnt = layout->line_buf_cnt ? layout->line_buf_cnt : 4;
+    while(new_cnt < line_cnt) new_cnt *= 2;
+
+    lv_draw_label_line_t * lines = lv_mem_realloc(layout->lines, new_cnt * sizeof(lv_draw_label_line_t));
+    if(lines == NULL) return false;
+
+    layout->lines = lines;
+    layout->line_buf_cnt = new_cnt;
+    return true;
+}
+
+/**
+ * Measure the line starting at `line_start`
+ * @return the length of the line in bytes. 0 at the end of the text.
+ */
+static uint32_t layout_calc_line(const char * txt, uint32_t line_start, const lv_font_t * font, lv_coord_t letter_space,
+                                 lv_coord_t max_w, lv_text_flag_t flag, lv_draw_label_line_t * line)
+{
+    line->start = line_start;
+    line->width = 0;
+    line->glyph_cnt = 0;
+
+    if(txt[line_start] == '\0') return 0;
+
+    uint32_t line_len = _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+    line->width = lv_txt_get_width(&txt[line_start], line_len, font, letter_space, flag);
+    line->glyph_cnt = _lv_txt_encoded_get_char_id(&txt[line_start], line_len);
+    return line_len;
+}
+
+/**
+ * Check if a line starts with a new word, i.e. the line before it ended with a break character
+ */
+static bool layout_line_starts_word(const char * txt, uint32_t line_start)
+{
+    if(line_start == 0) return true;
+
+    char c = txt[line_start - 1];
+    return c == '\n' || c == '\r' || _lv_txt_is_break_char((uint8_t)c);
+}
+
+static uint32_t get_line_end(const lv_draw_label_dsc_t * dsc, const lv_draw_label_layout_t * layout, uint32_t line_i,
+                             const char * txt, uint32_t line_start, int32_t w)
+{
+    if(layout) {
+        if(line_i >= layout->line_cnt) return line_start;
+        return layout->lines[line_i + 1].start;
+    }
+
+    return line_start + _lv_txt_get_next_line(&txt[line_start], dsc->font, dsc->letter_space, w, NULL, dsc->flag);
+}
+
+static int32_t get_line_width(const lv_draw_label_dsc_t * dsc, const lv_draw_label_layout_t * layout, uint32_t line_i,
+                              const char * txt, uint32_t line_start, uint32_t line_end)
+{
+    if(layout) {
+        if(line_i >= layout->line_cnt) return 0;
+        return layout->lines[line_i].width;
+    }
+
+    return lv_txt_get_width(&txt[line_start], line_end - line_start, dsc->font, dsc->letter_space, dsc->flag);
+}
+
+/**
+ * Draw the collected letters (if any) and empty the run
+ */
+static void flush_run(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, lv_draw_label_glyph_t * run,
+                      uint32_t * run_cnt)
+{
+    if(run == NULL || *run_cnt == 0) return;
+
+    lv_draw_text_run(draw_ctx, dsc, run, *run_cnt);
+    *run_cnt = 0;
+}
+
 /**
  * Convert a hexadecimal characters to a number (0..15)
  * @param hex Pointer to a hexadecimal character (0..9, A..F)
@@ -27,6 +27,8 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+struct _lv_draw_label_layout_t;
+
 typedef struct {
     const lv_font_t * font;
     uint32_t sel_start;
@@ -44,6 +46,10 @@ typedef struct {
     lv_text_flag_t flag;
     lv_text_decor_t decor : 3;
     lv_blend_mode_t blend_mode: 3;
+
+    /** The line breaks of the text calculated in advance. Used only if it was
+     * calculated with the same text, font, letter space, width and flags. Can be NULL.*/
+    const struct _lv_draw_label_layout_t * layout;
 } lv_draw_label_dsc_t;
 
 /** Store some info to speed up drawing of very large texts
@@ -63,6 +69,35 @@ typedef struct _lv_draw_label_hint_t {
     int32_t coord_y;
 } lv_draw_label_hint_t;
 
+/** A line of a text*/
+typedef struct {
+    uint32_t start;         /**< Byte index of the first character of the line*/
+    lv_coord_t width;       /**< Width of the line*/
+    uint32_t glyph_cnt;     /**< Number of letters in the line*/
+} lv_draw_label_line_t;
+
+/** Store the line breaks of a text to not search them again in every draw and size calculation*/
+typedef struct _lv_draw_label_layout_t {
+    lv_draw_label_line_t * lines;   /**< `line_cnt + 1` lines. The start of the last one is the end of the text*/
+    uint32_t line_cnt;
+    uint32_t line_buf_cnt;          /**< Number of lines allocated in `lines`*/
+    lv_coord_t max_line_w;          /**< Width of the longest line*/
+
+    /*The parameters used to calculate the layout*/
+    const char * txt;
+    const lv_font_t * font;
+    lv_coord_t letter_space;
+    lv_coord_t max_w;
+    lv_text_flag_t flag;
+    uint8_t valid : 1;
+} lv_draw_label_layout_t;
+
+/** A letter of a text run and its position*/
+typedef struct {
+    lv_point_t pos;     /**< Position of the letter, the same as `pos_p` of `lv_draw_letter()`*/
+    uint32_t letter;    /**< The Unicode letter*/
+} lv_draw_label_glyph_t;
+
 struct _lv_draw_ctx_t;
 /**********************
  * GLOBAL PROTOTYPES
@@ -82,9 +117,89 @@ void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_label_dsc_init(lv_draw_label_dsc_t * ds
 void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_label(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
                                                const lv_area_t * coords, const char * txt, lv_draw_label_hint_t * hint);
 
+/**
+ * Initialize a layout. It's invalid until `lv_draw_label_layout_update()` is called.
+ * @param layout        pointer to a layout
+ */
+void lv_draw_label_layout_init(lv_draw_label_layout_t * layout);
+
+/**
+ * Calculate the line breaks of a text if the layout is not valid or it was calculated with other parameters.
+ * @param layout        pointer to a layout
+ * @param txt           `\0` terminated text
+ * @param font          the font of the text
+ * @param letter_space  the letter space
+ * @param max_w         max width of the lines
+ * @param flag          settings for the text from `lv_text_flag_t`
+ * @return              true: the layout is valid; false: out of memory
+ */
+bool lv_draw_label_layout_update(lv_draw_label_layout_t * layout, const char * txt, const lv_font_t * font,
+                                 lv_coord_t letter_space, lv_coord_t max_w, lv_text_flag_t flag);
+
+/**
+ * Update a valid layout after a part of its text was replaced.
+ * Only the lines around the edit are calculated again, until the line breaks are the same as before.
+ * @param layout        pointer to a valid layout
+ * @param txt           the edited text. Can be at a different address than before.
+ * @param pos           byte index of the edit
+ * @param del_len       number of bytes deleted from `pos`
+ * @param ins_len       number of bytes inserted to `pos`
+ * @param first_line    store the index of the first changed line here (can be NULL)
+ * @param last_line     store the index after the last changed line here (can be NULL).
+ *                      If the number of lines has changed, the lines after it are moved.
+ * @return              true: the layout is updated; false: the layout became invalid and needs a full update
+ */
+bool lv_draw_label_layout_edit(lv_draw_label_layout_t * layout, const char * txt, uint32_t pos, uint32_t del_len,
+                               uint32_t ins_len, uint32_t * first_line, uint32_t * last_line);
+
+/**
+ * Check if a layout was calculated with the given parameters.
+ * @param layout        pointer to a layout
+ * @param txt           `\0` terminated text
+ * @param font          the font of the text
+ * @param letter_space  the letter space
+ * @param max_w         max width of the lines
+ * @param flag          settings for the text from `lv_text_flag_t`
+ * @return              true: the layout can be used for these parameters
+ */
+bool lv_draw_label_layout_is_valid(const lv_draw_label_layout_t * layout, const char * txt, const lv_font_t * font,
+                                   lv_coord_t letter_space, lv_coord_t max_w, lv_text_flag_t flag);
+
+/**
+ * Mark a layout as invalid, e.g. because its text has changed. It will be recalculated on the next update.
+ * @param layout        pointer to a layout
+ */
+void lv_draw_label_layout_invalidate(lv_draw_label_layout_t * layout);
+
+/**
+ * Free the memory used by a layout.
+ * @param layout        pointer to a layout
+ */
+void lv_draw_label_layout_free(lv_draw_label_layout_t * layout);
+
+/**
+ * Get the size of a laid out text. The same as `lv_txt_get_size()`.
+ * @param layout        pointer to a valid layout
+ * @param line_space    the line space
+ * @param size_res      store the result here
+ */
+void lv_draw_label_layout_get_size(const lv_draw_label_layout_t * layout, lv_coord_t line_space,
+                                   lv_point_t * size_res);
+
 void lv_draw_letter(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,  const lv_point_t * pos_p,
                     uint32_t letter);
 
+/**
+ * Draw letters with the same style. Uses `draw_text_run` of the draw context if available,
+ * else draws the letters one by one.
+ * @param draw_ctx      pointer to a draw context
+ * @param dsc           the style of the letters
+ * @param glyphs        the letters and their positions
+ * @param glyph_cnt     number of elements in `glyphs`
+ */
+void lv_draw_text_run(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                      const lv_draw_label_glyph_t * glyphs, uint32_t glyph_cnt);
+
 /***********************
  * GLOBAL VARIABLES
  ***********************/
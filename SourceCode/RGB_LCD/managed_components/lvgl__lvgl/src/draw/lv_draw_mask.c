@@ -59,10 +59,21 @@ static void circ_calc_aa4(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_t radi
 static lv_opa_t * get_next_line(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_t y, lv_coord_t * len,
                                 lv_coord_t * x_start);
 static inline lv_opa_t /* LV_ATTRIBUTE_FAST_MEM */ mask_mix(lv_opa_t mask_act, lv_opa_t mask_new);
+static inline void span_mark(lv_coord_t x, lv_coord_t len, lv_draw_mask_res_t res);
+static inline void span_move(lv_coord_t ofs, lv_coord_t len);
+#if LV_USE_DRAW_MASK_SPANS
+static void spans_lower(lv_draw_mask_span_list_t * list, int32_t x1, int32_t x2, lv_draw_mask_res_t res);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_USE_DRAW_MASK_SPANS
+static lv_draw_mask_span_list_t * span_list;    /*Collect the runs here while a mask is applied. NULL: don't collect*/
+static lv_coord_t span_ofs;                     /*Start of the part of the line the mask works on (angle masks)*/
+static lv_coord_t span_len;                     /*Length of the part of the line the mask works on*/
+static bool span_marked;                        /*The applied mask has reported a run*/
+#endif
 
 /**********************
  *      MACROS
@@ -163,6 +174,65 @@ lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_apply_ids(lv_opa_t * mask_
     return changed ? LV_DRAW_MASK_RES_CHANGED : LV_DRAW_MASK_RES_FULL_COVER;
 }
 
+#if LV_USE_DRAW_MASK_SPANS
+/**
+ * Apply the added masks on a line like `lv_draw_mask_apply()` and describe the coverage of the line with runs too.
+ * The line, angle and radius masks report which parts they have cleared and which parts they haven't touched,
+ * the other masks are considered to change the whole line.
+ * @param mask_buf store the result mask here. Has to be `len` byte long.
+ *                 Needs to be initialized with the same value on every pixel (e.g. `0xFF`).
+ * @param abs_x absolute X coordinate where the line to calculate start
+ * @param abs_y absolute Y coordinate where the line to calculate start
+ * @param len length of the line to calculate (in pixel count)
+ * @param spans store the runs here. Valid if the result is `LV_DRAW_MASK_RES_CHANGED`.
+ * @return same as `lv_draw_mask_apply()`
+ */
+lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_apply_spans(lv_opa_t * mask_buf, lv_coord_t abs_x,
+                                                                  lv_coord_t abs_y, lv_coord_t len,
+                                                                  lv_draw_mask_span_list_t * spans)
+{
+    bool changed = false;
+    _lv_draw_mask_common_dsc_t * dsc;
+
+    spans->cnt = 1;
+    spans->spans[0].x = 0;
+    spans->spans[0].len = len;
+    spans->spans[0].res = LV_DRAW_MASK_RES_FULL_COVER;
+
+    _lv_draw_mask_saved_t * m = LV_GC_ROOT(_lv_draw_mask_list);
+
+    while(m->param) {
+        dsc = m->param;
+
+        /*Only the built-in masks which report every changed pixel can narrow the runs*/
+        bool report = dsc->cb == (lv_draw_mask_xcb_t)lv_draw_mask_line ||
+                      dsc->cb == (lv_draw_mask_xcb_t)lv_draw_mask_angle ||
+                      dsc->cb == (lv_draw_mask_xcb_t)lv_draw_mask_radius;
+        span_list = report ? spans : NULL;
+        span_ofs = 0;
+        span_len = len;
+        span_marked = false;
+
+        lv_draw_mask_res_t res = dsc->cb(mask_buf, abs_x, abs_y, len, (void *)m->param);
+        span_list = NULL;
+
+        if(res == LV_DRAW_MASK_RES_TRANSP) {
+            spans->cnt = 1;
+            spans->spans[0].res = LV_DRAW_MASK_RES_TRANSP;
+            return LV_DRAW_MASK_RES_TRANSP;
+        }
+        else if(res == LV_DRAW_MASK_RES_CHANGED) {
+            changed = true;
+            if(!report || !span_marked) spans_lower(spans, 0, len - 1, LV_DRAW_MASK_RES_CHANGED);
+        }
+
+        m++;
+    }
+
+    return changed ? LV_DRAW_MASK_RES_CHANGED : LV_DRAW_MASK_RES_FULL_COVER;
+}
+#endif
+
 /**
  * Remove a mask with a given ID
  * @param id the ID of the mask.  Returned by `lv_draw_mask_add`
@@ -626,7 +696,10 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_line(lv_opa_t * mas
                 else {
                     int32_t k = - abs_x;
                     if(k < 0) return LV_DRAW_MASK_RES_TRANSP;
-                    if(k >= 0 && k < len) lv_memset_00(&mask_buf[k], len - k);
+                    if(k >= 0 && k < len) {
+                        lv_memset_00(&mask_buf[k], len - k);
+                        span_mark(k, len - k, LV_DRAW_MASK_RES_TRANSP);
+                    }
                     return  LV_DRAW_MASK_RES_CHANGED;
                 }
             }
@@ -636,7 +709,10 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_line(lv_opa_t * mas
                     int32_t k = - abs_x;
                     if(k < 0) k = 0;
                     if(k >= len) return LV_DRAW_MASK_RES_TRANSP;
-                    else if(k >= 0 && k < len) lv_memset_00(&mask_buf[0], k);
+                    else if(k >= 0 && k < len) {
+                        lv_memset_00(&mask_buf[0], k);
+                        span_mark(0, k, LV_DRAW_MASK_RES_TRANSP);
+                    }
                     return  LV_DRAW_MASK_RES_CHANGED;
                 }
             }
@@ -718,6 +794,7 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM line_mask_flat(lv_opa_t * mask_b
     if(xef == 0) px_h = 255;
     else px_h = 255 - (((255 - xef) * p->spx) >> 8);
     int32_t k = xei - abs_x;
+    int32_t k_aa = k;
     lv_opa_t m;
 
     if(xef) {
@@ -747,6 +824,7 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM line_mask_flat(lv_opa_t * mask_b
         if(p->inv) m = 255 - m;
         mask_buf[k] = mask_mix(mask_buf[k], m);
     }
+    span_mark(k_aa, k - k_aa + 1, LV_DRAW_MASK_RES_CHANGED);
 
     if(p->inv) {
         k = xei - abs_x;
@@ -755,6 +833,7 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM line_mask_flat(lv_opa_t * mask_b
         }
         if(k >= 0) {
             lv_memset_00(&mask_buf[0], k);
+            span_mark(0, k, LV_DRAW_MASK_RES_TRANSP);
         }
     }
     else {
@@ -764,6 +843,7 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM line_mask_flat(lv_opa_t * mask_b
         }
         if(k <= len) {
             lv_memset_00(&mask_buf[k], len - k);
+            span_mark(k, len - k, LV_DRAW_MASK_RES_TRANSP);
         }
     }
 
@@ -826,6 +906,7 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM line_mask_steep(lv_opa_t * mask_
             if(p->inv) m = 255 - m;
             mask_buf[k] = mask_mix(mask_buf[k], m);
         }
+        span_mark(k, 1, LV_DRAW_MASK_RES_CHANGED);
         k++;
 
         if(p->inv) {
@@ -833,13 +914,19 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM line_mask_steep(lv_opa_t * mask_
             if(k >= len) {
                 return LV_DRAW_MASK_RES_TRANSP;
             }
-            if(k >= 0) lv_memset_00(&mask_buf[0], k);
+            if(k >= 0) {
+                lv_memset_00(&mask_buf[0], k);
+                span_mark(0, k, LV_DRAW_MASK_RES_TRANSP);
+            }
 
         }
         else {
             if(k > len) k = len;
             if(k == 0) return LV_DRAW_MASK_RES_TRANSP;
-            else if(k > 0) lv_memset_00(&mask_buf[k],  len - k);
+            else if(k > 0) {
+                lv_memset_00(&mask_buf[k],  len - k);
+                span_mark(k, len - k, LV_DRAW_MASK_RES_TRANSP);
+            }
         }
 
     }
@@ -861,6 +948,7 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM line_mask_steep(lv_opa_t * mask_
                 if(p->inv) m = 255 - m;
                 mask_buf[k] = mask_mix(mask_buf[k], m);
             }
+            span_mark(k, 2, LV_DRAW_MASK_RES_CHANGED);
 
             k += 2;
 
@@ -868,12 +956,18 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM line_mask_steep(lv_opa_t * mask_
                 k = xsi - abs_x - 1;
 
                 if(k > len) k = len;
-                else if(k > 0) lv_memset_00(&mask_buf[0],  k);
+                else if(k > 0) {
+                    lv_memset_00(&mask_buf[0],  k);
+                    span_mark(0, k, LV_DRAW_MASK_RES_TRANSP);
+                }
 
             }
             else {
                 if(k > len) return LV_DRAW_MASK_RES_FULL_COVER;
-                if(k >= 0) lv_memset_00(&mask_buf[k],  len - k);
+                if(k >= 0) {
+                    lv_memset_00(&mask_buf[k],  len - k);
+                    span_mark(k, len - k, LV_DRAW_MASK_RES_TRANSP);
+                }
             }
 
         }
@@ -893,18 +987,25 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM line_mask_steep(lv_opa_t * mask_
                 if(p->inv) m = 255 - m;
                 mask_buf[k] = mask_mix(mask_buf[k], m);
             }
+            span_mark(k - 1, 2, LV_DRAW_MASK_RES_CHANGED);
             k++;
 
             if(p->inv) {
                 k = xsi - abs_x;
                 if(k > len)  return LV_DRAW_MASK_RES_TRANSP;
-                if(k >= 0) lv_memset_00(&mask_buf[0],  k);
+                if(k >= 0) {
+                    lv_memset_00(&mask_buf[0],  k);
+                    span_mark(0, k, LV_DRAW_MASK_RES_TRANSP);
+                }
 
             }
             else {
                 if(k > len) k = len;
                 if(k == 0) return LV_DRAW_MASK_RES_TRANSP;
-                else if(k > 0) lv_memset_00(&mask_buf[k],  len - k);
+                else if(k > 0) {
+                    lv_memset_00(&mask_buf[k],  len - k);
+                    span_mark(k, len - k, LV_DRAW_MASK_RES_TRANSP);
+                }
             }
         }
     }
@@ -948,17 +1049,23 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_angle(lv_opa_t * ma
         int32_t tmp = start_angle_last + dist - rel_x;
         if(tmp > len) tmp = len;
         if(tmp > 0) {
+            span_move(0, tmp);
             res1 = lv_draw_mask_line(&mask_buf[0], abs_x, abs_y, tmp, &p->start_line);
+            span_move(0, len);
             if(res1 == LV_DRAW_MASK_RES_TRANSP) {
                 lv_memset_00(&mask_buf[0], tmp);
+                span_mark(0, tmp, LV_DRAW_MASK_RES_TRANSP);
             }
         }
 
         if(tmp > len) tmp = len;
         if(tmp < 0) tmp = 0;
+        span_move(tmp, len - tmp);
         res2 = lv_draw_mask_line(&mask_buf[tmp], abs_x + tmp, abs_y, len - tmp, &p->end_line);
+        span_move(-tmp, len);
         if(res2 == LV_DRAW_MASK_RES_TRANSP) {
             lv_memset_00(&mask_buf[tmp], len - tmp);
+            span_mark(tmp, len - tmp, LV_DRAW_MASK_RES_TRANSP);
         }
         if(res1 == res2) return res1;
         else return LV_DRAW_MASK_RES_CHANGED;
@@ -990,17 +1097,23 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_angle(lv_opa_t * ma
         int32_t tmp = start_angle_last + dist - rel_x;
         if(tmp > len) tmp = len;
         if(tmp > 0) {
+            span_move(0, tmp);
             res1 = lv_draw_mask_line(&mask_buf[0], abs_x, abs_y, tmp, (lv_draw_mask_line_param_t *)&p->end_line);
+            span_move(0, len);
             if(res1 == LV_DRAW_MASK_RES_TRANSP) {
                 lv_memset_00(&mask_buf[0], tmp);
+                span_mark(0, tmp, LV_DRAW_MASK_RES_TRANSP);
             }
         }
 
         if(tmp > len) tmp = len;
         if(tmp < 0) tmp = 0;
+        span_move(tmp, len - tmp);
         res2 = lv_draw_mask_line(&mask_buf[tmp], abs_x + tmp, abs_y, len - tmp, (lv_draw_mask_line_param_t *)&p->start_line);
+        span_move(-tmp, len);
         if(res2 == LV_DRAW_MASK_RES_TRANSP) {
             lv_memset_00(&mask_buf[tmp], len - tmp);
+            span_mark(tmp, len - tmp, LV_DRAW_MASK_RES_TRANSP);
         }
         if(res1 == res2) return res1;
         else return LV_DRAW_MASK_RES_CHANGED;
@@ -1077,12 +1190,14 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_radius(lv_opa_t * m
             if(last > len) return LV_DRAW_MASK_RES_TRANSP;
             if(last >= 0) {
                 lv_memset_00(&mask_buf[0], last);
+                span_mark(0, last, LV_DRAW_MASK_RES_TRANSP);
             }
 
             int32_t first = rect.x2 - abs_x + 1;
             if(first <= 0) return LV_DRAW_MASK_RES_TRANSP;
             else if(first < len) {
                 lv_memset_00(&mask_buf[first], len - first);
+                span_mark(first, len - first, LV_DRAW_MASK_RES_TRANSP);
             }
             if(last == 0 && first == len) return LV_DRAW_MASK_RES_FULL_COVER;
             else return LV_DRAW_MASK_RES_CHANGED;
@@ -1095,6 +1210,7 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_radius(lv_opa_t * m
                 if(first + last > len) last = len - first;
                 if(last >= 0) {
                     lv_memset_00(&mask_buf[first], last);
+                    span_mark(first, last, LV_DRAW_MASK_RES_TRANSP);
                 }
             }
         }
@@ -1127,6 +1243,10 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_radius(lv_opa_t * m
     lv_coord_t cir_x_left = k + radius - x_start - 1;
     lv_coord_t i;
 
+    /*Only the pixels on the circle are anti-aliased*/
+    span_mark(cir_x_left - aa_len + 1, aa_len, LV_DRAW_MASK_RES_CHANGED);
+    span_mark(cir_x_right, aa_len, LV_DRAW_MASK_RES_CHANGED);
+
     if(outer == false) {
         for(i = 0; i < aa_len; i++) {
             lv_opa_t opa = aa_opa[aa_len - i - 1];
@@ -1141,10 +1261,12 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_radius(lv_opa_t * m
         /*Clean the right side*/
         cir_x_right = LV_CLAMP(0, cir_x_right + i, len);
         lv_memset_00(&mask_buf[cir_x_right], len - cir_x_right);
+        span_mark(cir_x_right, len - cir_x_right, LV_DRAW_MASK_RES_TRANSP);
 
         /*Clean the left side*/
         cir_x_left = LV_CLAMP(0, cir_x_left - aa_len + 1, len);
         lv_memset_00(&mask_buf[0], cir_x_left);
+        span_mark(0, cir_x_left, LV_DRAW_MASK_RES_TRANSP);
     }
     else {
         for(i = 0; i < aa_len; i++) {
@@ -1160,6 +1282,7 @@ static lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_radius(lv_opa_t * m
         lv_coord_t clr_start = LV_CLAMP(0, cir_x_left + 1, len);
         lv_coord_t clr_len = LV_CLAMP(0, cir_x_right - clr_start, len - clr_start);
         lv_memset_00(&mask_buf[clr_start], clr_len);
+        span_mark(clr_start, clr_len, LV_DRAW_MASK_RES_TRANSP);
     }
 
     return LV_DRAW_MASK_RES_CHANGED;
@@ -1523,4 +1646,121 @@ static inline lv_opa_t LV_ATTRIBUTE_FAST_MEM mask_mix(lv_opa_t mask_act, lv_opa_
     return LV_UDIV255(mask_act * mask_new);// >> 8);
 }
 
+/**
+ * Report a run of the line from a mask while `lv_draw_mask_apply_spans()` is running.
+ * Every pixel the mask changes needs to be reported.
+ * @param x     start of the run relative to the part of the line the mask works on
+ * @param len   length of the run
+ * @param res   `LV_DRAW_MASK_RES_TRANSP` if the pixels were cleared, else `LV_DRAW_MASK_RES_CHANGED`
+ */
+static inline void span_mark(lv_coord_t x, lv_coord_t len, lv_draw_mask_res_t res)
+{
+#if LV_USE_DRAW_MASK_SPANS
+    if(span_list == NULL) return;
+
+    int32_t x1 = LV_MAX(x, 0);
+    int32_t x2 = LV_MIN(x + len, span_len) - 1;
+    span_marked = true;
+    if(x1 > x2) return;
+
+    spans_lower(span_list, span_ofs + x1, span_ofs + x2, res);
+#else
+    LV_UNUSED(x);
+    LV_UNUSED(len);
+    LV_UNUSED(res);
+#endif
+}
+
+/**
+ * Move the start of the reported runs when a mask works only on a part of the line
+ * @param ofs   move the start with this many pixels (can be negative to move back)
+ * @param len   length of the new part
+ */
+static inline void span_move(lv_coord_t ofs, lv_coord_t len)
+{
+#if LV_USE_DRAW_MASK_SPANS
+    span_ofs += ofs;
+    span_len = len;
+#else
+    LV_UNUSED(ofs);
+    LV_UNUSED(len);
+#endif
+}
+
+#if LV_USE_DRAW_MASK_SPANS
+/*Rank the results by coverage. A run can only go lower as the masks are applied*/
+static inline uint8_t span_rank(lv_draw_mask_res_t res)
+{
+    if(res == LV_DRAW_MASK_RES_TRANSP) return 0;
+    else if(res == LV_DRAW_MASK_RES_CHANGED) return 1;
+    else return 2;
+}
+
+/**
+ * Set `res` on the `x1..x2` range of the runs where they have higher coverage.
+ * @param list  the runs
+ * @param x1    start of the range (inclusive)
+ * @param x2    end of the range (inclusive)
+ * @param res   `LV_DRAW_MASK_RES_TRANSP` or `LV_DRAW_MASK_RES_CHANGED`
+ */
+static void spans_lower(lv_draw_mask_span_list_t * list, int32_t x1, int32_t x2, lv_draw_mask_res_t res)
+{
+    lv_draw_mask_span_t * spans = list->spans;
+    uint32_t i;
+    for(i = 0; i < list->cnt; i++) {
+        int32_t s_x1 = spans[i].x;
+        int32_t s_x2 = s_x1 + spans[i].len - 1;
+        if(s_x2 < x1) continue;
+        if(s_x1 > x2) break;
+
+        lv_draw_mask_res_t s_res = spans[i].res;
+        if(span_rank(s_res) <= span_rank(res)) continue;
+
+        /*Split the run to the parts before, in and after the range*/
+        int32_t in_x1 = LV_MAX(s_x1, x1);
+        int32_t in_x2 = LV_MIN(s_x2, x2);
+        uint32_t part_cnt = 1 + (in_x1 > s_x1 ? 1 : 0) + (in_x2 < s_x2 ? 1 : 0);
+        if(list->cnt + part_cnt - 1 > _LV_DRAW_MASK_SPAN_MAX) {
+            /*Too many runs: everything is changed, only the cleared pixels are not important*/
+            int32_t len = spans[list->cnt - 1].x + spans[list->cnt - 1].len;
+            list->cnt = 1;
+            spans[0].x = 0;
+            spans[0].len = len;
+            spans[0].res = LV_DRAW_MASK_RES_CHANGED;
+            return;
+        }
+
+        uint32_t j;
+        for(j = list->cnt - 1; j > i; j--) spans[j + part_cnt - 1] = spans[j];
+        list->cnt += part_cnt - 1;
+
+        if(in_x1 > s_x1) {
+            spans[i].x = s_x1;
+            spans[i].len = in_x1 - s_x1;
+            spans[i].res = s_res;
+            i++;
+        }
+
+        spans[i].x = in_x1;
+        spans[i].len = in_x2 - in_x1 + 1;
+        spans[i].res = res;
+
+        if(in_x2 < s_x2) {
+            i++;
+            spans[i].x = in_x2 + 1;
+            spans[i].len = s_x2 - in_x2;
+            spans[i].res = s_res;
+        }
+    }
+
+    /*Merge the neighbors with the same result*/
+    uint32_t cnt = 1;
+    for(i = 1; i < list->cnt; i++) {
+        if(spans[i].res == spans[cnt - 1].res) spans[cnt - 1].len += spans[i].len;
+        else spans[cnt++] = spans[i];
+    }
+    list->cnt = cnt;
+}
+#endif
+
 #endif /*LV_DRAW_COMPLEX*/
@@ -10,38 +10,47 @@
 #include "lv_img_cache.h"
 #include "lv_img_decoder.h"
 #include "lv_draw_img.h"
+#include "lv_img_decode_async.h"
 #include "../hal/lv_hal_tick.h"
 #include "../misc/lv_gc.h"
 
 /*********************
  *      DEFINES
  *********************/
-/*Decrement life with this value on every open*/
-#define LV_IMG_CACHE_AGING 1
+#define _cache LV_GC_ROOT(_lv_img_cache)
 
-/*Boost life by this factor (multiply time_to_open with this value)*/
-#define LV_IMG_CACHE_LIFE_GAIN 1
-
-/*Don't let life to be greater than this limit because it would require a lot of time to
- * "die" from very high values*/
-#define LV_IMG_CACHE_LIFE_LIMIT 1000
+#define HASH_BUCKET_CNT     32
 
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct {
+    const void * src;
+    lv_color_t color;
+    int32_t frame_id;
+} cache_key_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 #if LV_IMG_CACHE_DEF_SIZE
     static bool lv_img_cache_match(const void * src1, const void * src2);
+    static bool entry_match(const _lv_hash_lru_entry_t * entry, const void * key);
+    static bool entry_match_src(const _lv_hash_lru_entry_t * entry, const void * src);
+    static uint32_t get_src_hash(const void * src);
+    static uint32_t get_entry_size(const _lv_img_cache_entry_t * entry);
+    static _lv_img_cache_entry_t * entry_create(void);
+    static void entry_insert(_lv_img_cache_entry_t * entry, uint32_t hash);
+    static void entry_free(_lv_hash_lru_entry_t * entry);
 #endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 #if LV_IMG_CACHE_DEF_SIZE
-    static uint16_t entry_cnt;
+    static _lv_hash_lru_entry_t * buckets[HASH_BUCKET_CNT];
+    static uint32_t entry_cnt_max;
+    static uint32_t cache_max_bytes = LV_IMG_CACHE_DEF_BYTES;
 #endif
 
 /**********************
@@ -55,66 +64,35 @@
 /**
  * Open an image using the image decoder interface and cache it.
  * The image will be left open meaning if the image decoder open callback allocated memory then it will remain.
- * The image is closed if a new image is opened and the new image takes its place in the cache.
+ * The least recently used images are closed if the number of images or their total size exceeds the limits.
  * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
  * @param color color The color of the image with `LV_IMG_CF_ALPHA_...`
  * @return pointer to the cache entry or NULL if can open the image
  */
 _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, int32_t frame_id)
 {
-    /*Is the image cached?*/
     _lv_img_cache_entry_t * cached_src = NULL;
 
 #if LV_IMG_CACHE_DEF_SIZE
-    if(entry_cnt == 0) {
+    if(entry_cnt_max == 0) {
         LV_LOG_WARN("lv_img_cache_open: the cache size is 0");
         return NULL;
     }
 
-    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
-
-    /*Decrement all lifes. Make the entries older*/
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(cache[i].life > INT32_MIN + LV_IMG_CACHE_AGING) {
-            cache[i].life -= LV_IMG_CACHE_AGING;
-        }
-    }
-
-    for(i = 0; i < entry_cnt; i++) {
-        if(color.full == cache[i].dec_dsc.color.full &&
-           frame_id == cache[i].dec_dsc.frame_id &&
-           lv_img_cache_match(src, cache[i].dec_dsc.src)) {
-            /*If opened increment its life.
-             *Image difficult to open should live longer to keep avoid frequent their recaching.
-             *Therefore increase `life` with `time_to_open`*/
-            cached_src = &cache[i];
-            cached_src->life += cached_src->dec_dsc.time_to_open * LV_IMG_CACHE_LIFE_GAIN;
-            if(cached_src->life > LV_IMG_CACHE_LIFE_LIMIT) cached_src->life = LV_IMG_CACHE_LIFE_LIMIT;
-            LV_LOG_TRACE("image source found in the cache");
-            break;
-        }
+    /*Is the image cached?*/
+    cache_key_t key = {src, color, frame_id};
+    uint32_t hash = get_src_hash(src);
+    cached_src = (_lv_img_cache_entry_t *)_lv_hash_lru_get(&_cache, hash, entry_match, &key);
+    if(cached_src) {
+        LV_LOG_TRACE("image source found in the cache");
+        return cached_src;
     }
 
     /*The image is not cached then cache it now*/
-    if(cached_src) return cached_src;
-
-    /*Find an entry to reuse. Select the entry with the least life*/
-    cached_src = &cache[0];
-    for(i = 1; i < entry_cnt; i++) {
-        if(cache[i].life < cached_src->life) {
-            cached_src = &cache[i];
-        }
-    }
+    LV_LOG_INFO("image draw: cache miss");
 
-    /*Close the decoder to reuse if it was opened (has a valid source)*/
-    if(cached_src->dec_dsc.src) {
-        lv_img_decoder_close(&cached_src->dec_dsc);
-        LV_LOG_INFO("image draw: cache miss, close and reuse an entry");
-    }
-    else {
-        LV_LOG_INFO("image draw: cache miss, cached to an empty entry");
-    }
+    cached_src = entry_create();
+    if(cached_src == NULL) return NULL;
 #else
     cached_src = &LV_GC_ROOT(_lv_img_cache_single);
 #endif
@@ -123,13 +101,14 @@ _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, i
     lv_res_t open_res = lv_img_decoder_open(&cached_src->dec_dsc, src, color, frame_id);
     if(open_res == LV_RES_INV) {
         LV_LOG_WARN("Image draw cannot open the image resource");
+#if LV_IMG_CACHE_DEF_SIZE
+        lv_mem_free(cached_src);
+#else
         lv_memset_00(cached_src, sizeof(_lv_img_cache_entry_t));
-        cached_src->life = INT32_MIN; /*Make the empty entry very "weak" to force its us*/
+#endif
         return NULL;
     }
 
-    cached_src->life = 0;
-
     /*If `time_to_open` was not set in the open function set it here*/
     if(cached_src->dec_dsc.time_to_open == 0) {
         cached_src->dec_dsc.time_to_open = lv_tick_elaps(t_start);
@@ -137,13 +116,68 @@ _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, i
 
     if(cached_src->dec_dsc.time_to_open == 0) cached_src->dec_dsc.time_to_open = 1;
 
+#if LV_IMG_CACHE_DEF_SIZE
+    entry_insert(cached_src, hash);
+#endif
+
+    return cached_src;
+}
+
+/**
+ * Find an image in the cache without opening it if it's not cached.
+ * @param src       source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
+ * @param color     the color of the image with `LV_IMG_CF_ALPHA_...`
+ * @param frame_id  the index of the frame. Used only with animated images, set 0 for normal images
+ * @return          pointer to the cache entry or NULL if the image is not cached
+ */
+_lv_img_cache_entry_t * _lv_img_cache_find(const void * src, lv_color_t color, int32_t frame_id)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    cache_key_t key = {src, color, frame_id};
+    return (_lv_img_cache_entry_t *)_lv_hash_lru_find(&_cache, get_src_hash(src), entry_match, &key);
+#else
+    LV_UNUSED(src);
+    LV_UNUSED(color);
+    LV_UNUSED(frame_id);
+    return NULL;
+#endif
+}
+
+/**
+ * Add an image opened with `lv_img_decoder_open()` to the cache, e.g. if it was opened in the background.
+ * The cache takes over the opened image and closes it when it's dropped from the cache.
+ * @param dsc       an opened image. If the same image is already cached `dsc` is closed.
+ * @return          pointer to the cache entry or NULL if the image couldn't be cached (`dsc` is closed then)
+ */
+_lv_img_cache_entry_t * _lv_img_cache_add(lv_img_decoder_dsc_t * dsc)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    cache_key_t key = {dsc->src, dsc->color, dsc->frame_id};
+    uint32_t hash = get_src_hash(dsc->src);
+    _lv_img_cache_entry_t * cached_src = (_lv_img_cache_entry_t *)_lv_hash_lru_find(&_cache, hash, entry_match, &key);
+    if(cached_src == NULL && entry_cnt_max) {
+        _cache.miss_cnt++;
+        cached_src = entry_create();
+        if(cached_src) {
+            cached_src->dec_dsc = *dsc;
+            entry_insert(cached_src, hash);
+            return cached_src;
+        }
+    }
+
+    lv_img_decoder_close(dsc);
     return cached_src;
+#else
+    lv_img_decoder_close(dsc);
+    return NULL;
+#endif
 }
 
 /**
  * Set the number of images to be cached.
  * More cached images mean more opened image at same time which might mean more memory usage.
  * E.g. if 20 PNG or JPG images are open in the RAM they consume memory while opened in the cache.
+ * The least recently used images are closed if there are more images in the cache.
  * @param new_entry_cnt number of image to cache
  */
 void lv_img_cache_set_size(uint16_t new_entry_cnt)
@@ -152,23 +186,51 @@ void lv_img_cache_set_size(uint16_t new_entry_cnt)
     LV_UNUSED(new_entry_cnt);
     LV_LOG_WARN("Can't change cache size because it's disabled by LV_IMG_CACHE_DEF_SIZE = 0");
 #else
-    if(LV_GC_ROOT(_lv_img_cache_array) != NULL) {
-        /*Clean the cache before free it*/
-        lv_img_cache_invalidate_src(NULL);
-        lv_mem_free(LV_GC_ROOT(_lv_img_cache_array));
+    /*Initialize the cache on the first call from `lv_init()`*/
+    if(_cache.buckets == NULL) {
+        _lv_hash_lru_init(&_cache, buckets, HASH_BUCKET_CNT, entry_free);
+        cache_max_bytes = LV_IMG_CACHE_DEF_BYTES;
     }
 
-    /*Reallocate the cache*/
-    LV_GC_ROOT(_lv_img_cache_array) = lv_mem_alloc(sizeof(_lv_img_cache_entry_t) * new_entry_cnt);
-    LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_img_cache_array));
-    if(LV_GC_ROOT(_lv_img_cache_array) == NULL) {
-        entry_cnt = 0;
-        return;
-    }
-    entry_cnt = new_entry_cnt;
+    entry_cnt_max = new_entry_cnt;
+    _lv_hash_lru_shrink(&_cache, entry_cnt_max, UINT32_MAX, NULL);
+#endif
+}
+
+/**
+ * Set the max. total size of the decoded images in the cache.
+ * Only the memory allocated by the decoders is counted, not images used directly from a variable.
+ * The least recently used images are closed if the current usage is larger.
+ * @param max_bytes the new size in bytes. 0: no limit
+ */
+void lv_img_cache_set_max_bytes(uint32_t max_bytes)
+{
+#if LV_IMG_CACHE_DEF_SIZE == 0
+    LV_UNUSED(max_bytes);
+    LV_LOG_WARN("Can't change cache size because it's disabled by LV_IMG_CACHE_DEF_SIZE = 0");
+#else
+    cache_max_bytes = max_bytes;
+    if(cache_max_bytes) _lv_hash_lru_shrink(&_cache, entry_cnt_max, cache_max_bytes, NULL);
+#endif
+}
 
-    /*Clean the cache*/
-    lv_memset_00(LV_GC_ROOT(_lv_img_cache_array), entry_cnt * sizeof(_lv_img_cache_entry_t));
+/**
+ * Get the current state of the image cache
+ * @param info      store the result here
+ */
+void lv_img_cache_get_info(lv_img_cache_info_t * info)
+{
+    LV_ASSERT_NULL(info);
+
+    lv_memset_00(info, sizeof(lv_img_cache_info_t));
+#if LV_IMG_CACHE_DEF_SIZE
+    info->entry_cnt = _cache.entry_cnt;
+    info->max_entry_cnt = entry_cnt_max;
+    info->used = _cache.used;
+    info->max_bytes = cache_max_bytes;
+    info->hit_cnt = _cache.hit_cnt;
+    info->miss_cnt = _cache.miss_cnt;
+    info->evict_cnt = _cache.evict_cnt;
 #endif
 }
 
@@ -180,18 +242,21 @@ void lv_img_cache_set_size(uint16_t new_entry_cnt)
 void lv_img_cache_invalidate_src(const void * src)
 {
     LV_UNUSED(src);
-#if LV_IMG_CACHE_DEF_SIZE
-    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+#if LV_USE_IMG_DECODE_ASYNC
+    _lv_img_decode_async_cancel(src);
+#endif
 
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(src == NULL || lv_img_cache_match(src, cache[i].dec_dsc.src)) {
-            if(cache[i].dec_dsc.src != NULL) {
-                lv_img_decoder_close(&cache[i].dec_dsc);
-            }
+#if LV_IMG_CACHE_DEF_SIZE
+    if(src == NULL) {
+        _lv_hash_lru_drop_matching(&_cache, NULL, NULL);
+        return;
+    }
 
-            lv_memset_00(&cache[i], sizeof(_lv_img_cache_entry_t));
-        }
+    /*All the frames and colors of the source have the same hash*/
+    _lv_hash_lru_entry_t * entry;
+    uint32_t hash = get_src_hash(src);
+    while((entry = _lv_hash_lru_find(&_cache, hash, entry_match_src, src)) != NULL) {
+        _lv_hash_lru_drop(&_cache, entry);
     }
 #endif
 }
@@ -212,4 +277,84 @@ static bool lv_img_cache_match(const void * src1, const void * src2)
         return false;
     return strcmp(src1, src2) == 0;
 }
+
+static uint32_t get_src_hash(const void * src)
+{
+    /*Hash the path of files as the same path might be stored at different addresses*/
+    if(lv_img_src_get_type(src) == LV_IMG_SRC_FILE) {
+        const uint8_t * s = src;
+        uint32_t h = 2166136261u;
+        while(*s) {
+            h = (h ^ *s) * 16777619u;
+            s++;
+        }
+        return h;
+    }
+
+    return _lv_hash_lru_hash(src, 0);
+}
+
+static uint32_t get_entry_size(const _lv_img_cache_entry_t * entry)
+{
+    const lv_img_decoder_dsc_t * dsc = &entry->dec_dsc;
+
+    /*The decoder knows best, e.g. the size of its buffers to read the image line by line*/
+    if(dsc->mem_size) return dsc->mem_size;
+
+    /*Opened to be read line by line and the decoder didn't tell the size of its buffers*/
+    if(dsc->img_data == NULL) return 0;
+
+    /*The image is used directly from the variable, nothing is allocated for it*/
+    if(lv_img_src_get_type(dsc->src) == LV_IMG_SRC_VARIABLE &&
+       dsc->img_data == ((const lv_img_dsc_t *)dsc->src)->data) {
+        return 0;
+    }
+
+    return lv_img_buf_get_img_size(dsc->header.w, dsc->header.h, dsc->header.cf);
+}
+
+/**
+ * Tell if an entry is the image in a `cache_key_t`
+ */
+static bool entry_match(const _lv_hash_lru_entry_t * entry, const void * key)
+{
+    const lv_img_decoder_dsc_t * dsc = &((const _lv_img_cache_entry_t *)entry)->dec_dsc;
+    const cache_key_t * k = key;
+    return k->color.full == dsc->color.full && k->frame_id == dsc->frame_id && lv_img_cache_match(k->src, dsc->src);
+}
+
+static bool entry_match_src(const _lv_hash_lru_entry_t * entry, const void * src)
+{
+    return lv_img_cache_match(src, ((const _lv_img_cache_entry_t *)entry)->dec_dsc.src);
+}
+
+/**
+ * Make room for a new entry and allocate it.
+ * It's not in the cache until `entry_insert` is called.
+ */
+static _lv_img_cache_entry_t * entry_create(void)
+{
+    _lv_hash_lru_shrink(&_cache, entry_cnt_max - 1, UINT32_MAX, NULL);
+
+    _lv_img_cache_entry_t * entry = lv_mem_alloc(sizeof(_lv_img_cache_entry_t));
+    LV_ASSERT_MALLOC(entry);
+    if(entry == NULL) return NULL;
+    lv_memset_00(entry, sizeof(_lv_img_cache_entry_t));
+    return entry;
+}
+
+static void entry_insert(_lv_img_cache_entry_t * entry, uint32_t hash)
+{
+    _lv_hash_lru_add(&_cache, &entry->lru, hash, get_entry_size(entry));
+
+    /*Close the least recently used images to fit into the budget.
+     *The new image is kept even if it alone is larger as it's about to be drawn.*/
+    if(cache_max_bytes) _lv_hash_lru_shrink(&_cache, entry_cnt_max, cache_max_bytes, &entry->lru);
+}
+
+static void entry_free(_lv_hash_lru_entry_t * entry)
+{
+    lv_img_decoder_close(&((_lv_img_cache_entry_t *)entry)->dec_dsc);
+    lv_mem_free(entry);
+}
 #endif
@@ -37,6 +37,8 @@ static lv_res_t lv_img_decoder_built_in_line_alpha(lv_img_decoder_dsc_t * dsc, l
                                                    lv_coord_t len, uint8_t * buf);
 static lv_res_t lv_img_decoder_built_in_line_indexed(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
                                                      lv_coord_t len, uint8_t * buf);
+static lv_res_t decoder_open(lv_img_decoder_t * only, lv_img_decoder_dsc_t * dsc, const void * src, lv_color_t color,
+                             int32_t frame_id);
 
 /**********************
  *  STATIC VARIABLES
@@ -70,6 +72,7 @@ void _lv_img_decoder_init(void)
     lv_img_decoder_set_info_cb(decoder, lv_img_decoder_built_in_info);
     lv_img_decoder_set_open_cb(decoder, lv_img_decoder_built_in_open);
     lv_img_decoder_set_read_line_cb(decoder, lv_img_decoder_built_in_read_line);
+    lv_img_decoder_set_read_area_cb(decoder, lv_img_decoder_built_in_read_area);
     lv_img_decoder_set_close_cb(decoder, lv_img_decoder_built_in_close);
 }
 
@@ -106,62 +109,24 @@ lv_res_t lv_img_decoder_get_info(const void * src, lv_img_header_t * header)
 
 lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, lv_color_t color, int32_t frame_id)
 {
-    lv_memset_00(dsc, sizeof(lv_img_decoder_dsc_t));
-
-    if(src == NULL) return LV_RES_INV;
-    lv_img_src_t src_type = lv_img_src_get_type(src);
-    if(src_type == LV_IMG_SRC_VARIABLE) {
-        const lv_img_dsc_t * img_dsc = src;
-        if(img_dsc->data == NULL) return LV_RES_INV;
-    }
-
-    dsc->color    = color;
-    dsc->src_type = src_type;
-    dsc->frame_id = frame_id;
-
-    if(dsc->src_type == LV_IMG_SRC_FILE) {
-        size_t fnlen = strlen(src);
-        dsc->src = lv_mem_alloc(fnlen + 1);
-        LV_ASSERT_MALLOC(dsc->src);
-        if(dsc->src == NULL) {
-            LV_LOG_WARN("lv_img_decoder_open: out of memory");
-            return LV_RES_INV;
-        }
-        strcpy((char *)dsc->src, src);
-    }
-    else {
-        dsc->src = src;
-    }
-
-    lv_res_t res = LV_RES_INV;
-
-    lv_img_decoder_t * decoder;
-    _LV_LL_READ(&LV_GC_ROOT(_lv_img_decoder_ll), decoder) {
-        /*Info and Open callbacks are required*/
-        if(decoder->info_cb == NULL || decoder->open_cb == NULL) continue;
-
-        res = decoder->info_cb(decoder, src, &dsc->header);
-        if(res != LV_RES_OK) continue;
-
-        dsc->decoder = decoder;
-        res = decoder->open_cb(decoder, dsc);
-
-        /*Opened successfully. It is a good decoder for this image source*/
-        if(res == LV_RES_OK) return res;
-
-        /*Prepare for the next loop*/
-        lv_memset_00(&dsc->header, sizeof(lv_img_header_t));
-
-        dsc->error_msg = NULL;
-        dsc->img_data  = NULL;
-        dsc->user_data = NULL;
-        dsc->time_to_open = 0;
-    }
-
-    if(dsc->src_type == LV_IMG_SRC_FILE)
-        lv_mem_free((void *)dsc->src);
+    return decoder_open(NULL, dsc, src, color, frame_id);
+}
 
-    return res;
+/**
+ * Open an image with a given decoder only. The other decoders' callbacks are not called,
+ * so it can be used from an other thread if `decoder` is thread safe.
+ * @param decoder the decoder to use
+ * @param dsc describes a decoding session. Simply a pointer to an `lv_img_decoder_dsc_t` variable.
+ * @param src the image source
+ * @param color The color of the image with `LV_IMG_CF_ALPHA_...`
+ * @param frame_id the index of the frame. Used only with animated images, set 0 for normal images
+ * @return LV_RES_OK: opened the image; LV_RES_INV: `decoder` couldn't open the image
+ */
+lv_res_t _lv_img_decoder_open_with(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, const void * src,
+                                   lv_color_t color, int32_t frame_id)
+{
+    LV_ASSERT_NULL(decoder);
+    return decoder_open(decoder, dsc, src, color, frame_id);
 }
 
 /**
@@ -181,6 +146,44 @@ lv_res_t lv_img_decoder_read_line(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_c
     return res;
 }
 
+/**
+ * Read an area from an opened image
+ * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
+ * @param x start X coordinate (from left)
+ * @param y start Y coordinate (from top)
+ * @param w width of the area
+ * @param h height of the area
+ * @param buf store the data here
+ * @return LV_RES_OK: success; LV_RES_INV: an error occurred
+ */
+lv_res_t lv_img_decoder_read_area(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h,
+                                  uint8_t * buf)
+{
+    if(dsc->decoder->read_area_cb) return dsc->decoder->read_area_cb(dsc->decoder, dsc, x, y, w, h, buf);
+
+    /*Fall back to reading the rows one by one*/
+    uint32_t stride = (uint32_t)w * lv_img_decoder_get_px_size(dsc);
+    lv_coord_t i;
+    for(i = 0; i < h; i++) {
+        lv_res_t res = lv_img_decoder_read_line(dsc, x, y + i, w, buf);
+        if(res != LV_RES_OK) return res;
+        buf += stride;
+    }
+
+    return LV_RES_OK;
+}
+
+/**
+ * Get the size of a pixel returned by `lv_img_decoder_read_line/area`
+ * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
+ * @return size of a pixel in bytes
+ */
+uint8_t lv_img_decoder_get_px_size(const lv_img_decoder_dsc_t * dsc)
+{
+    if(lv_img_cf_has_alpha(dsc->header.cf) || dsc->header.cf == LV_IMG_CF_RGB565A8) return LV_IMG_PX_SIZE_ALPHA_BYTE;
+    else return sizeof(lv_color_t);
+}
+
 /**
  * Close a decoding session
  * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
@@ -253,6 +256,16 @@ void lv_img_decoder_set_read_line_cb(lv_img_decoder_t * decoder, lv_img_decoder_
     decoder->read_line_cb = read_line_cb;
 }
 
+/**
+ * Set a callback to decode an area (several lines) of an image at once
+ * @param decoder pointer to an image decoder
+ * @param read_area_cb a function to read an area of an image
+ */
+void lv_img_decoder_set_read_area_cb(lv_img_decoder_t * decoder, lv_img_decoder_read_area_f_t read_area_cb)
+{
+    decoder->read_area_cb = read_area_cb;
+}
+
 /**
  * Set a callback to close a decoding session. E.g. close files and free other resources.
  * @param decoder pointer to an image decoder
@@ -508,6 +521,38 @@ lv_res_t lv_img_decoder_built_in_read_line(lv_img_decoder_t * decoder, lv_img_de
     return res;
 }
 
+/**
+ * Decode a `w` x `h` area starting from the given `x`, `y` coordinates and store it in `buf`.
+ * @param decoder pointer to the decoder the function associated with
+ * @param dsc pointer to decoder descriptor
+ * @param x start x coordinate
+ * @param y start y coordinate
+ * @param w width of the area
+ * @param h height of the area
+ * @param buf a buffer to store the decoded pixels
+ * @return LV_RES_OK: ok; LV_RES_INV: failed
+ */
+lv_res_t lv_img_decoder_built_in_read_area(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                           lv_coord_t y, lv_coord_t w, lv_coord_t h, uint8_t * buf)
+{
+    /*Full width rows of true color files are stored continuously so read them at once*/
+    if(x == 0 && w == dsc->header.w && (int32_t)w * h <= LV_COORD_MAX && dsc->src_type == LV_IMG_SRC_FILE &&
+       (dsc->header.cf == LV_IMG_CF_TRUE_COLOR || dsc->header.cf == LV_IMG_CF_TRUE_COLOR_ALPHA ||
+        dsc->header.cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED)) {
+        return lv_img_decoder_built_in_line_true_color(dsc, 0, y, w * h, buf);
+    }
+
+    uint32_t stride = (uint32_t)w * lv_img_decoder_get_px_size(dsc);
+    lv_coord_t i;
+    for(i = 0; i < h; i++) {
+        lv_res_t res = lv_img_decoder_built_in_read_line(decoder, dsc, x, y + i, w, buf);
+        if(res != LV_RES_OK) return res;
+        buf += stride;
+    }
+
+    return LV_RES_OK;
+}
+
 /**
  * Close the pending decoding. Free resources etc.
  * @param decoder pointer to the decoder the function associated with
@@ -534,6 +579,70 @@ void lv_img_decoder_built_in_close(lv_img_decoder_t * decoder, lv_img_decoder_ds
  *   STATIC FUNCTIONS
  **********************/
 
+static lv_res_t decoder_open(lv_img_decoder_t * only, lv_img_decoder_dsc_t * dsc, const void * src, lv_color_t color,
+                             int32_t frame_id)
+{
+    lv_memset_00(dsc, sizeof(lv_img_decoder_dsc_t));
+
+    if(src == NULL) return LV_RES_INV;
+    lv_img_src_t src_type = lv_img_src_get_type(src);
+    if(src_type == LV_IMG_SRC_VARIABLE) {
+        const lv_img_dsc_t * img_dsc = src;
+        if(img_dsc->data == NULL) return LV_RES_INV;
+    }
+
+    dsc->color    = color;
+    dsc->src_type = src_type;
+    dsc->frame_id = frame_id;
+
+    if(dsc->src_type == LV_IMG_SRC_FILE) {
+        size_t fnlen = strlen(src);
+        dsc->src = lv_mem_alloc(fnlen + 1);
+        LV_ASSERT_MALLOC(dsc->src);
+        if(dsc->src == NULL) {
+            LV_LOG_WARN("lv_img_decoder_open: out of memory");
+            return LV_RES_INV;
+        }
+        strcpy((char *)dsc->src, src);
+    }
+    else {
+        dsc->src = src;
+    }
+
+    lv_res_t res = LV_RES_INV;
+
+    lv_img_decoder_t * decoder;
+    _LV_LL_READ(&LV_GC_ROOT(_lv_img_decoder_ll), decoder) {
+        if(only && decoder != only) continue;
+
+        /*Info and Open callbacks are required*/
+        if(decoder->info_cb == NULL || decoder->open_cb == NULL) continue;
+
+        res = decoder->info_cb(decoder, src, &dsc->header);
+        if(res != LV_RES_OK) continue;
+
+        dsc->decoder = decoder;
+        res = decoder->open_cb(decoder, dsc);
+
+        /*Opened successfully. It is a good decoder for this image source*/
+        if(res == LV_RES_OK) return res;
+
+        /*Prepare for the next loop*/
+        lv_memset_00(&dsc->header, sizeof(lv_img_header_t));
+
+        dsc->error_msg = NULL;
+        dsc->img_data  = NULL;
+        dsc->user_data = NULL;
+        dsc->time_to_open = 0;
+        dsc->mem_size = 0;
+    }
+
+    if(dsc->src_type == LV_IMG_SRC_FILE)
+        lv_mem_free((void *)dsc->src);
+
+    return res;
+}
+
 static lv_res_t lv_img_decoder_built_in_line_true_color(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
                                                         lv_coord_t len, uint8_t * buf)
 {
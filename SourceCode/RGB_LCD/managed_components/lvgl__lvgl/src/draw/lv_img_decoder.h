@@ -75,6 +75,23 @@ typedef lv_res_t (*lv_img_decoder_open_f_t)(struct _lv_img_decoder_t * decoder,
 typedef lv_res_t (*lv_img_decoder_read_line_f_t)(struct _lv_img_decoder_t * decoder, struct _lv_img_decoder_dsc_t * dsc,
                                                  lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t * buf);
 
+/**
+ * Decode a `w` x `h` area starting from the given `x`, `y` coordinates and store it in `buf` row by row.
+ * The rows follow each other without padding, i.e. the same way as if `read_line` was called for each row.
+ * With `LV_IMG_CF_RGB565A8` the `w * h` colors are followed by the `w * h` alpha values.
+ * Optional. If not set `read_line` is called for each row.
+ * @param decoder pointer to the decoder the function associated with
+ * @param dsc pointer to decoder descriptor
+ * @param x start x coordinate
+ * @param y start y coordinate
+ * @param w width of the area
+ * @param h height of the area
+ * @param buf a buffer to store the decoded pixels
+ * @return LV_RES_OK: ok; LV_RES_INV: failed
+ */
+typedef lv_res_t (*lv_img_decoder_read_area_f_t)(struct _lv_img_decoder_t * decoder, struct _lv_img_decoder_dsc_t * dsc,
+                                                 lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h, uint8_t * buf);
+
 /**
  * Close the pending decoding. Free resources etc.
  * @param decoder pointer to the decoder the function associated with
@@ -87,6 +104,7 @@ typedef struct _lv_img_decoder_t {
     lv_img_decoder_open_f_t open_cb;
     lv_img_decoder_read_line_f_t read_line_cb;
     lv_img_decoder_close_f_t close_cb;
+    lv_img_decoder_read_area_f_t read_area_cb;
 
 #if LV_USE_USER_DATA
     void * user_data;
@@ -121,6 +139,10 @@ typedef struct _lv_img_decoder_dsc_t {
      *  If not set `lv_img_cache` will measure and set the time to open*/
     uint32_t time_to_open;
 
+    /** Memory used by the decoder for the opened image in bytes, e.g. the buffers to decode it line by line.
+     *  Can be set in `open` function. If not set `lv_img_cache` counts the size of the decoded image in `img_data`*/
+    uint32_t mem_size;
+
     /**A text to display instead of the image when the image can't be opened.
      * Can be set in `open` function or set NULL.*/
     const char * error_msg;
@@ -165,6 +187,19 @@ lv_res_t lv_img_decoder_get_info(const void * src, lv_img_header_t * header);
  */
 lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, lv_color_t color, int32_t frame_id);
 
+/**
+ * Open an image with a given decoder only. The other decoders' callbacks are not called,
+ * so it can be used from an other thread if `decoder` is thread safe.
+ * @param decoder the decoder to use
+ * @param dsc describes a decoding session. Simply a pointer to an `lv_img_decoder_dsc_t` variable.
+ * @param src the image source
+ * @param color The color of the image with `LV_IMG_CF_ALPHA_...`
+ * @param frame_id the index of the frame. Used only with animated images, set 0 for normal images
+ * @return LV_RES_OK: opened the image; LV_RES_INV: `decoder` couldn't open the image
+ */
+lv_res_t _lv_img_decoder_open_with(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, const void * src,
+                                   lv_color_t color, int32_t frame_id);
+
 /**
  * Read a line from an opened image
  * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
@@ -177,6 +212,26 @@ lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, lv_co
 lv_res_t lv_img_decoder_read_line(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
                                   uint8_t * buf);
 
+/**
+ * Read an area from an opened image. Uses the `read_area` callback of the decoder or reads the rows one by one.
+ * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
+ * @param x start X coordinate (from left)
+ * @param y start Y coordinate (from top)
+ * @param w width of the area
+ * @param h height of the area
+ * @param buf store the data here. Its size should be `w * h * lv_img_decoder_get_px_size(dsc)`.
+ * @return LV_RES_OK: success; LV_RES_INV: an error occurred
+ */
+lv_res_t lv_img_decoder_read_area(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h,
+                                  uint8_t * buf);
+
+/**
+ * Get the size of a pixel returned by `lv_img_decoder_read_line/area`
+ * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
+ * @return `LV_IMG_PX_SIZE_ALPHA_BYTE` if the image has alpha, `sizeof(lv_color_t)` otherwise
+ */
+uint8_t lv_img_decoder_get_px_size(const lv_img_decoder_dsc_t * dsc);
+
 /**
  * Close a decoding session
  * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
@@ -216,6 +271,13 @@ void lv_img_decoder_set_open_cb(lv_img_decoder_t * decoder, lv_img_decoder_open_
  */
 void lv_img_decoder_set_read_line_cb(lv_img_decoder_t * decoder, lv_img_decoder_read_line_f_t read_line_cb);
 
+/**
+ * Set a callback to decode an area (several lines) of an image at once
+ * @param decoder pointer to an image decoder
+ * @param read_area_cb a function to read an area of an image
+ */
+void lv_img_decoder_set_read_area_cb(lv_img_decoder_t * decoder, lv_img_decoder_read_area_f_t read_area_cb);
+
 /**
  * Set a callback to close a decoding session. E.g. close files and free other resources.
  * @param decoder pointer to an image decoder
@@ -254,6 +316,20 @@ lv_res_t lv_img_decoder_built_in_open(lv_img_decoder_t * decoder, lv_img_decoder
 lv_res_t lv_img_decoder_built_in_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
                                            lv_coord_t y, lv_coord_t len, uint8_t * buf);
 
+/**
+ * Decode a `w` x `h` area starting from the given `x`, `y` coordinates and store it in `buf`.
+ * @param decoder pointer to the decoder the function associated with
+ * @param dsc pointer to decoder descriptor
+ * @param x start x coordinate
+ * @param y start y coordinate
+ * @param w width of the area
+ * @param h height of the area
+ * @param buf a buffer to store the decoded pixels
+ * @return LV_RES_OK: ok; LV_RES_INV: failed
+ */
+lv_res_t lv_img_decoder_built_in_read_area(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                           lv_coord_t y, lv_coord_t w, lv_coord_t h, uint8_t * buf);
+
 /**
  * Close the pending decoding. Free resources etc.
  * @param decoder pointer to the decoder the function associated with
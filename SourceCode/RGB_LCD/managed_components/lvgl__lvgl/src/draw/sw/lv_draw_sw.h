@@ -14,6 +14,10 @@ extern "C" {
  *      INCLUDES
  *********************/
 #include "lv_draw_sw_blend.h"
+#include "lv_draw_sw_parallel.h"
+#include "lv_draw_sw_blend_simd.h"
+#include "lv_draw_sw_shadow_cache.h"
+#include "lv_draw_sw_glyph_cache.h"
 #include "../lv_draw.h"
 #include "../../misc/lv_area.h"
 #include "../../misc/lv_color.h"
@@ -61,6 +65,9 @@ void lv_draw_sw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, con
 void lv_draw_sw_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos_p,
                        uint32_t letter);
 
+void lv_draw_sw_text_run(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                         const lv_draw_label_glyph_t * glyphs, uint32_t glyph_cnt);
+
 void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_sw_img_decoded(struct _lv_draw_ctx_t * draw_ctx,
                                                         const lv_draw_img_dsc_t * draw_dsc,
                                                         const lv_area_t * coords, const uint8_t * src_buf,
@@ -0,0 +1,98 @@
+/**
+ * @file lv_draw_sw_blend_simd.h
+ *
+ */
+
+#ifndef LV_DRAW_SW_BLEND_SIMD_H
+#define LV_DRAW_SW_BLEND_SIMD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lv_conf_internal.h"
+#include "../../misc/lv_color.h"
+
+#if LV_USE_DRAW_SW_SIMD
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Blend kernels working on one row of `w` pixels of the `LV_BLEND_MODE_NORMAL` blending.
+ * The result must be the same as the result of `lv_color_mix()` and of the scalar reference kernels
+ * returned by `_lv_draw_sw_blend_simd_get_builtin(0)`. Any alignment of the pointers needs to be handled.
+ * Pixels with 0 mask value are not modified.
+ */
+typedef struct {
+    const char * name;
+
+    /** Fill with a color with `opa < LV_OPA_MAX`*/
+    void (*fill_opa)(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa);
+
+    /** Fill with a color using a mask. 255 mask values set `color`*/
+    void (*fill_mask)(lv_color_t * dest_buf, int32_t w, lv_color_t color, const lv_opa_t * mask);
+
+    /** Fill with a color with `opa < LV_OPA_MAX` using a mask. The mix ratio is `mask * opa >> 8` (`opa` for 255 mask)*/
+    void (*fill_mask_opa)(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa, const lv_opa_t * mask);
+
+    /** Mix an image with `opa < LV_OPA_MAX`*/
+    void (*map_opa)(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, lv_opa_t opa);
+
+    /** Mix an image with `opa > LV_OPA_MAX` using a mask. 255 mask values copy the source pixel*/
+    void (*map_mask)(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, const lv_opa_t * mask);
+
+    /** Mix an image with `opa <= LV_OPA_MAX` using a mask. The mix ratio is `mask * opa >> 8` (`opa` for mask >= `LV_OPA_MAX`)*/
+    void (*map_mask_opa)(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, lv_opa_t opa,
+                         const lv_opa_t * mask);
+} lv_draw_sw_blend_kernels_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Detect the CPU features and select the fastest built-in kernels. Called by `lv_init()`.
+ */
+void _lv_draw_sw_blend_simd_init(void);
+
+/**
+ * Set the kernels to use for blending. Can be used to add kernels for a custom CPU (e.g. with inline assembly).
+ * @param kernels   pointer to a static kernel table, or NULL to use the original scalar blending code
+ */
+void lv_draw_sw_blend_set_kernels(const lv_draw_sw_blend_kernels_t * kernels);
+
+/**
+ * Get the kernels used for blending
+ * @return          pointer to the kernel table or NULL if the original scalar blending code is used
+ */
+const lv_draw_sw_blend_kernels_t * lv_draw_sw_blend_get_kernels(void);
+
+/**
+ * Get the built-in kernels supported by the CPU and the current color format.
+ * `_lv_draw_sw_blend_simd_init()` needs to be called first.
+ * The first one is the scalar reference the others need to be bit exact with.
+ * @param idx       index of the kernels
+ * @return          pointer to the kernel table or NULL if `idx` is out of range
+ */
+const lv_draw_sw_blend_kernels_t * _lv_draw_sw_blend_simd_get_builtin(uint32_t idx);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_DRAW_SW_SIMD*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_BLEND_SIMD_H*/
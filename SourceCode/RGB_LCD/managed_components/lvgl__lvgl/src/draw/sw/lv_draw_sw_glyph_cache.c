@@ -0,0 +1,347 @@
+/**
+ * @file lv_draw_sw_glyph_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_glyph_cache.h"
+
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+
+#include "../../misc/lv_gc.h"
+#include "../../misc/lv_hash_lru.h"
+#include "../../misc/lv_assert.h"
+#include "../../misc/lv_log.h"
+#include "../../misc/lv_printf.h"
+#include "../../misc/lv_tlsf.h"
+
+#if defined(ESP_PLATFORM) && defined(CONFIG_SPIRAM)
+    #include "esp_heap_caps.h"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define _cache LV_GC_ROOT(_lv_glyph_cache)
+
+#define HASH_BUCKET_CNT     64
+
+/*With the built-in heap allocate the glyphs from a pool of fixed size.
+ *This way the cache takes the same amount of memory however the glyphs come and go and doesn't fragment the heap.*/
+#define USE_POOL            (LV_MEM_CUSTOM == 0)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    _lv_hash_lru_entry_t lru;           /**< Must be the first. Its size is the size of the bitmap.*/
+    const lv_font_t * font;
+    uint32_t letter;
+    uint16_t box_w;
+    uint16_t box_h;
+    uint8_t bpp;
+    lv_opa_t * buf;                     /**< Allocated together with the entry, right after it*/
+} cache_entry_t;
+
+typedef struct {
+    const lv_font_glyph_dsc_t * g;
+    uint32_t letter;
+} cache_key_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool entry_match(const _lv_hash_lru_entry_t * entry, const void * key);
+static bool entry_match_font(const _lv_hash_lru_entry_t * entry, const void * font);
+static cache_entry_t * entry_create(const lv_font_glyph_dsc_t * g, uint32_t letter, uint32_t hash);
+static bool entry_decode(cache_entry_t * entry, const uint8_t * map_p);
+static void entry_free(_lv_hash_lru_entry_t * entry);
+static cache_entry_t * entry_alloc(uint32_t size);
+static void * buf_alloc(uint32_t size);
+static void buf_free(void * buf);
+#if USE_POOL
+    static bool pool_create(void);
+    static void pool_delete(void);
+#endif
+
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+extern const uint8_t _lv_bpp1_opa_table[2];
+extern const uint8_t _lv_bpp2_opa_table[4];
+extern const uint8_t _lv_bpp4_opa_table[16];
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static _lv_hash_lru_entry_t * buckets[HASH_BUCKET_CNT];
+static uint32_t cache_size;
+#if USE_POOL
+static void * pool_mem;
+static lv_tlsf_t pool;
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_draw_sw_glyph_cache_init(void)
+{
+    _lv_hash_lru_init(&_cache, buckets, HASH_BUCKET_CNT, entry_free);
+    cache_size = LV_DRAW_SW_GLYPH_CACHE_SIZE;
+#if USE_POOL
+    /*The heap was reinitialized by `lv_init()`*/
+    pool_mem = NULL;
+    pool = NULL;
+#endif
+}
+
+const lv_opa_t * _lv_draw_sw_glyph_cache_get(const lv_font_glyph_dsc_t * g, uint32_t letter)
+{
+    /*Only the built-in bitmap formats can be decoded*/
+    if(g->bpp != 1 && g->bpp != 2 && g->bpp != 3 && g->bpp != 4 && g->bpp != 8) return NULL;
+
+    uint32_t size = (uint32_t)g->box_w * g->box_h;
+    if(size == 0 || sizeof(cache_entry_t) + size > cache_size) return NULL;
+
+    cache_key_t key = {g, letter};
+    uint32_t hash = _lv_hash_lru_hash(g->resolved_font, letter);
+    cache_entry_t * entry = (cache_entry_t *)_lv_hash_lru_get(&_cache, hash, entry_match, &key);
+    if(entry) return entry->buf;
+
+    entry = entry_create(g, letter, hash);
+    return entry ? entry->buf : NULL;
+}
+
+void lv_draw_sw_glyph_cache_set_size(uint32_t size)
+{
+#if USE_POOL
+    /*The pool can't be resized. Drop it with the glyphs, a new one is allocated when a glyph is cached again.*/
+    if(size != cache_size) pool_delete();
+#endif
+
+    cache_size = size;
+
+    /*Drop the least recently used glyphs to fit into the new size*/
+    _lv_hash_lru_shrink(&_cache, UINT32_MAX, cache_size, NULL);
+}
+
+void lv_draw_sw_glyph_cache_get_info(lv_draw_sw_glyph_cache_info_t * info)
+{
+    LV_ASSERT_NULL(info);
+
+    info->size = cache_size;
+    info->used = _cache.used;
+    info->entry_cnt = _cache.entry_cnt;
+    info->hit_cnt = _cache.hit_cnt;
+    info->miss_cnt = _cache.miss_cnt;
+}
+
+void lv_draw_sw_glyph_cache_clear(void)
+{
+    _lv_hash_lru_drop_matching(&_cache, NULL, NULL);
+    _cache.hit_cnt = 0;
+    _cache.miss_cnt = 0;
+}
+
+void lv_draw_sw_glyph_cache_drop_font(const lv_font_t * font)
+{
+    _lv_hash_lru_drop_matching(&_cache, entry_match_font, font);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Tell if an entry is the glyph in a `cache_key_t`.
+ * The size is compared too as the font might be changed since the glyph was cached
+ * (e.g. a new font at the same address). Such entries are dropped when they become the least recently used.
+ */
+static bool entry_match(const _lv_hash_lru_entry_t * entry, const void * key)
+{
+    const cache_entry_t * e = (const cache_entry_t *)entry;
+    const cache_key_t * k = key;
+    return e->font == k->g->resolved_font && e->letter == k->letter &&
+           e->box_w == k->g->box_w && e->box_h == k->g->box_h && e->bpp == k->g->bpp;
+}
+
+static bool entry_match_font(const _lv_hash_lru_entry_t * entry, const void * font)
+{
+    return ((const cache_entry_t *)entry)->font == font;
+}
+
+static cache_entry_t * entry_create(const lv_font_glyph_dsc_t * g, uint32_t letter, uint32_t hash)
+{
+    const uint8_t * map_p = lv_font_get_glyph_bitmap(g->resolved_font, letter);
+    if(map_p == NULL) return NULL;
+
+    uint32_t size = sizeof(cache_entry_t) + (uint32_t)g->box_w * g->box_h;
+
+    /*Drop the least recently used glyphs to get space*/
+    _lv_hash_lru_shrink(&_cache, UINT32_MAX, cache_size - size, NULL);
+
+    cache_entry_t * entry = entry_alloc(size);
+    if(entry == NULL) {
+        LV_LOG_WARN("Couldn't allocate %"LV_PRIu32" bytes for a glyph", size);
+        return NULL;
+    }
+
+    entry->font = g->resolved_font;
+    entry->letter = letter;
+    entry->box_w = g->box_w;
+    entry->box_h = g->box_h;
+    entry->bpp = g->bpp;
+    entry->buf = (lv_opa_t *)(entry + 1);
+
+    if(!entry_decode(entry, map_p)) {
+        entry_free(&entry->lru);
+        return NULL;
+    }
+
+    _lv_hash_lru_add(&_cache, &entry->lru, hash, size);
+    return entry;
+}
+
+/**
+ * Expand the 1, 2, 3, 4 or 8 bpp bitmap of the font to one opacity byte per pixel.
+ * The values are the same as the ones in `_lv_bpp*_opa_table`.
+ */
+static bool entry_decode(cache_entry_t * entry, const uint8_t * map_p)
+{
+    const uint8_t * bpp_opa_table_p;
+    uint32_t bpp = entry->bpp;
+    if(bpp == 3) bpp = 4;
+
+    switch(bpp) {
+        case 1:
+            bpp_opa_table_p = _lv_bpp1_opa_table;
+            break;
+        case 2:
+            bpp_opa_table_p = _lv_bpp2_opa_table;
+            break;
+        case 4:
+            bpp_opa_table_p = _lv_bpp4_opa_table;
+            break;
+        case 8:
+            lv_memcpy(entry->buf, map_p, (uint32_t)entry->box_w * entry->box_h);
+            return true;
+        default:
+            return false;
+    }
+
+    /*The rows are not padded so the bitmap is just a stream of pixels*/
+    uint32_t px_cnt = (uint32_t)entry->box_w * entry->box_h;
+    uint32_t px_per_byte = 8 / bpp;
+    uint32_t mask = (1 << bpp) - 1;
+    lv_opa_t * buf = entry->buf;
+    uint32_t i = 0;
+    while(i < px_cnt) {
+        uint8_t byte = *map_p;
+        map_p++;
+        int32_t shift = 8 - bpp;
+        uint32_t j;
+        for(j = 0; j < px_per_byte && i < px_cnt; j++) {
+            buf[i] = bpp_opa_table_p[(byte >> shift) & mask];
+            shift -= bpp;
+            i++;
+        }
+    }
+
+    return true;
+}
+
+static void entry_free(_lv_hash_lru_entry_t * entry)
+{
+#if USE_POOL
+    lv_tlsf_free(pool, entry);
+#else
+    buf_free(entry);
+#endif
+}
+
+/**
+ * Allocate an entry with its bitmap
+ * @param size      size of the entry and the bitmap
+ * @return          the new entry or NULL on error
+ */
+static cache_entry_t * entry_alloc(uint32_t size)
+{
+#if USE_POOL
+    if(pool == NULL && !pool_create()) return NULL;
+
+    void * p = lv_tlsf_malloc(pool, size);
+
+    /*The pool has some overhead and can be fragmented, drop the least recently used glyphs until it fits*/
+    while(p == NULL && _cache.entry_cnt > 0) {
+        _lv_hash_lru_shrink(&_cache, _cache.entry_cnt - 1, UINT32_MAX, NULL);
+        p = lv_tlsf_malloc(pool, size);
+    }
+
+    return p;
+#else
+    return buf_alloc(size);
+#endif
+}
+
+#if USE_POOL
+/**
+ * Allocate the pool for `cache_size` bytes of glyphs
+ * @return          true: the pool was created
+ */
+static bool pool_create(void)
+{
+    size_t pool_size = lv_tlsf_size() + lv_tlsf_pool_overhead() + cache_size;
+    pool_mem = buf_alloc(pool_size);
+    if(pool_mem == NULL) {
+        LV_LOG_WARN("Couldn't allocate %"LV_PRIu32" bytes for the glyph cache", (uint32_t)pool_size);
+        return false;
+    }
+
+    pool = lv_tlsf_create_with_pool(pool_mem, pool_size);
+    return true;
+}
+
+static void pool_delete(void)
+{
+    _lv_hash_lru_drop_matching(&_cache, NULL, NULL);
+    if(pool_mem == NULL) return;
+
+    lv_tlsf_destroy(pool);
+    buf_free(pool_mem);
+    pool_mem = NULL;
+    pool = NULL;
+}
+#endif
+
+/**
+ * Allocate the glyphs in the external RAM if it's available.
+ * They are only read while blending.
+ */
+static void * buf_alloc(uint32_t size)
+{
+#if defined(ESP_PLATFORM) && defined(CONFIG_SPIRAM)
+    void * buf = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if(buf == NULL) buf = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    return buf;
+#else
+    return lv_mem_alloc(size);
+#endif
+}
+
+static void buf_free(void * buf)
+{
+#if defined(ESP_PLATFORM) && defined(CONFIG_SPIRAM)
+    heap_caps_free(buf);
+#else
+    lv_mem_free(buf);
+#endif
+}
+
+#endif /*LV_USE_DRAW_SW_GLYPH_CACHE*/
@@ -0,0 +1,91 @@
+/**
+ * @file lv_draw_sw_glyph_cache.h
+ *
+ */
+
+#ifndef LV_DRAW_SW_GLYPH_CACHE_H
+#define LV_DRAW_SW_GLYPH_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lv_conf_internal.h"
+#include "../../misc/lv_color.h"
+#include "../../font/lv_font.h"
+
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    uint32_t size;          /**< The max. total size of the cached glyphs in bytes*/
+    uint32_t used;          /**< The current total size of the cached glyphs (bitmaps and descriptors) in bytes*/
+    uint32_t entry_cnt;     /**< Number of cached glyphs*/
+    uint32_t hit_cnt;       /**< Number of times a glyph was drawn from the cache*/
+    uint32_t miss_cnt;      /**< Number of times a glyph had to be decoded*/
+} lv_draw_sw_glyph_cache_info_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the glyph cache. Called by `lv_init()`.
+ */
+void _lv_draw_sw_glyph_cache_init(void);
+
+/**
+ * Get the bitmap of a glyph with 8 bit coverage values. If it's not cached yet, decode it into the cache.
+ * @param g         the descriptor of the glyph returned by `lv_font_get_glyph_dsc()`
+ * @param letter    the letter of the glyph
+ * @return          `g->box_w * g->box_h` opacity values or NULL if the glyph can't be cached.
+ *                  Valid until the next call.
+ */
+const lv_opa_t * _lv_draw_sw_glyph_cache_get(const lv_font_glyph_dsc_t * g, uint32_t letter);
+
+/**
+ * Set the max. total size of the cached glyphs.
+ * The least recently used glyphs are dropped if the new size is smaller than the current usage.
+ * With the built-in heap the pool of the glyphs is reallocated so all the glyphs are dropped.
+ * @param size      the new size in bytes. 0: disable caching
+ */
+void lv_draw_sw_glyph_cache_set_size(uint32_t size);
+
+/**
+ * Get the current state of the glyph cache
+ * @param info      store the result here
+ */
+void lv_draw_sw_glyph_cache_get_info(lv_draw_sw_glyph_cache_info_t * info);
+
+/**
+ * Drop all the cached glyphs and reset the hit/miss counters.
+ */
+void lv_draw_sw_glyph_cache_clear(void);
+
+/**
+ * Drop the cached glyphs of a font. Needs to be called before freeing a font created in run time.
+ * @param font      pointer to a font
+ */
+void lv_draw_sw_glyph_cache_drop_font(const lv_font_t * font);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_DRAW_SW_GLYPH_CACHE*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_GLYPH_CACHE_H*/
@@ -32,218 +32,201 @@
     #error "LV_GRAD_CACHE_DEF_SIZE is too small"
 #endif
 
+#define _cache LV_GC_ROOT(_lv_grad_cache)
+
+#define HASH_BUCKET_CNT     32
+
 /**********************
- *  STATIC PROTOTYPES
+ *      TYPEDEFS
  **********************/
-static lv_grad_t * next_in_cache(lv_grad_t * item);
+typedef struct {
+    const lv_grad_dsc_t * g;
+    lv_coord_t w;
+    lv_coord_t h;
+} grad_key_t;
 
-typedef lv_res_t (*op_cache_t)(lv_grad_t * c, void * ctx);
-static lv_res_t iterate_cache(op_cache_t func, void * ctx, lv_grad_t ** out);
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static size_t get_item_size(lv_coord_t w, lv_coord_t h, lv_coord_t size);
 static size_t get_cache_item_size(lv_grad_t * c);
 static lv_grad_t * allocate_item(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h);
-static lv_res_t find_oldest_item_life(lv_grad_t * c, void * ctx);
-static lv_res_t kill_oldest_item(lv_grad_t * c, void * ctx);
-static lv_res_t find_item(lv_grad_t * c, void * ctx);
-static void free_item(lv_grad_t * c);
-static  uint32_t compute_key(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h);
+static void init_item(lv_grad_t * item, const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h, uint32_t key);
+static bool item_matches(const lv_grad_t * c, const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h, uint32_t key);
+static bool item_matches_key(const _lv_hash_lru_entry_t * entry, const void * key);
+static void free_item(_lv_hash_lru_entry_t * entry);
+static uint32_t compute_key(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h);
 
 /**********************
  *   STATIC VARIABLE
  **********************/
-static size_t    grad_cache_size = 0;
-static uint8_t * grad_cache_end = 0;
+static size_t grad_cache_size = LV_GRAD_CACHE_DEF_SIZE;
+static _lv_hash_lru_entry_t * grad_buckets[HASH_BUCKET_CNT];
+static size_t grad_spare_size = 0;          /*Allocated size of `LV_GC_ROOT(_lv_grad_cache_spare)`*/
+static bool grad_spare_in_use = false;
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
-union void_cast {
-    const void * ptr;
-    const uint32_t value;
-};
 
-static uint32_t compute_key(const lv_grad_dsc_t * g, lv_coord_t size, lv_coord_t w)
+/*FNV-1a hash of everything the computed map depends on*/
+static uint32_t compute_key(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
 {
-    union void_cast v;
-    v.ptr = g;
-    return (v.value ^ size ^ (w >> 1)); /*Yes, this is correct, it's like a hash that changes if the width changes*/
-}
+    uint32_t k = 2166136261u;
+#define HASH_ADD(v) k = (k ^ (uint32_t)(v)) * 16777619u
+
+    HASH_ADD(g->dir);
+    HASH_ADD(g->dither);
+    HASH_ADD(g->stops_count);
+    uint8_t i;
+    for(i = 0; i < g->stops_count; i++) {
+        HASH_ADD(lv_color_to32(g->stops[i].color));
+        HASH_ADD(g->stops[i].frac);
+    }
+    HASH_ADD(w);
+    HASH_ADD(h);
 
-static size_t get_cache_item_size(lv_grad_t * c)
-{
-    size_t s = ALIGN(sizeof(*c)) + ALIGN(c->alloc_size * sizeof(lv_color_t));
-#if _DITHER_GRADIENT
-    s += ALIGN(c->size * sizeof(lv_color32_t));
-#if LV_DITHER_ERROR_DIFFUSION == 1
-    s += ALIGN(c->w * sizeof(lv_scolor24_t));
-#endif
-#endif
-    return s;
+#undef HASH_ADD
+    return k;
 }
 
-static lv_grad_t * next_in_cache(lv_grad_t * item)
+static bool item_matches(const lv_grad_t * c, const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h, uint32_t key)
 {
-    if(grad_cache_size == 0) return NULL;
-
-    if(item == NULL)
-        return (lv_grad_t *)LV_GC_ROOT(_lv_grad_cache_mem);
-
-    size_t s = get_cache_item_size(item);
-    /*Compute the size for this cache item*/
-    if((uint8_t *)item + s >= grad_cache_end) return NULL;
-    else return (lv_grad_t *)((uint8_t *)item + s);
-}
+    if(c->lru.hash != key || c->area_w != w || c->area_h != h) return false;
+    if(c->dsc.dir != g->dir || c->dsc.dither != g->dither || c->dsc.stops_count != g->stops_count) return false;
 
-static lv_res_t iterate_cache(op_cache_t func, void * ctx, lv_grad_t ** out)
-{
-    lv_grad_t * first = next_in_cache(NULL);
-    while(first != NULL && first->life) {
-        if((*func)(first, ctx) == LV_RES_OK) {
-            if(out != NULL) *out = first;
-            return LV_RES_OK;
-        }
-        first = next_in_cache(first);
+    uint8_t i;
+    for(i = 0; i < g->stops_count; i++) {
+        if(c->dsc.stops[i].color.full != g->stops[i].color.full) return false;
+        if(c->dsc.stops[i].frac != g->stops[i].frac) return false;
     }
-    return LV_RES_INV;
+    return true;
 }
 
-static lv_res_t find_oldest_item_life(lv_grad_t * c, void * ctx)
+static size_t get_item_size(lv_coord_t w, lv_coord_t h, lv_coord_t size)
 {
-    uint32_t * min_life = (uint32_t *)ctx;
-    if(c->life < *min_life) *min_life = c->life;
-    return LV_RES_INV;
-}
+    lv_coord_t map_size = LV_MAX(w, h); /* The map is being used horizontally (width) unless
+                                           no dithering is selected where it's used vertically */
 
-static void free_item(lv_grad_t * c)
-{
-    size_t size = get_cache_item_size(c);
-    size_t next_items_size = (size_t)(grad_cache_end - (uint8_t *)c) - size;
-    grad_cache_end -= size;
-    if(next_items_size) {
-        uint8_t * old = (uint8_t *)c;
-        lv_memcpy(c, ((uint8_t *)c) + size, next_items_size);
-        /* Then need to fix all internal pointers too */
-        while((uint8_t *)c != grad_cache_end) {
-            c->map = (lv_color_t *)(((uint8_t *)c->map) - size);
+    size_t s = ALIGN(sizeof(lv_grad_t)) + ALIGN(map_size * sizeof(lv_color_t));
 #if _DITHER_GRADIENT
-            c->hmap = (lv_color32_t *)(((uint8_t *)c->hmap) - size);
+    s += ALIGN(size * sizeof(lv_color32_t));
 #if LV_DITHER_ERROR_DIFFUSION == 1
-            c->error_acc = (lv_scolor24_t *)(((uint8_t *)c->error_acc) - size);
+    s += ALIGN(w * sizeof(lv_scolor24_t));
 #endif
+#else
+    LV_UNUSED(size);
 #endif
-            c = (lv_grad_t *)(((uint8_t *)c) + get_cache_item_size(c));
-        }
-        lv_memset_00(old + next_items_size, size);
-    }
+    return s;
 }
 
-static lv_res_t kill_oldest_item(lv_grad_t * c, void * ctx)
+static size_t get_cache_item_size(lv_grad_t * c)
 {
-    uint32_t * min_life = (uint32_t *)ctx;
-    if(c->life == *min_life) {
-        /*Found, let's kill it*/
-        free_item(c);
-        return LV_RES_OK;
-    }
-    return LV_RES_INV;
+    return get_item_size(c->area_w, c->area_h, c->size);
 }
 
-static lv_res_t find_item(lv_grad_t * c, void * ctx)
+static bool item_matches_key(const _lv_hash_lru_entry_t * entry, const void * key)
 {
-    uint32_t * k = (uint32_t *)ctx;
-    if(c->key == *k) return LV_RES_OK;
-    return LV_RES_INV;
+    const grad_key_t * k = key;
+    return item_matches((const lv_grad_t *)entry, k->g, k->w, k->h, entry->hash);
 }
 
-static lv_grad_t * allocate_item(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
+static void free_item(_lv_hash_lru_entry_t * entry)
+{
+    lv_mem_free(entry);
+}
+
+static void init_item(lv_grad_t * item, const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h, uint32_t key)
 {
     lv_coord_t size = g->dir == LV_GRAD_DIR_HOR ? w : h;
-    lv_coord_t map_size = LV_MAX(w, h); /* The map is being used horizontally (width) unless
-                                           no dithering is selected where it's used vertically */
+    lv_coord_t map_size = LV_MAX(w, h);
 
-    size_t req_size = ALIGN(sizeof(lv_grad_t)) + ALIGN(map_size * sizeof(lv_color_t));
+    item->lru.hash = key;
+    item->filled = 0;
+    item->dsc = *g;
+    item->area_w = w;
+    item->area_h = h;
+    item->alloc_size = map_size;
+    item->size = size;
+
+    uint8_t * p = (uint8_t *)item;
+    item->map = (lv_color_t *)(p + ALIGN(sizeof(*item)));
 #if _DITHER_GRADIENT
-    req_size += ALIGN(size * sizeof(lv_color32_t));
+    item->hmap = (lv_color32_t *)(p + ALIGN(sizeof(*item)) + ALIGN(map_size * sizeof(lv_color_t)));
 #if LV_DITHER_ERROR_DIFFUSION == 1
-    req_size += ALIGN(w * sizeof(lv_scolor24_t));
+    item->error_acc = (lv_scolor24_t *)(p + ALIGN(sizeof(*item)) + ALIGN(size * sizeof(lv_grad_color_t)) +
+                                        ALIGN(map_size * sizeof(lv_color_t)));
+    item->w = w;
 #endif
 #endif
+}
+
+static lv_grad_t * allocate_item(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
+{
+    lv_coord_t size = g->dir == LV_GRAD_DIR_HOR ? w : h;
+    size_t req_size = get_item_size(w, h, size);
 
-    size_t act_size = (size_t)(grad_cache_end - LV_GC_ROOT(_lv_grad_cache_mem));
     lv_grad_t * item = NULL;
-    if(req_size + act_size < grad_cache_size) {
-        item = (lv_grad_t *)grad_cache_end;
-        item->not_cached = 0;
-    }
-    else {
-        /*Need to evict items from cache until we find enough space to allocate this one */
-        if(req_size <= grad_cache_size) {
-            while(act_size + req_size > grad_cache_size) {
-                uint32_t oldest_life = UINT32_MAX;
-                iterate_cache(&find_oldest_item_life, &oldest_life, NULL);
-                iterate_cache(&kill_oldest_item, &oldest_life, NULL);
-                act_size = (size_t)(grad_cache_end - LV_GC_ROOT(_lv_grad_cache_mem));
-            }
-            item = (lv_grad_t *)grad_cache_end;
+    if(req_size <= grad_cache_size) {
+        /*Evict the least recently used items until this one fits*/
+        _lv_hash_lru_shrink(&_cache, UINT32_MAX, grad_cache_size - req_size, NULL);
+
+        item = lv_mem_alloc(req_size);
+        /*The heap might be fragmented, so try freeing some more*/
+        while(item == NULL && _cache.tail) {
+            _lv_hash_lru_drop(&_cache, _cache.tail);
+            item = lv_mem_alloc(req_size);
+        }
+        if(item) {
             item->not_cached = 0;
+            return item;
         }
-        else {
-            /*The cache is too small. Allocate the item manually and free it later.*/
-            item = lv_mem_alloc(req_size);
-            LV_ASSERT_MALLOC(item);
-            if(item == NULL) return NULL;
+    }
+    else if(!grad_spare_in_use) {
+        /*The cache is too small. Reuse the buffer of the previous large gradient to avoid allocating on every draw.*/
+        if(grad_spare_size < req_size) {
+            lv_mem_free(LV_GC_ROOT(_lv_grad_cache_spare));
+            LV_GC_ROOT(_lv_grad_cache_spare) = lv_mem_alloc(req_size);
+            grad_spare_size = LV_GC_ROOT(_lv_grad_cache_spare) ? req_size : 0;
+        }
+        item = LV_GC_ROOT(_lv_grad_cache_spare);
+        if(item) {
             item->not_cached = 1;
+            grad_spare_in_use = true;
+            return item;
         }
     }
 
-    item->key = compute_key(g, size, w);
-    item->life = 1;
-    item->filled = 0;
-    item->alloc_size = map_size;
-    item->size = size;
-    if(item->not_cached) {
-        uint8_t * p = (uint8_t *)item;
-        item->map = (lv_color_t *)(p + ALIGN(sizeof(*item)));
-#if _DITHER_GRADIENT
-        item->hmap = (lv_color32_t *)(p + ALIGN(sizeof(*item)) + ALIGN(map_size * sizeof(lv_color_t)));
-#if LV_DITHER_ERROR_DIFFUSION == 1
-        item->error_acc = (lv_scolor24_t *)(p + ALIGN(sizeof(*item)) + ALIGN(size * sizeof(lv_grad_color_t)) +
-                                            ALIGN(map_size * sizeof(lv_color_t)));
-        item->w = w;
-#endif
-#endif
-    }
-    else {
-        item->map = (lv_color_t *)(grad_cache_end + ALIGN(sizeof(*item)));
-#if _DITHER_GRADIENT
-        item->hmap = (lv_color32_t *)(grad_cache_end + ALIGN(sizeof(*item)) + ALIGN(map_size * sizeof(lv_color_t)));
-#if LV_DITHER_ERROR_DIFFUSION == 1
-        item->error_acc = (lv_scolor24_t *)(grad_cache_end + ALIGN(sizeof(*item)) + ALIGN(size * sizeof(lv_grad_color_t)) +
-                                            ALIGN(map_size * sizeof(lv_color_t)));
-        item->w = w;
-#endif
-#endif
-        grad_cache_end += req_size;
-    }
+    /*Nothing else worked so allocate the item manually and free it later.*/
+    item = lv_mem_alloc(req_size);
+    LV_ASSERT_MALLOC(item);
+    if(item == NULL) return NULL;
+    item->not_cached = 1;
     return item;
 }
 
 /**********************
  *     FUNCTIONS
  **********************/
+void _lv_gradient_cache_init(void)
+{
+    _lv_hash_lru_init(&_cache, grad_buckets, HASH_BUCKET_CNT, free_item);
+}
+
 void lv_gradient_free_cache(void)
 {
-    lv_mem_free(LV_GC_ROOT(_lv_grad_cache_mem));
-    LV_GC_ROOT(_lv_grad_cache_mem) = grad_cache_end = NULL;
-    grad_cache_size = 0;
+    _lv_hash_lru_drop_matching(&_cache, NULL, NULL);
+
+    lv_mem_free(LV_GC_ROOT(_lv_grad_cache_spare));
+    LV_GC_ROOT(_lv_grad_cache_spare) = NULL;
+    grad_spare_size = 0;
+    grad_spare_in_use = false;
 }
 
 void lv_gradient_set_cache_size(size_t max_bytes)
 {
-    lv_mem_free(LV_GC_ROOT(_lv_grad_cache_mem));
-    grad_cache_end = LV_GC_ROOT(_lv_grad_cache_mem) = lv_mem_alloc(max_bytes);
-    LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_grad_cache_mem));
-    lv_memset_00(LV_GC_ROOT(_lv_grad_cache_mem), max_bytes);
     grad_cache_size = max_bytes;
+    _lv_hash_lru_shrink(&_cache, UINT32_MAX, grad_cache_size, NULL);
 }
 
 lv_grad_t * lv_gradient_get(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
@@ -251,19 +234,15 @@ lv_grad_t * lv_gradient_get(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
     /* No gradient, no cache */
     if(g->dir == LV_GRAD_DIR_NONE) return NULL;
 
-    /* Step 0: Check if the cache exist (else create it) */
-    static bool inited = false;
-    if(!inited) {
-        lv_gradient_set_cache_size(LV_GRAD_CACHE_DEF_SIZE);
-        inited = true;
-    }
+    /* Step 1: Search the cache and the last large gradient for the given parameters */
+    grad_key_t k = {g, w, h};
+    uint32_t key = compute_key(g, w, h);
+    lv_grad_t * item = (lv_grad_t *)_lv_hash_lru_get(&_cache, key, item_matches_key, &k);
+    if(item) return item;
 
-    /* Step 1: Search cache for the given key */
-    lv_coord_t size = g->dir == LV_GRAD_DIR_HOR ? w : h;
-    uint32_t key = compute_key(g, size, w);
-    lv_grad_t * item = NULL;
-    if(iterate_cache(&find_item, &key, &item) == LV_RES_OK) {
-        item->life++; /* Don't forget to bump the counter */
+    item = LV_GC_ROOT(_lv_grad_cache_spare);
+    if(item && !grad_spare_in_use && item_matches(item, g, w, h, key)) {
+        grad_spare_in_use = true;
         return item;
     }
 
@@ -273,6 +252,8 @@ lv_grad_t * lv_gradient_get(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
         LV_LOG_WARN("Faild to allcoate item for teh gradient");
         return item;
     }
+    init_item(item, g, w, h, key);
+    if(!item->not_cached) _lv_hash_lru_add(&_cache, &item->lru, key, get_cache_item_size(item));
 
     /* Step 3: Fill it with the gradient, as expected */
 #if _DITHER_GRADIENT
@@ -338,7 +319,10 @@ lv_grad_color_t LV_ATTRIBUTE_FAST_MEM lv_gradient_calculate(const lv_grad_dsc_t
 
 void lv_gradient_cleanup(lv_grad_t * grad)
 {
-    if(grad->not_cached) {
+    if(grad == LV_GC_ROOT(_lv_grad_cache_spare)) {
+        grad_spare_in_use = false;
+    }
+    else if(grad->not_cached) {
         lv_mem_free(grad);
     }
 }
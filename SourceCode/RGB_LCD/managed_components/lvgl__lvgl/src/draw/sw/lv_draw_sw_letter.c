@@ -18,10 +18,17 @@
 /*********************
  *      DEFINES
  *********************/
+/*The mask of a text run has at most this many rows if the run is as wide as the screen*/
+#define TEXT_RUN_MASK_ROWS  8
 
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct {
+    lv_font_glyph_dsc_t g;
+    lv_area_t coords;       /**< The area of the glyph's bitmap*/
+    uint32_t letter;
+} run_glyph_t;
 
 /**********************
  *  STATIC PROTOTYPES
@@ -35,6 +42,14 @@ static void draw_letter_subpx(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_
                               lv_font_glyph_dsc_t * g, const uint8_t * map_p);
 #endif /*LV_DRAW_COMPLEX && LV_USE_FONT_SUBPX*/
 
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+static void draw_letter_a8(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos,
+                           lv_font_glyph_dsc_t * g, const lv_opa_t * a8_p);
+#endif
+
+static void run_add_glyph(lv_opa_t * mask_buf, const lv_area_t * mask_area, const run_glyph_t * rg);
+static const lv_opa_t * get_opa_table(lv_opa_t opa);
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -139,6 +154,16 @@ void lv_draw_sw_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc
         return;
     }
 
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    if(!g.resolved_font->subpx) {
+        const lv_opa_t * a8_p = _lv_draw_sw_glyph_cache_get(&g, letter);
+        if(a8_p) {
+            draw_letter_a8(draw_ctx, dsc, &gpos, &g, a8_p);
+            return;
+        }
+    }
+#endif
+
     const uint8_t * map_p = lv_font_get_glyph_bitmap(g.resolved_font, letter);
     if(map_p == NULL) {
         LV_LOG_WARN("lv_draw_letter: character's bitmap not found");
@@ -157,6 +182,115 @@ void lv_draw_sw_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc
     }
 }
 
+/**
+ * Draw letters with the same style at once. The coverage of the letters is collected in one mask
+ * which is blended in one step instead of blending each letter separately.
+ * Letters which can't be handled this way (e.g. sub-pixel rendered or missing ones) are drawn one by one.
+ * @param draw_ctx      pointer to a draw context
+ * @param dsc           the style of the letters
+ * @param glyphs        the letters and their positions
+ * @param glyph_cnt     number of elements in `glyphs`
+ */
+void lv_draw_sw_text_run(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                         const lv_draw_label_glyph_t * glyphs, uint32_t glyph_cnt)
+{
+    run_glyph_t * rg = lv_mem_buf_get(glyph_cnt * sizeof(run_glyph_t));
+    uint32_t rg_cnt = 0;
+    lv_area_t run_area;
+
+    uint32_t i;
+    for(i = 0; i < glyph_cnt; i++) {
+        lv_font_glyph_dsc_t * g = &rg[rg_cnt].g;
+        bool g_ret = lv_font_get_glyph_dsc(dsc->font, g, glyphs[i].letter, '\0');
+        if(g_ret == false || g->resolved_font->subpx ||
+           (g->bpp != 1 && g->bpp != 2 && g->bpp != 3 && g->bpp != 4 && g->bpp != 8)) {
+            lv_draw_sw_letter(draw_ctx, dsc, &glyphs[i].pos, glyphs[i].letter);
+            continue;
+        }
+
+        /*Don't draw anything if the character is empty. E.g. space*/
+        if((g->box_h == 0) || (g->box_w == 0)) continue;
+
+        lv_area_t * coords = &rg[rg_cnt].coords;
+        coords->x1 = glyphs[i].pos.x + g->ofs_x;
+        coords->y1 = glyphs[i].pos.y + (dsc->font->line_height - dsc->font->base_line) - g->box_h - g->ofs_y;
+        coords->x2 = coords->x1 + g->box_w - 1;
+        coords->y2 = coords->y1 + g->box_h - 1;
+        if(!_lv_area_is_on(coords, draw_ctx->clip_area)) continue;
+
+        if(rg_cnt == 0) run_area = *coords;
+        else _lv_area_join(&run_area, &run_area, coords);
+
+        rg[rg_cnt].letter = glyphs[i].letter;
+        rg_cnt++;
+    }
+
+    lv_area_t draw_area;
+    if(rg_cnt == 0 || !_lv_area_intersect(&draw_area, &run_area, draw_ctx->clip_area)) {
+        lv_mem_buf_release(rg);
+        return;
+    }
+
+    /*Use a band of rows of the run if the whole run doesn't fit into the mask*/
+    lv_coord_t run_w = lv_area_get_width(&draw_area);
+    lv_coord_t run_h = lv_area_get_height(&draw_area);
+    lv_coord_t hor_res = lv_disp_get_hor_res(_lv_refr_get_disp_refreshing());
+    int32_t band_h = (LV_MAX(hor_res, run_w) * TEXT_RUN_MASK_ROWS) / run_w;
+    if(band_h > run_h) band_h = run_h;
+    lv_opa_t * mask_buf = lv_mem_buf_get(run_w * band_h);
+
+    const lv_opa_t * opa_table = dsc->opa < LV_OPA_MAX ? get_opa_table(dsc->opa) : NULL;
+#if LV_DRAW_COMPLEX
+    bool mask_any = lv_draw_mask_is_any(&draw_area);
+#endif
+
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_memset_00(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.color = dsc->color;
+    blend_dsc.opa = dsc->opa;
+    blend_dsc.blend_mode = dsc->blend_mode;
+    blend_dsc.mask_buf = mask_buf;
+
+    lv_area_t band_area;
+    band_area.x1 = draw_area.x1;
+    band_area.x2 = draw_area.x2;
+    for(band_area.y1 = draw_area.y1; band_area.y1 <= draw_area.y2; band_area.y1 += band_h) {
+        band_area.y2 = LV_MIN(band_area.y1 + band_h - 1, draw_area.y2);
+        uint32_t band_size = (uint32_t)run_w * lv_area_get_height(&band_area);
+        lv_memset_00(mask_buf, band_size);
+
+        for(i = 0; i < rg_cnt; i++) {
+            if(_lv_area_is_on(&rg[i].coords, &band_area)) run_add_glyph(mask_buf, &band_area, &rg[i]);
+        }
+
+        if(opa_table) {
+            uint32_t p;
+            for(p = 0; p < band_size; p++) mask_buf[p] = opa_table[mask_buf[p]];
+        }
+
+#if LV_DRAW_COMPLEX
+        /*Apply masks if any*/
+        if(mask_any) {
+            lv_opa_t * mask_row = mask_buf;
+            lv_coord_t y;
+            for(y = band_area.y1; y <= band_area.y2; y++) {
+                lv_draw_mask_res_t mask_res = lv_draw_mask_apply(mask_row, band_area.x1, y, run_w);
+                if(mask_res == LV_DRAW_MASK_RES_TRANSP) lv_memset_00(mask_row, run_w);
+                mask_row += run_w;
+            }
+        }
+#endif
+
+        blend_dsc.blend_area = &band_area;
+        blend_dsc.mask_area = &band_area;
+        blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+        lv_draw_sw_blend(draw_ctx, &blend_dsc);
+    }
+
+    lv_mem_buf_release(mask_buf);
+    lv_mem_buf_release(rg);
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -350,6 +484,210 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_normal(lv_draw_ctx_t * draw_ctx, c
     lv_mem_buf_release(mask_buf);
 }
 
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+/**
+ * Draw a letter from the glyph cache where each pixel is already an opacity byte.
+ * Opaque, unmasked letters are blended directly from the cache,
+ * else the rows are copied into a mask buffer like in `draw_letter_normal()`.
+ */
+static void draw_letter_a8(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos,
+                           lv_font_glyph_dsc_t * g, const lv_opa_t * a8_p)
+{
+    int32_t box_w = g->box_w;
+    int32_t box_h = g->box_h;
+
+    lv_area_t letter_area;
+    letter_area.x1 = pos->x;
+    letter_area.y1 = pos->y;
+    letter_area.x2 = pos->x + box_w - 1;
+    letter_area.y2 = pos->y + box_h - 1;
+
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_memset_00(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.color = dsc->color;
+    blend_dsc.opa = dsc->opa;
+    blend_dsc.blend_mode = dsc->blend_mode;
+
+#if LV_DRAW_COMPLEX
+    bool mask_any = lv_draw_mask_is_any(&letter_area);
+#else
+    bool mask_any = false;
+#endif
+
+    /*Without anti-aliasing the blending rounds the mask in place so it can't be the cached bitmap*/
+    lv_disp_t * disp = _lv_refr_get_disp_refreshing();
+    if(dsc->opa >= LV_OPA_MAX && !mask_any && disp && disp->driver->antialiasing) {
+        blend_dsc.blend_area = &letter_area;
+        blend_dsc.mask_area = &letter_area;
+        blend_dsc.mask_buf = (lv_opa_t *)a8_p;
+        blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+        lv_draw_sw_blend(draw_ctx, &blend_dsc);
+        return;
+    }
+
+    const lv_opa_t * opa_table = get_opa_table(dsc->opa);
+
+    /*Calculate the col/row start/end on the map*/
+    int32_t col_start = pos->x >= draw_ctx->clip_area->x1 ? 0 : draw_ctx->clip_area->x1 - pos->x;
+    int32_t col_end   = pos->x + box_w <= draw_ctx->clip_area->x2 ? box_w : draw_ctx->clip_area->x2 - pos->x + 1;
+    int32_t row_start = pos->y >= draw_ctx->clip_area->y1 ? 0 : draw_ctx->clip_area->y1 - pos->y;
+    int32_t row_end   = pos->y + box_h <= draw_ctx->clip_area->y2 ? box_h : draw_ctx->clip_area->y2 - pos->y + 1;
+    int32_t fill_w = col_end - col_start;
+    if(fill_w <= 0 || row_end <= row_start) return;
+
+    lv_coord_t hor_res = lv_disp_get_hor_res(disp);
+    uint32_t mask_buf_size = box_w * box_h > hor_res ? hor_res : box_w * box_h;
+    lv_opa_t * mask_buf = lv_mem_buf_get(mask_buf_size);
+    blend_dsc.mask_buf = mask_buf;
+    uint32_t mask_p = 0;
+
+    lv_area_t fill_area;
+    fill_area.x1 = col_start + pos->x;
+    fill_area.x2 = col_end  + pos->x - 1;
+    fill_area.y1 = row_start + pos->y;
+    fill_area.y2 = fill_area.y1;
+    blend_dsc.blend_area = &fill_area;
+    blend_dsc.mask_area = &fill_area;
+
+    const lv_opa_t * src_p = a8_p + row_start * box_w + col_start;
+    int32_t row;
+    for(row = row_start; row < row_end; row++) {
+        int32_t col;
+        for(col = 0; col < fill_w; col++) {
+            mask_buf[mask_p + col] = opa_table[src_p[col]];
+        }
+
+#if LV_DRAW_COMPLEX
+        /*Apply masks if any*/
+        if(mask_any) {
+            lv_draw_mask_res_t mask_res = lv_draw_mask_apply(mask_buf + mask_p, fill_area.x1, fill_area.y2, fill_w);
+            if(mask_res == LV_DRAW_MASK_RES_TRANSP) {
+                lv_memset_00(mask_buf + mask_p, fill_w);
+            }
+        }
+#endif
+        mask_p += fill_w;
+        src_p += box_w;
+
+        if(mask_p + fill_w <= mask_buf_size) {
+            fill_area.y2 ++;
+        }
+        else {
+            blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+            lv_draw_sw_blend(draw_ctx, &blend_dsc);
+
+            fill_area.y1 = fill_area.y2 + 1;
+            fill_area.y2 = fill_area.y1;
+            mask_p = 0;
+        }
+    }
+
+    /*Flush the last part*/
+    if(fill_area.y1 != fill_area.y2) {
+        fill_area.y2--;
+        blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+        lv_draw_sw_blend(draw_ctx, &blend_dsc);
+    }
+
+    lv_mem_buf_release(mask_buf);
+}
+#endif /*LV_USE_DRAW_SW_GLYPH_CACHE*/
+
+/**
+ * Add the coverage of a glyph to the mask of a text run.
+ * The overlapping parts of the glyphs are combined as if they were blended on each other.
+ * @param mask_buf      the mask of the text run
+ * @param mask_area     the area of `mask_buf`
+ * @param rg            the glyph to add, it needs to be on `mask_area`
+ */
+static void run_add_glyph(lv_opa_t * mask_buf, const lv_area_t * mask_area, const run_glyph_t * rg)
+{
+    const lv_font_glyph_dsc_t * g = &rg->g;
+    lv_area_t a;
+    _lv_area_intersect(&a, &rg->coords, mask_area);
+
+    int32_t w = lv_area_get_width(&a);
+    int32_t mask_w = lv_area_get_width(mask_area);
+    int32_t col_start = a.x1 - rg->coords.x1;
+    int32_t row;
+    int32_t x;
+    lv_opa_t * dest = mask_buf + (a.y1 - mask_area->y1) * mask_w + (a.x1 - mask_area->x1);
+
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    const lv_opa_t * a8_p = _lv_draw_sw_glyph_cache_get(g, rg->letter);
+    if(a8_p) {
+        for(row = a.y1 - rg->coords.y1; row <= a.y2 - rg->coords.y1; row++) {
+            const lv_opa_t * src = a8_p + row * g->box_w + col_start;
+            for(x = 0; x < w; x++) {
+                if(src[x]) dest[x] = dest[x] == 0 ? src[x] : dest[x] + LV_UDIV255((uint32_t)src[x] * (255 - dest[x]));
+            }
+            dest += mask_w;
+        }
+        return;
+    }
+#endif
+
+    const uint8_t * map_p = lv_font_get_glyph_bitmap(g->resolved_font, rg->letter);
+    if(map_p == NULL) {
+        LV_LOG_WARN("lv_draw_sw_text_run: character's bitmap not found");
+        return;
+    }
+
+    const uint8_t * bpp_opa_table_p;
+    uint32_t bpp = g->bpp;
+    if(bpp == 3) bpp = 4;
+    switch(bpp) {
+        case 1:
+            bpp_opa_table_p = _lv_bpp1_opa_table;
+            break;
+        case 2:
+            bpp_opa_table_p = _lv_bpp2_opa_table;
+            break;
+        case 4:
+            bpp_opa_table_p = _lv_bpp4_opa_table;
+            break;
+        default:
+            bpp_opa_table_p = _lv_bpp8_opa_table;
+            break;
+    }
+
+    uint32_t px_mask = (1 << bpp) - 1;
+    for(row = a.y1 - rg->coords.y1; row <= a.y2 - rg->coords.y1; row++) {
+        uint32_t bit_ofs = (row * g->box_w + col_start) * bpp;
+        for(x = 0; x < w; x++) {
+            lv_opa_t v = bpp_opa_table_p[(map_p[bit_ofs >> 3] >> (8 - bpp - (bit_ofs & 0x7))) & px_mask];
+            if(v) dest[x] = dest[x] == 0 ? v : dest[x] + LV_UDIV255((uint32_t)v * (255 - dest[x]));
+            bit_ofs += bpp;
+        }
+        dest += mask_w;
+    }
+}
+
+/**
+ * Get a table to scale the opacity of the pixels of a letter the same way as `draw_letter_normal()`
+ * @param opa       the opacity of the letter
+ * @return          an opacity table with 256 elements. Valid until the next call.
+ */
+static const lv_opa_t * get_opa_table(lv_opa_t opa)
+{
+    static lv_opa_t opa_table[256];
+    static lv_opa_t prev_opa = LV_OPA_TRANSP;
+    static bool inited = false;
+
+    if(opa >= LV_OPA_MAX) opa = LV_OPA_COVER;
+    if(!inited || prev_opa != opa) {
+        uint32_t i;
+        for(i = 0; i < 256; i++) {
+            if(opa == LV_OPA_COVER) opa_table[i] = i;
+            else opa_table[i] = i == LV_OPA_COVER ? opa : ((i * opa) >> 8);
+        }
+        prev_opa = opa;
+        inited = true;
+    }
+
+    return opa_table;
+}
+
 #if LV_DRAW_COMPLEX && LV_USE_FONT_SUBPX
 static void draw_letter_subpx(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos,
                               lv_font_glyph_dsc_t * g, const uint8_t * map_p)
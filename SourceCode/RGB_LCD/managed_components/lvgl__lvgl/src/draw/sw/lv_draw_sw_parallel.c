@@ -0,0 +1,251 @@
+/**
+ * @file lv_draw_sw_parallel.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_parallel.h"
+
+#if LV_USE_DRAW_SW_PARALLEL
+
+#include "../../misc/lv_log.h"
+
+#if LV_DRAW_SW_PARALLEL_FREERTOS
+    #ifdef ESP_PLATFORM
+        #include "freertos/FreeRTOS.h"
+        #include "freertos/task.h"
+        #include "freertos/semphr.h"
+    #else
+        #include "FreeRTOS.h"
+        #include "task.h"
+        #include "semphr.h"
+    #endif
+#else
+    #include <pthread.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#if LV_DRAW_SW_PARALLEL_WORKER_CNT < 1
+    #error "LV_DRAW_SW_PARALLEL_WORKER_CNT must be at least 1"
+#endif
+
+/*The calling thread renders a stripe too*/
+#define STRIPE_CNT (LV_DRAW_SW_PARALLEL_WORKER_CNT + 1)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_draw_sw_parallel_cb_t cb;
+    void * user_data;
+    lv_coord_t y1;
+    lv_coord_t y2;
+#if LV_DRAW_SW_PARALLEL_FREERTOS
+    TaskHandle_t task;
+    SemaphoreHandle_t start_sem;
+    SemaphoreHandle_t done_sem;
+#else
+    pthread_t thread;
+    uint32_t job_id_seen;
+#endif
+} worker_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool workers_init(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static worker_t workers[LV_DRAW_SW_PARALLEL_WORKER_CNT];
+static bool inited;
+static bool init_failed;
+static bool enabled = true;
+
+#if LV_DRAW_SW_PARALLEL_FREERTOS == 0
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t start_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+static uint32_t job_id;
+static uint32_t pending_cnt;
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_draw_sw_parallel_set_enabled(bool en)
+{
+    enabled = en;
+}
+
+bool lv_draw_sw_parallel_is_enabled(void)
+{
+    return enabled;
+}
+
+bool _lv_draw_sw_parallel_should_split(lv_coord_t w, lv_coord_t h)
+{
+    if(!enabled || init_failed) return false;
+    if(h < 2) return false;
+    return (int32_t)w * h >= LV_DRAW_SW_PARALLEL_MIN_PX;
+}
+
+void _lv_draw_sw_parallel_run(lv_draw_sw_parallel_cb_t cb, void * user_data, lv_coord_t h)
+{
+    if(h <= 0) return;
+
+    if(!enabled || h < 2 || !workers_init()) {
+        cb(user_data, 0, h - 1);
+        return;
+    }
+
+    /*Distribute the remainder rows among the first stripes. The calling thread takes the first stripe.*/
+    lv_coord_t stripe_h = h / STRIPE_CNT;
+    lv_coord_t rem = h % STRIPE_CNT;
+    lv_coord_t y = stripe_h + (rem > 0 ? 1 : 0);
+    lv_coord_t own_y2 = y - 1;
+
+    uint32_t i;
+    for(i = 0; i < LV_DRAW_SW_PARALLEL_WORKER_CNT; i++) {
+        lv_coord_t act_h = stripe_h + ((lv_coord_t)(i + 1) < rem ? 1 : 0);
+        workers[i].cb = cb;
+        workers[i].user_data = user_data;
+        workers[i].y1 = y;
+        workers[i].y2 = y + act_h - 1;     /*Might be empty (y2 < y1) if there are only a few rows*/
+        y += act_h;
+    }
+
+#if LV_DRAW_SW_PARALLEL_FREERTOS
+    for(i = 0; i < LV_DRAW_SW_PARALLEL_WORKER_CNT; i++) {
+        xSemaphoreGive(workers[i].start_sem);
+    }
+
+    cb(user_data, 0, own_y2);
+
+    for(i = 0; i < LV_DRAW_SW_PARALLEL_WORKER_CNT; i++) {
+        xSemaphoreTake(workers[i].done_sem, portMAX_DELAY);
+    }
+#else
+    pthread_mutex_lock(&lock);
+    pending_cnt = LV_DRAW_SW_PARALLEL_WORKER_CNT;
+    job_id++;
+    pthread_cond_broadcast(&start_cond);
+    pthread_mutex_unlock(&lock);
+
+    cb(user_data, 0, own_y2);
+
+    pthread_mutex_lock(&lock);
+    while(pending_cnt) {
+        pthread_cond_wait(&done_cond, &lock);
+    }
+    pthread_mutex_unlock(&lock);
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if LV_DRAW_SW_PARALLEL_FREERTOS
+
+static void worker_task(void * param)
+{
+    worker_t * w = param;
+    while(1) {
+        xSemaphoreTake(w->start_sem, portMAX_DELAY);
+        if(w->y1 <= w->y2) w->cb(w->user_data, w->y1, w->y2);
+        xSemaphoreGive(w->done_sem);
+    }
+}
+
+static bool workers_init(void)
+{
+    if(inited) return true;
+    if(init_failed) return false;
+
+    uint32_t i;
+    for(i = 0; i < LV_DRAW_SW_PARALLEL_WORKER_CNT; i++) {
+        workers[i].start_sem = xSemaphoreCreateBinary();
+        workers[i].done_sem = xSemaphoreCreateBinary();
+        if(workers[i].start_sem == NULL || workers[i].done_sem == NULL) {
+            LV_LOG_WARN("couldn't create the semaphores of a worker. Rendering on a single thread.");
+            init_failed = true;
+            return false;
+        }
+
+        BaseType_t res;
+#if defined(ESP_PLATFORM) && LV_DRAW_SW_PARALLEL_CORE >= 0
+        res = xTaskCreatePinnedToCore(worker_task, "lv_draw_sw", LV_DRAW_SW_PARALLEL_STACK_SIZE, &workers[i],
+                                      LV_DRAW_SW_PARALLEL_TASK_PRIO, &workers[i].task, LV_DRAW_SW_PARALLEL_CORE);
+#else
+        res = xTaskCreate(worker_task, "lv_draw_sw", LV_DRAW_SW_PARALLEL_STACK_SIZE, &workers[i],
+                          LV_DRAW_SW_PARALLEL_TASK_PRIO, &workers[i].task);
+#endif
+        if(res != pdPASS) {
+            LV_LOG_WARN("couldn't create a worker task. Rendering on a single thread.");
+            init_failed = true;
+            return false;
+        }
+    }
+
+    inited = true;
+    return true;
+}
+
+#else /*LV_DRAW_SW_PARALLEL_FREERTOS*/
+
+static void * worker_thread(void * param)
+{
+    worker_t * w = param;
+
+    pthread_mutex_lock(&lock);
+    while(1) {
+        while(w->job_id_seen == job_id) {
+            pthread_cond_wait(&start_cond, &lock);
+        }
+        w->job_id_seen = job_id;
+        pthread_mutex_unlock(&lock);
+
+        if(w->y1 <= w->y2) w->cb(w->user_data, w->y1, w->y2);
+
+        pthread_mutex_lock(&lock);
+        pending_cnt--;
+        if(pending_cnt == 0) pthread_cond_signal(&done_cond);
+    }
+
+    return NULL;
+}
+
+static bool workers_init(void)
+{
+    if(inited) return true;
+    if(init_failed) return false;
+
+    uint32_t i;
+    for(i = 0; i < LV_DRAW_SW_PARALLEL_WORKER_CNT; i++) {
+        /*Don't let the worker run a job issued before it was started*/
+        workers[i].job_id_seen = job_id;
+        if(pthread_create(&workers[i].thread, NULL, worker_thread, &workers[i]) != 0) {
+            LV_LOG_WARN("couldn't create a worker thread. Rendering on a single thread.");
+            init_failed = true;
+            return false;
+        }
+    }
+
+    inited = true;
+    return true;
+}
+
+#endif /*LV_DRAW_SW_PARALLEL_FREERTOS*/
+
+#endif /*LV_USE_DRAW_SW_PARALLEL*/
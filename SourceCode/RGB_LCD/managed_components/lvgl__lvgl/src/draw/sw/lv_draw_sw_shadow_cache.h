@@ -0,0 +1,91 @@
+/**
+ * @file lv_draw_sw_shadow_cache.h
+ *
+ */
+
+#ifndef LV_DRAW_SW_SHADOW_CACHE_H
+#define LV_DRAW_SW_SHADOW_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lv_conf_internal.h"
+#include "../../misc/lv_area.h"
+#include "../../misc/lv_color.h"
+
+#if LV_DRAW_COMPLEX && defined(LV_SHADOW_CACHE_SIZE) && LV_SHADOW_CACHE_SIZE > 0
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    uint32_t size;          /**< Size of the cache in bytes (`LV_SHADOW_CACHE_SIZE^2` by default)*/
+    uint32_t used;          /**< The current total size of the cached corners in bytes*/
+    uint32_t entry_cnt;     /**< Number of cached corners*/
+    uint32_t hit_cnt;       /**< Number of times a corner was found in the cache*/
+    uint32_t miss_cnt;      /**< Number of times a corner had to be calculated*/
+} lv_draw_sw_shadow_cache_info_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Look up a blurred shadow corner.
+ * @param sw        shadow width
+ * @param r         radius of the shadow, clamped to the size of the shadow's core area
+ * @param w         width of the shadow's core area
+ * @param h         height of the shadow's core area
+ * @return          pointer to the `(sw + r)^2` bytes of the corner or NULL if it's not cached.
+ *                  Valid until the next `_lv_draw_sw_shadow_cache_add()`.
+ */
+const lv_opa_t * _lv_draw_sw_shadow_cache_get(lv_coord_t sw, lv_coord_t r, lv_coord_t w, lv_coord_t h);
+
+/**
+ * Cache a blurred shadow corner. The least recently used corners are dropped if there is no space for it.
+ * Corners larger than the whole cache are ignored.
+ * @param sw        shadow width
+ * @param r         radius of the shadow, clamped to the size of the shadow's core area
+ * @param w         width of the shadow's core area
+ * @param h         height of the shadow's core area
+ * @param buf       the `(sw + r)^2` bytes of the corner
+ */
+void _lv_draw_sw_shadow_cache_add(lv_coord_t sw, lv_coord_t r, lv_coord_t w, lv_coord_t h, const lv_opa_t * buf);
+
+/**
+ * Limit the total size of the cached corners. The least recently used corners are dropped to fit into the new size.
+ * @param size      the new size in bytes. Clamped to `LV_SHADOW_CACHE_SIZE^2`, 0: disable caching
+ */
+void lv_draw_sw_shadow_cache_set_size(uint32_t size);
+
+/**
+ * Get the current state of the shadow cache
+ * @param info      store the result here
+ */
+void lv_draw_sw_shadow_cache_get_info(lv_draw_sw_shadow_cache_info_t * info);
+
+/**
+ * Drop all the cached corners and reset the hit/miss counters.
+ */
+void lv_draw_sw_shadow_cache_clear(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_SHADOW_CACHE_H*/
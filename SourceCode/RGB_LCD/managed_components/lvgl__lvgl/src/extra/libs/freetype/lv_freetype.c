@@ -17,6 +17,10 @@
 #include FT_IMAGE_H
 #include FT_OUTLINE_H
 
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    #include "../../../draw/sw/lv_draw_sw_glyph_cache.h"
+#endif
+
 /*********************
  *      DEFINES
  *********************/
@@ -169,6 +173,10 @@ bool lv_ft_font_init(lv_ft_info_t * info)
 
 void lv_ft_font_destroy(lv_font_t * font)
 {
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    lv_draw_sw_glyph_cache_drop_font(font);
+#endif
+
 #if LV_FREETYPE_CACHE_SIZE >= 0
     lv_ft_font_destroy_cache(font);
 #else
@@ -3,6 +3,9 @@
 #if LV_USE_TINY_TTF
 #include <stdio.h>
 #include "../../../misc/lv_lru.h"
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    #include "../../../draw/sw/lv_draw_sw_glyph_cache.h"
+#endif
 
 #define STB_RECT_PACK_IMPLEMENTATION
 #define STBRP_STATIC
@@ -264,10 +267,16 @@ void lv_tiny_ttf_set_size(lv_font_t * font, lv_coord_t font_size)
     stbtt_GetFontVMetrics(&dsc->info, &dsc->ascent, &dsc->descent, &line_gap);
     font->line_height = (lv_coord_t)(dsc->scale * (dsc->ascent - dsc->descent + line_gap));
     font->base_line = (lv_coord_t)(dsc->scale * (line_gap - dsc->descent));
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    lv_draw_sw_glyph_cache_drop_font(font);
+#endif
 }
 void lv_tiny_ttf_destroy(lv_font_t * font)
 {
     if(font != NULL) {
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+        lv_draw_sw_glyph_cache_drop_font(font);
+#endif
         if(font->dsc != NULL) {
             ttf_font_desc_t * ttf = (ttf_font_desc_t *)font->dsc;
 #if LV_TINY_TTF_FILE_SUPPORT
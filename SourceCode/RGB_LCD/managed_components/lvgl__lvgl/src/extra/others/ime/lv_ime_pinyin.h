@@ -59,8 +59,8 @@ typedef struct {
     uint16_t ta_count;          /* The number of characters entered in the text box this time */
     uint16_t cand_num;          /* Number of candidates */
     uint16_t py_page;           /* Current pinyin map pages(k26) */
-    uint16_t py_num[26];        /* Number and length of Pinyin */
-    uint16_t py_pos[26];        /* Pinyin position */
+    uint16_t * dict_index;      /* Entries of the dictionary sorted by pinyin. NULL if the dictionary is sorted */
+    uint32_t dict_num;          /* Number of entries in the dictionary */
     uint8_t  mode : 1;          /* Set mode, 1: 26-key input(k26), 0: 9-key input(k9). Default: 1. */
 } lv_ime_pinyin_t;
 
@@ -86,6 +86,8 @@ void lv_ime_pinyin_set_keyboard(lv_obj_t * obj, lv_obj_t * kb);
 
 /**
  * Set the dictionary of Pinyin input method.
+ * If the entries are not sorted by their pinyin, a sorted index of them is allocated.
+ * An unsorted dictionary with more than 65535 entries is rejected and the current dictionary is kept.
  * @param obj  pointer to a Pinyin input method object
  * @param dict pointer to a Pinyin input method dictionary
  */
@@ -11,17 +11,55 @@
 #include "../misc/lv_assert.h"
 #include "../misc/lv_types.h"
 #include "../misc/lv_gc.h"
+#include "../misc/lv_hash_lru.h"
 #include "../misc/lv_log.h"
 #include "../misc/lv_utils.h"
 #include "../misc/lv_mem.h"
+#include "../misc/lv_printf.h"
 
 /*********************
  *      DEFINES
  *********************/
+#define _lookup_head LV_GC_ROOT(_lv_font_fmt_txt_lookup_head)
+
+#define _decompr_cache LV_GC_ROOT(_lv_font_decompr_cache)
+
+#define DECOMPR_BUCKET_CNT  32
+
+#if LV_FONT_KERN_CACHE_SIZE & (LV_FONT_KERN_CACHE_SIZE - 1)
+    #error "LV_FONT_KERN_CACHE_SIZE must be a power of 2"
+#endif
 
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct _lv_font_fmt_txt_lookup_t {
+    struct _lv_font_fmt_txt_lookup_t * next;    /*The next table in the list of all tables*/
+    lv_font_fmt_txt_glyph_cache_t * cache;      /*The cache of the font this table belongs to*/
+    uint32_t * letters;                         /*The letter in each slot, 0 for empty slots*/
+    uint16_t * glyph_ids;                       /*The glyph id of the letter in the same slot*/
+    uint32_t size;                              /*Size of the table in bytes*/
+    uint32_t mask;                              /*Number of slots - 1*/
+} lv_font_fmt_txt_lookup_t;
+
+#if LV_FONT_KERN_CACHE_SIZE
+typedef struct {
+    const void * kern_dsc;      /*The kerning pairs of the font, NULL for empty entries*/
+    uint16_t gid_left;
+    uint16_t gid_right;
+    int8_t value;
+} kern_cache_entry_t;
+#endif
+
+#if LV_USE_FONT_COMPRESSED
+typedef struct {
+    _lv_hash_lru_entry_t lru;               /*Must be the first. Its size is the size of `buf`.*/
+    const lv_font_fmt_txt_dsc_t * fdsc;
+    uint32_t gid;
+    uint8_t * buf;
+} decompr_entry_t;
+#endif
+
 typedef enum {
     RLE_STATE_SINGLE = 0,
     RLE_STATE_REPEATE,
@@ -36,6 +74,12 @@ static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t
 static int32_t unicode_list_compare(const void * ref, const void * element);
 static int32_t kern_pair_8_compare(const void * ref, const void * element);
 static int32_t kern_pair_16_compare(const void * ref, const void * element);
+static void lookup_build(const lv_font_fmt_txt_dsc_t * fdsc);
+static void lookup_free(lv_font_fmt_txt_glyph_cache_t * cache);
+static uint32_t lookup_get(const lv_font_fmt_txt_lookup_t * lookup, uint32_t letter);
+static int8_t get_kern_pair_value(const lv_font_fmt_txt_kern_pair_t * kdsc, uint32_t gid_left, uint32_t gid_right);
+static uint32_t kern_classes_assign(const int8_t * values, uint32_t cnt, uint32_t len, uint32_t stride, uint32_t step,
+                                    uint8_t * class_of);
 
 #if LV_USE_FONT_COMPRESSED
     static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord_t h, uint8_t bpp, bool prefilter);
@@ -44,6 +88,11 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element);
     static inline void bits_write(uint8_t * out, uint32_t bit_pos, uint8_t val, uint8_t len);
     static inline void rle_init(const uint8_t * in,  uint8_t bpp);
     static inline uint8_t rle_next(void);
+    static uint8_t * decompr_cache_get(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t gid, const uint8_t * bitmap,
+                                       uint32_t buf_size);
+    static bool decompr_entry_match(const _lv_hash_lru_entry_t * entry, const void * key);
+    static bool decompr_entry_match_fdsc(const _lv_hash_lru_entry_t * entry, const void * fdsc);
+    static void decompr_entry_free(_lv_hash_lru_entry_t * entry);
 #endif /*LV_USE_FONT_COMPRESSED*/
 
 /**********************
@@ -56,8 +105,15 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element);
     static uint8_t rle_prev_v;
     static uint8_t rle_cnt;
     static rle_state_t rle_state;
+
+    static _lv_hash_lru_entry_t * decompr_buckets[DECOMPR_BUCKET_CNT];
+    static uint32_t decompr_cache_size;
 #endif /*LV_USE_FONT_COMPRESSED*/
 
+#if LV_FONT_KERN_CACHE_SIZE
+    static kern_cache_entry_t kern_cache[LV_FONT_KERN_CACHE_SIZE];
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -85,13 +141,27 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
     if(!gid) return NULL;
 
     const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+    return _lv_font_fmt_txt_get_bitmap_by_id(font, gid, &fdsc->glyph_bitmap[gdsc->bitmap_index]);
+}
+
+/**
+ * Get the bitmap of a glyph to draw from the bitmap stored in the font. Decompress it if required.
+ * @param font      pointer to a font in `lv_font_fmt_txt` format
+ * @param gid       id of the glyph
+ * @param bitmap    the bitmap of the glyph as stored in the font (plain or compressed)
+ * @return          the bitmap to draw or NULL on error
+ */
+const uint8_t * _lv_font_fmt_txt_get_bitmap_by_id(const lv_font_t * font, uint32_t gid, const uint8_t * bitmap)
+{
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
 
     if(fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
-        return &fdsc->glyph_bitmap[gdsc->bitmap_index];
+        return bitmap;
     }
     /*Handle compressed bitmap*/
     else {
 #if LV_USE_FONT_COMPRESSED
+        const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
         static size_t last_buf_size = 0;
         if(LV_GC_ROOT(_lv_font_decompr_buf) == NULL) last_buf_size = 0;
 
@@ -115,6 +185,11 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
                 break;
         }
 
+        /*Use the already decompressed glyph or decompress it into the cache*/
+        uint8_t * cached = decompr_cache_get(fdsc, gid, bitmap, buf_size);
+        if(cached) return cached;
+
+        /*Doesn't fit into the cache, use a temporary buffer*/
         if(last_buf_size < buf_size) {
             uint8_t * tmp = lv_mem_realloc(LV_GC_ROOT(_lv_font_decompr_buf), buf_size);
             LV_ASSERT_MALLOC(tmp);
@@ -124,10 +199,10 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
         }
 
         bool prefilter = fdsc->bitmap_format == LV_FONT_FMT_TXT_COMPRESSED ? true : false;
-        decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], LV_GC_ROOT(_lv_font_decompr_buf), gdsc->box_w, gdsc->box_h,
-                   (uint8_t)fdsc->bpp, prefilter);
+        decompress(bitmap, LV_GC_ROOT(_lv_font_decompr_buf), gdsc->box_w, gdsc->box_h, (uint8_t)fdsc->bpp, prefilter);
         return LV_GC_ROOT(_lv_font_decompr_buf);
 #else /*!LV_USE_FONT_COMPRESSED*/
+        LV_UNUSED(gid);
         LV_LOG_WARN("Compressed fonts is used but LV_USE_FONT_COMPRESSED is not enabled in lv_conf.h");
         return NULL;
 #endif
@@ -189,6 +264,18 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
     return true;
 }
 
+/**
+ * Get the id of a glyph
+ * @param font      pointer to a font in `lv_font_fmt_txt` format
+ * @param letter    a Unicode letter
+ * @return          id of the glyph or 0 if the letter is not in the font
+ */
+uint32_t _lv_font_fmt_txt_get_glyph_id(const lv_font_t * font, uint32_t letter)
+{
+    if(letter == '\t') letter = ' ';
+    return get_glyph_dsc_id(font, letter);
+}
+
 /**
  * Free the allocated memories.
  */
@@ -202,6 +289,192 @@ void _lv_font_clean_up_fmt_txt(void)
 #endif
 }
 
+void lv_font_fmt_txt_set_lookup(const lv_font_t * font, bool en)
+{
+    LV_ASSERT_NULL(font);
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+    if(fdsc->cache == NULL) {
+        LV_LOG_WARN("The font has no glyph cache, can't use a lookup table");
+        return;
+    }
+
+    fdsc->cache->lookup_en = en ? 1 : 0;
+    fdsc->cache->lookup_failed = 0;
+    if(!en) lookup_free(fdsc->cache);
+}
+
+uint32_t lv_font_fmt_txt_get_lookup_size(const lv_font_t * font)
+{
+    LV_ASSERT_NULL(font);
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+    if(fdsc->cache == NULL || fdsc->cache->lookup == NULL) return 0;
+
+    return fdsc->cache->lookup->size;
+}
+
+void _lv_font_fmt_txt_free_lookups(void)
+{
+    while(_lookup_head) {
+        lookup_free(_lookup_head->cache);
+    }
+}
+
+lv_font_fmt_txt_kern_classes_t * lv_font_fmt_txt_kern_pairs_to_classes(const lv_font_fmt_txt_kern_pair_t * kern_pair,
+                                                                        uint32_t glyph_cnt)
+{
+    LV_ASSERT_NULL(kern_pair);
+
+    lv_font_fmt_txt_kern_classes_t * kdsc = lv_mem_alloc(sizeof(lv_font_fmt_txt_kern_classes_t));
+    uint8_t * left_mapping = lv_mem_alloc(glyph_cnt);
+    uint8_t * right_mapping = lv_mem_alloc(glyph_cnt);
+    int8_t * matrix = NULL;
+    int8_t * values = NULL;
+    if(kdsc == NULL || left_mapping == NULL || right_mapping == NULL) goto fail;
+
+    /*Give an index to each glyph which is on the left or right side of a pair*/
+    lv_memset_00(left_mapping, glyph_cnt);
+    lv_memset_00(right_mapping, glyph_cnt);
+    uint32_t left_cnt = 0;
+    uint32_t right_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < kern_pair->pair_cnt; i++) {
+        uint32_t gid_left;
+        uint32_t gid_right;
+        if(kern_pair->glyph_ids_size == 0) {
+            gid_left = ((const uint8_t *)kern_pair->glyph_ids)[i * 2];
+            gid_right = ((const uint8_t *)kern_pair->glyph_ids)[i * 2 + 1];
+        }
+        else {
+            gid_left = ((const uint16_t *)kern_pair->glyph_ids)[i * 2];
+            gid_right = ((const uint16_t *)kern_pair->glyph_ids)[i * 2 + 1];
+        }
+
+        if(gid_left >= glyph_cnt || gid_right >= glyph_cnt) goto fail;
+        if(left_mapping[gid_left] == 0) {
+            if(left_cnt == UINT8_MAX) goto fail;
+            left_cnt++;
+            left_mapping[gid_left] = left_cnt;
+        }
+        if(right_mapping[gid_right] == 0) {
+            if(right_cnt == UINT8_MAX) goto fail;
+            right_cnt++;
+            right_mapping[gid_right] = right_cnt;
+        }
+    }
+
+    /*Put all the values into a left_cnt * right_cnt matrix*/
+    matrix = lv_mem_alloc(LV_MAX(left_cnt * right_cnt, 1));
+    if(matrix == NULL) goto fail;
+    lv_memset_00(matrix, left_cnt * right_cnt);
+    for(i = 0; i < kern_pair->pair_cnt; i++) {
+        uint32_t gid_left;
+        uint32_t gid_right;
+        if(kern_pair->glyph_ids_size == 0) {
+            gid_left = ((const uint8_t *)kern_pair->glyph_ids)[i * 2];
+            gid_right = ((const uint8_t *)kern_pair->glyph_ids)[i * 2 + 1];
+        }
+        else {
+            gid_left = ((const uint16_t *)kern_pair->glyph_ids)[i * 2];
+            gid_right = ((const uint16_t *)kern_pair->glyph_ids)[i * 2 + 1];
+        }
+        matrix[(left_mapping[gid_left] - 1) * right_cnt + right_mapping[gid_right] - 1] = kern_pair->values[i];
+    }
+
+    /*The glyphs with the same row/column share a class*/
+    uint8_t left_class_of[UINT8_MAX];
+    uint8_t right_class_of[UINT8_MAX];
+    uint32_t left_class_cnt = kern_classes_assign(matrix, left_cnt, right_cnt, right_cnt, 1, left_class_of);
+    uint32_t right_class_cnt = kern_classes_assign(matrix, right_cnt, left_cnt, 1, right_cnt, right_class_of);
+
+    values = lv_mem_alloc(LV_MAX(left_class_cnt * right_class_cnt, 1));
+    if(values == NULL) goto fail;
+
+    uint32_t row;
+    uint32_t col;
+    for(row = 0; row < left_cnt; row++) {
+        if(left_class_of[row] == 0) continue;
+        for(col = 0; col < right_cnt; col++) {
+            if(right_class_of[col] == 0) continue;
+            values[(left_class_of[row] - 1) * right_class_cnt + right_class_of[col] - 1] = matrix[row * right_cnt + col];
+        }
+    }
+    lv_mem_free(matrix);
+
+    for(i = 0; i < glyph_cnt; i++) {
+        if(left_mapping[i]) left_mapping[i] = left_class_of[left_mapping[i] - 1];
+        if(right_mapping[i]) right_mapping[i] = right_class_of[right_mapping[i] - 1];
+    }
+
+    kdsc->class_pair_values = values;
+    kdsc->left_class_mapping = left_mapping;
+    kdsc->right_class_mapping = right_mapping;
+    kdsc->left_class_cnt = left_class_cnt;
+    kdsc->right_class_cnt = right_class_cnt;
+
+    LV_LOG_INFO("%"LV_PRIu32" kerning pairs converted to %"LV_PRIu32" x %"LV_PRIu32" classes",
+                (uint32_t)kern_pair->pair_cnt, left_class_cnt, right_class_cnt);
+
+    return kdsc;
+
+fail:
+    LV_LOG_WARN("Couldn't convert the kerning pairs to classes");
+    if(kdsc) lv_mem_free(kdsc);
+    if(left_mapping) lv_mem_free(left_mapping);
+    if(right_mapping) lv_mem_free(right_mapping);
+    if(matrix) lv_mem_free(matrix);
+    return NULL;
+}
+
+void _lv_font_fmt_txt_kern_cache_clear(void)
+{
+#if LV_FONT_KERN_CACHE_SIZE
+    lv_memset_00(kern_cache, sizeof(kern_cache));
+#endif
+}
+
+#if LV_USE_FONT_COMPRESSED
+
+void _lv_font_fmt_txt_decompr_cache_init(void)
+{
+    _lv_hash_lru_init(&_decompr_cache, decompr_buckets, DECOMPR_BUCKET_CNT, decompr_entry_free);
+    decompr_cache_size = LV_FONT_DECOMPR_CACHE_SIZE;
+}
+
+void lv_font_fmt_txt_decompr_cache_set_size(uint32_t size)
+{
+    decompr_cache_size = size;
+
+    /*Drop the least recently used glyphs to fit into the new size*/
+    _lv_hash_lru_shrink(&_decompr_cache, UINT32_MAX, decompr_cache_size, NULL);
+}
+
+void lv_font_fmt_txt_decompr_cache_get_info(lv_font_fmt_txt_decompr_cache_info_t * info)
+{
+    LV_ASSERT_NULL(info);
+
+    info->size = decompr_cache_size;
+    info->used = _decompr_cache.used;
+    info->entry_cnt = _decompr_cache.entry_cnt;
+    info->hit_cnt = _decompr_cache.hit_cnt;
+    info->miss_cnt = _decompr_cache.miss_cnt;
+}
+
+void lv_font_fmt_txt_decompr_cache_clear(void)
+{
+    _lv_hash_lru_drop_matching(&_decompr_cache, NULL, NULL);
+    _decompr_cache.hit_cnt = 0;
+    _decompr_cache.miss_cnt = 0;
+}
+
+void lv_font_fmt_txt_decompr_cache_drop_font(const lv_font_t * font)
+{
+    LV_ASSERT_NULL(font);
+
+    _lv_hash_lru_drop_matching(&_decompr_cache, decompr_entry_match_fdsc, font->dsc);
+}
+
+#endif /*LV_USE_FONT_COMPRESSED*/
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -215,12 +488,23 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
     /*Check the cache first*/
     if(fdsc->cache && letter == fdsc->cache->last_letter) return fdsc->cache->last_glyph_id;
 
+    /*Use the lookup table if enabled*/
+    if(fdsc->cache && fdsc->cache->lookup_en) {
+        if(fdsc->cache->lookup == NULL && !fdsc->cache->lookup_failed) lookup_build(fdsc);
+        if(fdsc->cache->lookup) {
+            uint32_t glyph_id = lookup_get(fdsc->cache->lookup, letter);
+            fdsc->cache->last_letter = letter;
+            fdsc->cache->last_glyph_id = glyph_id;
+            return glyph_id;
+        }
+    }
+
     uint16_t i;
     for(i = 0; i < fdsc->cmap_num; i++) {
 
         /*Relative code point*/
         uint32_t rcp = letter - fdsc->cmaps[i].range_start;
-        if(rcp > fdsc->cmaps[i].range_length) continue;
+        if(rcp >= fdsc->cmaps[i].range_length) continue;
         uint32_t glyph_id = 0;
         if(fdsc->cmaps[i].type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY) {
             glyph_id = fdsc->cmaps[i].glyph_id_start + rcp;
@@ -267,6 +551,124 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 
 }
 
+/**
+ * Tell if a letter is in the range of an earlier cmap than `cmap_i`.
+ * Such letters are resolved by the earlier cmap.
+ */
+static bool lookup_in_earlier_cmap(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t cmap_i, uint32_t letter)
+{
+    uint32_t i;
+    for(i = 0; i < cmap_i; i++) {
+        if(letter - fdsc->cmaps[i].range_start < fdsc->cmaps[i].range_length) return true;
+    }
+    return false;
+}
+
+static void lookup_insert(lv_font_fmt_txt_lookup_t * lookup, uint32_t letter, uint32_t glyph_id)
+{
+    uint32_t slot = _lv_hash_lru_hash(NULL, letter) & lookup->mask;
+    while(lookup->letters[slot] != 0) {
+        slot = (slot + 1) & lookup->mask;
+    }
+
+    lookup->letters[slot] = letter;
+    lookup->glyph_ids[slot] = glyph_id;
+}
+
+static uint32_t lookup_get(const lv_font_fmt_txt_lookup_t * lookup, uint32_t letter)
+{
+    uint32_t slot = _lv_hash_lru_hash(NULL, letter) & lookup->mask;
+    while(lookup->letters[slot] != 0) {
+        if(lookup->letters[slot] == letter) return lookup->glyph_ids[slot];
+        slot = (slot + 1) & lookup->mask;
+    }
+
+    return 0;
+}
+
+/**
+ * Put all the letters of the cmaps into a hash table with open addressing.
+ * The table is at most 75% full so a letter is found in a few steps.
+ */
+static void lookup_build(const lv_font_fmt_txt_dsc_t * fdsc)
+{
+    uint32_t letter_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &fdsc->cmaps[i];
+        if(cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY || cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL) {
+            letter_cnt += cmap->list_length;
+        }
+        else {
+            letter_cnt += cmap->range_length;
+        }
+    }
+
+    uint32_t slot_cnt = 16;
+    while(slot_cnt < letter_cnt + letter_cnt / 3 + 1) slot_cnt <<= 1;
+
+    uint32_t size = sizeof(lv_font_fmt_txt_lookup_t) + slot_cnt * (sizeof(uint32_t) + sizeof(uint16_t));
+    lv_font_fmt_txt_lookup_t * lookup = lv_mem_alloc(size);
+    if(lookup == NULL) {
+        LV_LOG_WARN("Couldn't allocate %"LV_PRIu32" bytes for the lookup table of a font", size);
+        fdsc->cache->lookup_failed = 1;
+        return;
+    }
+
+    lookup->cache = fdsc->cache;
+    lookup->letters = (uint32_t *)(lookup + 1);
+    lookup->glyph_ids = (uint16_t *)(lookup->letters + slot_cnt);
+    lookup->size = size;
+    lookup->mask = slot_cnt - 1;
+    lv_memset_00(lookup->letters, slot_cnt * sizeof(uint32_t));
+
+    for(i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &fdsc->cmaps[i];
+        bool sparse = cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY || cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL;
+        uint32_t cnt = sparse ? cmap->list_length : cmap->range_length;
+        uint32_t j;
+        for(j = 0; j < cnt; j++) {
+            uint32_t rcp = sparse ? cmap->unicode_list[j] : j;
+            uint32_t letter = cmap->range_start + rcp;
+            uint32_t glyph_id = cmap->glyph_id_start;
+            if(cmap->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY) glyph_id += rcp;
+            else if(cmap->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL) glyph_id += ((const uint8_t *)cmap->glyph_id_ofs_list)[rcp];
+            else if(cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY) glyph_id += j;
+            else glyph_id += ((const uint16_t *)cmap->glyph_id_ofs_list)[j];
+
+            if(letter == 0 || lookup_in_earlier_cmap(fdsc, i, letter)) continue;
+
+            if(glyph_id > UINT16_MAX) {
+                LV_LOG_WARN("Too many glyphs for a lookup table");
+                lv_mem_free(lookup);
+                fdsc->cache->lookup_failed = 1;
+                return;
+            }
+
+            lookup_insert(lookup, letter, glyph_id);
+        }
+    }
+
+    lookup->next = _lookup_head;
+    _lookup_head = lookup;
+    fdsc->cache->lookup = lookup;
+
+    LV_LOG_INFO("Lookup table with %"LV_PRIu32" letters in %"LV_PRIu32" bytes", letter_cnt, size);
+}
+
+static void lookup_free(lv_font_fmt_txt_glyph_cache_t * cache)
+{
+    lv_font_fmt_txt_lookup_t * lookup = cache->lookup;
+    if(lookup == NULL) return;
+
+    lv_font_fmt_txt_lookup_t ** p = &_lookup_head;
+    while(*p != lookup) p = &(*p)->next;
+    *p = lookup->next;
+
+    cache->lookup = NULL;
+    lv_mem_free(lookup);
+}
+
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right)
 {
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
@@ -276,36 +678,22 @@ static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t
     if(fdsc->kern_classes == 0) {
         /*Kern pairs*/
         const lv_font_fmt_txt_kern_pair_t * kdsc = fdsc->kern_dsc;
-        if(kdsc->glyph_ids_size == 0) {
-            /*Use binary search to find the kern value.
-             *The pairs are ordered left_id first, then right_id secondly.*/
-            const uint16_t * g_ids = kdsc->glyph_ids;
-            uint16_t g_id_both = (gid_right << 8) + gid_left; /*Create one number from the ids*/
-            uint16_t * kid_p = _lv_utils_bsearch(&g_id_both, g_ids, kdsc->pair_cnt, 2, kern_pair_8_compare);
-
-            /*If the `g_id_both` were found get its index from the pointer*/
-            if(kid_p) {
-                lv_uintptr_t ofs = kid_p - g_ids;
-                value = kdsc->values[ofs];
-            }
+#if LV_FONT_KERN_CACHE_SIZE
+        /*The same pairs come again and again, so remember the recent ones*/
+        uint32_t i = (gid_left * 31 + gid_right + ((lv_uintptr_t)kdsc >> 3)) & (LV_FONT_KERN_CACHE_SIZE - 1);
+        kern_cache_entry_t * entry = &kern_cache[i];
+        if(entry->kern_dsc == kdsc && entry->gid_left == gid_left && entry->gid_right == gid_right) {
+            return entry->value;
         }
-        else if(kdsc->glyph_ids_size == 1) {
-            /*Use binary search to find the kern value.
-             *The pairs are ordered left_id first, then right_id secondly.*/
-            const uint32_t * g_ids = kdsc->glyph_ids;
-            uint32_t g_id_both = (gid_right << 16) + gid_left; /*Create one number from the ids*/
-            uint32_t * kid_p = _lv_utils_bsearch(&g_id_both, g_ids, kdsc->pair_cnt, 4, kern_pair_16_compare);
-
-            /*If the `g_id_both` were found get its index from the pointer*/
-            if(kid_p) {
-                lv_uintptr_t ofs = kid_p - g_ids;
-                value = kdsc->values[ofs];
-            }
 
-        }
-        else {
-            /*Invalid value*/
-        }
+        value = get_kern_pair_value(kdsc, gid_left, gid_right);
+        entry->kern_dsc = kdsc;
+        entry->gid_left = gid_left;
+        entry->gid_right = gid_right;
+        entry->value = value;
+#else
+        value = get_kern_pair_value(kdsc, gid_left, gid_right);
+#endif
     }
     else {
         /*Kern classes*/
@@ -323,6 +711,86 @@ static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t
     return value;
 }
 
+static int8_t get_kern_pair_value(const lv_font_fmt_txt_kern_pair_t * kdsc, uint32_t gid_left, uint32_t gid_right)
+{
+    int8_t value = 0;
+    if(kdsc->glyph_ids_size == 0) {
+        /*Use binary search to find the kern value.
+         *The pairs are ordered left_id first, then right_id secondly.*/
+        const uint16_t * g_ids = kdsc->glyph_ids;
+        uint16_t g_id_both = (gid_right << 8) + gid_left; /*Create one number from the ids*/
+        uint16_t * kid_p = _lv_utils_bsearch(&g_id_both, g_ids, kdsc->pair_cnt, 2, kern_pair_8_compare);
+
+        /*If the `g_id_both` were found get its index from the pointer*/
+        if(kid_p) {
+            lv_uintptr_t ofs = kid_p - g_ids;
+            value = kdsc->values[ofs];
+        }
+    }
+    else if(kdsc->glyph_ids_size == 1) {
+        /*Use binary search to find the kern value.
+         *The pairs are ordered left_id first, then right_id secondly.*/
+        const uint32_t * g_ids = kdsc->glyph_ids;
+        uint32_t g_id_both = (gid_right << 16) + gid_left; /*Create one number from the ids*/
+        uint32_t * kid_p = _lv_utils_bsearch(&g_id_both, g_ids, kdsc->pair_cnt, 4, kern_pair_16_compare);
+
+        /*If the `g_id_both` were found get its index from the pointer*/
+        if(kid_p) {
+            lv_uintptr_t ofs = kid_p - g_ids;
+            value = kdsc->values[ofs];
+        }
+
+    }
+    else {
+        /*Invalid value*/
+    }
+    return value;
+}
+
+/**
+ * Give the same class to the rows (or columns) of a matrix with the same values.
+ * @param values    the matrix
+ * @param cnt       number of rows (columns)
+ * @param len       number of values in a row (column)
+ * @param stride    distance of the rows (columns) in `values`
+ * @param step      distance of the values in a row (column)
+ * @param class_of  store the class of each row (column) here. 0: all the values are 0
+ * @return          number of classes
+ */
+static uint32_t kern_classes_assign(const int8_t * values, uint32_t cnt, uint32_t len, uint32_t stride, uint32_t step,
+                                    uint8_t * class_of)
+{
+    uint8_t first_of[UINT8_MAX];    /*The first row (column) of each class*/
+    uint32_t class_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        const int8_t * a = values + i * stride;
+        uint32_t j;
+        for(j = 0; j < len; j++) {
+            if(a[j * step] != 0) break;
+        }
+        class_of[i] = 0;
+        if(j == len) continue;
+
+        uint32_t c;
+        for(c = 0; c < class_cnt; c++) {
+            const int8_t * b = values + first_of[c] * stride;
+            for(j = 0; j < len; j++) {
+                if(a[j * step] != b[j * step]) break;
+            }
+            if(j == len) break;
+        }
+
+        if(c == class_cnt) {
+            first_of[class_cnt] = i;
+            class_cnt++;
+        }
+        class_of[i] = c + 1;
+    }
+
+    return class_cnt;
+}
+
 static int32_t kern_pair_8_compare(const void * ref, const void * element)
 {
     const uint8_t * ref8_p = ref;
@@ -345,6 +813,67 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element)
 }
 
 #if LV_USE_FONT_COMPRESSED
+
+/**
+ * Get a decompressed glyph from the cache or decompress it into the cache.
+ * @param fdsc      the font's descriptor
+ * @param gid       id of the glyph
+ * @param bitmap    the compressed bitmap of the glyph
+ * @param buf_size  size of the decompressed glyph
+ * @return          the decompressed glyph or NULL if it doesn't fit into the cache
+ */
+static uint8_t * decompr_cache_get(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t gid, const uint8_t * bitmap,
+                                   uint32_t buf_size)
+{
+    if(buf_size > decompr_cache_size) return NULL;
+
+    decompr_entry_t key = {.fdsc = fdsc, .gid = gid};
+    uint32_t hash = _lv_hash_lru_hash(fdsc, gid);
+    decompr_entry_t * entry = (decompr_entry_t *)_lv_hash_lru_get(&_decompr_cache, hash, decompr_entry_match, &key);
+    if(entry) return entry->buf;
+
+    /*Drop the least recently used glyphs to get space*/
+    _lv_hash_lru_shrink(&_decompr_cache, UINT32_MAX, decompr_cache_size - buf_size, NULL);
+
+    uint8_t * buf = lv_mem_alloc(buf_size);
+    if(buf == NULL) return NULL;
+
+    entry = lv_mem_alloc(sizeof(decompr_entry_t));
+    if(entry == NULL) {
+        lv_mem_free(buf);
+        return NULL;
+    }
+
+    entry->fdsc = fdsc;
+    entry->gid = gid;
+    entry->buf = buf;
+    _lv_hash_lru_add(&_decompr_cache, &entry->lru, hash, buf_size);
+
+    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+    bool prefilter = fdsc->bitmap_format == LV_FONT_FMT_TXT_COMPRESSED ? true : false;
+    decompress(bitmap, buf, gdsc->box_w, gdsc->box_h, (uint8_t)fdsc->bpp, prefilter);
+
+    return buf;
+}
+
+static bool decompr_entry_match(const _lv_hash_lru_entry_t * entry, const void * key)
+{
+    const decompr_entry_t * e = (const decompr_entry_t *)entry;
+    const decompr_entry_t * k = key;
+    return e->fdsc == k->fdsc && e->gid == k->gid;
+}
+
+static bool decompr_entry_match_fdsc(const _lv_hash_lru_entry_t * entry, const void * fdsc)
+{
+    return ((const decompr_entry_t *)entry)->fdsc == fdsc;
+}
+
+static void decompr_entry_free(_lv_hash_lru_entry_t * entry)
+{
+    lv_mem_free(((decompr_entry_t *)entry)->buf);
+    lv_mem_free(entry);
+}
+
 /**
  * The compress a glyph's bitmap
  * @param in the compressed bitmap
@@ -151,9 +151,26 @@ typedef enum {
     LV_FONT_FMT_TXT_COMPRESSED_NO_PREFILTER = 1,
 } lv_font_fmt_txt_bitmap_format_t;
 
+struct _lv_font_fmt_txt_lookup_t;
+
+#if LV_USE_FONT_COMPRESSED
+typedef struct {
+    uint32_t size;          /**< The max. total size of the decompressed glyphs in bytes*/
+    uint32_t used;          /**< The current total size of the decompressed glyphs in bytes*/
+    uint32_t entry_cnt;     /**< Number of decompressed glyphs*/
+    uint32_t hit_cnt;       /**< Number of times a glyph was found decompressed*/
+    uint32_t miss_cnt;      /**< Number of times a glyph had to be decompressed*/
+} lv_font_fmt_txt_decompr_cache_info_t;
+#endif
+
 typedef struct {
     uint32_t last_letter;
     uint32_t last_glyph_id;
+
+    /*Hash table to get the glyph id of any letter in O(1) time. Built on the first use if `lookup_en` is set*/
+    struct _lv_font_fmt_txt_lookup_t * lookup;
+    uint8_t lookup_en : 1;
+    uint8_t lookup_failed : 1;  /*The table couldn't be built, use the cmaps*/
 } lv_font_fmt_txt_glyph_cache_t;
 
 /*Describe store additional data for fonts*/
@@ -209,6 +226,15 @@ typedef struct {
  */
 const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t letter);
 
+/**
+ * Get the bitmap of a glyph to draw from the bitmap stored in the font. Decompress it if required.
+ * @param font      pointer to a font in `lv_font_fmt_txt` format
+ * @param gid       id of the glyph
+ * @param bitmap    the bitmap of the glyph as stored in the font (plain or compressed)
+ * @return          the bitmap to draw or NULL on error
+ */
+const uint8_t * _lv_font_fmt_txt_get_bitmap_by_id(const lv_font_t * font, uint32_t gid, const uint8_t * bitmap);
+
 /**
  * Used as `get_glyph_dsc` callback in LittelvGL's native font format if the font is uncompressed.
  * @param font_p pointer to font
@@ -220,11 +246,89 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t lett
 bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter,
                                    uint32_t unicode_letter_next);
 
+/**
+ * Get the id of a glyph
+ * @param font      pointer to a font in `lv_font_fmt_txt` format
+ * @param letter    a Unicode letter
+ * @return          id of the glyph or 0 if the letter is not in the font
+ */
+uint32_t _lv_font_fmt_txt_get_glyph_id(const lv_font_t * font, uint32_t letter);
+
 /**
  * Free the allocated memories.
  */
 void _lv_font_clean_up_fmt_txt(void);
 
+/**
+ * Enable or disable a hash table to find the glyph of a letter in O(1) time instead of searching in the cmaps.
+ * Useful for fonts with many sparse letters (e.g. CJK fonts). The table is built when the font is used next time.
+ * The font needs to have a glyph cache (`lv_font_fmt_txt_dsc_t.cache`).
+ * @param font      pointer to a font in `lv_font_fmt_txt` format
+ * @param en        true: enable; false: disable and free the table
+ */
+void lv_font_fmt_txt_set_lookup(const lv_font_t * font, bool en);
+
+/**
+ * Get the memory used by the lookup table of a font.
+ * @param font      pointer to a font in `lv_font_fmt_txt` format
+ * @return          size of the table in bytes or 0 if it's not built
+ */
+uint32_t lv_font_fmt_txt_get_lookup_size(const lv_font_t * font);
+
+/**
+ * Free the lookup tables of all fonts. Called by `lv_deinit()`.
+ */
+void _lv_font_fmt_txt_free_lookups(void);
+
+/**
+ * Convert pair based kerning to class based kerning. Each glyph with kerning gets a class,
+ * and the glyphs with the same kern values share it.
+ * @param kern_pair     the kerning pairs of a font
+ * @param glyph_cnt     number of glyphs in the font
+ * @return              a new class based kerning descriptor or NULL if there are too many classes or
+ *                      out of memory. The descriptor and its 3 arrays are allocated by `lv_mem_alloc`.
+ */
+lv_font_fmt_txt_kern_classes_t * lv_font_fmt_txt_kern_pairs_to_classes(const lv_font_fmt_txt_kern_pair_t * kern_pair,
+                                                                        uint32_t glyph_cnt);
+
+/**
+ * Forget the cached kern values. Needs to be called before freeing the kerning pairs of a font.
+ */
+void _lv_font_fmt_txt_kern_cache_clear(void);
+
+#if LV_USE_FONT_COMPRESSED
+
+/**
+ * Initialize the cache of the decompressed glyphs. Called by `lv_init()`.
+ */
+void _lv_font_fmt_txt_decompr_cache_init(void);
+
+/**
+ * Set the max. total size of the decompressed glyphs to keep.
+ * The least recently used glyphs are dropped if the new size is smaller than the current usage.
+ * @param size      the new size in bytes. 0: decompress the glyphs each time they are used
+ */
+void lv_font_fmt_txt_decompr_cache_set_size(uint32_t size);
+
+/**
+ * Get the current state of the cache of the decompressed glyphs
+ * @param info      store the result here
+ */
+void lv_font_fmt_txt_decompr_cache_get_info(lv_font_fmt_txt_decompr_cache_info_t * info);
+
+/**
+ * Drop all the decompressed glyphs and reset the hit/miss counters.
+ */
+void lv_font_fmt_txt_decompr_cache_clear(void);
+
+/**
+ * Drop the decompressed glyphs of a font. Needs to be called before freeing a font created in run time.
+ * @param font      pointer to a font
+ */
+void lv_font_fmt_txt_decompr_cache_drop_font(const lv_font_t * font);
+
+#endif /*LV_USE_FONT_COMPRESSED*/
+
 /**********************
  *      MACROS
  **********************/
@@ -22,13 +22,40 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+typedef struct {
+    uint32_t load_time;     /**< Time of loading the font in milliseconds*/
+    uint32_t mem_size;      /**< Memory used by the font in bytes without the cached bitmaps*/
+    uint32_t glyph_cnt;     /**< Number of glyphs in the font*/
+    uint32_t cache_size;    /**< The max. total size of the cached bitmaps in bytes. 0 if all bitmaps are loaded*/
+    uint32_t cache_used;    /**< The current total size of the cached bitmaps in bytes*/
+    uint32_t hit_cnt;       /**< Number of times a bitmap was found in the cache*/
+    uint32_t miss_cnt;      /**< Number of times a bitmap was read from the file*/
+} lv_font_loader_info_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 
 lv_font_t * lv_font_load(const char * fontName);
+
+/**
+ * Load only the metrics, the character maps and the kerning of a binary font file.
+ * The glyph bitmaps are read from the file when they are drawn, so the file is kept open until `lv_font_free()`.
+ * @param font_name     filename where the font file is located
+ * @param cache_size    max. total size of the bitmaps to keep in RAM in bytes
+ * @return              a pointer to the font or NULL in case of error
+ */
+lv_font_t * lv_font_load_lazy(const char * font_name, uint32_t cache_size);
+
 void lv_font_free(lv_font_t * font);
 
+/**
+ * Get the load time, the memory usage and the state of the glyph cache of a font.
+ * @param font      a font created by `lv_font_load()` or `lv_font_load_lazy()`
+ * @param info      store the result here
+ */
+void lv_font_loader_get_info(const lv_font_t * font, lv_font_loader_info_t * info);
+
 /**********************
  *      MACROS
  **********************/
@@ -17,6 +17,7 @@ extern "C" {
 #include <stdint.h>
 #include "lv_mem.h"
 #include "lv_ll.h"
+#include "lv_hash_lru.h"
 #include "lv_timer.h"
 #include "lv_types.h"
 #include "../draw/lv_img_cache.h"
@@ -50,7 +51,7 @@ extern "C" {
     LV_DISPATCH(f, lv_ll_t, _lv_img_decoder_ll)                                                        \
     LV_DISPATCH(f, lv_ll_t, _lv_obj_style_trans_ll)                                                    \
     LV_DISPATCH(f, lv_layout_dsc_t *, _lv_layout_list)                                                 \
-    LV_DISPATCH_COND(f, _lv_img_cache_entry_t*, _lv_img_cache_array, LV_IMG_CACHE_DEF, 1)              \
+    LV_DISPATCH_COND(f, _lv_hash_lru_t, _lv_img_cache, LV_IMG_CACHE_DEF, 1)                            \
     LV_DISPATCH_COND(f, _lv_img_cache_entry_t, _lv_img_cache_single, LV_IMG_CACHE_DEF, 0)              \
     LV_DISPATCH(f, lv_timer_t*, _lv_timer_act)                                                         \
     LV_DISPATCH(f, lv_mem_buf_arr_t , lv_mem_buf)                                                      \
@@ -59,7 +60,12 @@ extern "C" {
     LV_DISPATCH(f, void * , _lv_theme_default_styles)                                                  \
     LV_DISPATCH(f, void * , _lv_theme_basic_styles)                                                  \
     LV_DISPATCH_COND(f, uint8_t *, _lv_font_decompr_buf, LV_USE_FONT_COMPRESSED, 1)                    \
-    LV_DISPATCH(f, uint8_t * , _lv_grad_cache_mem)                                                     \
+    LV_DISPATCH_COND(f, _lv_hash_lru_t, _lv_font_decompr_cache, LV_USE_FONT_COMPRESSED, 1)             \
+    LV_DISPATCH(f, _lv_hash_lru_t, _lv_grad_cache)                                                     \
+    LV_DISPATCH(f, struct _lv_gradient_cache_t * , _lv_grad_cache_spare)                               \
+    LV_DISPATCH(f, struct _lv_font_fmt_txt_lookup_t * , _lv_font_fmt_txt_lookup_head)                  \
+    LV_DISPATCH_COND(f, lv_ll_t, _lv_obj_draw_cache_ll, LV_USE_OBJ_DRAW_CACHE, 1)                      \
+    LV_DISPATCH_COND(f, _lv_hash_lru_t, _lv_glyph_cache, LV_USE_DRAW_SW_GLYPH_CACHE, 1)                \
     LV_DISPATCH(f, uint8_t * , _lv_style_custom_prop_flag_lookup_table)
 
 #define LV_DEFINE_ROOT(root_type, root_name) root_type root_name;
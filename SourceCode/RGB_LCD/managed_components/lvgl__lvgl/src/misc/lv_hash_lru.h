@@ -0,0 +1,156 @@
+/**
+ * @file lv_hash_lru.h
+ * A least recently used cache with a hash table to find the entries.
+ * The entries are allocated by the user and embed `_lv_hash_lru_entry_t` as their first member.
+ */
+
+#ifndef LV_HASH_LRU_H
+#define LV_HASH_LRU_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+#include "lv_types.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** Needs to be the first member of the cached entries*/
+typedef struct _lv_hash_lru_entry_t {
+    struct _lv_hash_lru_entry_t * hash_next;    /**< The next entry in the same bucket of the hash table*/
+    struct _lv_hash_lru_entry_t * prev;         /**< The more recently used entry*/
+    struct _lv_hash_lru_entry_t * next;         /**< The less recently used entry*/
+    uint32_t hash;                              /**< Hash of the key of the entry*/
+    uint32_t size;                              /**< The size counted in `used`, e.g. the size of the cached data*/
+} _lv_hash_lru_entry_t;
+
+/**
+ * Compare the key of an entry with a key
+ * @param entry     an entry of the cache
+ * @param key       the key passed to the find or drop function
+ * @return          true: the entry matches the key
+ */
+typedef bool (*_lv_hash_lru_match_cb_t)(const _lv_hash_lru_entry_t * entry, const void * key);
+
+/**
+ * Free an entry. Called after the entry was removed from the cache.
+ * @param entry     the dropped entry
+ */
+typedef void (*_lv_hash_lru_free_cb_t)(_lv_hash_lru_entry_t * entry);
+
+typedef struct {
+    _lv_hash_lru_entry_t ** buckets;    /**< The hash table. Its size is a power of 2*/
+    uint32_t bucket_mask;               /**< Number of buckets - 1*/
+    _lv_hash_lru_entry_t * head;        /**< The most recently used entry*/
+    _lv_hash_lru_entry_t * tail;        /**< The least recently used entry*/
+    _lv_hash_lru_free_cb_t free_cb;     /**< Free the dropped entries*/
+    uint32_t entry_cnt;                 /**< Number of cached entries*/
+    uint32_t used;                      /**< The total size of the cached entries*/
+    uint32_t hit_cnt;                   /**< Number of times an entry was found by `_lv_hash_lru_get`*/
+    uint32_t miss_cnt;                  /**< Number of times an entry wasn't found by `_lv_hash_lru_get`*/
+    uint32_t evict_cnt;                 /**< Number of entries dropped by `_lv_hash_lru_shrink`*/
+} _lv_hash_lru_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize an empty cache
+ * @param lru           pointer to a cache
+ * @param buckets       an array for the hash table. Needs to be valid while the cache is used.
+ * @param bucket_cnt    number of elements in `buckets`. Must be a power of 2.
+ * @param free_cb       called to free the dropped entries
+ */
+void _lv_hash_lru_init(_lv_hash_lru_t * lru, _lv_hash_lru_entry_t ** buckets, uint32_t bucket_cnt,
+                       _lv_hash_lru_free_cb_t free_cb);
+
+/**
+ * Find an entry without counting it as used
+ * @param lru       pointer to a cache
+ * @param hash      the hash of the key
+ * @param match_cb  compare the entries having the same hash with `key`
+ * @param key       the key to find
+ * @return          the entry or NULL if not found
+ */
+_lv_hash_lru_entry_t * _lv_hash_lru_find(const _lv_hash_lru_t * lru, uint32_t hash, _lv_hash_lru_match_cb_t match_cb,
+                                         const void * key);
+
+/**
+ * Find an entry, make it the most recently used one and count a hit or a miss
+ * @param lru       pointer to a cache
+ * @param hash      the hash of the key
+ * @param match_cb  compare the entries having the same hash with `key`
+ * @param key       the key to find
+ * @return          the entry or NULL if not found
+ */
+_lv_hash_lru_entry_t * _lv_hash_lru_get(_lv_hash_lru_t * lru, uint32_t hash, _lv_hash_lru_match_cb_t match_cb,
+                                        const void * key);
+
+/**
+ * Add an entry as the most recently used one
+ * @param lru       pointer to a cache
+ * @param entry     the new entry
+ * @param hash      the hash of its key
+ * @param size      the size to count in `lru->used`
+ */
+void _lv_hash_lru_add(_lv_hash_lru_t * lru, _lv_hash_lru_entry_t * entry, uint32_t hash, uint32_t size);
+
+/**
+ * Remove an entry from the cache and free it with `free_cb`
+ * @param lru       pointer to a cache
+ * @param entry     an entry of the cache
+ */
+void _lv_hash_lru_drop(_lv_hash_lru_t * lru, _lv_hash_lru_entry_t * entry);
+
+/**
+ * Drop the least recently used entries until there are at most `max_cnt` entries and they use at most `max_size`.
+ * @param lru       pointer to a cache
+ * @param max_cnt   max. number of entries to keep
+ * @param max_size  max. total size of the entries to keep
+ * @param keep      never drop this entry (can be NULL)
+ */
+void _lv_hash_lru_shrink(_lv_hash_lru_t * lru, uint32_t max_cnt, uint32_t max_size, const _lv_hash_lru_entry_t * keep);
+
+/**
+ * Drop the entries matching a key. Unlike with `_lv_hash_lru_find` the entries of all buckets are checked.
+ * @param lru       pointer to a cache
+ * @param match_cb  compare the entries with `key`. NULL to drop all the entries.
+ * @param key       the key to drop
+ */
+void _lv_hash_lru_drop_matching(_lv_hash_lru_t * lru, _lv_hash_lru_match_cb_t match_cb, const void * key);
+
+/**
+ * Hash a pointer and a number, e.g. a font and a glyph ID
+ * @param ptr       a pointer or NULL
+ * @param id        a number
+ * @return          the hash
+ */
+static inline uint32_t _lv_hash_lru_hash(const void * ptr, uint32_t id)
+{
+    uint32_t h = ((uint32_t)((lv_uintptr_t)ptr >> 2) * 31u + id) * 2654435761u;
+    return h ^ (h >> 16);
+}
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_HASH_LRU_H*/
@@ -6,12 +6,14 @@ CSRCS += lv_bidi.c
 CSRCS += lv_color.c
 CSRCS += lv_fs.c
 CSRCS += lv_gc.c
+CSRCS += lv_hash_lru.c
 CSRCS += lv_ll.c
 CSRCS += lv_log.c
 CSRCS += lv_lru.c
 CSRCS += lv_math.c
 CSRCS += lv_mem.c
 CSRCS += lv_printf.c
+CSRCS += lv_profiler.c
 CSRCS += lv_style.c
 CSRCS += lv_style_gen.c
 CSRCS += lv_timer.c
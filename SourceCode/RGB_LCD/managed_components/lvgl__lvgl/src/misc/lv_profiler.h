@@ -0,0 +1,113 @@
+/**
+ * @file lv_profiler.h
+ *
+ */
+
+#ifndef LV_PROFILER_H
+#define LV_PROFILER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if LV_USE_PROFILER
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Called with the text of the recorded events by `lv_profiler_flush()`.
+ * The text is passed line by line.
+ */
+typedef void (*lv_profiler_flush_cb_t)(const char * buf);
+
+/**
+ * Return a timestamp in microseconds
+ */
+typedef uint32_t (*lv_profiler_tick_cb_t)(void);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the profiler. Called by `lv_init()`.
+ */
+void _lv_profiler_init(void);
+
+/**
+ * Enable or disable recording the events. It's enabled by default.
+ * @param en        true: enable; false: disable
+ */
+void lv_profiler_set_enabled(bool en);
+
+/**
+ * Set a function to get the current time in microseconds.
+ * By default `esp_timer_get_time()` is used on ESP32, `clock_gettime(CLOCK_MONOTONIC)` on POSIX systems
+ * and `lv_tick_get() * 1000` (1 ms resolution) elsewhere.
+ * @param cb        the time source, or NULL to use the default
+ */
+void lv_profiler_set_tick_cb(lv_profiler_tick_cb_t cb);
+
+/**
+ * Delete all the recorded events
+ */
+void lv_profiler_reset(void);
+
+/**
+ * Get the number of recorded events
+ * @return          number of events waiting in the ring buffer
+ */
+uint32_t lv_profiler_get_cnt(void);
+
+/**
+ * Print the recorded events in the format of `ftrace`'s `tracing_mark_write` and delete them.
+ * `scripts/lv_profiler_trace.py` converts the printed log to Chrome trace JSON
+ * which can be opened in `chrome://tracing` or https://ui.perfetto.dev.
+ * @param cb        called with each line of the output
+ */
+void lv_profiler_flush(lv_profiler_flush_cb_t cb);
+
+/**
+ * Record the beginning or end of an event. Use the `LV_PROFILER_BEGIN/END` macros instead.
+ * @param tag       name of the event. Must be a string literal or other static string.
+ * @param type      'B' (begin) or 'E' (end)
+ */
+void lv_profiler_write(const char * tag, char type);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#define LV_PROFILER_BEGIN_TAG(tag)  lv_profiler_write((tag), 'B')
+#define LV_PROFILER_END_TAG(tag)    lv_profiler_write((tag), 'E')
+
+#else /*LV_USE_PROFILER*/
+
+#define LV_PROFILER_BEGIN_TAG(tag)
+#define LV_PROFILER_END_TAG(tag)
+
+#endif /*LV_USE_PROFILER*/
+
+/*Measure the enclosing function*/
+#define LV_PROFILER_BEGIN           LV_PROFILER_BEGIN_TAG(__func__)
+#define LV_PROFILER_END             LV_PROFILER_END_TAG(__func__)
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PROFILER_H*/
@@ -222,13 +222,27 @@ void lv_textarea_del_char(lv_obj_t * obj)
     lv_res_t res = insert_handler(obj, del_buf);
     if(res != LV_RES_OK) return;
 
-    char * label_txt = lv_label_get_text(ta->label);
-
     /*Delete a character*/
-    _lv_txt_cut(label_txt, ta->cursor.pos - 1, 1);
+#if LV_USE_ARABIC_PERSIAN_CHARS
+    /*The letters around the deleted one might need to be shaped again by `lv_label_set_text`.
+     *Only ASCII texts can be updated without it.*/
+    char * label_txt = lv_label_get_text(ta->label);
+    bool ascii = true;
+    uint32_t i;
+    for(i = 0; label_txt[i] != '\0' && ascii; i++) {
+        if((uint8_t)label_txt[i] >= 0x80) ascii = false;
+    }
 
-    /*Refresh the label*/
-    lv_label_set_text(ta->label, label_txt);
+    if(ascii) {
+        lv_label_cut_text(ta->label, ta->cursor.pos - 1, 1);
+    }
+    else {
+        _lv_txt_cut(label_txt, ta->cursor.pos - 1, 1);
+        lv_label_set_text(ta->label, label_txt);
+    }
+#else
+    lv_label_cut_text(ta->label, ta->cursor.pos - 1, 1);
+#endif
     lv_textarea_clear_selection(obj);
 
     /*If the textarea became empty, invalidate it to hide the placeholder*/
@@ -0,0 +1,210 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#define HOR_RES     100
+#define VER_RES     100
+#define BUF_CNT     3
+#define BUF_ROWS    10
+
+typedef struct {
+    lv_area_t area;
+    lv_color_t * buf;
+} pending_flush_t;
+
+static lv_color_t ring_buf_mem[BUF_CNT][HOR_RES * BUF_ROWS];
+static void * ring_bufs[BUF_CNT];
+static lv_color_t ref_buf[HOR_RES * VER_RES];
+static lv_color_t ring_fb[HOR_RES * VER_RES];
+static lv_color_t ref_fb[HOR_RES * VER_RES];
+
+/*The flushes waiting for the "DMA" of the ring display*/
+static pending_flush_t pending[BUF_CNT + 1];
+static uint32_t pending_cnt;
+static uint32_t max_pending_cnt;
+static uint32_t flush_cnt;
+static bool buf_order_ok;
+static uint32_t last_flush_idx;    /*Index of the flush where `lv_disp_flush_is_last()` was true*/
+static uint32_t last_cnt;
+
+static lv_disp_draw_buf_t ring_draw_buf;
+static lv_disp_draw_buf_t ref_draw_buf;
+static lv_disp_drv_t ring_drv;
+static lv_disp_drv_t ref_drv;
+static lv_disp_t * ring_disp;
+static lv_disp_t * ref_disp;
+
+static void copy_area(lv_color_t * fb, const lv_area_t * area, const lv_color_t * buf)
+{
+    lv_coord_t w = lv_area_get_width(area);
+    lv_coord_t y;
+    for(y = area->y1; y <= area->y2; y++) {
+        lv_memcpy(&fb[y * HOR_RES + area->x1], buf, w * sizeof(lv_color_t));
+        buf += w;
+    }
+}
+
+/*Finish the oldest transfer like a DMA complete interrupt would do*/
+static void complete_oldest(lv_disp_drv_t * drv)
+{
+    if(pending_cnt == 0) return;
+
+    copy_area(ring_fb, &pending[0].area, pending[0].buf);
+    uint32_t i;
+    for(i = 1; i < pending_cnt; i++) pending[i - 1] = pending[i];
+    pending_cnt--;
+
+    lv_disp_flush_ready(drv);
+}
+
+static void ring_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    LV_UNUSED(drv);
+
+    if(color_p != ring_bufs[flush_cnt % BUF_CNT]) buf_order_ok = false;
+    if(lv_disp_flush_is_last(drv)) {
+        last_flush_idx = flush_cnt;
+        last_cnt++;
+    }
+    flush_cnt++;
+
+    /*Don't touch the buffer yet, just queue it*/
+    TEST_ASSERT_LESS_THAN(BUF_CNT + 1, pending_cnt);
+    pending[pending_cnt].area = *area;
+    pending[pending_cnt].buf = color_p;
+    pending_cnt++;
+    if(pending_cnt > max_pending_cnt) max_pending_cnt = pending_cnt;
+}
+
+static void ring_wait_cb(lv_disp_drv_t * drv)
+{
+    complete_oldest(drv);
+}
+
+static void ref_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    copy_area(ref_fb, area, color_p);
+    lv_disp_flush_ready(drv);
+}
+
+static void create_ui(lv_disp_t * disp)
+{
+    lv_obj_t * scr = lv_disp_get_scr_act(disp);
+    lv_obj_set_style_bg_color(scr, lv_palette_lighten(LV_PALETTE_GREY, 3), 0);
+
+    lv_obj_t * obj = lv_obj_create(scr);
+    lv_obj_set_pos(obj, 5, 7);
+    lv_obj_set_size(obj, 70, 60);
+    lv_obj_set_style_radius(obj, 15, 0);
+    lv_obj_set_style_shadow_width(obj, 20, 0);
+    lv_obj_set_style_bg_grad_color(obj, lv_palette_main(LV_PALETTE_RED), 0);
+    lv_obj_set_style_bg_grad_dir(obj, LV_GRAD_DIR_VER, 0);
+
+    lv_obj_t * label = lv_label_create(scr);
+    lv_label_set_text(label, "Ring\nbuffer");
+    lv_obj_set_pos(label, 40, 60);
+}
+
+void setUp(void)
+{
+    uint32_t i;
+    for(i = 0; i < BUF_CNT; i++) ring_bufs[i] = ring_buf_mem[i];
+
+    lv_disp_draw_buf_init_ring(&ring_draw_buf, ring_bufs, BUF_CNT, HOR_RES * BUF_ROWS);
+    lv_disp_drv_init(&ring_drv);
+    ring_drv.draw_buf = &ring_draw_buf;
+    ring_drv.flush_cb = ring_flush_cb;
+    ring_drv.wait_cb = ring_wait_cb;
+    ring_drv.hor_res = HOR_RES;
+    ring_drv.ver_res = VER_RES;
+    ring_disp = lv_disp_drv_register(&ring_drv);
+
+    lv_disp_draw_buf_init(&ref_draw_buf, ref_buf, NULL, HOR_RES * VER_RES);
+    lv_disp_drv_init(&ref_drv);
+    ref_drv.draw_buf = &ref_draw_buf;
+    ref_drv.flush_cb = ref_flush_cb;
+    ref_drv.hor_res = HOR_RES;
+    ref_drv.ver_res = VER_RES;
+    ref_disp = lv_disp_drv_register(&ref_drv);
+
+    pending_cnt = 0;
+    max_pending_cnt = 0;
+    flush_cnt = 0;
+    buf_order_ok = true;
+    last_flush_idx = 0;
+    last_cnt = 0;
+}
+
+static void disp_remove(lv_disp_t * disp)
+{
+    /*`lv_disp_remove` doesn't free the draw context*/
+    lv_disp_drv_t * drv = disp->driver;
+    lv_disp_remove(disp);
+    drv->draw_ctx_deinit(drv, drv->draw_ctx);
+    lv_mem_free(drv->draw_ctx);
+}
+
+void tearDown(void)
+{
+    disp_remove(ring_disp);
+    disp_remove(ref_disp);
+}
+
+void test_disp_buf_ring_keeps_all_buffers_in_flight(void)
+{
+    create_ui(ring_disp);
+    create_ui(ref_disp);
+
+    lv_refr_now(ring_disp);
+    lv_refr_now(ref_disp);
+
+    /*Finish the transfers which were still in flight at the end of the refresh*/
+    while(pending_cnt) complete_oldest(&ring_drv);
+
+    TEST_ASSERT_EQUAL_UINT32(VER_RES / BUF_ROWS, flush_cnt);
+    TEST_ASSERT_EQUAL_UINT32(BUF_CNT, max_pending_cnt);
+    TEST_ASSERT_TRUE(buf_order_ok);
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, ring_fb, sizeof(ref_fb));
+}
+
+void test_disp_buf_ring_continues_across_frames(void)
+{
+    create_ui(ring_disp);
+    create_ui(ref_disp);
+
+    /*The first frame leaves buffers in flight. The next refresh has to wait for them.*/
+    lv_refr_now(ring_disp);
+    lv_obj_invalidate(lv_disp_get_scr_act(ring_disp));
+    lv_refr_now(ring_disp);
+    lv_refr_now(ref_disp);
+    while(pending_cnt) complete_oldest(&ring_drv);
+
+    TEST_ASSERT_EQUAL_UINT32(2 * VER_RES / BUF_ROWS, flush_cnt);
+    TEST_ASSERT_TRUE(buf_order_ok);
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, ring_fb, sizeof(ref_fb));
+}
+
+void test_disp_buf_ring_flush_is_last_with_pending_flushes(void)
+{
+    create_ui(ring_disp);
+    lv_refr_now(ring_disp);
+
+    /*Only the last area is reported as last, even though older buffers were completed while it was sent*/
+    TEST_ASSERT_EQUAL_UINT32(1, last_cnt);
+    TEST_ASSERT_EQUAL_UINT32(VER_RES / BUF_ROWS - 1, last_flush_idx);
+
+    /*Completing the older buffers doesn't clear it while the last one is in flight*/
+    TEST_ASSERT_GREATER_THAN_UINT32(1, pending_cnt);
+    while(pending_cnt > 1) {
+        complete_oldest(&ring_drv);
+        TEST_ASSERT_TRUE(lv_disp_flush_is_last(&ring_drv));
+        TEST_ASSERT_TRUE(ring_draw_buf.flushing);
+    }
+
+    complete_oldest(&ring_drv);
+    TEST_ASSERT_FALSE(lv_disp_flush_is_last(&ring_drv));
+    TEST_ASSERT_FALSE(ring_draw_buf.flushing);
+}
+
+#endif
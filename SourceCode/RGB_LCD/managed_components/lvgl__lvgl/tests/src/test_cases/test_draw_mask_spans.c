@@ -0,0 +1,214 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#if LV_USE_DRAW_MASK_SPANS
+
+#define LINE_W  200
+
+static lv_opa_t mask_buf[LINE_W];
+static lv_coord_t max_changed_len;      /*The longest changed run seen by `check_lines`*/
+
+/*Apply the masks on every line of `area` and check that the runs describe the mask buffer*/
+static void check_lines(const lv_area_t * area, lv_opa_t init)
+{
+    lv_draw_mask_span_list_t spans;
+    uint32_t transp_px = 0;
+    uint32_t cover_px = 0;
+    lv_coord_t len = lv_area_get_width(area);
+    lv_coord_t y;
+    for(y = area->y1; y <= area->y2; y++) {
+        lv_memset(mask_buf, init, len);
+        lv_draw_mask_res_t res = lv_draw_mask_apply_spans(mask_buf, area->x1, y, len, &spans);
+
+        /*Without spans the result needs to be the same*/
+        static lv_opa_t ref_buf[LINE_W];
+        lv_memset(ref_buf, init, len);
+        TEST_ASSERT_EQUAL(lv_draw_mask_apply(ref_buf, area->x1, y, len), res);
+        if(res != LV_DRAW_MASK_RES_CHANGED) continue;
+        TEST_ASSERT_EQUAL_MEMORY(ref_buf, mask_buf, len);
+
+        TEST_ASSERT_GREATER_THAN(0, spans.cnt);
+        TEST_ASSERT_LESS_OR_EQUAL(_LV_DRAW_MASK_SPAN_MAX, spans.cnt);
+
+        lv_coord_t x = 0;
+        uint32_t i;
+        for(i = 0; i < spans.cnt; i++) {
+            const lv_draw_mask_span_t * s = &spans.spans[i];
+            TEST_ASSERT_EQUAL(x, s->x);
+            TEST_ASSERT_GREATER_THAN(0, s->len);
+            if(i > 0) TEST_ASSERT_NOT_EQUAL(spans.spans[i - 1].res, s->res);
+
+            lv_coord_t j;
+            for(j = s->x; j < s->x + s->len; j++) {
+                if(s->res == LV_DRAW_MASK_RES_TRANSP) TEST_ASSERT_EQUAL_UINT8(0, mask_buf[j]);
+                else if(s->res == LV_DRAW_MASK_RES_FULL_COVER) TEST_ASSERT_EQUAL_UINT8(init, mask_buf[j]);
+            }
+
+            if(s->res == LV_DRAW_MASK_RES_TRANSP) transp_px += s->len;
+            else if(s->res == LV_DRAW_MASK_RES_FULL_COVER) cover_px += s->len;
+            else max_changed_len = LV_MAX(max_changed_len, s->len);
+            x += s->len;
+        }
+        TEST_ASSERT_EQUAL(len, x);
+    }
+
+    /*The runs need to be useful too*/
+    TEST_ASSERT_GREATER_THAN(0, transp_px);
+    TEST_ASSERT_GREATER_THAN(0, cover_px);
+}
+
+#endif
+
+void setUp(void)
+{
+    /* Function run before every test */
+}
+
+void tearDown(void)
+{
+#if LV_USE_DRAW_MASK_SPANS
+    _lv_draw_mask_cleanup();
+    lv_obj_clean(lv_scr_act());
+#endif
+}
+
+void test_draw_mask_spans_of_a_rounded_rect(void)
+{
+#if LV_USE_DRAW_MASK_SPANS
+    lv_area_t rect = {20, 10, 179, 149};
+    lv_draw_mask_radius_param_t rout;
+    lv_draw_mask_radius_init(&rout, &rect, 60, false);
+    int16_t rout_id = lv_draw_mask_add(&rout, NULL);
+
+    lv_area_t line_area = {0, 0, LINE_W - 1, 159};
+    check_lines(&line_area, LV_OPA_COVER);
+    check_lines(&line_area, LV_OPA_50);
+
+    /*A ring*/
+    lv_area_t rect_in = {50, 40, 149, 119};
+    lv_draw_mask_radius_param_t rin;
+    lv_draw_mask_radius_init(&rin, &rect_in, 30, true);
+    int16_t rin_id = lv_draw_mask_add(&rin, NULL);
+    check_lines(&line_area, LV_OPA_COVER);
+
+    lv_draw_mask_free_param(&rin);
+    lv_draw_mask_remove_id(rin_id);
+    lv_draw_mask_free_param(&rout);
+    lv_draw_mask_remove_id(rout_id);
+#endif
+}
+
+void test_draw_mask_spans_of_arcs(void)
+{
+#if LV_USE_DRAW_MASK_SPANS
+    static const lv_coord_t angles[][2] = {{0, 90}, {30, 330}, {100, 80}, {135, 45}, {200, 340}, {300, 240}, {90, 270}};
+
+    lv_area_t rect = {0, 0, LINE_W - 1, LINE_W - 1};
+    lv_draw_mask_radius_param_t rout;
+    lv_draw_mask_radius_init(&rout, &rect, LV_RADIUS_CIRCLE, false);
+    int16_t rout_id = lv_draw_mask_add(&rout, NULL);
+
+    lv_area_t rect_in = {30, 30, LINE_W - 31, LINE_W - 31};
+    lv_draw_mask_radius_param_t rin;
+    lv_draw_mask_radius_init(&rin, &rect_in, LV_RADIUS_CIRCLE, true);
+    int16_t rin_id = lv_draw_mask_add(&rin, NULL);
+
+    uint32_t i;
+    for(i = 0; i < sizeof(angles) / sizeof(angles[0]); i++) {
+        lv_draw_mask_angle_param_t angle;
+        lv_draw_mask_angle_init(&angle, LINE_W / 2, LINE_W / 2, angles[i][0], angles[i][1]);
+        int16_t angle_id = lv_draw_mask_add(&angle, NULL);
+
+        check_lines(&rect, LV_OPA_COVER);
+
+        lv_draw_mask_free_param(&angle);
+        lv_draw_mask_remove_id(angle_id);
+    }
+
+    lv_draw_mask_free_param(&rin);
+    lv_draw_mask_remove_id(rin_id);
+    lv_draw_mask_free_param(&rout);
+    lv_draw_mask_remove_id(rout_id);
+#endif
+}
+
+void test_draw_mask_spans_of_steep_lines(void)
+{
+#if LV_USE_DRAW_MASK_SPANS
+    /*Lines going to the right and to the left, keeping both sides*/
+    static const lv_coord_t points[][4] = {{50, 0, 150, 159}, {150, 0, 50, 159}, {90, 0, 110, 159}, {100, 0, 100, 159}};
+
+    lv_area_t line_area = {0, 0, LINE_W - 1, 159};
+    uint32_t i;
+    for(i = 0; i < sizeof(points) / sizeof(points[0]); i++) {
+        lv_draw_mask_line_side_t side;
+        for(side = LV_DRAW_MASK_LINE_SIDE_LEFT; side <= LV_DRAW_MASK_LINE_SIDE_RIGHT; side++) {
+            lv_draw_mask_line_param_t line;
+            lv_draw_mask_line_points_init(&line, points[i][0], points[i][1], points[i][2], points[i][3], side);
+            int16_t line_id = lv_draw_mask_add(&line, NULL);
+
+            max_changed_len = 0;
+            check_lines(&line_area, LV_OPA_COVER);
+
+            lv_draw_mask_free_param(&line);
+            lv_draw_mask_remove_id(line_id);
+
+            /*A steep line anti-aliases at most 2 pixels per row, only they should be changed*/
+            TEST_ASSERT_LESS_OR_EQUAL(2, max_changed_len);
+        }
+    }
+#endif
+}
+
+void test_draw_mask_spans_with_other_masks(void)
+{
+#if LV_USE_DRAW_MASK_SPANS
+    lv_area_t rect = {20, 10, 179, 149};
+    lv_draw_mask_radius_param_t rout;
+    lv_draw_mask_radius_init(&rout, &rect, 40, false);
+    int16_t rout_id = lv_draw_mask_add(&rout, NULL);
+
+    /*The fade mask changes every pixel so only the cleared pixels are known*/
+    lv_draw_mask_fade_param_t fade;
+    lv_draw_mask_fade_init(&fade, &rect, LV_OPA_COVER, 50, LV_OPA_TRANSP, 100);
+    int16_t fade_id = lv_draw_mask_add(&fade, NULL);
+
+    lv_draw_mask_span_list_t spans;
+    lv_memset_ff(mask_buf, LINE_W);
+    TEST_ASSERT_EQUAL(LV_DRAW_MASK_RES_CHANGED, lv_draw_mask_apply_spans(mask_buf, 0, 80, LINE_W, &spans));
+    TEST_ASSERT_EQUAL(3, spans.cnt);
+    TEST_ASSERT_EQUAL(LV_DRAW_MASK_RES_TRANSP, spans.spans[0].res);
+    TEST_ASSERT_EQUAL(20, spans.spans[0].len);
+    TEST_ASSERT_EQUAL(LV_DRAW_MASK_RES_CHANGED, spans.spans[1].res);
+    TEST_ASSERT_EQUAL(160, spans.spans[1].len);
+    TEST_ASSERT_EQUAL(LV_DRAW_MASK_RES_TRANSP, spans.spans[2].res);
+
+    lv_draw_mask_free_param(&fade);
+    lv_draw_mask_remove_id(fade_id);
+    lv_draw_mask_free_param(&rout);
+    lv_draw_mask_remove_id(rout_id);
+#endif
+}
+
+void test_draw_mask_spans_render_like_the_mask_buffer(void)
+{
+#if LV_USE_DRAW_MASK_SPANS
+    /*The reference image was rendered without `LV_USE_DRAW_MASK_SPANS`*/
+    lv_obj_t * arc = lv_arc_create(lv_scr_act());
+    lv_obj_set_size(arc, 300, 300);
+    lv_obj_center(arc);
+    lv_arc_set_value(arc, 70);
+
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(obj, 200, 150);
+    lv_obj_set_style_radius(obj, 50, 0);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_50, 0);
+    lv_obj_set_style_border_width(obj, 10, 0);
+
+    TEST_ASSERT_EQUAL_SCREENSHOT("draw_mask_spans_1.png");
+#endif
+}
+
+#endif
@@ -0,0 +1,215 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <string.h>
+
+#if LV_USE_DRAW_SW_SIMD
+
+#define BUF_W       80
+#define FB_SIZE     (800 * 480)
+
+extern lv_color_t test_fb[];
+
+static lv_color_t ref_fb[FB_SIZE];
+static lv_color_t dest_ori[BUF_W + 4];
+static lv_color_t dest_ref[BUF_W + 4];
+static lv_color_t dest_res[BUF_W + 4];
+static lv_color_t src[BUF_W + 4];
+static lv_opa_t mask[BUF_W + 4];
+static uint32_t seed;
+
+static const lv_opa_t opa_list[] = {0, 1, 7, 64, 127, 128, 200, 251, 252};
+
+static uint32_t rnd(void)
+{
+    seed = seed * 1664525 + 1013904223;
+    return seed >> 8;
+}
+
+static lv_color_t rnd_color(void)
+{
+    lv_color_t c;
+#if LV_COLOR_DEPTH == 32
+    c.full = rnd() | (rnd() << 24);
+#else
+    c.full = rnd();
+#endif
+    return c;
+}
+
+/*Mix random values with 0 and 255 runs like the real masks*/
+static void fill_rnd(uint32_t mode)
+{
+    uint32_t i;
+    for(i = 0; i < BUF_W + 4; i++) {
+        dest_ori[i] = rnd_color();
+        src[i] = rnd_color();
+        switch(mode) {
+            case 0:
+                mask[i] = rnd();
+                break;
+            case 1:
+                mask[i] = (i / 9) % 3 == 0 ? LV_OPA_TRANSP : (i / 9) % 3 == 1 ? LV_OPA_COVER : rnd();
+                break;
+            case 2:
+                mask[i] = LV_OPA_COVER;
+                break;
+            default:
+                mask[i] = rnd() & 0x3;    /*Small values are rounded to 0 by RGB565*/
+                break;
+        }
+    }
+}
+
+static void reset_dest(void)
+{
+    memcpy(dest_ref, dest_ori, sizeof(dest_ori));
+    memcpy(dest_res, dest_ori, sizeof(dest_ori));
+}
+
+static void check(const lv_draw_sw_blend_kernels_t * k, const char * kernel, int32_t w, lv_opa_t opa)
+{
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%s %s w:%d opa:%d", k->name, kernel, (int)w, (int)opa);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(dest_ref, dest_res, sizeof(dest_ref), msg);
+}
+
+static void draw_scene(void)
+{
+    /*The performance and memory monitors would show different values on the two renders*/
+    lv_obj_add_flag(lv_layer_sys(), LV_OBJ_FLAG_HIDDEN);
+
+    lv_obj_t * scr = lv_scr_act();
+    lv_obj_set_style_bg_color(scr, lv_palette_lighten(LV_PALETTE_BLUE, 4), 0);
+
+    uint32_t i;
+    for(i = 0; i < 6; i++) {
+        lv_obj_t * obj = lv_obj_create(scr);
+        lv_obj_set_pos(obj, 20 + i * 90, 20 + i * 40);
+        lv_obj_set_size(obj, 200, 150);
+        lv_obj_set_style_radius(obj, 10 + i * 10, 0);
+        lv_obj_set_style_bg_opa(obj, 60 + i * 30, 0);
+        lv_obj_set_style_bg_color(obj, lv_palette_main(i + 1), 0);
+        lv_obj_set_style_shadow_width(obj, 20, 0);
+        lv_obj_set_style_opa(obj, i % 2 ? LV_OPA_COVER : LV_OPA_70, 0);
+
+        lv_obj_t * label = lv_label_create(obj);
+        lv_label_set_text(label, "Blend kernels");
+    }
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_USE_DRAW_SW_SIMD
+    seed = 1;
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_USE_DRAW_SW_SIMD
+    _lv_draw_sw_blend_simd_init();
+    lv_obj_clean(lv_scr_act());
+    lv_obj_clear_flag(lv_layer_sys(), LV_OBJ_FLAG_HIDDEN);
+#endif
+}
+
+void test_draw_sw_blend_simd_kernels_are_bit_exact(void)
+{
+#if LV_USE_DRAW_SW_SIMD
+    const lv_draw_sw_blend_kernels_t * ref = _lv_draw_sw_blend_simd_get_builtin(0);
+    TEST_ASSERT_NOT_NULL(ref);
+#if defined(__x86_64__)
+    /*SSE2 is always available on x86_64*/
+    TEST_ASSERT_NOT_NULL(_lv_draw_sw_blend_simd_get_builtin(1));
+#endif
+
+    uint32_t idx;
+    const lv_draw_sw_blend_kernels_t * k;
+    for(idx = 1; (k = _lv_draw_sw_blend_simd_get_builtin(idx)) != NULL; idx++) {
+        uint32_t mode;
+        for(mode = 0; mode < 4; mode++) {
+            fill_rnd(mode);
+            lv_color_t color = rnd_color();
+            int32_t w;
+            for(w = 1; w <= BUF_W; w++) {
+                /*Test unaligned buffers too*/
+                uint32_t ofs = w % 4;
+                uint32_t mask_ofs = (w / 4) % 4;
+                lv_color_t * d_ref = dest_ref + ofs;
+                lv_color_t * d_res = dest_res + ofs;
+                const lv_color_t * s = src + (3 - ofs);
+                const lv_opa_t * m = mask + mask_ofs;
+
+                uint32_t i;
+                for(i = 0; i < sizeof(opa_list); i++) {
+                    lv_opa_t opa = opa_list[i];
+
+                    reset_dest();
+                    ref->fill_opa(d_ref, w, color, opa);
+                    k->fill_opa(d_res, w, color, opa);
+                    check(k, "fill_opa", w, opa);
+
+                    reset_dest();
+                    ref->fill_mask_opa(d_ref, w, color, opa, m);
+                    k->fill_mask_opa(d_res, w, color, opa, m);
+                    check(k, "fill_mask_opa", w, opa);
+
+                    reset_dest();
+                    ref->map_opa(d_ref, s, w, opa);
+                    k->map_opa(d_res, s, w, opa);
+                    check(k, "map_opa", w, opa);
+
+                    reset_dest();
+                    ref->map_mask_opa(d_ref, s, w, opa, m);
+                    k->map_mask_opa(d_res, s, w, opa, m);
+                    check(k, "map_mask_opa", w, opa);
+                }
+
+                reset_dest();
+                ref->map_mask_opa(d_ref, s, w, LV_OPA_MAX, m);
+                k->map_mask_opa(d_res, s, w, LV_OPA_MAX, m);
+                check(k, "map_mask_opa", w, LV_OPA_MAX);
+
+                reset_dest();
+                ref->fill_mask(d_ref, w, color, m);
+                k->fill_mask(d_res, w, color, m);
+                check(k, "fill_mask", w, LV_OPA_COVER);
+
+                reset_dest();
+                ref->map_mask(d_ref, s, w, m);
+                k->map_mask(d_res, s, w, m);
+                check(k, "map_mask", w, LV_OPA_COVER);
+            }
+        }
+    }
+#endif
+}
+
+void test_draw_sw_blend_simd_kernels_match_the_scalar_ones(void)
+{
+#if LV_USE_DRAW_SW_SIMD
+    if(lv_draw_sw_blend_get_kernels() == NULL) {
+        TEST_IGNORE_MESSAGE("no vector kernels on this CPU");
+    }
+
+    draw_scene();
+
+    lv_draw_sw_blend_set_kernels(_lv_draw_sw_blend_simd_get_builtin(0));
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    lv_memcpy(ref_fb, test_fb, sizeof(ref_fb));
+
+    _lv_draw_sw_blend_simd_init();
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+#endif
+}
+
+#endif
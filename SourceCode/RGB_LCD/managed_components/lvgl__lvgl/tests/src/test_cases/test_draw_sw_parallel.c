@@ -0,0 +1,115 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+
+#include "unity/unity.h"
+
+#if LV_USE_DRAW_SW_PARALLEL
+
+#define CANVAS_SIZE 100
+
+extern lv_color_t test_fb[];
+
+static lv_color_t ref_fb[800 * 480];
+static lv_color_t canvas_buf[LV_CANVAS_BUF_SIZE_TRUE_COLOR_ALPHA(CANVAS_SIZE, CANVAS_SIZE)];
+
+/*Render the screen with and without the workers and compare the frame buffers*/
+static void check_identical(void)
+{
+    lv_draw_sw_parallel_set_enabled(false);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    lv_memcpy(ref_fb, test_fb, sizeof(ref_fb));
+
+    lv_draw_sw_parallel_set_enabled(true);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+}
+
+#endif
+
+void tearDown(void)
+{
+#if LV_USE_DRAW_SW_PARALLEL
+    lv_draw_sw_parallel_set_enabled(true);
+    lv_obj_clean(lv_scr_act());
+#endif
+}
+
+void test_draw_sw_parallel_rectangles_are_identical(void)
+{
+#if LV_USE_DRAW_SW_PARALLEL
+    /*Full screen gradient, then rounded, semi transparent rectangles with shadow and text on it*/
+    lv_obj_t * bg = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(bg, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_radius(bg, 0, 0);
+    lv_obj_set_style_bg_color(bg, lv_palette_main(LV_PALETTE_BLUE), 0);
+    lv_obj_set_style_bg_grad_color(bg, lv_palette_main(LV_PALETTE_RED), 0);
+    lv_obj_set_style_bg_grad_dir(bg, LV_GRAD_DIR_VER, 0);
+
+    uint32_t i;
+    for(i = 0; i < 6; i++) {
+        lv_obj_t * obj = lv_obj_create(bg);
+        lv_obj_set_pos(obj, 10 + i * 110, 10 + i * 60);
+        lv_obj_set_size(obj, 300, 200);
+        lv_obj_set_style_radius(obj, 10 + i * 15, 0);
+        lv_obj_set_style_bg_opa(obj, 80 + i * 30, 0);
+        lv_obj_set_style_bg_color(obj, lv_palette_main(i + 2), 0);
+        lv_obj_set_style_border_width(obj, i * 3, 0);
+        lv_obj_set_style_shadow_width(obj, 30, 0);
+        lv_obj_set_style_shadow_spread(obj, i * 2, 0);
+
+        lv_obj_t * label = lv_label_create(obj);
+        lv_label_set_text(label, "Rendered in stripes\non more threads");
+    }
+
+    check_identical();
+#endif
+}
+
+void test_draw_sw_parallel_images_are_identical(void)
+{
+#if LV_USE_DRAW_SW_PARALLEL
+    lv_obj_t * canvas = lv_canvas_create(lv_scr_act());
+    lv_canvas_set_buffer(canvas, canvas_buf, CANVAS_SIZE, CANVAS_SIZE, LV_IMG_CF_TRUE_COLOR_ALPHA);
+    lv_canvas_fill_bg(canvas, lv_palette_main(LV_PALETTE_GREEN), LV_OPA_50);
+    lv_draw_rect_dsc_t rect_dsc;
+    lv_draw_rect_dsc_init(&rect_dsc);
+    rect_dsc.radius = LV_RADIUS_CIRCLE;
+    rect_dsc.bg_color = lv_palette_main(LV_PALETTE_ORANGE);
+    lv_canvas_draw_rect(canvas, 10, 10, CANVAS_SIZE - 20, CANVAS_SIZE - 20, &rect_dsc);
+    lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+
+    /*Large, transformed, recolored and semi transparent images*/
+    uint32_t i;
+    for(i = 0; i < 4; i++) {
+        lv_obj_t * img = lv_img_create(lv_scr_act());
+        lv_img_set_src(img, lv_canvas_get_img(canvas));
+        lv_obj_set_pos(img, 150 + i * 120, 150 + i * 40);
+        lv_img_set_zoom(img, 512 + i * 256);
+        lv_img_set_angle(img, i * 150);
+        lv_obj_set_style_img_opa(img, 255 - i * 50, 0);
+        lv_obj_set_style_img_recolor(img, lv_palette_main(LV_PALETTE_PURPLE), 0);
+        lv_obj_set_style_img_recolor_opa(img, i * 60, 0);
+    }
+
+    check_identical();
+#endif
+}
+
+void test_draw_sw_parallel_can_be_disabled(void)
+{
+#if LV_USE_DRAW_SW_PARALLEL
+    lv_draw_sw_parallel_set_enabled(false);
+    TEST_ASSERT_FALSE(lv_draw_sw_parallel_is_enabled());
+    TEST_ASSERT_FALSE(_lv_draw_sw_parallel_should_split(800, 480));
+
+    lv_draw_sw_parallel_set_enabled(true);
+    TEST_ASSERT_TRUE(lv_draw_sw_parallel_is_enabled());
+    TEST_ASSERT_TRUE(_lv_draw_sw_parallel_should_split(800, 480));
+    TEST_ASSERT_FALSE(_lv_draw_sw_parallel_should_split(800, 1));
+#endif
+}
+
+#endif
@@ -0,0 +1,179 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+
+#include "unity/unity.h"
+
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE >= 200
+
+#define FB_SIZE     (800 * 480)
+
+/*Limit the cache in run time to fill it with small shadows*/
+#define SH_SIZE     200
+
+extern lv_color_t test_fb[];
+
+static lv_color_t ref_fb[FB_SIZE];
+static lv_opa_t corner_buf[(SH_SIZE + 1) * (SH_SIZE + 1)];
+
+static void create_cards(void)
+{
+    static const lv_coord_t variants[][2] = {{20, 10}, {30, 20}, {40, 0}};
+
+    uint32_t i;
+    for(i = 0; i < 6; i++) {
+        lv_obj_t * obj = lv_obj_create(lv_scr_act());
+        lv_obj_set_pos(obj, 40 + (i % 3) * 250, 40 + (i / 3) * 220);
+        lv_obj_set_size(obj, 180, 140);
+        lv_obj_set_style_shadow_width(obj, variants[i % 3][0], 0);
+        lv_obj_set_style_radius(obj, variants[i % 3][1], 0);
+        lv_obj_set_style_shadow_spread(obj, i % 3, 0);
+    }
+}
+
+/*Add a corner whose bytes are derived from its shadow width*/
+static void add_corner(lv_coord_t sw, lv_coord_t r)
+{
+    lv_memset(corner_buf, sw, (sw + r) * (sw + r));
+    _lv_draw_sw_shadow_cache_add(sw, r, 500, 500, corner_buf);
+}
+
+static bool check_corner(lv_coord_t sw, lv_coord_t r)
+{
+    const lv_opa_t * buf = _lv_draw_sw_shadow_cache_get(sw, r, 500, 500);
+    if(buf == NULL) return false;
+
+    uint32_t i;
+    for(i = 0; i < (uint32_t)(sw + r) * (sw + r); i++) {
+        TEST_ASSERT_EQUAL_UINT8(sw, buf[i]);
+    }
+    return true;
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE >= 200
+    lv_draw_sw_shadow_cache_clear();
+    lv_draw_sw_shadow_cache_set_size(SH_SIZE * SH_SIZE);
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE >= 200
+    lv_draw_sw_shadow_cache_clear();
+    lv_draw_sw_shadow_cache_set_size(UINT32_MAX);
+    lv_obj_clean(lv_scr_act());
+#endif
+}
+
+void test_draw_sw_shadow_cache_keeps_every_variant(void)
+{
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE >= 200
+    create_cards();
+
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    lv_memcpy(ref_fb, test_fb, sizeof(ref_fb));
+
+    lv_draw_sw_shadow_cache_info_t info;
+    lv_draw_sw_shadow_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(3, info.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(3, info.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(3, info.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(SH_SIZE * SH_SIZE, info.size);
+    TEST_ASSERT_EQUAL_UINT32(30 * 30 + 50 * 50 + 40 * 40, info.used);
+
+    /*Redraw from the cache only*/
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    lv_draw_sw_shadow_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(3, info.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(9, info.hit_cnt);
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+#endif
+}
+
+void test_draw_sw_shadow_cache_drops_the_least_recently_used(void)
+{
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE >= 200
+    uint32_t i;
+    for(i = 1; i <= LV_SHADOW_CACHE_CNT; i++) {
+        add_corner(i, 5);
+    }
+    TEST_ASSERT_TRUE(check_corner(1, 5));
+
+    /*The second corner is the least recently used now*/
+    add_corner(50, 5);
+    TEST_ASSERT_FALSE(check_corner(2, 5));
+    TEST_ASSERT_TRUE(check_corner(1, 5));
+    TEST_ASSERT_TRUE(check_corner(50, 5));
+
+    lv_draw_sw_shadow_cache_info_t info;
+    lv_draw_sw_shadow_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(LV_SHADOW_CACHE_CNT, info.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, info.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(3, info.hit_cnt);
+#endif
+}
+
+void test_draw_sw_shadow_cache_stays_in_the_budget(void)
+{
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE >= 200
+    uint32_t size = SH_SIZE * SH_SIZE;
+    lv_coord_t r = SH_SIZE / 10;
+
+    /*Two corners with a bit less than half of the cache*/
+    lv_coord_t sw = SH_SIZE * 7 / 10 - r;
+    add_corner(sw, r);
+    add_corner(sw - 1, r);
+    add_corner(sw - 2, r);
+    TEST_ASSERT_FALSE(check_corner(sw, r));
+    TEST_ASSERT_TRUE(check_corner(sw - 1, r));
+    TEST_ASSERT_TRUE(check_corner(sw - 2, r));
+
+    lv_draw_sw_shadow_cache_info_t info;
+    lv_draw_sw_shadow_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(2, info.entry_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(size, info.used);
+
+    /*The whole cache*/
+    add_corner(SH_SIZE - r, r);
+    TEST_ASSERT_TRUE(check_corner(SH_SIZE - r, r));
+    lv_draw_sw_shadow_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(1, info.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(size, info.used);
+
+    /*Too large corners are not cached*/
+    add_corner(SH_SIZE + 1 - r, r);
+    TEST_ASSERT_FALSE(check_corner(SH_SIZE + 1 - r, r));
+    TEST_ASSERT_TRUE(check_corner(SH_SIZE - r, r));
+
+    /*Shrinking drops the corners which don't fit*/
+    lv_draw_sw_shadow_cache_set_size(size - 1);
+    TEST_ASSERT_FALSE(check_corner(SH_SIZE - r, r));
+    lv_draw_sw_shadow_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(0, info.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, info.used);
+#endif
+}
+
+void test_draw_sw_shadow_cache_separates_small_areas(void)
+{
+#if LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE >= 200
+    lv_memset_00(corner_buf, 30 * 30);
+    _lv_draw_sw_shadow_cache_add(20, 10, 500, 500, corner_buf);
+
+    /*The far edges of a small area are visible in the corner*/
+    TEST_ASSERT_NULL(_lv_draw_sw_shadow_cache_get(20, 10, 20, 500));
+    TEST_ASSERT_NULL(_lv_draw_sw_shadow_cache_get(20, 10, 500, 59));
+
+    /*Large areas share the corner*/
+    TEST_ASSERT_NOT_NULL(_lv_draw_sw_shadow_cache_get(20, 10, 60, 800));
+    TEST_ASSERT_NOT_NULL(_lv_draw_sw_shadow_cache_get(20, 10, 1000, 100));
+#endif
+}
+
+#endif
@@ -0,0 +1,160 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#define MAX_PAIR_CNT    (200 * 200)
+
+static uint16_t pair_ids_16[MAX_PAIR_CNT * 2];
+static uint8_t pair_ids_8[MAX_PAIR_CNT * 2];
+static int8_t pair_values[MAX_PAIR_CNT];
+
+static lv_font_fmt_txt_kern_pair_t kern_pairs;
+static lv_font_fmt_txt_glyph_cache_t glyph_cache;
+static lv_font_fmt_txt_dsc_t font_dsc;
+static lv_font_t font;
+
+static uint32_t get_glyph_cnt(const lv_font_fmt_txt_dsc_t * dsc)
+{
+    uint32_t glyph_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < dsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &dsc->cmaps[i];
+        TEST_ASSERT_TRUE(cmap->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY || cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY);
+        uint32_t cnt = cmap->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY ? cmap->range_length : cmap->list_length;
+        glyph_cnt = LV_MAX(glyph_cnt, cmap->glyph_id_start + cnt);
+    }
+    return glyph_cnt;
+}
+
+/*Create a copy of a font with class based kerning which uses the given kerning instead*/
+static void create_font(const lv_font_t * base, const void * kern_dsc, bool kern_classes)
+{
+    font = *base;
+    font_dsc = *(const lv_font_fmt_txt_dsc_t *)base->dsc;
+    lv_memset_00(&glyph_cache, sizeof(glyph_cache));
+    font_dsc.cache = &glyph_cache;
+    font_dsc.kern_dsc = kern_dsc;
+    font_dsc.kern_classes = kern_classes ? 1 : 0;
+    font.dsc = &font_dsc;
+}
+
+/*Convert the kerning classes of a font to sorted pairs*/
+static void create_pairs(const lv_font_t * base, bool ids_16)
+{
+    const lv_font_fmt_txt_dsc_t * dsc = base->dsc;
+    const lv_font_fmt_txt_kern_classes_t * kdsc = dsc->kern_dsc;
+    uint32_t glyph_cnt = get_glyph_cnt(dsc);
+    uint32_t cnt = 0;
+    uint32_t left;
+    uint32_t right;
+    for(left = 0; left < glyph_cnt; left++) {
+        for(right = 0; right < glyph_cnt; right++) {
+            uint8_t left_class = kdsc->left_class_mapping[left];
+            uint8_t right_class = kdsc->right_class_mapping[right];
+            if(left_class == 0 || right_class == 0) continue;
+            int8_t value = kdsc->class_pair_values[(left_class - 1) * kdsc->right_class_cnt + (right_class - 1)];
+            if(value == 0) continue;
+
+            TEST_ASSERT_LESS_THAN_UINT32(MAX_PAIR_CNT, cnt);
+            pair_ids_16[cnt * 2] = left;
+            pair_ids_16[cnt * 2 + 1] = right;
+            pair_ids_8[cnt * 2] = left;
+            pair_ids_8[cnt * 2 + 1] = right;
+            pair_values[cnt] = value;
+            cnt++;
+        }
+    }
+
+    kern_pairs.glyph_ids = ids_16 ? (const void *)pair_ids_16 : (const void *)pair_ids_8;
+    kern_pairs.values = pair_values;
+    kern_pairs.pair_cnt = cnt;
+    kern_pairs.glyph_ids_size = ids_16 ? 1 : 0;
+}
+
+static void check_kerning(const lv_font_t * ref)
+{
+    uint32_t left;
+    uint32_t right;
+    uint32_t kern_cnt = 0;
+    for(left = 0x20; left < 0x7F; left++) {
+        for(right = 0x20; right < 0x7F; right++) {
+            lv_font_glyph_dsc_t g_ref;
+            lv_font_glyph_dsc_t g;
+            TEST_ASSERT_TRUE(lv_font_get_glyph_dsc(ref, &g_ref, left, right));
+            TEST_ASSERT_TRUE(lv_font_get_glyph_dsc(&font, &g, left, right));
+            TEST_ASSERT_EQUAL_UINT16(g_ref.adv_w, g.adv_w);
+
+            lv_font_get_glyph_dsc(ref, &g_ref, left, 0);
+            if(g_ref.adv_w != g.adv_w) kern_cnt++;
+        }
+    }
+
+    /*Make sure kerning was really tested*/
+    TEST_ASSERT_GREATER_THAN_UINT32(100, kern_cnt);
+}
+
+void setUp(void)
+{
+    /* Function run before every test */
+}
+
+void tearDown(void)
+{
+    _lv_font_fmt_txt_kern_cache_clear();
+}
+
+void test_font_kern_pairs(void)
+{
+    create_pairs(&lv_font_montserrat_14, true);
+    create_font(&lv_font_montserrat_14, &kern_pairs, false);
+
+    /*The second time the values come from the cache*/
+    check_kerning(&lv_font_montserrat_14);
+    check_kerning(&lv_font_montserrat_14);
+
+    _lv_font_fmt_txt_kern_cache_clear();
+    create_pairs(&lv_font_montserrat_14, false);
+    check_kerning(&lv_font_montserrat_14);
+}
+
+void test_font_kern_pairs_to_classes(void)
+{
+    const lv_font_fmt_txt_dsc_t * ref_dsc = lv_font_montserrat_14.dsc;
+    const lv_font_fmt_txt_kern_classes_t * ref_kdsc = ref_dsc->kern_dsc;
+
+    create_pairs(&lv_font_montserrat_14, true);
+    lv_font_fmt_txt_kern_classes_t * kdsc = lv_font_fmt_txt_kern_pairs_to_classes(&kern_pairs, get_glyph_cnt(ref_dsc));
+    TEST_ASSERT_NOT_NULL(kdsc);
+
+    /*The glyphs with the same kerning share the classes*/
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(ref_kdsc->left_class_cnt, kdsc->left_class_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(ref_kdsc->right_class_cnt, kdsc->right_class_cnt);
+
+    create_font(&lv_font_montserrat_14, kdsc, true);
+    check_kerning(&lv_font_montserrat_14);
+
+    lv_mem_free((void *)kdsc->class_pair_values);
+    lv_mem_free((void *)kdsc->left_class_mapping);
+    lv_mem_free((void *)kdsc->right_class_mapping);
+    lv_mem_free(kdsc);
+}
+
+void test_font_kern_pairs_to_classes_too_many_classes(void)
+{
+    /*Every glyph pair has a different value so more than 255 classes would be needed*/
+    uint32_t i;
+    for(i = 0; i < 300; i++) {
+        pair_ids_16[i * 2] = i;
+        pair_ids_16[i * 2 + 1] = i;
+        pair_values[i] = (int8_t)i;
+    }
+    kern_pairs.glyph_ids = pair_ids_16;
+    kern_pairs.values = pair_values;
+    kern_pairs.pair_cnt = 300;
+    kern_pairs.glyph_ids_size = 1;
+
+    TEST_ASSERT_NULL(lv_font_fmt_txt_kern_pairs_to_classes(&kern_pairs, 300));
+}
+
+#endif
@@ -25,7 +25,10 @@
  **********************/
 
 static int compare_fonts(lv_font_t * f1, lv_font_t * f2);
+static void compare_bitmaps(lv_font_t * f1, lv_font_t * f2);
 void test_font_loader(void);
+void test_font_loader_lazy(void);
+void test_font_loader_lazy_small_cache(void);
 
 /**********************
  *  STATIC VARIABLES
@@ -72,6 +75,67 @@ void test_font_loader(void)
     lv_font_free(font_3_bin);
 }
 
+void test_font_loader_lazy(void)
+{
+    static const char * paths[] = {
+        "A:src/test_fonts/font_1.fnt",
+        "A:src/test_fonts/font_2.fnt",
+        "A:src/test_fonts/font_3.fnt",
+        "B:src/test_fonts/font_1.fnt",
+    };
+
+    for(uint32_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+        lv_font_t * font_bin = lv_font_load(paths[i]);
+        lv_font_t * font_lazy = lv_font_load_lazy(paths[i], 16 * 1024);
+        TEST_ASSERT_NOT_NULL(font_bin);
+        TEST_ASSERT_NOT_NULL(font_lazy);
+
+        compare_bitmaps(font_bin, font_lazy);
+
+        lv_font_loader_info_t info_bin;
+        lv_font_loader_info_t info_lazy;
+        lv_font_loader_get_info(font_bin, &info_bin);
+        lv_font_loader_get_info(font_lazy, &info_lazy);
+        TEST_ASSERT_EQUAL_UINT32(info_bin.glyph_cnt, info_lazy.glyph_cnt);
+        TEST_ASSERT_LESS_THAN_UINT32(info_bin.mem_size, info_lazy.mem_size);
+        TEST_ASSERT_EQUAL_UINT32(0, info_bin.cache_size);
+        TEST_ASSERT_GREATER_THAN_UINT32(0, info_lazy.cache_used);
+        TEST_ASSERT_EQUAL_UINT32(0, info_lazy.hit_cnt);
+
+        /*The second time the bitmaps are read from the cache*/
+        uint32_t miss_cnt = info_lazy.miss_cnt;
+        compare_bitmaps(font_bin, font_lazy);
+        lv_font_loader_get_info(font_lazy, &info_lazy);
+        TEST_ASSERT_EQUAL_UINT32(miss_cnt, info_lazy.miss_cnt);
+        TEST_ASSERT_EQUAL_UINT32(miss_cnt, info_lazy.hit_cnt);
+
+        lv_font_free(font_bin);
+        lv_font_free(font_lazy);
+    }
+}
+
+void test_font_loader_lazy_small_cache(void)
+{
+    lv_font_t * font_bin = lv_font_load("A:src/test_fonts/font_3.fnt");
+    lv_font_t * font_lazy = lv_font_load_lazy("A:src/test_fonts/font_3.fnt", 256);
+
+    /*The glyphs replace each other in the cache, the large ones are not cached at all*/
+    compare_bitmaps(font_bin, font_lazy);
+    compare_bitmaps(font_bin, font_lazy);
+
+    lv_font_loader_info_t info;
+    lv_font_loader_get_info(font_lazy, &info);
+    TEST_ASSERT_EQUAL_UINT32(256, info.cache_size);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(info.cache_size, info.cache_used);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, info.miss_cnt);
+
+    lv_font_free(font_bin);
+    lv_font_free(font_lazy);
+
+    /*Missing file*/
+    TEST_ASSERT_NULL(lv_font_load_lazy("A:src/test_fonts/no_such_font.fnt", 256));
+}
+
 static int compare_fonts(lv_font_t * f1, lv_font_t * f2)
 {
     TEST_ASSERT_NOT_NULL_MESSAGE(f1, "font not null");
@@ -216,5 +280,33 @@ static int compare_fonts(lv_font_t * f1, lv_font_t * f2)
  *   STATIC FUNCTIONS
  **********************/
 
+/*Compare the bitmaps of the ASCII letters as they are drawn*/
+static void compare_bitmaps(lv_font_t * f1, lv_font_t * f2)
+{
+    static uint8_t buf[1024];
+
+    for(uint32_t letter = 0x20; letter < 0x7F; letter++) {
+        lv_font_glyph_dsc_t g;
+        if(!lv_font_get_glyph_dsc(f1, &g, letter, 0)) continue;
+
+        const lv_font_fmt_txt_dsc_t * dsc = f1->dsc;
+        uint32_t bpp = g.bpp;
+        /*Compressed bitmaps are decompressed to 4 bpp*/
+        if(bpp == 3 && dsc->bitmap_format != LV_FONT_FMT_TXT_PLAIN) bpp = 4;
+        uint32_t size = ((uint32_t)g.box_w * g.box_h * bpp + 7) / 8;
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(sizeof(buf), size);
+        if(size == 0) continue;
+
+        /*The decompressed bitmaps are valid only until the next call*/
+        const uint8_t * bmp1 = lv_font_get_glyph_bitmap(f1, letter);
+        TEST_ASSERT_NOT_NULL(bmp1);
+        lv_memcpy(buf, bmp1, size);
+
+        const uint8_t * bmp2 = lv_font_get_glyph_bitmap(f2, letter);
+        TEST_ASSERT_NOT_NULL(bmp2);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(buf, bmp2, size);
+    }
+}
+
 #endif // LV_BUILD_TEST
 
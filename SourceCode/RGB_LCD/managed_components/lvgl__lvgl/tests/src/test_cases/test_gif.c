@@ -0,0 +1,224 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#if LV_USE_GIF
+
+#define GIF_W       40
+#define GIF_H       30
+#define OBJ_X       100
+#define OBJ_Y       50
+
+extern lv_color_t test_fb[];
+
+static const uint8_t palette[4][3] = {{0x00, 0x00, 0xff}, {0xff, 0x00, 0x00}, {0x00, 0xff, 0x00}, {0xff, 0xff, 0xff}};
+
+static uint8_t gif_data[4096];
+static uint32_t gif_size;
+static lv_img_dsc_t gif_dsc;
+
+static void put_u8(uint8_t v)
+{
+    TEST_ASSERT_LESS_THAN_UINT32(sizeof(gif_data), gif_size);
+    gif_data[gif_size++] = v;
+}
+
+static void put_u16(uint16_t v)
+{
+    put_u8(v & 0xff);
+    put_u8(v >> 8);
+}
+
+static void gif_start(void)
+{
+    gif_size = 0;
+    const char * sig = "GIF89a";
+    while(*sig) put_u8(*sig++);
+    put_u16(GIF_W);
+    put_u16(GIF_H);
+    put_u8(0x81);   /*4 colors in the global color table*/
+    put_u8(0);      /*Background color index*/
+    put_u8(0);
+    uint32_t i;
+    for(i = 0; i < 4; i++) {
+        put_u8(palette[i][0]);
+        put_u8(palette[i][1]);
+        put_u8(palette[i][2]);
+    }
+}
+
+/*Add a frame filled with a color. The codes are not compressed: a clear code is sent before every 2 pixels
+ *to keep the code size on 3 bits.*/
+static void gif_add_frame(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t color, uint8_t disposal)
+{
+    /*Graphic control extension*/
+    put_u8(0x21);
+    put_u8(0xf9);
+    put_u8(4);
+    put_u8(disposal << 2);
+    put_u16(10);
+    put_u8(0);
+    put_u8(0);
+
+    /*Image descriptor*/
+    put_u8(0x2c);
+    put_u16(x);
+    put_u16(y);
+    put_u16(w);
+    put_u16(h);
+    put_u8(0);
+
+    /*LZW data*/
+    put_u8(2);
+    uint8_t codes[2048];
+    uint32_t code_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < (uint32_t)w * h; i++) {
+        if(i % 2 == 0) codes[code_cnt++] = 4;    /*Clear*/
+        codes[code_cnt++] = color;
+    }
+    codes[code_cnt++] = 5;  /*Stop*/
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(sizeof(codes), code_cnt);
+
+    uint8_t bytes[1024];
+    uint32_t byte_cnt = (code_cnt * 3 + 7) / 8;
+    lv_memset_00(bytes, sizeof(bytes));
+    for(i = 0; i < code_cnt; i++) {
+        uint32_t bit;
+        for(bit = 0; bit < 3; bit++) {
+            if(codes[i] & (1 << bit)) bytes[(i * 3 + bit) / 8] |= 1 << ((i * 3 + bit) % 8);
+        }
+    }
+
+    for(i = 0; i < byte_cnt; i += 255) {
+        uint32_t len = LV_MIN(255, byte_cnt - i);
+        put_u8(len);
+        uint32_t j;
+        for(j = 0; j < len; j++) put_u8(bytes[i + j]);
+    }
+    put_u8(0);
+}
+
+static void gif_end(void)
+{
+    put_u8(0x3b);
+    lv_memset_00(&gif_dsc, sizeof(gif_dsc));
+    gif_dsc.data = gif_data;
+    gif_dsc.data_size = gif_size;
+}
+
+static void refr_all(void)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+static void check_rect(lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h, uint8_t color)
+{
+    lv_color_t c = lv_color_make(palette[color][0], palette[color][1], palette[color][2]);
+    lv_coord_t i;
+    lv_coord_t j;
+    for(j = y; j < y + h; j++) {
+        for(i = x; i < x + w; i++) {
+            TEST_ASSERT_EQUAL_HEX32(c.full, test_fb[(OBJ_Y + j) * 800 + OBJ_X + i].full);
+        }
+    }
+}
+
+/*Show the next frame and return the invalidated area*/
+static void next_frame(lv_obj_t * obj, lv_area_t * inv_area)
+{
+    lv_refr_now(NULL);
+    lv_tick_inc(100);
+    lv_timer_t * timer = ((lv_gif_t *)obj)->timer;
+    timer->timer_cb(timer);
+
+    lv_disp_t * disp = lv_disp_get_default();
+    TEST_ASSERT_EQUAL_UINT16(1, disp->inv_p);
+    lv_area_copy(inv_area, &disp->inv_areas[0]);
+}
+
+/*The invalidated areas are increased by 5 px on each side and truncated to the object*/
+static void check_area(const lv_area_t * area, lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2)
+{
+    TEST_ASSERT_EQUAL_INT32(OBJ_X + LV_MAX(x1 - 5, 0), area->x1);
+    TEST_ASSERT_EQUAL_INT32(OBJ_Y + LV_MAX(y1 - 5, 0), area->y1);
+    TEST_ASSERT_EQUAL_INT32(OBJ_X + LV_MIN(x2 + 5, GIF_W - 1), area->x2);
+    TEST_ASSERT_EQUAL_INT32(OBJ_Y + LV_MIN(y2 + 5, GIF_H - 1), area->y2);
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_USE_IMG_DECODE_ASYNC
+    lv_img_decode_async_set_enabled(false);
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_USE_GIF
+    lv_obj_clean(lv_scr_act());
+#endif
+
+#if LV_USE_IMG_DECODE_ASYNC
+    lv_img_decode_async_set_enabled(true);
+#endif
+}
+
+void test_gif_frames_invalidate_only_the_changed_area(void)
+{
+#if LV_USE_GIF
+    gif_start();
+    gif_add_frame(0, 0, GIF_W, GIF_H, 1, 1);
+    gif_add_frame(5, 6, 10, 8, 2, 2);       /*Restored to the background color*/
+    gif_add_frame(20, 10, 6, 4, 3, 1);
+    gif_end();
+
+    lv_obj_t * obj = lv_gif_create(lv_scr_act());
+    lv_gif_set_src(obj, &gif_dsc);
+    lv_obj_set_pos(obj, OBJ_X, OBJ_Y);
+    refr_all();
+    check_rect(0, 0, GIF_W, GIF_H, 1);
+
+    lv_area_t inv_area;
+    next_frame(obj, &inv_area);
+    check_area(&inv_area, 5, 6, 14, 13);
+    refr_all();
+    check_rect(0, 0, GIF_W, 6, 1);
+    check_rect(5, 6, 10, 8, 2);
+
+    /*The disposed previous frame and the new frame*/
+    next_frame(obj, &inv_area);
+    check_area(&inv_area, 5, 6, 25, 13);
+    refr_all();
+    check_rect(5, 6, 10, 8, 0);
+    check_rect(20, 10, 6, 4, 3);
+    check_rect(0, 14, GIF_W, GIF_H - 14, 1);
+#endif
+}
+
+void test_gif_zoomed_invalidates_the_whole_object(void)
+{
+#if LV_USE_GIF
+    gif_start();
+    gif_add_frame(0, 0, GIF_W, GIF_H, 1, 1);
+    gif_add_frame(5, 6, 10, 8, 2, 1);
+    gif_end();
+
+    lv_obj_t * obj = lv_gif_create(lv_scr_act());
+    lv_gif_set_src(obj, &gif_dsc);
+    lv_obj_set_pos(obj, OBJ_X, OBJ_Y);
+    lv_img_set_zoom(obj, 512);
+
+    lv_area_t inv_area;
+    next_frame(obj, &inv_area);
+    lv_area_t coords;
+    lv_obj_get_coords(obj, &coords);
+    TEST_ASSERT_TRUE(_lv_area_is_in(&coords, &inv_area, 0));
+#endif
+}
+
+#endif
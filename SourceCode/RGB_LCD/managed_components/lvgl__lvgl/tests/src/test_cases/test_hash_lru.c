@@ -0,0 +1,147 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include "../../src/misc/lv_hash_lru.h"
+
+#define BUCKET_CNT  4
+
+typedef struct {
+    _lv_hash_lru_entry_t lru;
+    uint32_t id;
+} test_entry_t;
+
+static _lv_hash_lru_t lru;
+static _lv_hash_lru_entry_t * buckets[BUCKET_CNT];
+static uint32_t free_cnt;
+
+static bool match(const _lv_hash_lru_entry_t * entry, const void * id)
+{
+    return ((const test_entry_t *)entry)->id == *(const uint32_t *)id;
+}
+
+static bool match_odd(const _lv_hash_lru_entry_t * entry, const void * key)
+{
+    LV_UNUSED(key);
+    return ((const test_entry_t *)entry)->id & 1;
+}
+
+static void entry_free(_lv_hash_lru_entry_t * entry)
+{
+    free_cnt++;
+    lv_mem_free(entry);
+}
+
+static void add(uint32_t id, uint32_t size)
+{
+    test_entry_t * entry = lv_mem_alloc(sizeof(test_entry_t));
+    TEST_ASSERT_NOT_NULL(entry);
+    entry->id = id;
+    _lv_hash_lru_add(&lru, &entry->lru, _lv_hash_lru_hash(NULL, id), size);
+}
+
+static test_entry_t * get(uint32_t id)
+{
+    return (test_entry_t *)_lv_hash_lru_get(&lru, _lv_hash_lru_hash(NULL, id), match, &id);
+}
+
+static test_entry_t * find(uint32_t id)
+{
+    return (test_entry_t *)_lv_hash_lru_find(&lru, _lv_hash_lru_hash(NULL, id), match, &id);
+}
+
+void setUp(void)
+{
+    _lv_hash_lru_init(&lru, buckets, BUCKET_CNT, entry_free);
+    free_cnt = 0;
+}
+
+void tearDown(void)
+{
+    _lv_hash_lru_drop_matching(&lru, NULL, NULL);
+    TEST_ASSERT_EQUAL_UINT32(0, lru.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, lru.used);
+    TEST_ASSERT_NULL(lru.head);
+    TEST_ASSERT_NULL(lru.tail);
+}
+
+void test_hash_lru_find(void)
+{
+    /*More entries than buckets to have collisions*/
+    uint32_t i;
+    for(i = 1; i <= 20; i++) add(i, i);
+
+    TEST_ASSERT_EQUAL_UINT32(20, lru.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(20 * 21 / 2, lru.used);
+    for(i = 1; i <= 20; i++) {
+        test_entry_t * entry = get(i);
+        TEST_ASSERT_NOT_NULL(entry);
+        TEST_ASSERT_EQUAL_UINT32(i, entry->id);
+        TEST_ASSERT_EQUAL_UINT32(i, entry->lru.size);
+    }
+    TEST_ASSERT_NULL(get(21));
+
+    TEST_ASSERT_EQUAL_UINT32(20, lru.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, lru.miss_cnt);
+
+    /*Finding an entry doesn't count*/
+    TEST_ASSERT_NOT_NULL(find(5));
+    TEST_ASSERT_NULL(find(21));
+    TEST_ASSERT_EQUAL_UINT32(20, lru.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, lru.miss_cnt);
+}
+
+void test_hash_lru_drops_the_least_recently_used(void)
+{
+    add(1, 10);
+    add(2, 10);
+    add(3, 10);
+    add(4, 10);
+
+    /*Used recently, so it's kept*/
+    TEST_ASSERT_NOT_NULL(get(1));
+    TEST_ASSERT_NOT_NULL(find(2));
+
+    _lv_hash_lru_shrink(&lru, UINT32_MAX, 25, NULL);
+    TEST_ASSERT_EQUAL_UINT32(2, lru.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(20, lru.used);
+    TEST_ASSERT_EQUAL_UINT32(2, lru.evict_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2, free_cnt);
+    TEST_ASSERT_NOT_NULL(find(1));
+    TEST_ASSERT_NOT_NULL(find(4));
+    TEST_ASSERT_NULL(find(2));
+    TEST_ASSERT_NULL(find(3));
+
+    /*The kept entry is skipped*/
+    test_entry_t * keep = find(4);
+    _lv_hash_lru_shrink(&lru, 0, UINT32_MAX, &keep->lru);
+    TEST_ASSERT_EQUAL_UINT32(1, lru.entry_cnt);
+    TEST_ASSERT_EQUAL_PTR(keep, find(4));
+    TEST_ASSERT_EQUAL_PTR(&keep->lru, lru.head);
+    TEST_ASSERT_EQUAL_PTR(&keep->lru, lru.tail);
+}
+
+void test_hash_lru_drop_matching(void)
+{
+    uint32_t i;
+    for(i = 1; i <= 10; i++) add(i, 1);
+
+    _lv_hash_lru_drop_matching(&lru, match_odd, NULL);
+    TEST_ASSERT_EQUAL_UINT32(5, lru.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(5, free_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, lru.evict_cnt);
+    for(i = 1; i <= 10; i++) {
+        if(i & 1) TEST_ASSERT_NULL(find(i));
+        else TEST_ASSERT_NOT_NULL(find(i));
+    }
+
+    /*The order of the rest is kept: 10 is the most recently added*/
+    const _lv_hash_lru_entry_t * entry = lru.head;
+    for(i = 10; i >= 2; i -= 2) {
+        TEST_ASSERT_EQUAL_UINT32(i, ((const test_entry_t *)entry)->id);
+        entry = entry->next;
+    }
+    TEST_ASSERT_NULL(entry);
+}
+
+#endif
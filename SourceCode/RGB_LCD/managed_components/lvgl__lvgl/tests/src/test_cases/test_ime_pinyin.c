@@ -0,0 +1,187 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#if LV_USE_IME_PINYIN
+
+static lv_obj_t * ime;
+static lv_obj_t * kb;
+static lv_obj_t * ta;
+
+/*Not sorted on purpose*/
+static lv_pinyin_dict_t unsorted_dict[] = {
+    { "ni", "你" },
+    { "hao", "好" },
+    { "ha", "哈" },
+    { "hai", "还" },
+    { "a", "啊" },
+    {NULL, NULL}
+};
+
+/*Too many entries to sort them*/
+static lv_pinyin_dict_t huge_dict[UINT16_MAX + 2];
+
+static void press(const char * txt)
+{
+    uint16_t i;
+    for(i = 0; ; i++) {
+        const char * btn_txt = lv_btnmatrix_get_btn_text(kb, i);
+        TEST_ASSERT_NOT_NULL_MESSAGE(btn_txt, txt);
+        if(strcmp(btn_txt, txt) == 0) break;
+    }
+
+    lv_btnmatrix_set_selected_btn(kb, i);
+    lv_event_send(kb, LV_EVENT_VALUE_CHANGED, NULL);
+}
+
+static const char * get_first_cand(void)
+{
+    lv_obj_t * cand_panel = lv_ime_pinyin_get_cand_panel(ime);
+    if(lv_obj_has_flag(cand_panel, LV_OBJ_FLAG_HIDDEN)) return NULL;
+    return lv_btnmatrix_get_btn_text(cand_panel, 1);
+}
+
+#if LV_IME_PINYIN_USE_K9_MODE
+/*Count the combinations of the keys' letters which are the beginning of a pinyin, the slow way*/
+static uint32_t count_k9_combinations(const char * keys[], uint32_t key_cnt)
+{
+    lv_pinyin_dict_t * dict = lv_ime_pinyin_get_dict(ime);
+    char py[8] = {0};
+    uint32_t cnt = 0;
+    uint32_t combination_cnt = 1;
+    for(uint32_t k = 0; k < key_cnt; k++) combination_cnt *= strlen(keys[k]);
+
+    for(uint32_t c = 0; c < combination_cnt; c++) {
+        uint32_t rest = c;
+        for(int32_t k = key_cnt - 1; k >= 0; k--) {
+            uint32_t n = strlen(keys[k]);
+            py[k] = keys[k][rest % n];
+            rest /= n;
+        }
+
+        if(py[0] == 'i' || py[0] == 'u' || py[0] == 'v') continue;
+        for(uint32_t i = 0; dict[i].py; i++) {
+            if(strncmp(dict[i].py, py, key_cnt) == 0) {
+                cnt++;
+                break;
+            }
+        }
+    }
+
+    return cnt;
+}
+#endif
+
+#endif
+
+void setUp(void)
+{
+#if LV_USE_IME_PINYIN
+    ime = lv_ime_pinyin_create(lv_scr_act());
+    kb = lv_keyboard_create(lv_scr_act());
+    ta = lv_textarea_create(lv_scr_act());
+    lv_keyboard_set_textarea(kb, ta);
+    lv_ime_pinyin_set_keyboard(ime, kb);
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_USE_IME_PINYIN
+    lv_obj_clean(lv_scr_act());
+#endif
+}
+
+void test_ime_pinyin_k26_finds_the_candidates(void)
+{
+#if LV_USE_IME_PINYIN && LV_IME_PINYIN_USE_DEFAULT_DICT
+    press("n");
+    TEST_ASSERT_EQUAL_STRING("那", get_first_cand());
+    press("i");
+    TEST_ASSERT_EQUAL_STRING("你", get_first_cand());
+
+    press(LV_SYMBOL_NEW_LINE);
+    TEST_ASSERT_NULL(get_first_cand());
+
+    /*The perfect match comes before the longer pinyins*/
+    press("z");
+    press("u");
+    TEST_ASSERT_EQUAL_STRING("足", get_first_cand());
+
+    press(LV_SYMBOL_NEW_LINE);
+    press("i");
+    TEST_ASSERT_NULL(get_first_cand());
+#endif
+}
+
+void test_ime_pinyin_unsorted_dict(void)
+{
+#if LV_USE_IME_PINYIN
+    lv_ime_pinyin_set_dict(ime, unsorted_dict);
+    lv_ime_pinyin_t * pinyin_ime = (lv_ime_pinyin_t *)ime;
+    TEST_ASSERT_NOT_NULL(pinyin_ime->dict_index);
+    TEST_ASSERT_EQUAL_UINT32(5, pinyin_ime->dict_num);
+
+    press("h");
+    TEST_ASSERT_EQUAL_STRING("哈", get_first_cand());
+    press("a");
+    TEST_ASSERT_EQUAL_STRING("哈", get_first_cand());
+    press("o");
+    TEST_ASSERT_EQUAL_STRING("好", get_first_cand());
+    press(LV_SYMBOL_BACKSPACE);
+    press("i");
+    TEST_ASSERT_EQUAL_STRING("还", get_first_cand());
+
+    press(LV_SYMBOL_NEW_LINE);
+    press("n");
+    TEST_ASSERT_EQUAL_STRING("你", get_first_cand());
+#endif
+}
+
+void test_ime_pinyin_huge_unsorted_dict_is_rejected(void)
+{
+#if LV_USE_IME_PINYIN
+    lv_ime_pinyin_set_dict(ime, unsorted_dict);
+
+    /*The members are `const`, so copy the entries*/
+    uint32_t i;
+    for(i = 0; i < UINT16_MAX + 1; i++) {
+        lv_memcpy(&huge_dict[i], &unsorted_dict[i & 1], sizeof(lv_pinyin_dict_t));
+    }
+    lv_memcpy(&huge_dict[i], &unsorted_dict[5], sizeof(lv_pinyin_dict_t));
+
+    /*The previous dictionary is kept*/
+    lv_ime_pinyin_set_dict(ime, huge_dict);
+    lv_ime_pinyin_t * pinyin_ime = (lv_ime_pinyin_t *)ime;
+    TEST_ASSERT_EQUAL_PTR(unsorted_dict, lv_ime_pinyin_get_dict(ime));
+    TEST_ASSERT_NOT_NULL(pinyin_ime->dict_index);
+    TEST_ASSERT_EQUAL_UINT32(5, pinyin_ime->dict_num);
+
+    press("n");
+    TEST_ASSERT_EQUAL_STRING("你", get_first_cand());
+#endif
+}
+
+void test_ime_pinyin_k9_skips_the_invalid_combinations(void)
+{
+#if LV_USE_IME_PINYIN && LV_IME_PINYIN_USE_K9_MODE && LV_IME_PINYIN_USE_DEFAULT_DICT
+    lv_ime_pinyin_t * pinyin_ime = (lv_ime_pinyin_t *)ime;
+    lv_ime_pinyin_set_mode(ime, LV_IME_PINYIN_MODE_K9);
+
+    static const char * keys[] = {"mno", "ghi", "mno"};
+    for(uint32_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+        press(keys[i]);
+        TEST_ASSERT_EQUAL_UINT32(count_k9_combinations(keys, i + 1), pinyin_ime->k9_legal_py_count);
+    }
+
+    /*In alphabetical order*/
+    ime_pinyin_k9_py_str_t * py = _lv_ll_get_head(&pinyin_ime->k9_legal_py_ll);
+    TEST_ASSERT_EQUAL_UINT32(2, pinyin_ime->k9_legal_py_count);
+    TEST_ASSERT_EQUAL_STRING("min", py->py_str);
+    py = _lv_ll_get_next(&pinyin_ime->k9_legal_py_ll, py);
+    TEST_ASSERT_EQUAL_STRING("nin", py->py_str);
+#endif
+}
+
+#endif
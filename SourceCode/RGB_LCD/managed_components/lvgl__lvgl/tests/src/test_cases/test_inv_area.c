@@ -0,0 +1,124 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+static uint32_t flush_cnt;
+static void (*flush_cb_ori)(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
+
+static void counting_flush_cb(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    flush_cnt++;
+    flush_cb_ori(disp_drv, area, color_p);
+}
+
+static void inv_area(lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2)
+{
+    lv_area_t a;
+    lv_area_set(&a, x1, y1, x2, y2);
+    _lv_inv_area(NULL, &a);
+}
+
+void setUp(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    flush_cb_ori = disp->driver->flush_cb;
+    disp->driver->flush_cb = counting_flush_cb;
+    disp->driver->flush_cost_px = 0;
+
+    /*Start without invalidated areas*/
+    lv_refr_now(NULL);
+    flush_cnt = 0;
+}
+
+void tearDown(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    disp->driver->flush_cb = flush_cb_ori;
+    disp->driver->flush_cost_px = 0;
+}
+
+void test_inv_area_overlapping_areas_are_joined(void)
+{
+    inv_area(10, 10, 59, 59);
+    inv_area(20, 20, 69, 69);
+    inv_area(200, 10, 209, 19);
+
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(2, flush_cnt);
+}
+
+void test_inv_area_separate_areas_are_joined_only_if_the_flush_costs_more(void)
+{
+    /*Two 10x10 areas with a 10 px gap. The bounding box has 100 extra pixels.*/
+    inv_area(10, 10, 19, 19);
+    inv_area(30, 10, 39, 19);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(2, flush_cnt);
+
+    flush_cnt = 0;
+    lv_disp_get_default()->driver->flush_cost_px = 100;
+    inv_area(10, 10, 19, 19);
+    inv_area(30, 10, 39, 19);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(2, flush_cnt);
+
+    flush_cnt = 0;
+    lv_disp_get_default()->driver->flush_cost_px = 101;
+    inv_area(10, 10, 19, 19);
+    inv_area(30, 10, 39, 19);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(1, flush_cnt);
+}
+
+void test_inv_area_chain_of_areas_is_joined(void)
+{
+    /*Vertically spread areas which are close enough to form 2 groups*/
+    lv_disp_get_default()->driver->flush_cost_px = 10 * 20;
+    inv_area(100, 100, 109, 109);
+    inv_area(100, 300, 109, 309);
+    inv_area(100, 120, 109, 129);
+    inv_area(100, 140, 109, 149);
+    inv_area(100, 280, 109, 289);
+
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(2, flush_cnt);
+}
+
+void test_inv_area_overflow_does_not_invalidate_the_screen(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+
+    /*A grid of small "indicators", more than what fits into the buffer*/
+    uint32_t i;
+    for(i = 0; i < LV_INV_BUF_SIZE + 16; i++) {
+        lv_coord_t x = (i % 8) * 100;
+        lv_coord_t y = (i / 8) * 60;
+        inv_area(x, y, x + 9, y + 9);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(LV_INV_BUF_SIZE, disp->inv_p);
+
+    uint32_t px_sum = 0;
+    for(i = 0; i < disp->inv_p; i++) {
+        px_sum += lv_area_get_size(&disp->inv_areas[i]);
+    }
+    TEST_ASSERT_LESS_THAN_UINT32(lv_disp_get_hor_res(disp) * lv_disp_get_ver_res(disp) / 4, px_sum);
+
+    /*All areas still have to be redrawn*/
+    for(i = 0; i < LV_INV_BUF_SIZE + 16; i++) {
+        lv_area_t a;
+        lv_area_set(&a, (i % 8) * 100, (i / 8) * 60, (i % 8) * 100 + 9, (i / 8) * 60 + 9);
+        uint32_t j;
+        bool found = false;
+        for(j = 0; j < disp->inv_p; j++) {
+            if(_lv_area_is_in(&a, &disp->inv_areas[j], 0)) found = true;
+        }
+        TEST_ASSERT_TRUE(found);
+    }
+
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(0, disp->inv_p);
+}
+
+#endif
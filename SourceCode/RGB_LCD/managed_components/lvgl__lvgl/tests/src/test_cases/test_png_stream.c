@@ -0,0 +1,311 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include "../../src/extra/libs/png/lodepng.h"
+#include "../../src/extra/libs/png/lv_png_stream.h"
+#include <stdio.h>
+
+#if LV_USE_PNG && LV_PNG_STREAM && LV_COLOR_DEPTH == 32
+
+extern lv_color_t test_fb[];
+
+static uint8_t * png;
+static size_t png_size;
+static lv_img_dsc_t img;
+static uint8_t palette_size;
+
+#define BAD_PNG_FILE    "/tmp/lv_test_png_stream_bad.png"
+
+static void get_raw_px(lv_coord_t x, lv_coord_t y, unsigned colortype, uint8_t * px)
+{
+    if(colortype == LCT_PALETTE) {
+        uint8_t i = (x * 3 + y * 5 + (x * y) % 7) % palette_size;
+        px[0] = i * 16;
+        px[1] = 255 - i * 16;
+        px[2] = i * 8;
+        px[3] = i * 17;
+        return;
+    }
+
+    px[0] = (x * 7 + y * 3) ^ (x * y);
+    px[1] = x * 5 + y * 11;
+    px[2] = (y * 9) ^ x;
+    px[3] = x + y * 13;
+    if(colortype == LCT_GREY || colortype == LCT_GREY_ALPHA) {
+        px[1] = px[0];
+        px[2] = px[0];
+    }
+}
+
+/*Encode an RGBA image with the given PNG color mode. lodepng converts the pixels.*/
+static void encode(unsigned w, unsigned h, unsigned colortype, unsigned bitdepth, unsigned btype, unsigned interlace)
+{
+    palette_size = 1 << LV_MIN(bitdepth, 4);
+    uint8_t * raw = lv_mem_alloc(w * h * 4);
+    TEST_ASSERT_NOT_NULL(raw);
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = 0; y < (lv_coord_t)h; y++) {
+        for(x = 0; x < (lv_coord_t)w; x++) get_raw_px(x, y, colortype, raw + (y * w + x) * 4);
+    }
+
+    LodePNGState state;
+    lodepng_state_init(&state);
+    state.encoder.auto_convert = 0;
+    state.encoder.zlibsettings.btype = btype;
+    state.info_png.interlace_method = interlace;
+    state.info_png.color.colortype = colortype;
+    state.info_png.color.bitdepth = bitdepth;
+    if(colortype == LCT_PALETTE) {
+        uint8_t i;
+        for(i = 0; i < palette_size; i++) lodepng_palette_add(&state.info_png.color, i * 16, 255 - i * 16, i * 8, i * 17);
+    }
+    else if(colortype == LCT_RGB || colortype == LCT_GREY) {
+        /*Make a pixel transparent with a tRNS chunk*/
+        uint8_t px[4];
+        get_raw_px(3, 2, colortype, px);
+        uint32_t mul = bitdepth == 16 ? 257 : 1;
+        state.info_png.color.key_defined = 1;
+        state.info_png.color.key_r = px[0] * mul;
+        state.info_png.color.key_g = px[1] * mul;
+        state.info_png.color.key_b = px[2] * mul;
+        if(colortype == LCT_GREY && bitdepth < 8) state.info_png.color.key_r = px[0] >> (8 - bitdepth);
+    }
+
+    unsigned error = lodepng_encode(&png, &png_size, raw, w, h, &state);
+    lodepng_state_cleanup(&state);
+    lv_mem_free(raw);
+    TEST_ASSERT_EQUAL_UINT32(0, error);
+
+    lv_memset_00(&img, sizeof(img));
+    img.data = png;
+    img.data_size = png_size;
+}
+
+static void check_px(const uint8_t * ref_rgba, lv_color_t c, bool has_alpha)
+{
+    TEST_ASSERT_EQUAL_HEX8(ref_rgba[0], c.ch.red);
+    TEST_ASSERT_EQUAL_HEX8(ref_rgba[1], c.ch.green);
+    TEST_ASSERT_EQUAL_HEX8(ref_rgba[2], c.ch.blue);
+    if(has_alpha) TEST_ASSERT_EQUAL_HEX8(ref_rgba[3], c.ch.alpha);
+    else TEST_ASSERT_EQUAL_HEX8(0xff, ref_rgba[3]);
+}
+
+/*Read the image line by line, bottom to top and in areas and compare it with lodepng's result*/
+static void check_stream(void)
+{
+    uint8_t * ref;
+    unsigned w;
+    unsigned h;
+    TEST_ASSERT_EQUAL_UINT32(0, lodepng_decode32(&ref, &w, &h, png, png_size));
+
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, &img, lv_color_black(), 0));
+    TEST_ASSERT_NULL(dsc.img_data);
+    TEST_ASSERT_EQUAL(w, dsc.header.w);
+    TEST_ASSERT_EQUAL(h, dsc.header.h);
+    bool has_alpha = dsc.header.cf == LV_IMG_CF_TRUE_COLOR_ALPHA;
+
+    lv_color_t * buf = lv_mem_alloc(w * h * sizeof(lv_color_t));
+    TEST_ASSERT_NOT_NULL(buf);
+    uint32_t i;
+    lv_coord_t y;
+
+    for(y = 0; y < (lv_coord_t)h; y++) {
+        TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, 0, y, w, (uint8_t *)(buf + y * w)));
+    }
+    for(i = 0; i < w * h; i++) check_px(ref + i * 4, buf[i], has_alpha);
+
+    lv_memset_00(buf, w * h * sizeof(lv_color_t));
+    for(y = h - 1; y >= 0; y--) {
+        TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, 0, y, w, (uint8_t *)(buf + y * w)));
+    }
+    for(i = 0; i < w * h; i++) check_px(ref + i * 4, buf[i], has_alpha);
+
+    /*A 5 px wide area from the middle, the same rows again and the area below it*/
+    lv_coord_t x = w / 2;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_area(&dsc, x, 4, 5, 7, (uint8_t *)buf));
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_area(&dsc, x, 10, 5, 7, (uint8_t *)buf));
+    for(i = 0; i < 5 * 7; i++) check_px(ref + ((10 + i / 5) * w + x + i % 5) * 4, buf[i], has_alpha);
+
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_decoder_read_area(&dsc, 0, h - 1, w, 2, (uint8_t *)buf));
+
+    lv_img_decoder_close(&dsc);
+    lv_mem_free(buf);
+    lv_mem_free(ref);
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_USE_IMG_DECODE_ASYNC
+    lv_img_decode_async_set_enabled(false);
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_USE_PNG && LV_PNG_STREAM && LV_COLOR_DEPTH == 32
+    lv_obj_clean(lv_scr_act());
+    lv_img_cache_invalidate_src(NULL);
+    lv_mem_free(png);
+    png = NULL;
+#endif
+
+#if LV_USE_IMG_DECODE_ASYNC
+    lv_img_decode_async_set_enabled(true);
+#endif
+}
+
+void test_png_stream_compressed_blocks(void)
+{
+#if LV_USE_PNG && LV_PNG_STREAM && LV_COLOR_DEPTH == 32
+    encode(61, 47, LCT_RGBA, 8, 2, 0);
+    check_stream();
+    lv_mem_free(png);
+
+    encode(61, 47, LCT_RGBA, 8, 1, 0);
+    check_stream();
+#endif
+}
+
+void test_png_stream_stored_blocks(void)
+{
+#if LV_USE_PNG && LV_PNG_STREAM && LV_COLOR_DEPTH == 32
+    /*More than 64 kB so it needs more stored blocks*/
+    encode(200, 120, LCT_RGB, 8, 0, 0);
+    check_stream();
+#endif
+}
+
+void test_png_stream_color_types(void)
+{
+#if LV_USE_PNG && LV_PNG_STREAM && LV_COLOR_DEPTH == 32
+    static const uint8_t modes[][2] = {
+        {LCT_GREY, 1}, {LCT_GREY, 2}, {LCT_GREY, 4}, {LCT_GREY, 8}, {LCT_GREY, 16},
+        {LCT_RGB, 16}, {LCT_PALETTE, 1}, {LCT_PALETTE, 2}, {LCT_PALETTE, 4}, {LCT_PALETTE, 8},
+        {LCT_GREY_ALPHA, 8}, {LCT_GREY_ALPHA, 16}, {LCT_RGBA, 16}
+    };
+
+    uint32_t i;
+    for(i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        encode(33, 21, modes[i][0], modes[i][1], 2, 0);
+        check_stream();
+        lv_mem_free(png);
+        png = NULL;
+    }
+#endif
+}
+
+void test_png_stream_interlaced_is_decoded_at_once(void)
+{
+#if LV_USE_PNG && LV_PNG_STREAM && LV_COLOR_DEPTH == 32
+    encode(20, 20, LCT_RGBA, 8, 2, 1);
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, &img, lv_color_black(), 0));
+    TEST_ASSERT_NOT_NULL(dsc.img_data);
+    lv_img_decoder_close(&dsc);
+#endif
+}
+
+void test_png_stream_file(void)
+{
+#if LV_USE_PNG && LV_PNG_STREAM && LV_COLOR_DEPTH == 32
+    TEST_ASSERT_EQUAL_UINT32(0, lodepng_load_file(&png, &png_size, "A:../examples/libs/png/wink.png"));
+
+    uint8_t * ref;
+    unsigned w;
+    unsigned h;
+    TEST_ASSERT_EQUAL_UINT32(0, lodepng_decode32(&ref, &w, &h, png, png_size));
+
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, "A:../examples/libs/png/wink.png", lv_color_black(), 0));
+    TEST_ASSERT_NULL(dsc.img_data);
+    TEST_ASSERT_EQUAL(LV_IMG_CF_TRUE_COLOR_ALPHA, dsc.header.cf);
+
+    lv_color_t * buf = lv_mem_alloc(w * h * sizeof(lv_color_t));
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_area(&dsc, 0, 0, w, h, (uint8_t *)buf));
+    uint32_t i;
+    for(i = 0; i < w * h; i++) check_px(ref + i * 4, buf[i], true);
+
+    lv_img_decoder_close(&dsc);
+    lv_mem_free(buf);
+    lv_mem_free(ref);
+#endif
+}
+
+void test_png_stream_draw(void)
+{
+#if LV_USE_PNG && LV_PNG_STREAM && LV_COLOR_DEPTH == 32
+    /*An opaque image to compare the drawn pixels directly*/
+    encode(90, 70, LCT_RGB, 8, 2, 0);
+    uint8_t * ref;
+    unsigned w;
+    unsigned h;
+    TEST_ASSERT_EQUAL_UINT32(0, lodepng_decode32(&ref, &w, &h, png, png_size));
+
+    /*Opaque except the tRNS key color*/
+    lv_obj_t * obj = lv_img_create(lv_scr_act());
+    lv_img_set_src(obj, &img);
+    lv_obj_set_pos(obj, 10, 20);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = 0; y < (lv_coord_t)h; y++) {
+        for(x = 0; x < (lv_coord_t)w; x++) {
+            const uint8_t * px = ref + (y * w + x) * 4;
+            if(px[3] != 0xff) continue;
+            lv_color_t c = test_fb[(20 + y) * 800 + 10 + x];
+            TEST_ASSERT_EQUAL_HEX32(lv_color_make(px[0], px[1], px[2]).full, c.full);
+        }
+    }
+    lv_mem_free(ref);
+
+    /*The image isn't decoded in the cache but the stream's buffers are counted (at least the 32 kB window)*/
+    lv_img_cache_info_t info;
+    lv_img_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(1, info.entry_cnt);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(32768, info.used);
+#endif
+}
+
+void test_png_stream_invalid_chunk_length(void)
+{
+#if LV_USE_PNG && LV_PNG_STREAM && LV_COLOR_DEPTH == 32
+    encode(20, 20, LCT_RGBA, 8, 2, 0);
+
+    /*Insert an IDAT chunk before IEND whose length is too large or points beyond the end of the file.
+     *The length of the first one is valid and it's accepted.*/
+    static const uint32_t lens[] = {0, 0xFFFFFFF0, 0x80000000, 0x7FFFFFF0, 100};
+    uint32_t i;
+    for(i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        uint32_t len = lens[i];
+        uint8_t chunk[12] = {len >> 24, (len >> 16) & 0xff, (len >> 8) & 0xff, len & 0xff, 'I', 'D', 'A', 'T'};
+
+        FILE * f = fopen(BAD_PNG_FILE, "wb");
+        TEST_ASSERT_NOT_NULL(f);
+        fwrite(png, 1, png_size - 12, f);
+        fwrite(chunk, 1, sizeof(chunk), f);
+        fwrite(png + png_size - 12, 1, 12, f);
+        fclose(f);
+
+        lv_png_stream_t * stream = _lv_png_stream_open("A:" BAD_PNG_FILE, LV_IMG_SRC_FILE);
+        if(len == 0) {
+            TEST_ASSERT_NOT_NULL(stream);
+            _lv_png_stream_close(stream);
+        }
+        else {
+            TEST_ASSERT_NULL(stream);
+        }
+    }
+
+    remove(BAD_PNG_FILE);
+#endif
+}
+
+#endif
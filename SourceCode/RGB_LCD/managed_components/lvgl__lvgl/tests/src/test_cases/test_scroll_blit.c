@@ -0,0 +1,211 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#if LV_USE_SCROLL_BLIT
+
+#define HOR_RES     100
+#define VER_RES     100
+
+static lv_color_t direct_buf1[HOR_RES * VER_RES];
+static lv_color_t direct_buf2[HOR_RES * VER_RES];
+static lv_color_t ref_buf[HOR_RES * VER_RES];
+static lv_color_t ref_fb[HOR_RES * VER_RES];
+
+/*The buffer which is on the screen of the direct mode display*/
+static lv_color_t * shown_buf;
+static uint32_t refr_px;
+
+static lv_disp_draw_buf_t direct_draw_buf;
+static lv_disp_draw_buf_t ref_draw_buf;
+static lv_disp_drv_t direct_drv;
+static lv_disp_drv_t ref_drv;
+static lv_disp_t * direct_disp;
+static lv_disp_t * ref_disp;
+
+static lv_obj_t * direct_cont;
+static lv_obj_t * ref_cont;
+
+static void direct_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    LV_UNUSED(area);
+    if(lv_disp_flush_is_last(drv)) shown_buf = color_p;
+    lv_disp_flush_ready(drv);
+}
+
+static void direct_monitor_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px)
+{
+    LV_UNUSED(drv);
+    LV_UNUSED(time);
+    refr_px = px;
+}
+
+static void ref_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    lv_coord_t w = lv_area_get_width(area);
+    lv_coord_t y;
+    for(y = area->y1; y <= area->y2; y++) {
+        lv_memcpy(&ref_fb[y * HOR_RES + area->x1], color_p, w * sizeof(lv_color_t));
+        color_p += w;
+    }
+    lv_disp_flush_ready(drv);
+}
+
+static void disp_create(bool double_buffered)
+{
+    lv_disp_draw_buf_init(&direct_draw_buf, direct_buf1, double_buffered ? direct_buf2 : NULL, HOR_RES * VER_RES);
+    lv_disp_drv_init(&direct_drv);
+    direct_drv.draw_buf = &direct_draw_buf;
+    direct_drv.flush_cb = direct_flush_cb;
+    direct_drv.monitor_cb = direct_monitor_cb;
+    direct_drv.direct_mode = 1;
+    direct_drv.hor_res = HOR_RES;
+    direct_drv.ver_res = VER_RES;
+    direct_disp = lv_disp_drv_register(&direct_drv);
+
+    lv_disp_draw_buf_init(&ref_draw_buf, ref_buf, NULL, HOR_RES * VER_RES);
+    lv_disp_drv_init(&ref_drv);
+    ref_drv.draw_buf = &ref_draw_buf;
+    ref_drv.flush_cb = ref_flush_cb;
+    ref_drv.hor_res = HOR_RES;
+    ref_drv.ver_res = VER_RES;
+    ref_disp = lv_disp_drv_register(&ref_drv);
+}
+
+static lv_obj_t * create_ui(lv_disp_t * disp)
+{
+    lv_obj_t * scr = lv_disp_get_scr_act(disp);
+
+    /*The theme's scrollbar style in the scrolled state would redraw the whole object
+     *when `lv_obj_scroll_by` adds and removes the state*/
+    lv_obj_t * cont = lv_obj_create(scr);
+    lv_obj_remove_style_all(cont);
+    lv_obj_set_style_bg_color(cont, lv_palette_lighten(LV_PALETTE_BLUE, 4), 0);
+    lv_obj_set_style_bg_opa(cont, LV_OPA_COVER, 0);
+    lv_obj_set_style_pad_all(cont, 6, 0);
+    lv_obj_set_style_pad_row(cont, 4, 0);
+    lv_obj_set_pos(cont, 5, 5);
+    lv_obj_set_size(cont, 90, 90);
+    lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_COLUMN);
+
+    uint32_t i;
+    for(i = 0; i < 10; i++) {
+        lv_obj_t * btn = lv_obj_create(cont);
+        lv_obj_set_size(btn, 120, 30);
+        lv_obj_set_style_bg_color(btn, lv_palette_main(i % 16), 0);
+
+        lv_obj_t * label = lv_label_create(btn);
+        lv_label_set_text_fmt(label, "Item %d", (int)i);
+    }
+
+    return cont;
+}
+
+static void refr_and_compare(void)
+{
+    lv_refr_now(direct_disp);
+    lv_refr_now(ref_disp);
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, shown_buf, sizeof(ref_fb));
+}
+
+static void scroll_by(lv_coord_t x, lv_coord_t y)
+{
+    lv_obj_scroll_by(direct_cont, x, y, LV_ANIM_OFF);
+    lv_obj_scroll_by(ref_cont, x, y, LV_ANIM_OFF);
+}
+
+static void disp_remove(lv_disp_t * disp)
+{
+    /*`lv_disp_remove` doesn't free the draw context*/
+    lv_disp_drv_t * drv = disp->driver;
+    lv_disp_remove(disp);
+    drv->draw_ctx_deinit(drv, drv->draw_ctx);
+    lv_mem_free(drv->draw_ctx);
+}
+
+static void test_scroll(bool double_buffered)
+{
+    disp_create(double_buffered);
+    direct_cont = create_ui(direct_disp);
+    ref_cont = create_ui(ref_disp);
+    refr_and_compare();
+
+    uint32_t i;
+    for(i = 0; i < 8; i++) {
+        scroll_by(0, -7);
+        refr_and_compare();
+        /*Only the newly exposed stripe and the scrollbar should be redrawn*/
+        TEST_ASSERT_LESS_THAN_UINT32(90 * 90 / 2, refr_px);
+    }
+
+    for(i = 0; i < 4; i++) {
+        scroll_by(-5, 3);
+        refr_and_compare();
+        TEST_ASSERT_LESS_THAN_UINT32(90 * 90 / 2, refr_px);
+    }
+
+    /*Scrolling more times before refreshing*/
+    scroll_by(0, 4);
+    scroll_by(2, 5);
+    refr_and_compare();
+    TEST_ASSERT_LESS_THAN_UINT32(90 * 90 / 2, refr_px);
+
+    /*Changing a child before scrolling*/
+    lv_obj_t * label = lv_obj_get_child(lv_obj_get_child(direct_cont, 3), 0);
+    lv_label_set_text(label, "Changed");
+    label = lv_obj_get_child(lv_obj_get_child(ref_cont, 3), 0);
+    lv_label_set_text(label, "Changed");
+    scroll_by(0, -6);
+    refr_and_compare();
+}
+
+#endif
+
+void tearDown(void)
+{
+#if LV_USE_SCROLL_BLIT
+    if(direct_disp) disp_remove(direct_disp);
+    if(ref_disp) disp_remove(ref_disp);
+    direct_disp = NULL;
+    ref_disp = NULL;
+#endif
+}
+
+void test_scroll_blit_moves_the_pixels_in_direct_mode(void)
+{
+#if LV_USE_SCROLL_BLIT
+    test_scroll(false);
+#endif
+}
+
+void test_scroll_blit_moves_the_pixels_in_direct_mode_with_two_buffers(void)
+{
+#if LV_USE_SCROLL_BLIT
+    test_scroll(true);
+#endif
+}
+
+void test_scroll_blit_redraws_the_object_if_covered(void)
+{
+#if LV_USE_SCROLL_BLIT
+    disp_create(false);
+    direct_cont = create_ui(direct_disp);
+    ref_cont = create_ui(ref_disp);
+
+    /*A sibling over the scrolled object*/
+    lv_obj_t * overlay = lv_obj_create(lv_disp_get_scr_act(direct_disp));
+    lv_obj_set_pos(overlay, 40, 40);
+    lv_obj_set_size(overlay, 30, 30);
+    overlay = lv_obj_create(lv_disp_get_scr_act(ref_disp));
+    lv_obj_set_pos(overlay, 40, 40);
+    lv_obj_set_size(overlay, 30, 30);
+    refr_and_compare();
+
+    scroll_by(0, -7);
+    refr_and_compare();
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(90 * 90, refr_px);
+#endif
+}
+
+#endif
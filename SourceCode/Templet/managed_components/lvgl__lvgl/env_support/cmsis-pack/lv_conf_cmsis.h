@@ -120,9 +120,13 @@
 
     /*Allow buffering some shadow calculation.
     *LV_SHADOW_CACHE_SIZE is the max. shadow size to buffer, where shadow size is `shadow_width + radius`
-    *Caching has LV_SHADOW_CACHE_SIZE^2 RAM cost*/
+    *Caching has LV_SHADOW_CACHE_SIZE^2 RAM cost. The least recently used shadows are dropped
+    *if several smaller shadows don't fit into this space.*/
     #define LV_SHADOW_CACHE_SIZE 0
 
+    /*Max. number of different shadows to buffer if LV_SHADOW_CACHE_SIZE > 0*/
+    #define LV_SHADOW_CACHE_CNT 4
+
     /* Set number of maximally cached circle data.
     * The circumference of 1/4 circle are saved for anti-aliasing
     * radius * 4 bytes are used per circle (the most often used radiuses are saved)
@@ -153,14 +157,42 @@
  *0: to disable caching*/
 #define LV_IMG_CACHE_DEF_SIZE 0
 
+/*Max. total size of the decoded images kept in the image cache [bytes].
+ *The least recently used images are closed to stay below it. Used only if LV_IMG_CACHE_DEF_SIZE > 0.
+ *0: no limit, only the number of images is limited*/
+#define LV_IMG_CACHE_DEF_BYTES 0
+
+/*Decode the images which are not in the image cache in the background and draw a placeholder meanwhile.
+ *Only images which need a decoder (files and `LV_IMG_CF_RAW...` variables) are decoded in the background.
+ *The area of the image is invalidated when it's decoded. Requires LV_IMG_CACHE_DEF_SIZE > 0.*/
+#define LV_USE_IMG_DECODE_ASYNC 0
+#if LV_USE_IMG_DECODE_ASYNC
+    /*Max. number of images waiting to be decoded. If it's full the images are decoded immediately.*/
+    #define LV_IMG_DECODE_ASYNC_QUEUE_LEN 8
+
+    /*1: decode on a helper thread. The image decoders, the file system drivers and
+     *   the memory allocator (LV_MEM_CUSTOM = 1 is required) need to be thread safe.
+     *0: decode one image at a time from an lv_timer between the refreshes*/
+    #define LV_IMG_DECODE_ASYNC_THREAD 0
+    #if LV_IMG_DECODE_ASYNC_THREAD
+        /*1: Use a FreeRTOS task; 0: use a POSIX thread (e.g. on a Linux host)*/
+        #define LV_IMG_DECODE_ASYNC_FREERTOS 0
+        #if LV_IMG_DECODE_ASYNC_FREERTOS
+            #define LV_IMG_DECODE_ASYNC_TASK_PRIO  3
+            #define LV_IMG_DECODE_ASYNC_STACK_SIZE 8192    /*Passed to xTaskCreate() (bytes on ESP-IDF, words elsewhere)*/
+            #define LV_IMG_DECODE_ASYNC_CORE       1       /*ESP-IDF only: pin the task to this core. -1: no affinity*/
+        #endif
+    #endif
+#endif
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #define LV_GRADIENT_MAX_STOPS 2
 
 /*Default gradient buffer size.
  *When LVGL calculates the gradient "maps" it can save them into a cache to avoid calculating them again.
- *LV_GRAD_CACHE_DEF_SIZE sets the size of this cache in bytes.
- *If the cache is too small the map will be allocated only while it's required for the drawing.
+ *LV_GRAD_CACHE_DEF_SIZE sets the size of this cache in bytes. The least recently used maps are freed if it's full.
+ *Maps larger than the cache reuse the buffer of the last such map.
  *0 mean no caching.*/
 #define LV_GRAD_CACHE_DEF_SIZE 0
 
@@ -179,6 +211,10 @@
  *Only used if software rotation is enabled in the display driver.*/
 #define LV_DISP_ROT_MAX_BUF (10*1024)
 
+/*Maximum buffer size to allocate for drawing images which are read line by line (e.g. from files).
+ *Several lines are read and drawn at once as long as they fit into this buffer.*/
+#define LV_IMG_READ_AREA_MAX_BUF (8*1024)
+
 /*-------------
  * GPU
  *-----------*/
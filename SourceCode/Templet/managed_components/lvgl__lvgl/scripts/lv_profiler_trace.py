@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+
+'''
+Converts the log printed by lv_profiler_flush() to Chrome trace JSON.
+Open the result in chrome://tracing or https://ui.perfetto.dev
+
+Usage: lv_profiler_trace.py <log file> [output.json]
+Other lines of the log (e.g. LV_LOG messages) are ignored.
+'''
+
+import sys
+import re
+import json
+
+if sys.version_info < (3,6,0):
+  print("Python >=3.6 is required", file=sys.stderr)
+  exit(1)
+
+# E.g. "   LVGL-1 [0] 12.345678: tracing_mark_write: B|1|refr_area"
+LINE_RE = re.compile(r"\s*(\S+)-(\d+)\s+\[(\d+)\]\s+(\d+)\.(\d+): tracing_mark_write: ([BE])\|(\d+)\|(.+)")
+
+def convert(lines):
+  events = []
+  for line in lines:
+    m = LINE_RE.match(line)
+    if not m:
+      continue
+
+    thread, tid, cpu, sec, usec, ph, pid, tag = m.groups()
+    events.append({
+      "name": tag.strip(),
+      "ph": ph,
+      "ts": int(sec) * 1000000 + int(usec),
+      "pid": int(pid),
+      "tid": int(tid),
+    })
+
+  return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+if len(sys.argv) < 2:
+  print("Usage: %s <log file> [output.json]" % sys.argv[0], file=sys.stderr)
+  exit(1)
+
+with open(sys.argv[1], errors="replace") as f:
+  trace = convert(f)
+
+out_path = sys.argv[2] if len(sys.argv) > 2 else "lv_profiler_trace.json"
+with open(out_path, "w") as f:
+  json.dump(trace, f)
+
+print("%d events written to %s" % (len(trace["traceEvents"]), out_path))
@@ -11,6 +11,7 @@
 #include "lv_indev.h"
 #include "lv_disp.h"
 #include "lv_indev_scroll.h"
+#include "lv_refr.h"
 
 /*********************
  *      DEFINES
@@ -36,6 +37,13 @@ static void scroll_y_anim(void * obj, int32_t v);
 static void scroll_anim_ready_cb(lv_anim_t * a);
 static void scroll_area_into_view(const lv_area_t * area, lv_obj_t * child, lv_point_t * scroll_value,
                                   lv_anim_enable_t anim_en);
+#if LV_USE_SCROLL_BLIT
+static bool scroll_blit(lv_obj_t * obj, lv_coord_t x, lv_coord_t y, const lv_area_t * hor_sb_ori,
+                        const lv_area_t * ver_sb_ori);
+static bool scroll_blit_get_area(lv_obj_t * obj, lv_area_t * area);
+static bool is_covered_by_layer(lv_obj_t * layer, const lv_area_t * area);
+static bool class_has_event_cb(const lv_obj_t * obj);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -414,12 +422,23 @@ lv_res_t _lv_obj_scroll_by_raw(lv_obj_t * obj, lv_coord_t x, lv_coord_t y)
 
     lv_obj_allocate_spec_attr(obj);
 
+#if LV_USE_SCROLL_BLIT
+    lv_area_t hor_sb_ori;
+    lv_area_t ver_sb_ori;
+    lv_obj_get_scrollbar_area(obj, &hor_sb_ori, &ver_sb_ori);
+#endif
+
     obj->spec_attr->scroll.x += x;
     obj->spec_attr->scroll.y += y;
 
     lv_obj_move_children_by(obj, x, y, true);
     lv_res_t res = lv_event_send(obj, LV_EVENT_SCROLL, NULL);
     if(res != LV_RES_OK) return res;
+
+#if LV_USE_SCROLL_BLIT
+    if(scroll_blit(obj, x, y, &hor_sb_ori, &ver_sb_ori)) return LV_RES_OK;
+#endif
+
     lv_obj_invalidate(obj);
     return LV_RES_OK;
 }
@@ -794,3 +813,196 @@ static void scroll_area_into_view(const lv_area_t * area, lv_obj_t * child, lv_p
     scroll_value->y += anim_en == LV_ANIM_OFF ? 0 : y_scroll;
     lv_obj_scroll_by(parent, x_scroll, y_scroll, anim_en);
 }
+
+#if LV_USE_SCROLL_BLIT
+
+/**
+ * Move the already rendered content of a scrolled object in the frame buffer
+ * and invalidate only the newly exposed parts.
+ * @param obj           pointer to the scrolled object (its children are already moved)
+ * @param x             scrolled horizontally by this much
+ * @param y             scrolled vertically by this much
+ * @param hor_sb_ori    the horizontal scrollbar's area before scrolling
+ * @param ver_sb_ori    the vertical scrollbar's area before scrolling
+ * @return              false: the pixels can't be moved, `obj` needs to be invalidated
+ */
+static bool scroll_blit(lv_obj_t * obj, lv_coord_t x, lv_coord_t y, const lv_area_t * hor_sb_ori,
+                        const lv_area_t * ver_sb_ori)
+{
+    lv_area_t area;
+    if(!scroll_blit_get_area(obj, &area)) return false;
+
+    _lv_refr_scroll_blit(lv_obj_get_disp(obj), &area, x, y);
+
+    /*Invalidate everything except where the pixels are moved to*/
+    lv_area_t obj_area;
+    lv_coord_t ext_size = _lv_obj_get_ext_draw_size(obj);
+    lv_area_copy(&obj_area, &obj->coords);
+    lv_area_increase(&obj_area, ext_size, ext_size);
+
+    lv_area_t moved_area = area;
+    lv_area_move(&moved_area, x, y);
+    lv_area_t res[4];
+    int8_t res_c = -1;
+    if(_lv_area_intersect(&moved_area, &moved_area, &area)) {
+        res_c = _lv_area_diff(res, &obj_area, &moved_area);
+    }
+
+    if(res_c < 0) {
+        lv_obj_invalidate_area(obj, &obj_area);
+    }
+    else {
+        int8_t i;
+        for(i = 0; i < res_c; i++) {
+            lv_obj_invalidate_area(obj, &res[i]);
+        }
+    }
+
+    /*The scrollbars are moved too. Redraw them on the moved and on their new position.*/
+    lv_area_t sb_area = *hor_sb_ori;
+    lv_area_move(&sb_area, x, y);
+    lv_obj_invalidate_area(obj, &sb_area);
+    sb_area = *ver_sb_ori;
+    lv_area_move(&sb_area, x, y);
+    lv_obj_invalidate_area(obj, &sb_area);
+
+    lv_area_t hor_sb;
+    lv_area_t ver_sb;
+    lv_obj_get_scrollbar_area(obj, &hor_sb, &ver_sb);
+    lv_obj_invalidate_area(obj, &hor_sb);
+    lv_obj_invalidate_area(obj, &ver_sb);
+
+    return true;
+}
+
+/**
+ * Get the area whose pixels can be simply moved when the children of an object are scrolled.
+ * Only the object's own background can be there (which has to look the same everywhere on the area)
+ * and the moving children. Nothing else can be drawn over it.
+ * @param obj       pointer to the scrolled object
+ * @param area      store the area here (absolute coordinates)
+ * @return          false: the pixels can't be moved
+ */
+static bool scroll_blit_get_area(lv_obj_t * obj, lv_area_t * area)
+{
+    /*The previous frame is kept in the buffer only in direct mode*/
+    lv_disp_t * disp = lv_obj_get_disp(obj);
+    lv_disp_drv_t * drv = disp->driver;
+    if(!drv->direct_mode || drv->full_refresh) return false;
+    if(drv->set_px_cb || drv->screen_transp || drv->rotated != LV_DISP_ROT_NONE) return false;
+
+    /*Don't bother with screen load animations*/
+    if(disp->prev_scr || disp->scr_to_load) return false;
+    if(lv_obj_get_screen(obj) != disp->act_scr) return false;
+
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE)) return false;
+    if(class_has_event_cb(obj) || _lv_obj_has_draw_event_cb(obj)) return false;
+    if(lv_obj_get_style_bg_opa(obj, LV_PART_MAIN) < LV_OPA_COVER) return false;
+    if(lv_obj_get_style_bg_grad_dir(obj, LV_PART_MAIN) != LV_GRAD_DIR_NONE) return false;
+    if(lv_obj_get_style_bg_img_src(obj, LV_PART_MAIN) != NULL) return false;
+
+    /*Floating children are not moved*/
+    uint32_t i;
+    uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    for(i = 0; i < child_cnt; i++) {
+        lv_obj_t * child = obj->spec_attr->children[i];
+        if(lv_obj_has_flag(child, LV_OBJ_FLAG_FLOATING) && !lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) return false;
+    }
+
+    /*Leave out the rounded corners and the border*/
+    lv_coord_t inset = lv_obj_get_style_radius(obj, LV_PART_MAIN);
+    if(lv_obj_get_style_border_side(obj, LV_PART_MAIN) != LV_BORDER_SIDE_NONE &&
+       lv_obj_get_style_border_opa(obj, LV_PART_MAIN) > LV_OPA_MIN) {
+        inset = LV_MAX(inset, lv_obj_get_style_border_width(obj, LV_PART_MAIN));
+    }
+
+    lv_area_copy(area, &obj->coords);
+    lv_area_increase(area, -inset, -inset);
+
+    /*Go up to the screen and check that nothing is drawn over the area*/
+    lv_obj_t * child = obj;
+    lv_obj_t * parent = lv_obj_get_parent(obj);
+    while(1) {
+        if(_lv_obj_get_layer_type(child) != LV_LAYER_TYPE_NONE) return false;
+        if(parent == NULL) break;
+
+        if(!_lv_area_intersect(area, area, &parent->coords)) return false;
+        if(class_has_event_cb(parent) || _lv_obj_has_draw_event_cb(parent)) return false;
+        if(lv_obj_get_style_border_post(parent, LV_PART_MAIN)) return false;
+        if(lv_obj_get_style_clip_corner(parent, LV_PART_MAIN) && lv_obj_get_style_radius(parent, LV_PART_MAIN)) {
+            return false;
+        }
+
+        lv_area_t hor_sb;
+        lv_area_t ver_sb;
+        lv_obj_get_scrollbar_area(parent, &hor_sb, &ver_sb);
+        if(_lv_area_is_on(area, &hor_sb) || _lv_area_is_on(area, &ver_sb)) return false;
+
+        /*The next siblings are drawn later*/
+        child_cnt = lv_obj_get_child_cnt(parent);
+        for(i = lv_obj_get_index(child) + 1; i < child_cnt; i++) {
+            lv_obj_t * sibling = parent->spec_attr->children[i];
+            if(lv_obj_has_flag(sibling, LV_OBJ_FLAG_HIDDEN)) continue;
+
+            lv_area_t sibling_area;
+            lv_coord_t ext_size = _lv_obj_get_ext_draw_size(sibling);
+            lv_area_copy(&sibling_area, &sibling->coords);
+            lv_area_increase(&sibling_area, ext_size, ext_size);
+            if(_lv_area_is_on(area, &sibling_area)) return false;
+        }
+
+        child = parent;
+        parent = lv_obj_get_parent(parent);
+    }
+
+    if(is_covered_by_layer(disp->top_layer, area)) return false;
+    if(is_covered_by_layer(disp->sys_layer, area)) return false;
+
+    lv_area_t disp_area;
+    lv_area_set(&disp_area, 0, 0, lv_disp_get_hor_res(disp) - 1, lv_disp_get_ver_res(disp) - 1);
+    return _lv_area_intersect(area, area, &disp_area);
+}
+
+/**
+ * Tell if anything is drawn on an area by the top or system layer
+ * @param layer     pointer to the top or system layer
+ * @param area      the area to check
+ * @return          true: there is a visible child on the area
+ */
+static bool is_covered_by_layer(lv_obj_t * layer, const lv_area_t * area)
+{
+    if(layer == NULL) return false;
+    if(lv_obj_get_style_bg_opa(layer, LV_PART_MAIN) > LV_OPA_MIN) return true;
+
+    uint32_t i;
+    uint32_t child_cnt = lv_obj_get_child_cnt(layer);
+    for(i = 0; i < child_cnt; i++) {
+        lv_obj_t * child = layer->spec_attr->children[i];
+        if(lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) continue;
+
+        lv_area_t child_area;
+        lv_coord_t ext_size = _lv_obj_get_ext_draw_size(child);
+        lv_area_copy(&child_area, &child->coords);
+        lv_area_increase(&child_area, ext_size, ext_size);
+        if(_lv_area_is_on(area, &child_area)) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Tell if a widget class (or any of its base classes) has an event callback apart from `lv_obj_class`.
+ * Such widgets might draw something which doesn't scroll with the children.
+ */
+static bool class_has_event_cb(const lv_obj_t * obj)
+{
+    const lv_obj_class_t * class_p = obj->class_p;
+    while(class_p && class_p != &lv_obj_class) {
+        if(class_p->event_cb) return true;
+        class_p = class_p->base_class;
+    }
+
+    return false;
+}
+
+#endif /*LV_USE_SCROLL_BLIT*/
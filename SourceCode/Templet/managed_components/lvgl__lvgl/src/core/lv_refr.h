@@ -85,6 +85,21 @@ lv_disp_t * _lv_refr_get_disp_refreshing(void);
  */
 void _lv_refr_set_disp_refreshing(lv_disp_t * disp);
 
+#if LV_USE_SCROLL_BLIT
+/**
+ * Move the already rendered pixels of an area in the frame buffer before the next refresh.
+ * The invalidated areas on `area` are invalidated on their moved position too.
+ * Only one area can be moved per refresh; if an other area is moved the previous one is invalidated instead.
+ * The caller needs to be sure that the display is in direct mode and the moved pixels are still valid
+ * and also needs to invalidate the newly exposed parts.
+ * @param disp  pointer to a display
+ * @param area  the area to move (absolute coordinates)
+ * @param dx    move horizontally by this much
+ * @param dy    move vertically by this much
+ */
+void _lv_refr_scroll_blit(lv_disp_t * disp, const lv_area_t * area, lv_coord_t dx, lv_coord_t dy);
+#endif
+
 #if LV_USE_PERF_MONITOR
 /**
  * Reset FPS counter
@@ -17,8 +17,10 @@ extern "C" {
 
 #include "../misc/lv_style.h"
 #include "../misc/lv_txt.h"
+#include "../misc/lv_profiler.h"
 #include "lv_img_decoder.h"
 #include "lv_img_cache.h"
+#include "lv_img_decode_async.h"
 
 #include "lv_draw_rect.h"
 #include "lv_draw_label.h"
@@ -88,6 +90,17 @@ typedef struct _lv_draw_ctx_t  {
     void (*draw_letter)(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,  const lv_point_t * pos_p,
                         uint32_t letter);
 
+    /**
+     * Draw more letters with the same style at once (e.g. a line of a label). Optional.
+     * If `NULL` the letters are drawn one by one with `draw_letter`.
+     * @param draw_ctx      pointer to a draw context
+     * @param dsc           the style of the letters
+     * @param glyphs        the letters and their positions
+     * @param glyph_cnt     number of elements in `glyphs`
+     */
+    void (*draw_text_run)(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                          const lv_draw_label_glyph_t * glyphs, uint32_t glyph_cnt);
+
     void (*draw_line)(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_line_dsc_t * dsc, const lv_point_t * point1,
                       const lv_point_t * point2);
 
@@ -10,6 +10,7 @@ CSRCS += lv_draw_layer.c
 CSRCS += lv_draw_triangle.c
 CSRCS += lv_img_buf.c
 CSRCS += lv_img_cache.c
+CSRCS += lv_img_decode_async.c
 CSRCS += lv_img_decoder.c
 
 DEPPATH += --dep-path $(LVGL_DIR)/$(LVGL_DIR_NAME)/src/draw
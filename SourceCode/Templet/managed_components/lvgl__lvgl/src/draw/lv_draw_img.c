@@ -8,6 +8,7 @@
  *********************/
 #include "lv_draw_img.h"
 #include "lv_img_cache.h"
+#include "lv_img_decode_async.h"
 #include "../hal/lv_hal_disp.h"
 #include "../misc/lv_log.h"
 #include "../core/lv_refr.h"
@@ -70,6 +71,8 @@ void lv_draw_img(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * dsc, const
 
     if(dsc->opa <= LV_OPA_MIN) return;
 
+    LV_PROFILER_BEGIN;
+
     lv_res_t res = LV_RES_INV;
 
     if(draw_ctx->draw_img) {
@@ -84,6 +87,8 @@ void lv_draw_img(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * dsc, const
         LV_LOG_WARN("Image draw error");
         show_error(draw_ctx, coords, "No\ndata");
     }
+
+    LV_PROFILER_END;
 }
 
 /**
@@ -230,7 +235,9 @@ void lv_draw_img_decoded(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * dsc
 {
     if(draw_ctx->draw_img_decoded == NULL) return;
 
+    LV_PROFILER_BEGIN;
     draw_ctx->draw_img_decoded(draw_ctx, dsc, coords, map_p, color_format);
+    LV_PROFILER_END;
 }
 
 /**********************
@@ -243,6 +250,24 @@ static lv_res_t LV_ATTRIBUTE_FAST_MEM decode_and_draw(lv_draw_ctx_t * draw_ctx,
 {
     if(draw_dsc->opa <= LV_OPA_MIN) return LV_RES_OK;
 
+#if LV_USE_IMG_DECODE_ASYNC
+    /*Don't wait for the decoder, draw a placeholder and redraw the image when it's decoded*/
+    if(_lv_img_cache_find(src, draw_dsc->recolor, draw_dsc->frame_id) == NULL) {
+        lv_area_t inv_area;
+        lv_area_copy(&inv_area, coords);
+        if(draw_dsc->angle || draw_dsc->zoom != LV_IMG_ZOOM_NONE) {
+            _lv_img_buf_get_transformed_area(&inv_area, lv_area_get_width(coords), lv_area_get_height(coords),
+                                             draw_dsc->angle, draw_dsc->zoom, &draw_dsc->pivot);
+            lv_area_move(&inv_area, coords->x1, coords->y1);
+        }
+
+        if(_lv_img_decode_async_request(src, draw_dsc->recolor, draw_dsc->frame_id, &inv_area)) {
+            _lv_img_decode_async_draw_placeholder(draw_ctx, coords, draw_dsc->opa);
+            return LV_RES_OK;
+        }
+    }
+#endif
+
     _lv_img_cache_entry_t * cdsc = _lv_img_cache_open(src, draw_dsc->recolor, draw_dsc->frame_id);
 
     if(cdsc == NULL) return LV_RES_INV;
@@ -298,7 +323,7 @@ static lv_res_t LV_ATTRIBUTE_FAST_MEM decode_and_draw(lv_draw_ctx_t * draw_ctx,
         lv_draw_img_decoded(draw_ctx, draw_dsc, coords, cdsc->dec_dsc.img_data, cf);
         draw_ctx->clip_area = clip_area_ori;
     }
-    /*The whole uncompressed image is not available. Try to read it line-by-line*/
+    /*The whole uncompressed image is not available. Read and draw it in tiles of a few lines*/
     else {
         lv_area_t mask_com; /*Common area of mask and coords*/
         bool union_ok;
@@ -309,39 +334,44 @@ static lv_res_t LV_ATTRIBUTE_FAST_MEM decode_and_draw(lv_draw_ctx_t * draw_ctx,
             return LV_RES_OK;
         }
 
+        /*The decoders return the pixels of the alpha only images with color too*/
+        if(cf == LV_IMG_CF_ALPHA_8BIT) cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+
         int32_t width = lv_area_get_width(&mask_com);
+        uint32_t px_size = lv_img_decoder_get_px_size(&cdsc->dec_dsc);
+
+        /*The color and the alpha of RGB565A8 are stored in separate planes. `read_area_cb` returns
+         *them for the whole tile but the line by line fallback only for 1 line.*/
+        int32_t tile_h = 1;
+        if(cf != LV_IMG_CF_RGB565A8 || cdsc->dec_dsc.decoder->read_area_cb) {
+            tile_h = LV_IMG_READ_AREA_MAX_BUF / (width * px_size);
+            tile_h = LV_CLAMP(1, tile_h, lv_area_get_height(&mask_com));
+        }
 
-        uint8_t  * buf = lv_mem_buf_get(lv_area_get_width(&mask_com) *
-                                        LV_IMG_PX_SIZE_ALPHA_BYTE);  /*+1 because of the possible alpha byte*/
+        uint8_t * buf = lv_mem_buf_get(width * tile_h * px_size);
 
         const lv_area_t * clip_area_ori = draw_ctx->clip_area;
-        lv_area_t line;
-        lv_area_copy(&line, &mask_com);
-        lv_area_set_height(&line, 1);
+        lv_area_t tile;
+        lv_area_copy(&tile, &mask_com);
         int32_t x = mask_com.x1 - coords->x1;
-        int32_t y = mask_com.y1 - coords->y1;
-        int32_t row;
         lv_res_t read_res;
-        for(row = mask_com.y1; row <= mask_com.y2; row++) {
-            lv_area_t mask_line;
-            union_ok = _lv_area_intersect(&mask_line, clip_area_ori, &line);
-            if(union_ok == false) continue;
+        while(tile.y1 <= mask_com.y2) {
+            tile.y2 = LV_MIN(tile.y1 + tile_h - 1, mask_com.y2);
 
-            read_res = lv_img_decoder_read_line(&cdsc->dec_dsc, x, y, width, buf);
+            read_res = lv_img_decoder_read_area(&cdsc->dec_dsc, x, tile.y1 - coords->y1, width,
+                                                lv_area_get_height(&tile), buf);
             if(read_res != LV_RES_OK) {
                 lv_img_decoder_close(&cdsc->dec_dsc);
-                LV_LOG_WARN("Image draw can't read the line");
+                LV_LOG_WARN("Image draw can't read the lines");
                 lv_mem_buf_release(buf);
                 draw_cleanup(cdsc);
                 draw_ctx->clip_area = clip_area_ori;
                 return LV_RES_INV;
             }
 
-            draw_ctx->clip_area = &mask_line;
-            lv_draw_img_decoded(draw_ctx, draw_dsc, &line, buf, cf);
-            line.y1++;
-            line.y2++;
-            y++;
+            draw_ctx->clip_area = &tile;
+            lv_draw_img_decoded(draw_ctx, draw_dsc, &tile, buf, cf);
+            tile.y1 = tile.y2 + 1;
         }
         draw_ctx->clip_area = clip_area_ori;
         lv_mem_buf_release(buf);
@@ -71,7 +71,11 @@ void lv_draw_layer_adjust(struct _lv_draw_ctx_t * draw_ctx, struct _lv_draw_laye
 void lv_draw_layer_blend(struct _lv_draw_ctx_t * draw_ctx, struct _lv_draw_layer_ctx_t * layer_ctx,
                          lv_draw_img_dsc_t * draw_dsc)
 {
-    if(draw_ctx->layer_blend) draw_ctx->layer_blend(draw_ctx, layer_ctx, draw_dsc);
+    if(draw_ctx->layer_blend == NULL) return;
+
+    LV_PROFILER_BEGIN;
+    draw_ctx->layer_blend(draw_ctx, layer_ctx, draw_dsc);
+    LV_PROFILER_END;
 }
 
 void lv_draw_layer_destroy(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * layer_ctx)
@@ -28,6 +28,11 @@ extern "C" {
 # define _LV_MASK_MAX_NUM     1
 #endif
 
+#if LV_USE_DRAW_MASK_SPANS
+/*Max. number of coverage runs on a line. More runs are merged into one changed run*/
+# define _LV_DRAW_MASK_SPAN_MAX  16
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -41,6 +46,27 @@ enum {
 
 typedef uint8_t lv_draw_mask_res_t;
 
+#if LV_USE_DRAW_MASK_SPANS
+/**
+ * A run of pixels on a masked line with the same kind of coverage
+ */
+typedef struct {
+    lv_coord_t x;               /**< Start of the run relative to the start of the line*/
+    lv_coord_t len;             /**< Number of pixels in the run*/
+    lv_draw_mask_res_t res;     /**< `LV_DRAW_MASK_RES_TRANSP`: every pixel is 0,
+                                 *   `LV_DRAW_MASK_RES_FULL_COVER`: the masks haven't changed the pixels,
+                                 *   `LV_DRAW_MASK_RES_CHANGED`: the pixels need to be read from the mask buffer*/
+} lv_draw_mask_span_t;
+
+/**
+ * The runs covering a whole masked line from left to right
+ */
+typedef struct {
+    lv_draw_mask_span_t spans[_LV_DRAW_MASK_SPAN_MAX];
+    uint8_t cnt;
+} lv_draw_mask_span_list_t;
+#endif
+
 typedef struct {
     void * param;
     void * custom_id;
@@ -255,6 +281,24 @@ lv_draw_mask_res_t /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_mask_apply_ids(lv_opa_t *
                                                                       lv_coord_t abs_y, lv_coord_t len,
                                                                       const int16_t * ids, int16_t ids_count);
 
+#if LV_USE_DRAW_MASK_SPANS
+/**
+ * Apply the added masks on a line like `lv_draw_mask_apply()` and describe the coverage of the line with runs too.
+ * The line, angle and radius masks report which parts they have cleared and which parts they haven't touched,
+ * the other masks are considered to change the whole line.
+ * @param mask_buf store the result mask here. Has to be `len` byte long.
+ *                 Needs to be initialized with the same value on every pixel (e.g. `0xFF`).
+ * @param abs_x absolute X coordinate where the line to calculate start
+ * @param abs_y absolute Y coordinate where the line to calculate start
+ * @param len length of the line to calculate (in pixel count)
+ * @param spans store the runs here. Valid if the result is `LV_DRAW_MASK_RES_CHANGED`.
+ * @return same as `lv_draw_mask_apply()`
+ */
+lv_draw_mask_res_t /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_mask_apply_spans(lv_opa_t * mask_buf, lv_coord_t abs_x,
+                                                                        lv_coord_t abs_y, lv_coord_t len,
+                                                                        lv_draw_mask_span_list_t * spans);
+#endif
+
 //! @endcond
 
 /**
@@ -14,6 +14,7 @@ extern "C" {
  *      INCLUDES
  *********************/
 #include "lv_img_decoder.h"
+#include "../misc/lv_hash_lru.h"
 
 /*********************
  *      DEFINES
@@ -28,15 +29,24 @@ extern "C" {
  *
  * To avoid repeating this heavy load images can be cached.
  */
-typedef struct {
-    lv_img_decoder_dsc_t dec_dsc; /**< Image information*/
+typedef struct _lv_img_cache_entry_t {
+#if LV_IMG_CACHE_DEF_SIZE
+    _lv_hash_lru_entry_t lru;                   /**< Its size is the size of the decoded image or the decoder's buffers*/
+#endif
 
-    /** Count the cache entries's life. Add `time_to_open` to `life` when the entry is used.
-     * Decrement all lifes by one every in every ::lv_img_cache_open.
-     * If life == 0 the entry can be reused*/
-    int32_t life;
+    lv_img_decoder_dsc_t dec_dsc;               /**< Image information*/
 } _lv_img_cache_entry_t;
 
+typedef struct {
+    uint32_t entry_cnt;     /**< Number of cached images*/
+    uint32_t max_entry_cnt; /**< Max. number of cached images*/
+    uint32_t used;          /**< The current total size of the decoded images and decoder buffers in bytes*/
+    uint32_t max_bytes;     /**< The max. total size of the decoded images in bytes. 0: no limit*/
+    uint32_t hit_cnt;       /**< Number of times an image was found in the cache*/
+    uint32_t miss_cnt;      /**< Number of times an image had to be opened*/
+    uint32_t evict_cnt;     /**< Number of images closed to make room for others*/
+} lv_img_cache_info_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -44,7 +54,7 @@ typedef struct {
 /**
  * Open an image using the image decoder interface and cache it.
  * The image will be left open meaning if the image decoder open callback allocated memory then it will remain.
- * The image is closed if a new image is opened and the new image takes its place in the cache.
+ * The least recently used images are closed if the number of images or their total size exceeds the limits.
  * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
  * @param color The color of the image with `LV_IMG_CF_ALPHA_...`
  * @param frame_id the index of the frame. Used only with animated images, set 0 for normal images
@@ -52,14 +62,46 @@ typedef struct {
  */
 _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, int32_t frame_id);
 
+/**
+ * Find an image in the cache without opening it if it's not cached.
+ * @param src       source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
+ * @param color     the color of the image with `LV_IMG_CF_ALPHA_...`
+ * @param frame_id  the index of the frame. Used only with animated images, set 0 for normal images
+ * @return          pointer to the cache entry or NULL if the image is not cached
+ */
+_lv_img_cache_entry_t * _lv_img_cache_find(const void * src, lv_color_t color, int32_t frame_id);
+
+/**
+ * Add an image opened with `lv_img_decoder_open()` to the cache, e.g. if it was opened in the background.
+ * The cache takes over the opened image and closes it when it's dropped from the cache.
+ * @param dsc       an opened image. If the same image is already cached `dsc` is closed.
+ * @return          pointer to the cache entry or NULL if the image couldn't be cached (`dsc` is closed then)
+ */
+_lv_img_cache_entry_t * _lv_img_cache_add(lv_img_decoder_dsc_t * dsc);
+
 /**
  * Set the number of images to be cached.
  * More cached images mean more opened image at same time which might mean more memory usage.
  * E.g. if 20 PNG or JPG images are open in the RAM they consume memory while opened in the cache.
+ * The least recently used images are closed if there are more images in the cache.
  * @param new_entry_cnt number of image to cache
  */
 void lv_img_cache_set_size(uint16_t new_slot_num);
 
+/**
+ * Set the max. total size of the decoded images in the cache.
+ * Only the memory allocated by the decoders is counted, not images used directly from a variable.
+ * The least recently used images are closed if the current usage is larger.
+ * @param max_bytes the new size in bytes. 0: no limit
+ */
+void lv_img_cache_set_max_bytes(uint32_t max_bytes);
+
+/**
+ * Get the current state of the image cache
+ * @param info      store the result here
+ */
+void lv_img_cache_get_info(lv_img_cache_info_t * info);
+
 /**
  * Invalidate an image source in the cache.
  * Useful if the image source is updated therefore it needs to be cached again.
@@ -0,0 +1,683 @@
+/**
+ * @file lv_img_decode_async.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_img_decode_async.h"
+
+#if LV_USE_IMG_DECODE_ASYNC
+
+#include "lv_draw.h"
+#include "lv_img_cache.h"
+#include "../core/lv_refr.h"
+#include "../hal/lv_hal_disp.h"
+#include "../misc/lv_timer.h"
+#include "../misc/lv_assert.h"
+#include "../misc/lv_log.h"
+#include "../misc/lv_ll.h"
+#include "../misc/lv_gc.h"
+
+#if LV_IMG_DECODE_ASYNC_THREAD
+    #if LV_IMG_DECODE_ASYNC_FREERTOS
+        #ifdef ESP_PLATFORM
+            #include "freertos/FreeRTOS.h"
+            #include "freertos/task.h"
+            #include "freertos/semphr.h"
+        #else
+            #include "FreeRTOS.h"
+            #include "task.h"
+            #include "semphr.h"
+        #endif
+    #else
+        #include <pthread.h>
+    #endif
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#if LV_IMG_DECODE_ASYNC_QUEUE_LEN < 1
+    #error "LV_IMG_DECODE_ASYNC_QUEUE_LEN must be at least 1"
+#endif
+
+/*Check the decoded images this often [ms]*/
+#define TIMER_PERIOD    5
+
+/*Max. number of decoders which can be used on the decoder thread*/
+#define THREAD_SAFE_DECODER_MAX 4
+
+#if LV_IMG_DECODE_ASYNC_THREAD
+    #if LV_IMG_DECODE_ASYNC_FREERTOS
+        /*The mutex is created with the decoder task*/
+        #define LOCK()      do { if(lock) xSemaphoreTake(lock, portMAX_DELAY); } while(0)
+        #define UNLOCK()    do { if(lock) xSemaphoreGive(lock); } while(0)
+    #else
+        #define LOCK()      pthread_mutex_lock(&lock)
+        #define UNLOCK()    pthread_mutex_unlock(&lock)
+    #endif
+#else
+    #define LOCK()
+    #define UNLOCK()
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    JOB_FREE,
+    JOB_QUEUED,     /**< Waiting to be decoded*/
+    JOB_DECODING,   /**< Being decoded. Only the decoder thread touches `dec_dsc` and `res`*/
+    JOB_DONE,       /**< Decoded, waiting to be added to the image cache*/
+    JOB_LANDED,     /**< Added to the image cache. Kept to detect if it was dropped from the cache before drawing*/
+    JOB_FAILED,     /**< Couldn't be decoded. Kept to not retry it on every refresh*/
+} job_state_t;
+
+typedef struct {
+    lv_img_decoder_dsc_t dec_dsc;
+    const void * src;       /**< A copy of the path for files*/
+    lv_color_t color;
+    int32_t frame_id;
+    lv_disp_t * disp;       /**< Invalidate `area` on this display when decoded. NULL for prefetched images*/
+    lv_area_t area;
+    uint32_t seq;           /**< Order of the requests*/
+    lv_img_decoder_t * decoder;   /**< Decode it on the decoder thread with this decoder. NULL: decode it in the timer*/
+    lv_res_t res;
+    uint8_t state;
+    uint8_t visible : 1;    /**< Requested by drawing, decode it before the prefetched images*/
+} job_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool needs_decoder(const void * src);
+static bool src_match(const void * src1, const void * src2);
+static job_t * job_find(const void * src, lv_color_t color, int32_t frame_id);
+static job_t * job_alloc(bool visible);
+static job_t * job_next(bool on_worker);
+static void job_free(job_t * job);
+static bool job_add(const void * src, lv_color_t color, int32_t frame_id, const lv_area_t * area);
+static void timer_cb(lv_timer_t * t);
+static bool disp_exists(lv_disp_t * disp);
+static lv_img_decoder_t * get_thread_safe_decoder(const void * src);
+static void worker_wake(void);
+static void worker_wait_job(job_t * job);
+#if LV_IMG_DECODE_ASYNC_THREAD
+    static bool worker_init(void);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static job_t jobs[LV_IMG_DECODE_ASYNC_QUEUE_LEN];
+static uint32_t seq_act;
+static lv_timer_t * timer;
+static bool enabled;
+static lv_color_t placeholder_color;
+static lv_opa_t placeholder_opa;
+static lv_img_decoder_t * thread_safe_decoders[THREAD_SAFE_DECODER_MAX];
+
+#if LV_IMG_DECODE_ASYNC_THREAD
+static bool worker_inited;
+static bool worker_init_failed;
+#if LV_IMG_DECODE_ASYNC_FREERTOS
+static SemaphoreHandle_t lock;
+static SemaphoreHandle_t work_sem;
+static SemaphoreHandle_t done_sem;
+static TaskHandle_t worker_task_handle;
+#else
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t worker_thread_handle;
+#endif
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_img_decode_async_init(void)
+{
+    /*The decoder thread is kept between `lv_deinit()` and `lv_init()`, but `lv_deinit()` cancelled its jobs*/
+    lv_memset_00(jobs, sizeof(jobs));
+    seq_act = 0;
+    timer = NULL;
+    enabled = true;
+    placeholder_color = lv_color_black();
+    placeholder_opa = LV_OPA_TRANSP;
+    lv_memset_00(thread_safe_decoders, sizeof(thread_safe_decoders));
+}
+
+bool _lv_img_decode_async_request(const void * src, lv_color_t color, int32_t frame_id, const lv_area_t * area)
+{
+    if(!enabled || !needs_decoder(src)) return false;
+
+    /*Not drawing to a real display (e.g. taking a snapshot), there is nothing to invalidate later*/
+    lv_disp_t * disp = _lv_refr_get_disp_refreshing();
+    if(disp == NULL || !disp_exists(disp)) return false;
+
+    LOCK();
+    job_t * job = job_find(src, color, frame_id);
+    if(job == NULL) {
+        UNLOCK();
+        return job_add(src, color, frame_id, area);
+    }
+
+    bool queued = true;
+    if(job->state == JOB_LANDED || job->state == JOB_FAILED) {
+        /*It was decoded but dropped from the cache before it could be drawn, or it can't be decoded.
+         *Decode it now to not request it on every refresh again.*/
+        job_free(job);
+        queued = false;
+    }
+    else if(job->disp == NULL) {
+        /*Prefetched but it's needed now*/
+        job->disp = disp;
+        job->area = *area;
+        job->visible = 1;
+    }
+    else if(job->disp == disp) {
+        _lv_area_join(&job->area, &job->area, area);
+    }
+    else {
+        /*Only one display is invalidated*/
+        queued = false;
+    }
+    UNLOCK();
+
+    return queued;
+}
+
+void _lv_img_decode_async_cancel(const void * src)
+{
+    LOCK();
+    uint32_t i;
+    for(i = 0; i < LV_IMG_DECODE_ASYNC_QUEUE_LEN; i++) {
+        job_t * job = &jobs[i];
+        if(job->state == JOB_FREE) continue;
+        if(src && !src_match(src, job->src)) continue;
+
+        /*The decoder might read the source, don't let it be freed or changed meanwhile*/
+        worker_wait_job(job);
+        job_free(job);
+    }
+    UNLOCK();
+}
+
+void _lv_img_decode_async_draw_placeholder(lv_draw_ctx_t * draw_ctx, const lv_area_t * coords, lv_opa_t opa)
+{
+    if(placeholder_opa <= LV_OPA_MIN) return;
+
+    lv_draw_rect_dsc_t rect_dsc;
+    lv_draw_rect_dsc_init(&rect_dsc);
+    rect_dsc.bg_color = placeholder_color;
+    rect_dsc.bg_opa = opa >= LV_OPA_MAX ? placeholder_opa : (uint32_t)placeholder_opa * opa >> 8;
+    lv_draw_rect(draw_ctx, &rect_dsc, coords);
+}
+
+bool lv_img_decode_async_prefetch(const void * src)
+{
+    if(!enabled || !needs_decoder(src)) return false;
+
+    lv_color_t color = lv_color_black();
+    if(_lv_img_cache_find(src, color, 0)) return true;
+
+    LOCK();
+    job_t * job = job_find(src, color, 0);
+    bool pending = job && job->state != JOB_LANDED && job->state != JOB_FAILED;
+    if(job && !pending) job_free(job);
+    UNLOCK();
+    if(pending) return true;
+
+    return job_add(src, color, 0, NULL);
+}
+
+void lv_img_decode_async_set_enabled(bool en)
+{
+    enabled = en;
+}
+
+bool lv_img_decode_async_is_enabled(void)
+{
+    return enabled;
+}
+
+void lv_img_decode_async_set_placeholder(lv_color_t color, lv_opa_t opa)
+{
+    placeholder_color = color;
+    placeholder_opa = opa;
+}
+
+void lv_img_decode_async_set_thread_safe(lv_img_decoder_t * decoder, bool en)
+{
+    LV_ASSERT_NULL(decoder);
+
+    uint32_t i;
+    for(i = 0; i < THREAD_SAFE_DECODER_MAX; i++) {
+        if(thread_safe_decoders[i] == decoder) {
+            if(!en) thread_safe_decoders[i] = NULL;
+            return;
+        }
+    }
+
+    if(!en) return;
+
+    for(i = 0; i < THREAD_SAFE_DECODER_MAX; i++) {
+        if(thread_safe_decoders[i] == NULL) {
+            thread_safe_decoders[i] = decoder;
+            return;
+        }
+    }
+
+    LV_LOG_WARN("too many thread safe decoders, its images are decoded from the timer");
+}
+
+uint32_t lv_img_decode_async_get_pending_cnt(void)
+{
+    uint32_t cnt = 0;
+    LOCK();
+    uint32_t i;
+    for(i = 0; i < LV_IMG_DECODE_ASYNC_QUEUE_LEN; i++) {
+        if(jobs[i].state == JOB_QUEUED || jobs[i].state == JOB_DECODING || jobs[i].state == JOB_DONE) cnt++;
+    }
+    UNLOCK();
+    return cnt;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * The built-in formats in variables are used (almost) in place, only the others are worth to decode in the background.
+ */
+static bool needs_decoder(const void * src)
+{
+    lv_img_src_t src_type = lv_img_src_get_type(src);
+    if(src_type == LV_IMG_SRC_FILE) return true;
+    if(src_type != LV_IMG_SRC_VARIABLE) return false;
+
+    lv_img_cf_t cf = ((const lv_img_dsc_t *)src)->header.cf;
+    return cf == LV_IMG_CF_RAW || cf == LV_IMG_CF_RAW_ALPHA || cf == LV_IMG_CF_RAW_CHROMA_KEYED;
+}
+
+static bool src_match(const void * src1, const void * src2)
+{
+    if(lv_img_src_get_type(src1) != LV_IMG_SRC_FILE) return src1 == src2;
+    if(lv_img_src_get_type(src2) != LV_IMG_SRC_FILE) return false;
+    return strcmp(src1, src2) == 0;
+}
+
+static job_t * job_find(const void * src, lv_color_t color, int32_t frame_id)
+{
+    uint32_t i;
+    for(i = 0; i < LV_IMG_DECODE_ASYNC_QUEUE_LEN; i++) {
+        job_t * job = &jobs[i];
+        if(job->state != JOB_FREE && job->color.full == color.full && job->frame_id == frame_id &&
+           src_match(src, job->src)) {
+            return job;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Get a free job. If there is none, reuse the oldest finished job or
+ * drop the oldest prefetched image for a visible image.
+ */
+static job_t * job_alloc(bool visible)
+{
+    job_t * finished = NULL;
+    job_t * prefetch = NULL;
+    uint32_t i;
+    for(i = 0; i < LV_IMG_DECODE_ASYNC_QUEUE_LEN; i++) {
+        job_t * job = &jobs[i];
+        if(job->state == JOB_FREE) return job;
+
+        if(job->state == JOB_LANDED || job->state == JOB_FAILED) {
+            if(finished == NULL || job->seq < finished->seq) finished = job;
+        }
+        else if(visible && job->state == JOB_QUEUED && !job->visible) {
+            if(prefetch == NULL || job->seq < prefetch->seq) prefetch = job;
+        }
+    }
+
+    job_t * job = finished ? finished : prefetch;
+    if(job) job_free(job);
+    return job;
+}
+
+/**
+ * Get the next job to decode: the oldest visible image or the oldest prefetched image if there is no visible one
+ * @param on_worker true: get a job of a thread safe decoder; false: get a job to decode in the timer
+ */
+static job_t * job_next(bool on_worker)
+{
+    job_t * next = NULL;
+    uint32_t i;
+    for(i = 0; i < LV_IMG_DECODE_ASYNC_QUEUE_LEN; i++) {
+        job_t * job = &jobs[i];
+        if(job->state != JOB_QUEUED) continue;
+        if((job->decoder != NULL) != on_worker) continue;
+        if(next == NULL || job->visible > next->visible ||
+           (job->visible == next->visible && job->seq < next->seq)) {
+            next = job;
+        }
+    }
+
+    return next;
+}
+
+static void job_free(job_t * job)
+{
+    if(job->state == JOB_DONE && job->res == LV_RES_OK) lv_img_decoder_close(&job->dec_dsc);
+    if(lv_img_src_get_type(job->src) == LV_IMG_SRC_FILE) lv_mem_free((void *)job->src);
+    lv_memset_00(job, sizeof(job_t));
+}
+
+static bool job_add(const void * src, lv_color_t color, int32_t frame_id, const lv_area_t * area)
+{
+#if LV_IMG_DECODE_ASYNC_THREAD
+    if(!worker_init()) return false;
+#endif
+
+    if(timer == NULL) {
+        timer = lv_timer_create(timer_cb, TIMER_PERIOD, NULL);
+        LV_ASSERT_MALLOC(timer);
+        if(timer == NULL) return false;
+    }
+
+    const void * src_copy = src;
+    if(lv_img_src_get_type(src) == LV_IMG_SRC_FILE) {
+        size_t len = strlen(src);
+        char * path = lv_mem_alloc(len + 1);
+        LV_ASSERT_MALLOC(path);
+        if(path == NULL) return false;
+        lv_memcpy(path, src, len + 1);
+        src_copy = path;
+    }
+
+    /*Look for the decoder here as the `info_cb` of the other decoders might not be thread safe*/
+    lv_img_decoder_t * decoder = get_thread_safe_decoder(src);
+
+    LOCK();
+    job_t * job = job_alloc(area != NULL);
+    if(job == NULL) {
+        UNLOCK();
+        if(src_copy != src) lv_mem_free((void *)src_copy);
+        LV_LOG_INFO("the queue is full, decode the image now");
+        return false;
+    }
+
+    job->src = src_copy;
+    job->color = color;
+    job->frame_id = frame_id;
+    job->decoder = decoder;
+    job->seq = seq_act++;
+    if(area) {
+        job->disp = _lv_refr_get_disp_refreshing();
+        job->area = *area;
+        job->visible = 1;
+    }
+    job->state = JOB_QUEUED;
+    UNLOCK();
+
+    lv_timer_resume(timer);
+    if(decoder) worker_wake();
+
+    return true;
+}
+
+static void timer_cb(lv_timer_t * t)
+{
+    /*Decode one image of the not thread safe decoders in every call to keep the UI responsive*/
+    LOCK();
+    job_t * next = job_next(false);
+    if(next) next->state = JOB_DECODING;
+    UNLOCK();
+    if(next) {
+        /*A job being decoded is not freed or changed by the others, it's safe to read without the lock*/
+        lv_img_decoder_dsc_t dec_dsc;
+        lv_res_t res = lv_img_decoder_open(&dec_dsc, next->src, next->color, next->frame_id);
+        LOCK();
+        next->dec_dsc = dec_dsc;
+        next->res = res;
+        next->state = JOB_DONE;
+        UNLOCK();
+    }
+
+    bool pending = false;
+    uint32_t i;
+    for(i = 0; i < LV_IMG_DECODE_ASYNC_QUEUE_LEN; i++) {
+        job_t * job = &jobs[i];
+        LOCK();
+        if(job->state == JOB_QUEUED || job->state == JOB_DECODING) pending = true;
+        if(job->state != JOB_DONE) {
+            UNLOCK();
+            continue;
+        }
+
+        /*The cache takes over the decoded image*/
+        lv_img_decoder_dsc_t dec_dsc = job->dec_dsc;
+        lv_memset_00(&job->dec_dsc, sizeof(lv_img_decoder_dsc_t));
+        job->state = job->res == LV_RES_OK ? JOB_LANDED : JOB_FAILED;
+        lv_disp_t * disp = job->disp;
+        lv_area_t area = job->area;
+        lv_res_t res = job->res;
+        UNLOCK();
+
+        if(res == LV_RES_OK) _lv_img_cache_add(&dec_dsc);
+        else LV_LOG_WARN("couldn't decode an image in the background");
+
+        /*Redraw the image or show the error*/
+        if(disp && disp_exists(disp)) _lv_inv_area(disp, &area);
+    }
+
+    LOCK();
+    next = job_next(false);
+    UNLOCK();
+    if(next) {
+        pending = true;
+        lv_timer_ready(t);
+    }
+
+    if(!pending) lv_timer_pause(t);
+}
+
+static bool disp_exists(lv_disp_t * disp)
+{
+    lv_disp_t * d = lv_disp_get_next(NULL);
+    while(d) {
+        if(d == disp) return true;
+        d = lv_disp_get_next(d);
+    }
+
+    return false;
+}
+
+/**
+ * Get the decoder which will open an image if it was marked as thread safe.
+ * @return the decoder or NULL if the image should be decoded in the timer
+ */
+static lv_img_decoder_t * get_thread_safe_decoder(const void * src)
+{
+#if LV_IMG_DECODE_ASYNC_THREAD
+    lv_img_decoder_t * decoder;
+    _LV_LL_READ(&LV_GC_ROOT(_lv_img_decoder_ll), decoder) {
+        if(decoder->info_cb == NULL || decoder->open_cb == NULL) continue;
+
+        lv_img_header_t header;
+        if(decoder->info_cb(decoder, src, &header) != LV_RES_OK) continue;
+
+        uint32_t i;
+        for(i = 0; i < THREAD_SAFE_DECODER_MAX; i++) {
+            if(thread_safe_decoders[i] == decoder) return decoder;
+        }
+        return NULL;
+    }
+#else
+    LV_UNUSED(src);
+#endif
+
+    return NULL;
+}
+
+#if LV_IMG_DECODE_ASYNC_THREAD && LV_IMG_DECODE_ASYNC_FREERTOS
+
+static void worker_task(void * param)
+{
+    LV_UNUSED(param);
+    while(1) {
+        LOCK();
+        job_t * job = job_next(true);
+        if(job == NULL) {
+            UNLOCK();
+            xSemaphoreTake(work_sem, portMAX_DELAY);
+            continue;
+        }
+
+        job->state = JOB_DECODING;
+        UNLOCK();
+
+        lv_img_decoder_dsc_t dec_dsc;
+        lv_res_t res = _lv_img_decoder_open_with(job->decoder, &dec_dsc, job->src, job->color, job->frame_id);
+
+        LOCK();
+        job->dec_dsc = dec_dsc;
+        job->res = res;
+        job->state = JOB_DONE;
+        UNLOCK();
+        xSemaphoreGive(done_sem);
+    }
+}
+
+static bool worker_init(void)
+{
+    if(worker_inited) return true;
+    if(worker_init_failed) return false;
+
+    lock = xSemaphoreCreateMutex();
+    work_sem = xSemaphoreCreateBinary();
+    done_sem = xSemaphoreCreateBinary();
+    if(lock == NULL || work_sem == NULL || done_sem == NULL) {
+        LV_LOG_WARN("couldn't create the semaphores of the decoder task. Decoding the images while drawing.");
+        worker_init_failed = true;
+        return false;
+    }
+
+    BaseType_t res;
+#if defined(ESP_PLATFORM) && LV_IMG_DECODE_ASYNC_CORE >= 0
+    res = xTaskCreatePinnedToCore(worker_task, "lv_img_dec", LV_IMG_DECODE_ASYNC_STACK_SIZE, NULL,
+                                  LV_IMG_DECODE_ASYNC_TASK_PRIO, &worker_task_handle, LV_IMG_DECODE_ASYNC_CORE);
+#else
+    res = xTaskCreate(worker_task, "lv_img_dec", LV_IMG_DECODE_ASYNC_STACK_SIZE, NULL,
+                      LV_IMG_DECODE_ASYNC_TASK_PRIO, &worker_task_handle);
+#endif
+    if(res != pdPASS) {
+        LV_LOG_WARN("couldn't create the decoder task. Decoding the images while drawing.");
+        worker_init_failed = true;
+        return false;
+    }
+
+    worker_inited = true;
+    return true;
+}
+
+static void worker_wake(void)
+{
+    xSemaphoreGive(work_sem);
+}
+
+/*Called with the lock held*/
+static void worker_wait_job(job_t * job)
+{
+    while(job->state == JOB_DECODING) {
+        /*Given after every decoded image, so it might wake up for an other job too*/
+        UNLOCK();
+        xSemaphoreTake(done_sem, portMAX_DELAY);
+        LOCK();
+    }
+}
+
+#elif LV_IMG_DECODE_ASYNC_THREAD
+
+static void * worker_thread(void * param)
+{
+    LV_UNUSED(param);
+    LOCK();
+    while(1) {
+        job_t * job = job_next(true);
+        if(job == NULL) {
+            pthread_cond_wait(&work_cond, &lock);
+            continue;
+        }
+
+        job->state = JOB_DECODING;
+        UNLOCK();
+
+        lv_img_decoder_dsc_t dec_dsc;
+        lv_res_t res = _lv_img_decoder_open_with(job->decoder, &dec_dsc, job->src, job->color, job->frame_id);
+
+        LOCK();
+        job->dec_dsc = dec_dsc;
+        job->res = res;
+        job->state = JOB_DONE;
+        pthread_cond_broadcast(&done_cond);
+    }
+
+    return NULL;
+}
+
+static bool worker_init(void)
+{
+    if(worker_inited) return true;
+    if(worker_init_failed) return false;
+
+    if(pthread_create(&worker_thread_handle, NULL, worker_thread, NULL) != 0) {
+        LV_LOG_WARN("couldn't create the decoder thread. Decoding the images while drawing.");
+        worker_init_failed = true;
+        return false;
+    }
+
+    worker_inited = true;
+    return true;
+}
+
+static void worker_wake(void)
+{
+    LOCK();
+    pthread_cond_signal(&work_cond);
+    UNLOCK();
+}
+
+/*Called with the lock held*/
+static void worker_wait_job(job_t * job)
+{
+    while(job->state == JOB_DECODING) {
+        pthread_cond_wait(&done_cond, &lock);
+    }
+}
+
+#else /*LV_IMG_DECODE_ASYNC_THREAD*/
+
+static void worker_wake(void)
+{
+    /*The images are decoded in `timer_cb`*/
+}
+
+static void worker_wait_job(job_t * job)
+{
+    LV_UNUSED(job);
+}
+
+#endif /*LV_IMG_DECODE_ASYNC_THREAD*/
+
+#endif /*LV_USE_IMG_DECODE_ASYNC*/
@@ -0,0 +1,132 @@
+/**
+ * @file lv_img_decode_async.h
+ *
+ */
+
+#ifndef LV_IMG_DECODE_ASYNC_H
+#define LV_IMG_DECODE_ASYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+#include "../misc/lv_area.h"
+#include "../misc/lv_color.h"
+#include "lv_img_decoder.h"
+
+#if LV_USE_IMG_DECODE_ASYNC
+
+#if LV_IMG_CACHE_DEF_SIZE == 0
+    #error "LV_USE_IMG_DECODE_ASYNC requires LV_IMG_CACHE_DEF_SIZE > 0"
+#endif
+
+#if LV_IMG_DECODE_ASYNC_THREAD && LV_MEM_CUSTOM == 0
+    #error "LV_IMG_DECODE_ASYNC_THREAD requires LV_MEM_CUSTOM = 1 (a thread safe allocator)"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+struct _lv_draw_ctx_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the background decoding. Called by `lv_init()`.
+ */
+void _lv_img_decode_async_init(void);
+
+/**
+ * Queue an image to be decoded in the background if it needs a decoder (it's a file or an `LV_IMG_CF_RAW...` variable).
+ * When it's decoded it's added to the image cache and `area` is invalidated on the display being refreshed.
+ * Requesting an image which is already queued only extends the area to invalidate.
+ * @param src       source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
+ * @param color     the color of the image with `LV_IMG_CF_ALPHA_...`
+ * @param frame_id  the index of the frame
+ * @param area      the area of the image on the display
+ * @return          true: the image is being decoded, draw a placeholder; false: the image should be decoded now
+ */
+bool _lv_img_decode_async_request(const void * src, lv_color_t color, int32_t frame_id, const lv_area_t * area);
+
+/**
+ * Drop the queued and decoded images of a source. Called by `lv_img_cache_invalidate_src()`.
+ * Waits until the source is decoded if it's being decoded right now.
+ * @param src       source of the image or NULL to drop all the images
+ */
+void _lv_img_decode_async_cancel(const void * src);
+
+/**
+ * Draw the placeholder of an image which is being decoded
+ * @param draw_ctx  pointer to the current draw context
+ * @param coords    the area of the image
+ * @param opa       opacity of the image
+ */
+void _lv_img_decode_async_draw_placeholder(struct _lv_draw_ctx_t * draw_ctx, const lv_area_t * coords, lv_opa_t opa);
+
+/**
+ * Queue an image to be decoded in the background with low priority, e.g. the images of the next screen.
+ * The images requested by drawing are decoded first. Nothing is invalidated when it's decoded.
+ * @param src       source of the image. Path to file or pointer to an `lv_img_dsc_t` variable.
+ *                  It's cached with black recolor (the default of the image widget).
+ * @return          true: the image is cached or queued; false: the queue is full or the image needs no decoder
+ */
+bool lv_img_decode_async_prefetch(const void * src);
+
+/**
+ * Enable or disable the background decoding in run time. It's enabled by default.
+ * If disabled the images are decoded while drawing them.
+ * @param en        true: enable; false: disable
+ */
+void lv_img_decode_async_set_enabled(bool en);
+
+/**
+ * Tell whether the images are decoded in the background
+ * @return          true: enabled
+ */
+bool lv_img_decode_async_is_enabled(void);
+
+/**
+ * Set how to draw the images which are being decoded. By default nothing is drawn.
+ * @param color     color of the rectangle drawn instead of the image
+ * @param opa       opacity of the rectangle. `LV_OPA_TRANSP`: draw nothing
+ */
+void lv_img_decode_async_set_placeholder(lv_color_t color, lv_opa_t opa);
+
+/**
+ * Mark an image decoder as thread safe. With `LV_IMG_DECODE_ASYNC_THREAD` only the images of these decoders
+ * are decoded on the decoder thread, the others are decoded one by one from an `lv_timer` between the refreshes.
+ * A decoder is thread safe if its callbacks use only `lv_mem` (`LV_MEM_CUSTOM = 1` with a thread safe `malloc`),
+ * file system drivers which can be used from an other thread and no other global state of LVGL.
+ * No decoder is marked by default. Unmark the decoder before deleting it.
+ * @param decoder   pointer to an image decoder
+ * @param en        true: it's thread safe; false: decode its images from the timer
+ */
+void lv_img_decode_async_set_thread_safe(lv_img_decoder_t * decoder, bool en);
+
+/**
+ * Get the number of images which are queued or being decoded and not added to the image cache yet.
+ * @return          number of pending images
+ */
+uint32_t lv_img_decode_async_get_pending_cnt(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_IMG_DECODE_ASYNC*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_IMG_DECODE_ASYNC_H*/
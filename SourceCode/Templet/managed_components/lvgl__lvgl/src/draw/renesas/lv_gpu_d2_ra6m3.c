@@ -703,6 +703,7 @@ void lv_draw_ra6m3_2d_ctx_init(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx)
     ra_2d_draw_ctx->base_draw.draw_img_decoded = lv_port_gpu_img_decoded;
     ra_2d_draw_ctx->base_draw.wait_for_finish = lv_port_gpu_wait;
     ra_2d_draw_ctx->base_draw.draw_letter = lv_draw_gpu_letter;
+    ra_2d_draw_ctx->base_draw.draw_text_run = NULL;     /*Draw the letters one by one with the GPU*/
     //ra_2d_draw_ctx->base_draw.buffer_copy = lv_draw_ra6m3_2d_buffer_copy;
 }
 
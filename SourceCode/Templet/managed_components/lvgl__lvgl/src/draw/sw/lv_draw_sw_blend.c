@@ -18,10 +18,27 @@
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct {
+    const lv_draw_sw_blend_dsc_t * dsc;
+    lv_color_t * dest_buf;              /*Points to the first pixel of `blend_area`*/
+    const lv_color_t * src_buf;         /*Points to the first pixel of `blend_area` or NULL*/
+    const lv_opa_t * mask;              /*Points to the first pixel of `blend_area` or NULL*/
+    lv_coord_t dest_stride;
+    lv_coord_t src_stride;
+    lv_coord_t mask_stride;
+    lv_area_t blend_area;               /*Relative to the draw buffer*/
+    uint8_t set_px : 1;
+    uint8_t screen_transp : 1;
+} blend_job_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void /* LV_ATTRIBUTE_FAST_MEM */ blend_stripe(void * user_data, lv_coord_t y1, lv_coord_t y2);
+#if LV_USE_DRAW_MASK_SPANS
+static void /* LV_ATTRIBUTE_FAST_MEM */ blend_spans(const blend_job_t * job, const lv_draw_mask_span_list_t * spans,
+                                                    lv_coord_t span_ofs);
+#endif
 
 static void fill_set_px(lv_color_t * dest_buf, const lv_area_t * blend_area, lv_coord_t dest_stride,
                         lv_color_t color, lv_opa_t opa, const lv_opa_t * mask, lv_coord_t mask_stide);
@@ -145,6 +162,7 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
     }
 
     lv_coord_t mask_stride;
+    lv_coord_t span_ofs = 0;
     if(mask) {
         /*Round the values in the mask if anti-aliasing is disabled*/
         if(disp->driver->antialiasing == 0) {
@@ -157,6 +175,7 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
 
         mask_stride = lv_area_get_width(dsc->mask_area);
         mask += mask_stride * (blend_area.y1 - dsc->mask_area->y1) + (blend_area.x1 - dsc->mask_area->x1);
+        span_ofs = blend_area.x1 - dsc->mask_area->x1;
 
     }
     else {
@@ -165,7 +184,78 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
 
     lv_area_move(&blend_area, -draw_ctx->buf_area->x1, -draw_ctx->buf_area->y1);
 
-    if(disp->driver->set_px_cb) {
+    blend_job_t job;
+    job.dsc = dsc;
+    job.dest_buf = dest_buf;
+    job.dest_stride = dest_stride;
+    job.src_buf = src_buf;
+    job.src_stride = src_stride;
+    job.mask = mask;
+    job.mask_stride = mask_stride;
+    job.blend_area = blend_area;
+    job.set_px = disp->driver->set_px_cb != NULL;
+    job.screen_transp = disp->driver->screen_transp;
+
+#if LV_USE_DRAW_MASK_SPANS
+    /*Skip the transparent runs of the mask and fill the not masked ones without reading the mask.
+     *The other blend modes would give slightly different result without the mask so use the spans only with the normal mode*/
+    if(mask && dsc->mask_spans && dsc->mask_area->y1 == dsc->mask_area->y2 &&
+       job.set_px == false && job.screen_transp == 0 && dsc->blend_mode == LV_BLEND_MODE_NORMAL) {
+        blend_spans(&job, dsc->mask_spans, span_ofs);
+        return;
+    }
+#else
+    LV_UNUSED(span_ofs);
+#endif
+
+#if LV_USE_DRAW_SW_PARALLEL
+    /*`set_px_cb` and the ARGB blend modes with `LV_COLOR_SCREEN_TRANSP` use global state so render them serially*/
+    bool can_split = job.set_px == false && (job.screen_transp == 0 || dsc->blend_mode == LV_BLEND_MODE_NORMAL);
+    if(can_split && _lv_draw_sw_parallel_should_split(lv_area_get_width(&blend_area), lv_area_get_height(&blend_area))) {
+        _lv_draw_sw_parallel_run(blend_stripe, &job, lv_area_get_height(&blend_area));
+        return;
+    }
+#endif
+
+    blend_stripe(&job, 0, lv_area_get_height(&blend_area) - 1);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Blend the `y1..y2` rows (relative to the top of `job->blend_area`) of a blend job.
+ * With `LV_USE_DRAW_SW_PARALLEL` it's called from the worker threads too.
+ */
+static void LV_ATTRIBUTE_FAST_MEM blend_stripe(void * user_data, lv_coord_t y1, lv_coord_t y2)
+{
+    const blend_job_t * job = user_data;
+    const lv_draw_sw_blend_dsc_t * dsc = job->dsc;
+
+    lv_area_t blend_area = job->blend_area;
+    blend_area.y1 = job->blend_area.y1 + y1;
+    blend_area.y2 = job->blend_area.y1 + y2;
+
+    lv_color_t * dest_buf = job->dest_buf;
+    if(job->set_px == false) {
+        if(job->screen_transp == 0) {
+            dest_buf += job->dest_stride * y1;
+        }
+        else {
+            uint8_t * dest_buf8 = (uint8_t *) dest_buf;
+            dest_buf8 += job->dest_stride * y1 * LV_IMG_PX_SIZE_ALPHA_BYTE;
+            dest_buf = (lv_color_t *)dest_buf8;
+        }
+    }
+
+    const lv_color_t * src_buf = job->src_buf ? job->src_buf + job->src_stride * y1 : NULL;
+    const lv_opa_t * mask = job->mask ? job->mask + job->mask_stride * y1 : NULL;
+    lv_coord_t dest_stride = job->dest_stride;
+    lv_coord_t src_stride = job->src_stride;
+    lv_coord_t mask_stride = job->mask_stride;
+
+    if(job->set_px) {
         if(dsc->src_buf == NULL) {
             fill_set_px(dest_buf, &blend_area, dest_stride, dsc->color, dsc->opa, mask, mask_stride);
         }
@@ -174,7 +264,7 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
         }
     }
 #if LV_COLOR_SCREEN_TRANSP
-    else if(disp->driver->screen_transp) {
+    else if(job->screen_transp) {
         if(dsc->src_buf == NULL) {
             fill_argb(dest_buf, &blend_area, dest_stride, dsc->color, dsc->opa, mask, mask_stride);
         }
@@ -203,9 +293,53 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
     }
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
+#if LV_USE_DRAW_MASK_SPANS
+/**
+ * Blend a 1 line high job run by run.
+ * @param job       the job to blend
+ * @param spans     the coverage runs of the mask line
+ * @param span_ofs  the first pixel of `job->blend_area` in the mask line
+ */
+static void LV_ATTRIBUTE_FAST_MEM blend_spans(const blend_job_t * job, const lv_draw_mask_span_list_t * spans,
+                                              lv_coord_t span_ofs)
+{
+    lv_coord_t w = lv_area_get_width(&job->blend_area);
+    uint32_t i;
+    for(i = 0; i < spans->cnt; i++) {
+        const lv_draw_mask_span_t * span = &spans->spans[i];
+        if(span->res == LV_DRAW_MASK_RES_TRANSP) continue;
+
+        /*Relative to the start of the blend area*/
+        lv_coord_t x1 = LV_MAX(span->x - span_ofs, 0);
+        lv_coord_t x2 = LV_MIN(span->x + span->len - span_ofs, w) - 1;
+        if(x1 > x2) continue;
+
+        blend_job_t span_job = *job;
+        span_job.blend_area.x1 = job->blend_area.x1 + x1;
+        span_job.blend_area.x2 = job->blend_area.x1 + x2;
+        span_job.dest_buf += x1;
+        if(span_job.src_buf) span_job.src_buf += x1;
+        span_job.mask += x1;
+
+        if(span->res == LV_DRAW_MASK_RES_CHANGED) {
+            blend_stripe(&span_job, 0, 0);
+        }
+        else {
+            /*The masks haven't touched these pixels so they have the same value everywhere*/
+            lv_opa_t mask_opa = span_job.mask[0];
+            if(mask_opa <= LV_OPA_MIN) continue;
+
+            lv_draw_sw_blend_dsc_t span_dsc = *job->dsc;
+            if(mask_opa != LV_OPA_COVER) {
+                span_dsc.opa = span_dsc.opa >= LV_OPA_MAX ? mask_opa : (uint32_t)((uint32_t)span_dsc.opa * mask_opa) >> 8;
+            }
+            span_job.dsc = &span_dsc;
+            span_job.mask = NULL;
+            blend_stripe(&span_job, 0, 0);
+        }
+    }
+}
+#endif
 
 static void fill_set_px(lv_color_t * dest_buf, const lv_area_t * blend_area, lv_coord_t dest_stride,
                         lv_color_t color, lv_opa_t opa, const lv_opa_t * mask, lv_coord_t mask_stide)
@@ -249,6 +383,22 @@ static LV_ATTRIBUTE_FAST_MEM void fill_normal(lv_color_t * dest_buf, const lv_ar
     int32_t x;
     int32_t y;
 
+#if LV_USE_DRAW_SW_SIMD
+    /*Use the vector kernels for everything except the simple fill*/
+    const lv_draw_sw_blend_kernels_t * kernels = lv_draw_sw_blend_get_kernels();
+    if(kernels && (mask || opa < LV_OPA_MAX)) {
+        for(y = 0; y < h; y++) {
+            if(mask == NULL) kernels->fill_opa(dest_buf, w, color, opa);
+            else if(opa >= LV_OPA_MAX) kernels->fill_mask(dest_buf, w, color, mask);
+            else kernels->fill_mask_opa(dest_buf, w, color, opa, mask);
+
+            dest_buf += dest_stride;
+            if(mask) mask += mask_stride;
+        }
+        return;
+    }
+#endif
+
     /*No mask*/
     if(mask == NULL) {
         if(opa >= LV_OPA_MAX) {
@@ -650,6 +800,23 @@ static void LV_ATTRIBUTE_FAST_MEM map_normal(lv_color_t * dest_buf, const lv_are
     int32_t x;
     int32_t y;
 
+#if LV_USE_DRAW_SW_SIMD
+    /*Use the vector kernels for everything except the simple copy*/
+    const lv_draw_sw_blend_kernels_t * kernels = lv_draw_sw_blend_get_kernels();
+    if(kernels && (mask || opa < LV_OPA_MAX)) {
+        for(y = 0; y < h; y++) {
+            if(mask == NULL) kernels->map_opa(dest_buf, src_buf, w, opa);
+            else if(opa > LV_OPA_MAX) kernels->map_mask(dest_buf, src_buf, w, mask);
+            else kernels->map_mask_opa(dest_buf, src_buf, w, opa, mask);
+
+            dest_buf += dest_stride;
+            src_buf += src_stride;
+            if(mask) mask += mask_stride;
+        }
+        return;
+    }
+#endif
+
     /*Simple fill (maybe with opacity), no masking*/
     if(mask == NULL) {
         if(opa >= LV_OPA_MAX) {
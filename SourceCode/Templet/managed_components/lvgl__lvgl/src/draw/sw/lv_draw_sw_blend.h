@@ -36,6 +36,10 @@ typedef struct {
     const lv_area_t * mask_area;    /**< The area of `mask_buf` with absolute coordinates*/
     lv_opa_t opa;                   /**< The overall opacity*/
     lv_blend_mode_t blend_mode;     /**< E.g. LV_BLEND_MODE_ADDITIVE*/
+#if LV_USE_DRAW_MASK_SPANS
+    lv_draw_mask_span_list_t * mask_spans;  /**< NULL if ignored, or the coverage runs of a 1 line high `mask_buf`
+                                             *   (see `lv_draw_mask_apply_spans()`)*/
+#endif
 } lv_draw_sw_blend_dsc_t;
 
 struct _lv_draw_ctx_t;
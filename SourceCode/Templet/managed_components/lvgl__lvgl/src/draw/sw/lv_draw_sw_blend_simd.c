@@ -0,0 +1,888 @@
+/**
+ * @file lv_draw_sw_blend_simd.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_blend_simd.h"
+
+#if LV_USE_DRAW_SW_SIMD
+
+#include <stdbool.h>
+#include <string.h>
+#include "../../misc/lv_log.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/*The vector kernels are bit exact only with the color mixing algorithm of these color formats*/
+#if LV_COLOR_DEPTH == 32 || (LV_COLOR_DEPTH == 16 && LV_COLOR_MIX_ROUND_OFS == 0)
+    #define BLEND_SIMD_COLOR_OK 1
+#else
+    #define BLEND_SIMD_COLOR_OK 0
+#endif
+
+#if BLEND_SIMD_COLOR_OK && defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+    #define BLEND_SIMD_X86 1
+    #include <immintrin.h>
+    /*AVX2 is enabled only for these functions and they are called only if the CPU supports it*/
+    #define ATTRIBUTE_AVX2 __attribute__((target("avx2")))
+#else
+    #define BLEND_SIMD_X86 0
+#endif
+
+#if LV_COLOR_DEPTH == 16
+    #define PX_SSE2 8
+    #define PX_AVX2 16
+#else
+    #define PX_SSE2 4
+    #define PX_AVX2 8
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_opa_t premult_prepare(lv_color_t color, lv_opa_t opa, uint16_t * color_premult);
+static void fill_opa_scalar(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa);
+static void fill_mask_scalar(lv_color_t * dest_buf, int32_t w, lv_color_t color, const lv_opa_t * mask);
+static void fill_mask_opa_scalar(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa,
+                                 const lv_opa_t * mask);
+static void map_opa_scalar(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, lv_opa_t opa);
+static void map_mask_scalar(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, const lv_opa_t * mask);
+static void map_mask_opa_scalar(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, lv_opa_t opa,
+                                const lv_opa_t * mask);
+
+#if BLEND_SIMD_X86
+static void fill_opa_sse2(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa);
+static void fill_mask_sse2(lv_color_t * dest_buf, int32_t w, lv_color_t color, const lv_opa_t * mask);
+static void fill_mask_opa_sse2(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa,
+                               const lv_opa_t * mask);
+static void map_opa_sse2(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, lv_opa_t opa);
+static void map_mask_sse2(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, const lv_opa_t * mask);
+static void map_mask_opa_sse2(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, lv_opa_t opa,
+                              const lv_opa_t * mask);
+
+static void fill_opa_avx2(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa);
+static void fill_mask_avx2(lv_color_t * dest_buf, int32_t w, lv_color_t color, const lv_opa_t * mask);
+static void fill_mask_opa_avx2(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa,
+                               const lv_opa_t * mask);
+static void map_opa_avx2(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, lv_opa_t opa);
+static void map_mask_avx2(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, const lv_opa_t * mask);
+static void map_mask_opa_avx2(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, lv_opa_t opa,
+                              const lv_opa_t * mask);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const lv_draw_sw_blend_kernels_t kernels_scalar = {
+    .name = "scalar",
+    .fill_opa = fill_opa_scalar,
+    .fill_mask = fill_mask_scalar,
+    .fill_mask_opa = fill_mask_opa_scalar,
+    .map_opa = map_opa_scalar,
+    .map_mask = map_mask_scalar,
+    .map_mask_opa = map_mask_opa_scalar,
+};
+
+#if BLEND_SIMD_X86
+static const lv_draw_sw_blend_kernels_t kernels_sse2 = {
+    .name = "sse2",
+    .fill_opa = fill_opa_sse2,
+    .fill_mask = fill_mask_sse2,
+    .fill_mask_opa = fill_mask_opa_sse2,
+    .map_opa = map_opa_sse2,
+    .map_mask = map_mask_sse2,
+    .map_mask_opa = map_mask_opa_sse2,
+};
+
+static const lv_draw_sw_blend_kernels_t kernels_avx2 = {
+    .name = "avx2",
+    .fill_opa = fill_opa_avx2,
+    .fill_mask = fill_mask_avx2,
+    .fill_mask_opa = fill_mask_opa_avx2,
+    .map_opa = map_opa_avx2,
+    .map_mask = map_mask_avx2,
+    .map_mask_opa = map_mask_opa_avx2,
+};
+#endif
+
+static const lv_draw_sw_blend_kernels_t * kernels_act;
+#if BLEND_SIMD_X86
+    static bool cpu_has_avx2;
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_draw_sw_blend_simd_init(void)
+{
+#if BLEND_SIMD_X86
+    __builtin_cpu_init();
+    cpu_has_avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+    /*Use the last (fastest) vector kernels.
+     *The scalar reference kernels are not used as the original blending code is faster.*/
+    kernels_act = NULL;
+    uint32_t i;
+    for(i = 1; _lv_draw_sw_blend_simd_get_builtin(i); i++) {
+        kernels_act = _lv_draw_sw_blend_simd_get_builtin(i);
+    }
+
+    if(kernels_act) LV_LOG_INFO("using the %s blend kernels", kernels_act->name);
+}
+
+void lv_draw_sw_blend_set_kernels(const lv_draw_sw_blend_kernels_t * kernels)
+{
+    kernels_act = kernels;
+}
+
+const lv_draw_sw_blend_kernels_t * lv_draw_sw_blend_get_kernels(void)
+{
+    return kernels_act;
+}
+
+const lv_draw_sw_blend_kernels_t * _lv_draw_sw_blend_simd_get_builtin(uint32_t idx)
+{
+    const lv_draw_sw_blend_kernels_t * list[3];
+    uint32_t cnt = 0;
+    list[cnt++] = &kernels_scalar;
+#if BLEND_SIMD_X86
+    list[cnt++] = &kernels_sse2;
+    if(cpu_has_avx2) list[cnt++] = &kernels_avx2;
+#endif
+
+    return idx < cnt ? list[idx] : NULL;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*=====================
+ * Scalar reference
+ *====================*/
+
+/**
+ * Prepare the color for `lv_color_mix_premult()` the same way as `fill_normal()` does.
+ * @param color         the color to fill with
+ * @param opa           opacity of the color
+ * @param color_premult store the pre-multiplied color channels here
+ * @return              the inverted opacity to use with `lv_color_mix_premult()`
+ */
+static lv_opa_t premult_prepare(lv_color_t color, lv_opa_t opa, uint16_t * color_premult)
+{
+#if LV_COLOR_MIX_ROUND_OFS == 0 && LV_COLOR_DEPTH == 16
+    /*Use the same rounding error as lv_color_mix*/
+    opa = (uint32_t)((uint32_t)opa + 4) >> 3;
+    opa = opa << 3;
+#endif
+
+    lv_color_premult(color, opa, color_premult);
+    return 255 - opa;
+}
+
+static void fill_opa_scalar(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa)
+{
+    uint16_t color_premult[3];
+    lv_opa_t opa_inv = premult_prepare(color, opa, color_premult);
+
+    int32_t x;
+    for(x = 0; x < w; x++) {
+        dest_buf[x] = lv_color_mix_premult(color_premult, dest_buf[x], opa_inv);
+    }
+}
+
+static void fill_mask_scalar(lv_color_t * dest_buf, int32_t w, lv_color_t color, const lv_opa_t * mask)
+{
+    int32_t x;
+    for(x = 0; x < w; x++) {
+        if(mask[x] == LV_OPA_COVER) dest_buf[x] = color;
+        else if(mask[x]) dest_buf[x] = lv_color_mix(color, dest_buf[x], mask[x]);
+    }
+}
+
+static void fill_mask_opa_scalar(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa,
+                                 const lv_opa_t * mask)
+{
+    int32_t x;
+    for(x = 0; x < w; x++) {
+        if(mask[x]) {
+            lv_opa_t opa_tmp = mask[x] == LV_OPA_COVER ? opa : (uint32_t)((uint32_t)mask[x] * opa) >> 8;
+            dest_buf[x] = lv_color_mix(color, dest_buf[x], opa_tmp);
+        }
+    }
+}
+
+static void map_opa_scalar(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, lv_opa_t opa)
+{
+    int32_t x;
+    for(x = 0; x < w; x++) {
+        dest_buf[x] = lv_color_mix(src_buf[x], dest_buf[x], opa);
+    }
+}
+
+static void map_mask_scalar(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, const lv_opa_t * mask)
+{
+    int32_t x;
+    for(x = 0; x < w; x++) {
+        if(mask[x] == LV_OPA_COVER) dest_buf[x] = src_buf[x];
+        else if(mask[x]) dest_buf[x] = lv_color_mix(src_buf[x], dest_buf[x], mask[x]);
+    }
+}
+
+static void map_mask_opa_scalar(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, lv_opa_t opa,
+                                const lv_opa_t * mask)
+{
+    int32_t x;
+    for(x = 0; x < w; x++) {
+        if(mask[x]) {
+            lv_opa_t opa_tmp = mask[x] >= LV_OPA_MAX ? opa : ((opa * mask[x]) >> 8);
+            dest_buf[x] = lv_color_mix(src_buf[x], dest_buf[x], opa_tmp);
+        }
+    }
+}
+
+#if BLEND_SIMD_X86
+
+/*=====================
+ * SSE2
+ *====================*/
+
+/* The helpers below hide the color format. In the vectors the mix ratios are stored in the 16 bit lanes
+ * of the pixels, in both 16 bit halves with 32 bit color depth. So the ratios can be processed with
+ * the same 16 bit operations for both color depths.*/
+
+#if LV_COLOR_DEPTH == 16
+
+static inline __m128i load_px_sse2(const lv_color_t * buf)
+{
+    __m128i v = _mm_loadu_si128((const __m128i *)buf);
+#if LV_COLOR_16_SWAP
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+#endif
+    return v;
+}
+
+static inline void store_px_sse2(lv_color_t * buf, __m128i v)
+{
+#if LV_COLOR_16_SWAP
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+#endif
+    _mm_storeu_si128((__m128i *)buf, v);
+}
+
+static inline __m128i set1_px_sse2(lv_color_t color)
+{
+#if LV_COLOR_16_SWAP
+    color.full = (uint16_t)(color.full << 8 | color.full >> 8);
+#endif
+    return _mm_set1_epi16((int16_t)color.full);
+}
+
+static inline __m128i load_mask_sse2(const lv_opa_t * mask)
+{
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)mask), _mm_setzero_si128());
+}
+
+/**
+ * Mix the channels like `lv_color_mix()` does on the packed RGB565 value: ((fg - bg) * mix / 8 >> 5) + bg
+ */
+static inline __m128i mix_sse2(__m128i fg, __m128i bg, __m128i mix)
+{
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    mix = _mm_srli_epi16(_mm_add_epi16(mix, _mm_set1_epi16(4)), 3);
+
+    __m128i bg_r = _mm_srli_epi16(bg, 11);
+    __m128i bg_g = _mm_and_si128(_mm_srli_epi16(bg, 5), mask6);
+    __m128i bg_b = _mm_and_si128(bg, mask5);
+    __m128i r = _mm_sub_epi16(_mm_srli_epi16(fg, 11), bg_r);
+    __m128i g = _mm_sub_epi16(_mm_and_si128(_mm_srli_epi16(fg, 5), mask6), bg_g);
+    __m128i b = _mm_sub_epi16(_mm_and_si128(fg, mask5), bg_b);
+
+    r = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(r, mix), 5), bg_r);
+    g = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(g, mix), 5), bg_g);
+    b = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(b, mix), 5), bg_b);
+
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11), _mm_slli_epi16(g, 5)), b);
+}
+
+/*With RGB565 the mix gives exactly `bg` and `fg` for 0 and 255 mask so there is nothing to do*/
+static inline __m128i keep_transp_sse2(__m128i res, __m128i bg, __m128i mask)
+{
+    LV_UNUSED(bg);
+    LV_UNUSED(mask);
+    return res;
+}
+
+static inline __m128i copy_cover_sse2(__m128i res, __m128i fg, __m128i mask)
+{
+    LV_UNUSED(fg);
+    LV_UNUSED(mask);
+    return res;
+}
+
+static void fill_opa_sse2(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa)
+{
+    uint16_t color_premult[3];
+    lv_opa_t opa_inv = premult_prepare(color, opa, color_premult);
+
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    const __m128i div255 = _mm_set1_epi16((int16_t)0x8081);
+    __m128i pre_r = _mm_set1_epi16((int16_t)color_premult[0]);
+    __m128i pre_g = _mm_set1_epi16((int16_t)color_premult[1]);
+    __m128i pre_b = _mm_set1_epi16((int16_t)color_premult[2]);
+    __m128i inv = _mm_set1_epi16(opa_inv);
+
+    int32_t x;
+    for(x = 0; x + PX_SSE2 <= w; x += PX_SSE2) {
+        __m128i bg = load_px_sse2(&dest_buf[x]);
+        /*LV_UDIV255(premult + bg * opa_inv)*/
+        __m128i r = _mm_add_epi16(pre_r, _mm_mullo_epi16(_mm_srli_epi16(bg, 11), inv));
+        __m128i g = _mm_add_epi16(pre_g, _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(bg, 5), mask6), inv));
+        __m128i b = _mm_add_epi16(pre_b, _mm_mullo_epi16(_mm_and_si128(bg, mask5), inv));
+        r = _mm_srli_epi16(_mm_mulhi_epu16(r, div255), 7);
+        g = _mm_srli_epi16(_mm_mulhi_epu16(g, div255), 7);
+        b = _mm_srli_epi16(_mm_mulhi_epu16(b, div255), 7);
+        store_px_sse2(&dest_buf[x], _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11), _mm_slli_epi16(g, 5)), b));
+    }
+
+    fill_opa_scalar(&dest_buf[x], w - x, color, opa);
+}
+
+#else /*LV_COLOR_DEPTH == 32*/
+
+static inline __m128i load_px_sse2(const lv_color_t * buf)
+{
+    return _mm_loadu_si128((const __m128i *)buf);
+}
+
+static inline void store_px_sse2(lv_color_t * buf, __m128i v)
+{
+    _mm_storeu_si128((__m128i *)buf, v);
+}
+
+static inline __m128i set1_px_sse2(lv_color_t color)
+{
+    return _mm_set1_epi32((int32_t)color.full);
+}
+
+static inline __m128i load_mask_sse2(const lv_opa_t * mask)
+{
+    uint32_t m32;
+    memcpy(&m32, mask, sizeof(m32));
+    __m128i m = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int32_t)m32), _mm_setzero_si128());
+    return _mm_unpacklo_epi16(m, m);
+}
+
+static inline __m128i udiv255_sse2(__m128i x)
+{
+    return _mm_srli_epi16(_mm_mulhi_epu16(x, _mm_set1_epi16((int16_t)0x8081)), 7);
+}
+
+/**
+ * Mix the channels like `lv_color_mix()`: LV_UDIV255(fg * mix + bg * (255 - mix)) and set the alpha to 0xFF.
+ * Blue-red and green-alpha are processed in the low and high bytes of the 16 bit lanes.
+ */
+static inline __m128i mix_sse2(__m128i fg, __m128i bg, __m128i mix)
+{
+    const __m128i mask8 = _mm_set1_epi16(0xFF);
+    const __m128i round_ofs = _mm_set1_epi16(LV_COLOR_MIX_ROUND_OFS);
+    __m128i mix_inv = _mm_sub_epi16(mask8, mix);
+
+    __m128i rb = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(fg, mask8), mix),
+                               _mm_mullo_epi16(_mm_and_si128(bg, mask8), mix_inv));
+    __m128i ga = _mm_add_epi16(_mm_mullo_epi16(_mm_srli_epi16(fg, 8), mix),
+                               _mm_mullo_epi16(_mm_srli_epi16(bg, 8), mix_inv));
+    rb = udiv255_sse2(_mm_add_epi16(rb, round_ofs));
+    ga = udiv255_sse2(_mm_add_epi16(ga, round_ofs));
+
+    __m128i res = _mm_or_si128(rb, _mm_slli_epi16(ga, 8));
+    return _mm_or_si128(res, _mm_set1_epi32((int32_t)0xFF000000));
+}
+
+/*`lv_color_mix()` always sets 0xFF alpha, so the 0 and 255 mask values need to be handled separately*/
+static inline __m128i keep_transp_sse2(__m128i res, __m128i bg, __m128i mask)
+{
+    __m128i sel = _mm_cmpeq_epi32(mask, _mm_setzero_si128());
+    return _mm_or_si128(_mm_and_si128(sel, bg), _mm_andnot_si128(sel, res));
+}
+
+static inline __m128i copy_cover_sse2(__m128i res, __m128i fg, __m128i mask)
+{
+    __m128i sel = _mm_cmpeq_epi32(mask, _mm_set1_epi32(0x00FF00FF));
+    return _mm_or_si128(_mm_and_si128(sel, fg), _mm_andnot_si128(sel, res));
+}
+
+static void fill_opa_sse2(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa)
+{
+    uint16_t color_premult[3];
+    lv_opa_t opa_inv = premult_prepare(color, opa, color_premult);
+
+    const __m128i mask8 = _mm_set1_epi16(0xFF);
+    const __m128i round_ofs = _mm_set1_epi16(LV_COLOR_MIX_ROUND_OFS);
+    /*Blue-red and green-alpha in the 16 bit lanes*/
+    __m128i pre_rb = _mm_set1_epi32((int32_t)((uint32_t)color_premult[2] | ((uint32_t)color_premult[0] << 16)));
+    __m128i pre_ga = _mm_set1_epi32((int32_t)color_premult[1]);
+    __m128i inv = _mm_set1_epi16(opa_inv);
+
+    int32_t x;
+    for(x = 0; x + PX_SSE2 <= w; x += PX_SSE2) {
+        __m128i bg = load_px_sse2(&dest_buf[x]);
+        /*LV_UDIV255(premult + bg * opa_inv + LV_COLOR_MIX_ROUND_OFS)*/
+        __m128i rb = _mm_add_epi16(pre_rb, _mm_mullo_epi16(_mm_and_si128(bg, mask8), inv));
+        __m128i ga = _mm_add_epi16(pre_ga, _mm_mullo_epi16(_mm_srli_epi16(bg, 8), inv));
+        rb = udiv255_sse2(_mm_add_epi16(rb, round_ofs));
+        ga = udiv255_sse2(_mm_add_epi16(ga, round_ofs));
+        __m128i res = _mm_or_si128(rb, _mm_slli_epi16(ga, 8));
+        store_px_sse2(&dest_buf[x], _mm_or_si128(res, _mm_set1_epi32((int32_t)0xFF000000)));
+    }
+
+    fill_opa_scalar(&dest_buf[x], w - x, color, opa);
+}
+
+#endif /*LV_COLOR_DEPTH*/
+
+static inline bool mask_is_transp_sse2(__m128i mask)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(mask, _mm_setzero_si128())) == 0xFFFF;
+}
+
+static inline bool mask_is_cover_sse2(__m128i mask)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(mask, _mm_set1_epi16(LV_OPA_COVER))) == 0xFFFF;
+}
+
+static void fill_mask_sse2(lv_color_t * dest_buf, int32_t w, lv_color_t color, const lv_opa_t * mask)
+{
+    __m128i fg = set1_px_sse2(color);
+
+    int32_t x;
+    for(x = 0; x + PX_SSE2 <= w; x += PX_SSE2) {
+        __m128i m = load_mask_sse2(&mask[x]);
+        if(mask_is_transp_sse2(m)) continue;
+        if(mask_is_cover_sse2(m)) {
+            store_px_sse2(&dest_buf[x], fg);
+            continue;
+        }
+
+        __m128i bg = load_px_sse2(&dest_buf[x]);
+        __m128i res = mix_sse2(fg, bg, m);
+        res = copy_cover_sse2(res, fg, m);
+        res = keep_transp_sse2(res, bg, m);
+        store_px_sse2(&dest_buf[x], res);
+    }
+
+    fill_mask_scalar(&dest_buf[x], w - x, color, &mask[x]);
+}
+
+static void fill_mask_opa_sse2(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa,
+                               const lv_opa_t * mask)
+{
+    __m128i fg = set1_px_sse2(color);
+    __m128i opa_v = _mm_set1_epi16(opa);
+
+    int32_t x;
+    for(x = 0; x + PX_SSE2 <= w; x += PX_SSE2) {
+        __m128i m = load_mask_sse2(&mask[x]);
+        if(mask_is_transp_sse2(m)) continue;
+
+        /*mask == 255 ? opa : mask * opa >> 8*/
+        __m128i cover = _mm_cmpeq_epi16(m, _mm_set1_epi16(LV_OPA_COVER));
+        __m128i mix = _mm_srli_epi16(_mm_mullo_epi16(m, opa_v), 8);
+        mix = _mm_or_si128(_mm_and_si128(cover, opa_v), _mm_andnot_si128(cover, mix));
+
+        __m128i bg = load_px_sse2(&dest_buf[x]);
+        __m128i res = mix_sse2(fg, bg, mix);
+        res = keep_transp_sse2(res, bg, m);
+        store_px_sse2(&dest_buf[x], res);
+    }
+
+    fill_mask_opa_scalar(&dest_buf[x], w - x, color, opa, &mask[x]);
+}
+
+static void map_opa_sse2(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, lv_opa_t opa)
+{
+    __m128i opa_v = _mm_set1_epi16(opa);
+
+    int32_t x;
+    for(x = 0; x + PX_SSE2 <= w; x += PX_SSE2) {
+        __m128i fg = load_px_sse2(&src_buf[x]);
+        __m128i bg = load_px_sse2(&dest_buf[x]);
+        store_px_sse2(&dest_buf[x], mix_sse2(fg, bg, opa_v));
+    }
+
+    map_opa_scalar(&dest_buf[x], &src_buf[x], w - x, opa);
+}
+
+static void map_mask_sse2(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, const lv_opa_t * mask)
+{
+    int32_t x;
+    for(x = 0; x + PX_SSE2 <= w; x += PX_SSE2) {
+        __m128i m = load_mask_sse2(&mask[x]);
+        if(mask_is_transp_sse2(m)) continue;
+
+        __m128i fg = load_px_sse2(&src_buf[x]);
+        if(mask_is_cover_sse2(m)) {
+            store_px_sse2(&dest_buf[x], fg);
+            continue;
+        }
+
+        __m128i bg = load_px_sse2(&dest_buf[x]);
+        __m128i res = mix_sse2(fg, bg, m);
+        res = copy_cover_sse2(res, fg, m);
+        res = keep_transp_sse2(res, bg, m);
+        store_px_sse2(&dest_buf[x], res);
+    }
+
+    map_mask_scalar(&dest_buf[x], &src_buf[x], w - x, &mask[x]);
+}
+
+static void map_mask_opa_sse2(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, lv_opa_t opa,
+                              const lv_opa_t * mask)
+{
+    __m128i opa_v = _mm_set1_epi16(opa);
+
+    int32_t x;
+    for(x = 0; x + PX_SSE2 <= w; x += PX_SSE2) {
+        __m128i m = load_mask_sse2(&mask[x]);
+        if(mask_is_transp_sse2(m)) continue;
+
+        /*mask >= LV_OPA_MAX ? opa : mask * opa >> 8*/
+        __m128i cover = _mm_cmpgt_epi16(m, _mm_set1_epi16(LV_OPA_MAX - 1));
+        __m128i mix = _mm_srli_epi16(_mm_mullo_epi16(m, opa_v), 8);
+        mix = _mm_or_si128(_mm_and_si128(cover, opa_v), _mm_andnot_si128(cover, mix));
+
+        __m128i fg = load_px_sse2(&src_buf[x]);
+        __m128i bg = load_px_sse2(&dest_buf[x]);
+        __m128i res = mix_sse2(fg, bg, mix);
+        res = keep_transp_sse2(res, bg, m);
+        store_px_sse2(&dest_buf[x], res);
+    }
+
+    map_mask_opa_scalar(&dest_buf[x], &src_buf[x], w - x, opa, &mask[x]);
+}
+
+/*=====================
+ * AVX2
+ *====================*/
+
+/*The same as the SSE2 kernels but with twice as wide vectors*/
+
+#if LV_COLOR_DEPTH == 16
+
+static inline ATTRIBUTE_AVX2 __m256i load_px_avx2(const lv_color_t * buf)
+{
+    __m256i v = _mm256_loadu_si256((const __m256i *)buf);
+#if LV_COLOR_16_SWAP
+    v = _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8));
+#endif
+    return v;
+}
+
+static inline ATTRIBUTE_AVX2 void store_px_avx2(lv_color_t * buf, __m256i v)
+{
+#if LV_COLOR_16_SWAP
+    v = _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8));
+#endif
+    _mm256_storeu_si256((__m256i *)buf, v);
+}
+
+static inline ATTRIBUTE_AVX2 __m256i set1_px_avx2(lv_color_t color)
+{
+#if LV_COLOR_16_SWAP
+    color.full = (uint16_t)(color.full << 8 | color.full >> 8);
+#endif
+    return _mm256_set1_epi16((int16_t)color.full);
+}
+
+static inline ATTRIBUTE_AVX2 __m256i load_mask_avx2(const lv_opa_t * mask)
+{
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)mask));
+}
+
+static inline ATTRIBUTE_AVX2 __m256i mix_avx2(__m256i fg, __m256i bg, __m256i mix)
+{
+    const __m256i mask5 = _mm256_set1_epi16(0x1F);
+    const __m256i mask6 = _mm256_set1_epi16(0x3F);
+    mix = _mm256_srli_epi16(_mm256_add_epi16(mix, _mm256_set1_epi16(4)), 3);
+
+    __m256i bg_r = _mm256_srli_epi16(bg, 11);
+    __m256i bg_g = _mm256_and_si256(_mm256_srli_epi16(bg, 5), mask6);
+    __m256i bg_b = _mm256_and_si256(bg, mask5);
+    __m256i r = _mm256_sub_epi16(_mm256_srli_epi16(fg, 11), bg_r);
+    __m256i g = _mm256_sub_epi16(_mm256_and_si256(_mm256_srli_epi16(fg, 5), mask6), bg_g);
+    __m256i b = _mm256_sub_epi16(_mm256_and_si256(fg, mask5), bg_b);
+
+    r = _mm256_add_epi16(_mm256_srai_epi16(_mm256_mullo_epi16(r, mix), 5), bg_r);
+    g = _mm256_add_epi16(_mm256_srai_epi16(_mm256_mullo_epi16(g, mix), 5), bg_g);
+    b = _mm256_add_epi16(_mm256_srai_epi16(_mm256_mullo_epi16(b, mix), 5), bg_b);
+
+    return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(r, 11), _mm256_slli_epi16(g, 5)), b);
+}
+
+static inline ATTRIBUTE_AVX2 __m256i keep_transp_avx2(__m256i res, __m256i bg, __m256i mask)
+{
+    LV_UNUSED(bg);
+    LV_UNUSED(mask);
+    return res;
+}
+
+static inline ATTRIBUTE_AVX2 __m256i copy_cover_avx2(__m256i res, __m256i fg, __m256i mask)
+{
+    LV_UNUSED(fg);
+    LV_UNUSED(mask);
+    return res;
+}
+
+static ATTRIBUTE_AVX2 void fill_opa_avx2(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa)
+{
+    uint16_t color_premult[3];
+    lv_opa_t opa_inv = premult_prepare(color, opa, color_premult);
+
+    const __m256i mask5 = _mm256_set1_epi16(0x1F);
+    const __m256i mask6 = _mm256_set1_epi16(0x3F);
+    const __m256i div255 = _mm256_set1_epi16((int16_t)0x8081);
+    __m256i pre_r = _mm256_set1_epi16((int16_t)color_premult[0]);
+    __m256i pre_g = _mm256_set1_epi16((int16_t)color_premult[1]);
+    __m256i pre_b = _mm256_set1_epi16((int16_t)color_premult[2]);
+    __m256i inv = _mm256_set1_epi16(opa_inv);
+
+    int32_t x;
+    for(x = 0; x + PX_AVX2 <= w; x += PX_AVX2) {
+        __m256i bg = load_px_avx2(&dest_buf[x]);
+        __m256i r = _mm256_add_epi16(pre_r, _mm256_mullo_epi16(_mm256_srli_epi16(bg, 11), inv));
+        __m256i g = _mm256_add_epi16(pre_g, _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(bg, 5), mask6), inv));
+        __m256i b = _mm256_add_epi16(pre_b, _mm256_mullo_epi16(_mm256_and_si256(bg, mask5), inv));
+        r = _mm256_srli_epi16(_mm256_mulhi_epu16(r, div255), 7);
+        g = _mm256_srli_epi16(_mm256_mulhi_epu16(g, div255), 7);
+        b = _mm256_srli_epi16(_mm256_mulhi_epu16(b, div255), 7);
+        store_px_avx2(&dest_buf[x], _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(r, 11), _mm256_slli_epi16(g, 5)), b));
+    }
+
+    fill_opa_sse2(&dest_buf[x], w - x, color, opa);
+}
+
+#else /*LV_COLOR_DEPTH == 32*/
+
+static inline ATTRIBUTE_AVX2 __m256i load_px_avx2(const lv_color_t * buf)
+{
+    return _mm256_loadu_si256((const __m256i *)buf);
+}
+
+static inline ATTRIBUTE_AVX2 void store_px_avx2(lv_color_t * buf, __m256i v)
+{
+    _mm256_storeu_si256((__m256i *)buf, v);
+}
+
+static inline ATTRIBUTE_AVX2 __m256i set1_px_avx2(lv_color_t color)
+{
+    return _mm256_set1_epi32((int32_t)color.full);
+}
+
+static inline ATTRIBUTE_AVX2 __m256i load_mask_avx2(const lv_opa_t * mask)
+{
+    __m256i m = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)mask));
+    return _mm256_or_si256(m, _mm256_slli_epi32(m, 16));
+}
+
+static inline ATTRIBUTE_AVX2 __m256i udiv255_avx2(__m256i x)
+{
+    return _mm256_srli_epi16(_mm256_mulhi_epu16(x, _mm256_set1_epi16((int16_t)0x8081)), 7);
+}
+
+static inline ATTRIBUTE_AVX2 __m256i mix_avx2(__m256i fg, __m256i bg, __m256i mix)
+{
+    const __m256i mask8 = _mm256_set1_epi16(0xFF);
+    const __m256i round_ofs = _mm256_set1_epi16(LV_COLOR_MIX_ROUND_OFS);
+    __m256i mix_inv = _mm256_sub_epi16(mask8, mix);
+
+    __m256i rb = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_and_si256(fg, mask8), mix),
+                                  _mm256_mullo_epi16(_mm256_and_si256(bg, mask8), mix_inv));
+    __m256i ga = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(fg, 8), mix),
+                                  _mm256_mullo_epi16(_mm256_srli_epi16(bg, 8), mix_inv));
+    rb = udiv255_avx2(_mm256_add_epi16(rb, round_ofs));
+    ga = udiv255_avx2(_mm256_add_epi16(ga, round_ofs));
+
+    __m256i res = _mm256_or_si256(rb, _mm256_slli_epi16(ga, 8));
+    return _mm256_or_si256(res, _mm256_set1_epi32((int32_t)0xFF000000));
+}
+
+static inline ATTRIBUTE_AVX2 __m256i keep_transp_avx2(__m256i res, __m256i bg, __m256i mask)
+{
+    __m256i sel = _mm256_cmpeq_epi32(mask, _mm256_setzero_si256());
+    return _mm256_blendv_epi8(res, bg, sel);
+}
+
+static inline ATTRIBUTE_AVX2 __m256i copy_cover_avx2(__m256i res, __m256i fg, __m256i mask)
+{
+    __m256i sel = _mm256_cmpeq_epi32(mask, _mm256_set1_epi32(0x00FF00FF));
+    return _mm256_blendv_epi8(res, fg, sel);
+}
+
+static ATTRIBUTE_AVX2 void fill_opa_avx2(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa)
+{
+    uint16_t color_premult[3];
+    lv_opa_t opa_inv = premult_prepare(color, opa, color_premult);
+
+    const __m256i mask8 = _mm256_set1_epi16(0xFF);
+    const __m256i round_ofs = _mm256_set1_epi16(LV_COLOR_MIX_ROUND_OFS);
+    __m256i pre_rb = _mm256_set1_epi32((int32_t)((uint32_t)color_premult[2] | ((uint32_t)color_premult[0] << 16)));
+    __m256i pre_ga = _mm256_set1_epi32((int32_t)color_premult[1]);
+    __m256i inv = _mm256_set1_epi16(opa_inv);
+
+    int32_t x;
+    for(x = 0; x + PX_AVX2 <= w; x += PX_AVX2) {
+        __m256i bg = load_px_avx2(&dest_buf[x]);
+        __m256i rb = _mm256_add_epi16(pre_rb, _mm256_mullo_epi16(_mm256_and_si256(bg, mask8), inv));
+        __m256i ga = _mm256_add_epi16(pre_ga, _mm256_mullo_epi16(_mm256_srli_epi16(bg, 8), inv));
+        rb = udiv255_avx2(_mm256_add_epi16(rb, round_ofs));
+        ga = udiv255_avx2(_mm256_add_epi16(ga, round_ofs));
+        __m256i res = _mm256_or_si256(rb, _mm256_slli_epi16(ga, 8));
+        store_px_avx2(&dest_buf[x], _mm256_or_si256(res, _mm256_set1_epi32((int32_t)0xFF000000)));
+    }
+
+    fill_opa_sse2(&dest_buf[x], w - x, color, opa);
+}
+
+#endif /*LV_COLOR_DEPTH*/
+
+static inline ATTRIBUTE_AVX2 bool mask_is_transp_avx2(__m256i mask)
+{
+    return _mm256_testz_si256(mask, mask);
+}
+
+static inline ATTRIBUTE_AVX2 bool mask_is_cover_avx2(__m256i mask)
+{
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi16(mask, _mm256_set1_epi16(LV_OPA_COVER))) == -1;
+}
+
+/*The remaining pixels are blended by the SSE2 kernels (which use the scalar ones for the last few pixels)*/
+
+static ATTRIBUTE_AVX2 void fill_mask_avx2(lv_color_t * dest_buf, int32_t w, lv_color_t color, const lv_opa_t * mask)
+{
+    __m256i fg = set1_px_avx2(color);
+
+    int32_t x;
+    for(x = 0; x + PX_AVX2 <= w; x += PX_AVX2) {
+        __m256i m = load_mask_avx2(&mask[x]);
+        if(mask_is_transp_avx2(m)) continue;
+        if(mask_is_cover_avx2(m)) {
+            store_px_avx2(&dest_buf[x], fg);
+            continue;
+        }
+
+        __m256i bg = load_px_avx2(&dest_buf[x]);
+        __m256i res = mix_avx2(fg, bg, m);
+        res = copy_cover_avx2(res, fg, m);
+        res = keep_transp_avx2(res, bg, m);
+        store_px_avx2(&dest_buf[x], res);
+    }
+
+    fill_mask_sse2(&dest_buf[x], w - x, color, &mask[x]);
+}
+
+static ATTRIBUTE_AVX2 void fill_mask_opa_avx2(lv_color_t * dest_buf, int32_t w, lv_color_t color, lv_opa_t opa,
+                                              const lv_opa_t * mask)
+{
+    __m256i fg = set1_px_avx2(color);
+    __m256i opa_v = _mm256_set1_epi16(opa);
+
+    int32_t x;
+    for(x = 0; x + PX_AVX2 <= w; x += PX_AVX2) {
+        __m256i m = load_mask_avx2(&mask[x]);
+        if(mask_is_transp_avx2(m)) continue;
+
+        __m256i cover = _mm256_cmpeq_epi16(m, _mm256_set1_epi16(LV_OPA_COVER));
+        __m256i mix = _mm256_srli_epi16(_mm256_mullo_epi16(m, opa_v), 8);
+        mix = _mm256_blendv_epi8(mix, opa_v, cover);
+
+        __m256i bg = load_px_avx2(&dest_buf[x]);
+        __m256i res = mix_avx2(fg, bg, mix);
+        res = keep_transp_avx2(res, bg, m);
+        store_px_avx2(&dest_buf[x], res);
+    }
+
+    fill_mask_opa_sse2(&dest_buf[x], w - x, color, opa, &mask[x]);
+}
+
+static ATTRIBUTE_AVX2 void map_opa_avx2(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w, lv_opa_t opa)
+{
+    __m256i opa_v = _mm256_set1_epi16(opa);
+
+    int32_t x;
+    for(x = 0; x + PX_AVX2 <= w; x += PX_AVX2) {
+        __m256i fg = load_px_avx2(&src_buf[x]);
+        __m256i bg = load_px_avx2(&dest_buf[x]);
+        store_px_avx2(&dest_buf[x], mix_avx2(fg, bg, opa_v));
+    }
+
+    map_opa_sse2(&dest_buf[x], &src_buf[x], w - x, opa);
+}
+
+static ATTRIBUTE_AVX2 void map_mask_avx2(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w,
+                                         const lv_opa_t * mask)
+{
+    int32_t x;
+    for(x = 0; x + PX_AVX2 <= w; x += PX_AVX2) {
+        __m256i m = load_mask_avx2(&mask[x]);
+        if(mask_is_transp_avx2(m)) continue;
+
+        __m256i fg = load_px_avx2(&src_buf[x]);
+        if(mask_is_cover_avx2(m)) {
+            store_px_avx2(&dest_buf[x], fg);
+            continue;
+        }
+
+        __m256i bg = load_px_avx2(&dest_buf[x]);
+        __m256i res = mix_avx2(fg, bg, m);
+        res = copy_cover_avx2(res, fg, m);
+        res = keep_transp_avx2(res, bg, m);
+        store_px_avx2(&dest_buf[x], res);
+    }
+
+    map_mask_sse2(&dest_buf[x], &src_buf[x], w - x, &mask[x]);
+}
+
+static ATTRIBUTE_AVX2 void map_mask_opa_avx2(lv_color_t * dest_buf, const lv_color_t * src_buf, int32_t w,
+                                             lv_opa_t opa, const lv_opa_t * mask)
+{
+    __m256i opa_v = _mm256_set1_epi16(opa);
+
+    int32_t x;
+    for(x = 0; x + PX_AVX2 <= w; x += PX_AVX2) {
+        __m256i m = load_mask_avx2(&mask[x]);
+        if(mask_is_transp_avx2(m)) continue;
+
+        __m256i cover = _mm256_cmpgt_epi16(m, _mm256_set1_epi16(LV_OPA_MAX - 1));
+        __m256i mix = _mm256_srli_epi16(_mm256_mullo_epi16(m, opa_v), 8);
+        mix = _mm256_blendv_epi8(mix, opa_v, cover);
+
+        __m256i fg = load_px_avx2(&src_buf[x]);
+        __m256i bg = load_px_avx2(&dest_buf[x]);
+        __m256i res = mix_avx2(fg, bg, mix);
+        res = keep_transp_avx2(res, bg, m);
+        store_px_avx2(&dest_buf[x], res);
+    }
+
+    map_mask_opa_sse2(&dest_buf[x], &src_buf[x], w - x, opa, &mask[x]);
+}
+
+#endif /*BLEND_SIMD_X86*/
+
+#endif /*LV_USE_DRAW_SW_SIMD*/
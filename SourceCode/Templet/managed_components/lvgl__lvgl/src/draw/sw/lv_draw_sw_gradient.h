@@ -15,6 +15,7 @@ extern "C" {
  *********************/
 #include "../../misc/lv_color.h"
 #include "../../misc/lv_style.h"
+#include "../../misc/lv_hash_lru.h"
 #include "lv_draw_sw_dither.h"
 
 /*********************
@@ -37,22 +38,22 @@ typedef lv_color_t lv_grad_color_t;
  *  it's possible to cache the computation in this structure instance.
  *  Whenever possible, this structure is reused instead of recomputing the gradient map */
 typedef struct _lv_gradient_cache_t {
-    uint32_t        key;          /**< A discriminating key that's built from the drawing operation.
-                                   * If the key does not match, the cache item is not used */
-    uint32_t        life : 30;    /**< A life counter that's incremented on usage. Higher counter is
-                                   * less likely to be evicted from the cache */
+    _lv_hash_lru_entry_t lru;     /**< The hash is a hash of `dsc`, `area_w` and `area_h` to find the item quickly*/
     uint32_t        filled : 1;   /**< Used to skip dithering in it if already done */
     uint32_t        not_cached: 1; /**< The cache was too small so this item is not managed by the cache*/
+    lv_grad_dsc_t   dsc;          /**< A copy of the gradient descriptor the map was computed for*/
+    lv_coord_t      area_w;       /**< The width of the area the map was computed for*/
+    lv_coord_t      area_h;       /**< The height of the area the map was computed for*/
     lv_color_t   *  map;          /**< The computed gradient low bitdepth color map, points into the
-                                   * cache's buffer, no free needed */
+                                   * item's buffer, no free needed */
     lv_coord_t      alloc_size;   /**< The map allocated size in colors */
     lv_coord_t      size;         /**< The computed gradient color map size, in colors */
 #if _DITHER_GRADIENT
     lv_color32_t  * hmap;         /**< If dithering, we need to store the current, high bitdepth gradient
-                                   * map too, points to the cache's buffer, no free needed */
+                                   * map too, points to the item's buffer, no free needed */
 #if LV_DITHER_ERROR_DIFFUSION == 1
     lv_scolor24_t * error_acc;    /**< Error diffusion dithering algorithm requires storing the last error
-                                   * drawn, points to the cache's buffer, no free needed  */
+                                   * drawn, points to the item's buffer, no free needed  */
     lv_coord_t      w;            /**< The error array width in pixels */
 #endif
 #endif
@@ -70,16 +71,26 @@ typedef struct _lv_gradient_cache_t {
 lv_grad_color_t /* LV_ATTRIBUTE_FAST_MEM */ lv_gradient_calculate(const lv_grad_dsc_t * dsc, lv_coord_t range,
                                                                   lv_coord_t frac);
 
+/** Initialize the gradient cache. Called by `lv_init()`. */
+void _lv_gradient_cache_init(void);
+
 /**
- * Set the gradient cache size
+ * Set the gradient cache size. The least recently used gradients are freed if the new size is smaller than the current usage.
  * @param max_bytes Max cahce size
  */
 void lv_gradient_set_cache_size(size_t max_bytes);
 
-/** Free the gradient cache */
+/** Free the gradient cache. The cache can be used again after it. */
 void lv_gradient_free_cache(void);
 
-/** Get a gradient cache from the given parameters */
+/**
+ * Get a gradient cache from the given parameters.
+ * Gradients larger than the cache reuse the buffer of the last such gradient.
+ * @param gradient  the gradient descriptor. Only its content is used to find the cached items.
+ * @param w         the width of the area to fill
+ * @param h         the height of the area to fill
+ * @return          the gradient or NULL on error. It's valid until `lv_gradient_cleanup()`.
+ */
 lv_grad_t * lv_gradient_get(const lv_grad_dsc_t * gradient, lv_coord_t w, lv_coord_t h);
 
 /**
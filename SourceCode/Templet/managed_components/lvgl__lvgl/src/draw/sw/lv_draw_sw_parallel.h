@@ -0,0 +1,80 @@
+/**
+ * @file lv_draw_sw_parallel.h
+ *
+ */
+
+#ifndef LV_DRAW_SW_PARALLEL_H
+#define LV_DRAW_SW_PARALLEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lv_conf_internal.h"
+#include "../../misc/lv_area.h"
+
+#if LV_USE_DRAW_SW_PARALLEL
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Render the `y1..y2` rows (inclusive, relative to the start of the job) of a job.
+ * It's called from the worker threads too so it must not touch any global LVGL state.
+ */
+typedef void (*lv_draw_sw_parallel_cb_t)(void * user_data, lv_coord_t y1, lv_coord_t y2);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Enable or disable splitting the rendering among the workers in run time.
+ * It's enabled by default. Useful to compare the rendering time with and without the workers.
+ * @param en        true: enable; false: render everything on the calling thread
+ */
+void lv_draw_sw_parallel_set_enabled(bool en);
+
+/**
+ * Tell whether the rendering is split among the workers
+ * @return          true: enabled
+ */
+bool lv_draw_sw_parallel_is_enabled(void);
+
+/**
+ * Tell whether it's worth to split a job of the given size among the workers.
+ * @param w         width of the job in pixels
+ * @param h         height of the job in pixels
+ * @return          true: `_lv_draw_sw_parallel_run` will really split the job
+ */
+bool _lv_draw_sw_parallel_should_split(lv_coord_t w, lv_coord_t h);
+
+/**
+ * Split `h` rows into horizontal stripes and call `cb` for each stripe from the workers and
+ * the calling thread. Returns only when all the stripes are ready.
+ * The workers are started on the first call.
+ * @param cb        the callback to render a stripe
+ * @param user_data passed to `cb` as it is
+ * @param h         number of rows of the job
+ */
+void _lv_draw_sw_parallel_run(lv_draw_sw_parallel_cb_t cb, void * user_data, lv_coord_t h);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_DRAW_SW_PARALLEL*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_PARALLEL_H*/
@@ -39,6 +39,8 @@ static void /* LV_ATTRIBUTE_FAST_MEM */ draw_shadow(lv_draw_ctx_t * draw_ctx, co
 static void /* LV_ATTRIBUTE_FAST_MEM */ shadow_draw_corner_buf(const lv_area_t * coords, uint16_t * sh_buf,
                                                                lv_coord_t s, lv_coord_t r);
 static void /* LV_ATTRIBUTE_FAST_MEM */ shadow_blur_corner(lv_coord_t size, lv_coord_t sw, uint16_t * sh_ups_buf);
+static lv_draw_mask_res_t apply_masks(lv_draw_sw_blend_dsc_t * blend_dsc, lv_coord_t abs_x, lv_coord_t abs_y,
+                                      lv_coord_t len);
 #endif
 
 void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area, const lv_area_t * inner_area,
@@ -50,11 +52,6 @@ static void draw_border_simple(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer
 /**********************
  *  STATIC VARIABLES
  **********************/
-#if defined(LV_SHADOW_CACHE_SIZE) && LV_SHADOW_CACHE_SIZE > 0
-    static uint8_t sh_cache[LV_SHADOW_CACHE_SIZE * LV_SHADOW_CACHE_SIZE];
-    static int32_t sh_cache_size = -1;
-    static int32_t sh_cache_r = -1;
-#endif
 
 /**********************
  *      MACROS
@@ -162,6 +159,10 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
     blend_dsc.blend_area = &blend_area;
     blend_dsc.mask_area = &blend_area;
     blend_dsc.opa = LV_OPA_COVER;
+#if LV_USE_DRAW_MASK_SPANS
+    lv_draw_mask_span_list_t mask_spans;
+    blend_dsc.mask_spans = &mask_spans;
+#endif
 
     /*Get gradient if appropriate*/
     lv_grad_t * grad = lv_gradient_get(&dsc->bg_grad, coords_bg_w, coords_bg_h);
@@ -222,7 +223,7 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
             /* Initialize the mask to opa instead of 0xFF and blend with LV_OPA_COVER.
              * It saves calculating the final opa in lv_draw_sw_blend*/
             lv_memset(mask_buf, opa, clipped_w);
-            blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, clipped_coords.x1, h, clipped_w);
+            blend_dsc.mask_res = apply_masks(&blend_dsc, clipped_coords.x1, h, clipped_w);
             if(blend_dsc.mask_res == LV_DRAW_MASK_RES_FULL_COVER) blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
 
 #if _DITHER_GRADIENT
@@ -243,7 +244,7 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
         /* Initialize the mask to opa instead of 0xFF and blend with LV_OPA_COVER.
          * It saves calculating the final opa in lv_draw_sw_blend*/
         lv_memset(mask_buf, opa, clipped_w);
-        blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, blend_area.x1, top_y, clipped_w);
+        blend_dsc.mask_res = apply_masks(&blend_dsc, blend_area.x1, top_y, clipped_w);
         if(blend_dsc.mask_res == LV_DRAW_MASK_RES_FULL_COVER) blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
 
         if(top_y >= clipped_coords.y1) {
@@ -294,7 +295,7 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
             /*If there is no other mask do not apply mask as in the center there is no radius to mask*/
             if(mask_any_center) {
                 lv_memset(mask_buf, opa, clipped_w);
-                blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, clipped_coords.x1, h, clipped_w);
+                blend_dsc.mask_res = apply_masks(&blend_dsc, clipped_coords.x1, h, clipped_w);
             }
 
             blend_area.y1 = h;
@@ -479,10 +480,13 @@ static void LV_ATTRIBUTE_FAST_MEM draw_shadow(lv_draw_ctx_t * draw_ctx, const lv
     lv_opa_t * sh_buf;
 
 #if LV_SHADOW_CACHE_SIZE
-    if(sh_cache_size == corner_size && sh_cache_r == r_sh) {
+    lv_coord_t core_w = lv_area_get_width(&core_area);
+    lv_coord_t core_h = lv_area_get_height(&core_area);
+    const lv_opa_t * sh_cached = _lv_draw_sw_shadow_cache_get(dsc->shadow_width, r_sh, core_w, core_h);
+    if(sh_cached) {
         /*Use the cache if available*/
         sh_buf = lv_mem_buf_get(corner_size * corner_size);
-        lv_memcpy(sh_buf, sh_cache, corner_size * corner_size);
+        lv_memcpy(sh_buf, sh_cached, corner_size * corner_size);
     }
     else {
         /*A larger buffer is required for calculation*/
@@ -490,11 +494,7 @@ static void LV_ATTRIBUTE_FAST_MEM draw_shadow(lv_draw_ctx_t * draw_ctx, const lv
         shadow_draw_corner_buf(&core_area, (uint16_t *)sh_buf, dsc->shadow_width, r_sh);
 
         /*Cache the corner if it fits into the cache size*/
-        if((uint32_t)corner_size * corner_size < sizeof(sh_cache)) {
-            lv_memcpy(sh_cache, sh_buf, corner_size * corner_size);
-            sh_cache_size = corner_size;
-            sh_cache_r = r_sh;
-        }
+        _lv_draw_sw_shadow_cache_add(dsc->shadow_width, r_sh, core_w, core_h, sh_buf);
     }
 #else
     sh_buf = lv_mem_buf_get(corner_size * corner_size * sizeof(uint16_t));
@@ -1101,6 +1101,25 @@ static void LV_ATTRIBUTE_FAST_MEM shadow_blur_corner(lv_coord_t size, lv_coord_t
 
     lv_mem_buf_release(sh_ups_blur_buf);
 }
+
+/**
+ * Apply the masks on the 1 line high mask buffer of a blend descriptor.
+ * With `LV_USE_DRAW_MASK_SPANS` get the coverage runs too to let the blending skip the unmasked and cleared parts.
+ * @param blend_dsc     the blend descriptor with an initialized `mask_buf` (the same value on every pixel)
+ * @param abs_x         absolute X coordinate where the line start
+ * @param abs_y         absolute Y coordinate of the line
+ * @param len           length of the line
+ * @return              the result of the masks
+ */
+static lv_draw_mask_res_t apply_masks(lv_draw_sw_blend_dsc_t * blend_dsc, lv_coord_t abs_x, lv_coord_t abs_y,
+                                      lv_coord_t len)
+{
+#if LV_USE_DRAW_MASK_SPANS
+    return lv_draw_mask_apply_spans(blend_dsc->mask_buf, abs_x, abs_y, len, blend_dsc->mask_spans);
+#else
+    return lv_draw_mask_apply(blend_dsc->mask_buf, abs_x, abs_y, len);
+#endif
+}
 #endif
 
 static void draw_outline(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords)
@@ -1166,6 +1185,10 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
     lv_draw_sw_blend_dsc_t blend_dsc;
     lv_memset_00(&blend_dsc, sizeof(blend_dsc));
     blend_dsc.mask_buf = lv_mem_buf_get(draw_area_w);;
+#if LV_USE_DRAW_MASK_SPANS
+    lv_draw_mask_span_list_t mask_spans;
+    blend_dsc.mask_spans = &mask_spans;
+#endif
 
     /*Create mask for the outer area*/
     int16_t mask_rout_id = LV_MASK_ID_INV;
@@ -1211,7 +1234,7 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
             blend_area.y2 = h;
 
             lv_memset_ff(blend_dsc.mask_buf, draw_area_w);
-            blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, draw_area.x1, h, draw_area_w);
+            blend_dsc.mask_res = apply_masks(&blend_dsc, draw_area.x1, h, draw_area_w);
             lv_draw_sw_blend(draw_ctx, &blend_dsc);
         }
 
@@ -1284,7 +1307,7 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
             if(top_y < draw_area.y1 && bottom_y > draw_area.y2) continue;   /*This line is clipped now*/
 
             lv_memset_ff(blend_dsc.mask_buf, draw_area_w);
-            blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, top_y, draw_area_w);
+            blend_dsc.mask_res = apply_masks(&blend_dsc, blend_area.x1, top_y, draw_area_w);
 
             if(top_y >= draw_area.y1) {
                 blend_area.y1 = top_y;
@@ -1311,7 +1334,7 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
                     blend_area.y2 = h;
 
                     lv_memset_ff(blend_dsc.mask_buf, blend_w);
-                    blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, h, blend_w);
+                    blend_dsc.mask_res = apply_masks(&blend_dsc, blend_area.x1, h, blend_w);
                     lv_draw_sw_blend(draw_ctx, &blend_dsc);
                 }
             }
@@ -1322,7 +1345,7 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
                     blend_area.y2 = h;
 
                     lv_memset_ff(blend_dsc.mask_buf, blend_w);
-                    blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, h, blend_w);
+                    blend_dsc.mask_res = apply_masks(&blend_dsc, blend_area.x1, h, blend_w);
                     lv_draw_sw_blend(draw_ctx, &blend_dsc);
                 }
             }
@@ -1340,7 +1363,7 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
                     blend_area.y2 = h;
 
                     lv_memset_ff(blend_dsc.mask_buf, blend_w);
-                    blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, h, blend_w);
+                    blend_dsc.mask_res = apply_masks(&blend_dsc, blend_area.x1, h, blend_w);
                     lv_draw_sw_blend(draw_ctx, &blend_dsc);
                 }
             }
@@ -1351,7 +1374,7 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
                     blend_area.y2 = h;
 
                     lv_memset_ff(blend_dsc.mask_buf, blend_w);
-                    blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, h, blend_w);
+                    blend_dsc.mask_res = apply_masks(&blend_dsc, blend_area.x1, h, blend_w);
                     lv_draw_sw_blend(draw_ctx, &blend_dsc);
                 }
             }
@@ -0,0 +1,204 @@
+/**
+ * @file lv_draw_sw_shadow_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_shadow_cache.h"
+
+#if LV_DRAW_COMPLEX && defined(LV_SHADOW_CACHE_SIZE) && LV_SHADOW_CACHE_SIZE > 0
+
+#include "../../misc/lv_mem.h"
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#if LV_SHADOW_CACHE_CNT < 1
+    #error "LV_SHADOW_CACHE_CNT must be at least 1"
+#endif
+
+#define CACHE_BYTES ((uint32_t)LV_SHADOW_CACHE_SIZE * LV_SHADOW_CACHE_SIZE)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t life;      /*Value of `tick` when the corner was last used*/
+    uint32_t ofs;       /*Start of the corner in `cache_buf`*/
+    lv_coord_t sw;
+    lv_coord_t r;
+    lv_coord_t w;
+    lv_coord_t h;
+} entry_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void get_key(lv_coord_t sw, lv_coord_t r, lv_coord_t * w, lv_coord_t * h);
+static uint32_t entry_get_size(const entry_t * e);
+static void drop_lru(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/*The corners are stored packed in the order of `entries`*/
+static uint8_t cache_buf[CACHE_BYTES];
+static entry_t entries[LV_SHADOW_CACHE_CNT];
+static uint32_t entry_cnt;
+static uint32_t used;
+static uint32_t max_size = CACHE_BYTES;
+static uint32_t tick;
+static uint32_t hit_cnt;
+static uint32_t miss_cnt;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Look up a blurred shadow corner.
+ * @param sw        shadow width
+ * @param r         radius of the shadow, clamped to the size of the shadow's core area
+ * @param w         width of the shadow's core area
+ * @param h         height of the shadow's core area
+ * @return          pointer to the `(sw + r)^2` bytes of the corner or NULL if it's not cached.
+ *                  Valid until the next `_lv_draw_sw_shadow_cache_add()`.
+ */
+const lv_opa_t * _lv_draw_sw_shadow_cache_get(lv_coord_t sw, lv_coord_t r, lv_coord_t w, lv_coord_t h)
+{
+    get_key(sw, r, &w, &h);
+
+    uint32_t i;
+    for(i = 0; i < entry_cnt; i++) {
+        entry_t * e = &entries[i];
+        if(e->sw == sw && e->r == r && e->w == w && e->h == h) {
+            tick++;
+            e->life = tick;
+            hit_cnt++;
+            return &cache_buf[e->ofs];
+        }
+    }
+
+    miss_cnt++;
+    return NULL;
+}
+
+/**
+ * Cache a blurred shadow corner. The least recently used corners are dropped if there is no space for it.
+ * Corners larger than the whole cache are ignored.
+ * @param sw        shadow width
+ * @param r         radius of the shadow, clamped to the size of the shadow's core area
+ * @param w         width of the shadow's core area
+ * @param h         height of the shadow's core area
+ * @param buf       the `(sw + r)^2` bytes of the corner
+ */
+void _lv_draw_sw_shadow_cache_add(lv_coord_t sw, lv_coord_t r, lv_coord_t w, lv_coord_t h, const lv_opa_t * buf)
+{
+    uint32_t size = (uint32_t)(sw + r) * (sw + r);
+    if(size > max_size) return;
+
+    get_key(sw, r, &w, &h);
+
+    while(entry_cnt >= LV_SHADOW_CACHE_CNT || used + size > max_size) {
+        drop_lru();
+    }
+
+    entry_t * e = &entries[entry_cnt];
+    tick++;
+    e->life = tick;
+    e->ofs = used;
+    e->sw = sw;
+    e->r = r;
+    e->w = w;
+    e->h = h;
+    lv_memcpy(&cache_buf[e->ofs], buf, size);
+
+    entry_cnt++;
+    used += size;
+}
+
+/**
+ * Limit the total size of the cached corners. The least recently used corners are dropped to fit into the new size.
+ * @param size      the new size in bytes. Clamped to `LV_SHADOW_CACHE_SIZE^2`, 0: disable caching
+ */
+void lv_draw_sw_shadow_cache_set_size(uint32_t size)
+{
+    max_size = LV_MIN(size, CACHE_BYTES);
+    while(used > max_size) drop_lru();
+}
+
+/**
+ * Get the current state of the shadow cache
+ * @param info      store the result here
+ */
+void lv_draw_sw_shadow_cache_get_info(lv_draw_sw_shadow_cache_info_t * info)
+{
+    info->size = max_size;
+    info->used = used;
+    info->entry_cnt = entry_cnt;
+    info->hit_cnt = hit_cnt;
+    info->miss_cnt = miss_cnt;
+}
+
+/**
+ * Drop all the cached corners and reset the hit/miss counters.
+ */
+void lv_draw_sw_shadow_cache_clear(void)
+{
+    entry_cnt = 0;
+    used = 0;
+    hit_cnt = 0;
+    miss_cnt = 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * The corner depends on the size of the core area only if it's small enough for
+ * its far edges to reach the corner. Limit the size to share the corner of larger areas.
+ */
+static void get_key(lv_coord_t sw, lv_coord_t r, lv_coord_t * w, lv_coord_t * h)
+{
+    lv_coord_t max = 2 * (sw + r);
+    if(*w > max) *w = max;
+    if(*h > max) *h = max;
+}
+
+static uint32_t entry_get_size(const entry_t * e)
+{
+    return (uint32_t)(e->sw + e->r) * (e->sw + e->r);
+}
+
+/**
+ * Drop the least recently used corner and move the next corners to its place
+ */
+static void drop_lru(void)
+{
+    uint32_t lru = 0;
+    uint32_t i;
+    for(i = 1; i < entry_cnt; i++) {
+        if(entries[i].life < entries[lru].life) lru = i;
+    }
+
+    uint32_t size = entry_get_size(&entries[lru]);
+    uint32_t ofs = entries[lru].ofs;
+    if(ofs + size < used) memmove(&cache_buf[ofs], &cache_buf[ofs + size], used - ofs - size);
+    used -= size;
+
+    for(i = lru; i + 1 < entry_cnt; i++) {
+        entries[i] = entries[i + 1];
+        entries[i].ofs -= size;
+    }
+    entry_cnt--;
+}
+
+#endif /*LV_DRAW_COMPLEX && LV_SHADOW_CACHE_SIZE*/
@@ -37,6 +37,11 @@ static lv_res_t decoder_open(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc)
 static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc,
                                   lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t * buf);
 
+static lv_res_t decoder_read_area(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc,
+                                  lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h, uint8_t * buf);
+
+static void convert_row(bmp_dsc_t * b, uint8_t * buf, lv_coord_t len);
+
 static void decoder_close(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc);
 
 /**********************
@@ -56,6 +61,7 @@ void lv_bmp_init(void)
     lv_img_decoder_set_info_cb(dec, decoder_info);
     lv_img_decoder_set_open_cb(dec, decoder_open);
     lv_img_decoder_set_read_line_cb(dec, decoder_read_line);
+    lv_img_decoder_set_read_area_cb(dec, decoder_read_area);
     lv_img_decoder_set_close_cb(dec, decoder_close);
 }
 
@@ -176,7 +182,9 @@ static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t *
         if(dsc->user_data == NULL) return LV_RES_INV;
         memcpy(dsc->user_data, &b, sizeof(b));
 
+        /*The lines are read directly into the caller's buffer, only the descriptor is kept*/
         dsc->img_data = NULL;
+        dsc->mem_size = sizeof(bmp_dsc_t);
         return LV_RES_OK;
     }
     /* BMP file as data not supported for simplicity.
@@ -200,6 +208,63 @@ static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc
     lv_fs_seek(&b->f, p, LV_FS_SEEK_SET);
     lv_fs_read(&b->f, buf, len * (b->bpp / 8), NULL);
 
+    convert_row(b, buf, len);
+
+    return LV_RES_OK;
+}
+
+static lv_res_t decoder_read_area(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc,
+                                  lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h, uint8_t * buf)
+{
+    bmp_dsc_t * b = dsc->user_data;
+    uint32_t px_size = lv_img_decoder_get_px_size(dsc);
+    uint32_t stride = w * px_size;
+
+    /*Read the rows with one read if they are stored continuously and needn't be expanded*/
+    if(x != 0 || w != b->px_width || (uint32_t)b->row_size_bytes != stride || px_size != b->bpp / 8) {
+        lv_coord_t i;
+        for(i = 0; i < h; i++) {
+            decoder_read_line(decoder, dsc, x, y + i, w, buf + i * stride);
+        }
+        return LV_RES_OK;
+    }
+
+    /*BMP images are stored upside down so start from the last row*/
+    uint32_t p = b->px_offset + b->row_size_bytes * ((b->px_height - 1) - (y + h - 1));
+    uint32_t btr = stride * h;
+    uint32_t br = 0;
+    lv_fs_seek(&b->f, p, LV_FS_SEEK_SET);
+    lv_fs_res_t res = lv_fs_read(&b->f, buf, btr, &br);
+    if(res != LV_FS_RES_OK || br != btr) return LV_RES_INV;
+
+    lv_coord_t i;
+    for(i = 0; i < h / 2; i++) {
+        uint8_t * r1 = buf + i * stride;
+        uint8_t * r2 = buf + (h - 1 - i) * stride;
+        uint32_t j;
+        for(j = 0; j < stride; j++) {
+            uint8_t t = r1[j];
+            r1[j] = r2[j];
+            r2[j] = t;
+        }
+    }
+
+    for(i = 0; i < h; i++) {
+        convert_row(b, buf + i * stride, w);
+    }
+
+    return LV_RES_OK;
+}
+
+/**
+ * Convert the pixels of a row read from the file to the current color format in place
+ */
+static void convert_row(bmp_dsc_t * b, uint8_t * buf, lv_coord_t len)
+{
+    LV_UNUSED(b);
+    LV_UNUSED(buf);
+    LV_UNUSED(len);
+
 #if LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 1
     for(unsigned int i = 0; i < len * (b->bpp / 8); i += 2) {
         buf[i] = buf[i] ^ buf[i + 1];
@@ -235,8 +300,6 @@ static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc
         }
     }
 #endif
-
-    return LV_RES_OK;
 }
 
 /**
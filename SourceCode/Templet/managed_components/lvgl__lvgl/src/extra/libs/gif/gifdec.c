@@ -29,6 +29,45 @@ static void f_gif_read(gd_GIF * gif, void * buf, size_t len);
 static int f_gif_seek(gd_GIF * gif, size_t pos, int k);
 static void f_gif_close(gd_GIF * gif);
 
+/* Write a pixel of the canvas in the display's color format. */
+static inline void
+set_px(gd_GIF *gif, int i, lv_color_t c, uint8_t opa)
+{
+#if LV_COLOR_DEPTH == 32
+    lv_color_t *px = (lv_color_t *) gif->canvas;
+    px[i] = c;
+    px[i].ch.alpha = opa;
+#elif LV_COLOR_DEPTH == 16
+    /* RGB565A8: the alpha values are after the colors */
+    ((lv_color_t *) gif->canvas)[i] = c;
+    gif->canvas[gif->width * gif->height * 2 + i] = opa;
+#elif LV_COLOR_DEPTH == 8 || LV_COLOR_DEPTH == 1
+    gif->canvas[i*2 + 0] = c.full;
+    gif->canvas[i*2 + 1] = opa;
+#endif
+}
+
+/* Convert the current palette to the display's color format if it has changed. */
+static void
+update_native_colors(gd_GIF *gif)
+{
+    int i;
+    uint8_t *color;
+
+    /* The local color table can be different in each frame */
+    if (gif->native_palette == gif->palette && gif->palette != &gif->lct) return;
+
+    for (i = 0; i < gif->palette->size; i++) {
+        color = &gif->palette->colors[i*3];
+#if LV_COLOR_DEPTH == 1
+        gif->native_colors[i].full = ((*(color + 0)) | (*(color + 1)) | (*(color + 2))) > 128 ? 1 : 0;
+#else
+        gif->native_colors[i] = lv_color_make(*(color + 0), *(color + 1), *(color + 2));
+#endif
+    }
+    gif->native_palette = gif->palette;
+}
+
 static uint16_t
 read_num(gd_GIF * gif)
 {
@@ -71,7 +110,6 @@ static gd_GIF * gif_open(gd_GIF * gif_base)
     uint16_t width, height, depth;
     uint8_t fdsz, bgidx, aspect;
     int i;
-    uint8_t *bgcolor;
     int gct_sz;
     gd_GIF *gif = NULL;
 
@@ -108,11 +146,11 @@ static gd_GIF * gif_open(gd_GIF * gif_base)
     f_gif_read(gif_base, &aspect, 1);
     /* Create gd_GIF Structure. */
 #if LV_COLOR_DEPTH == 32
-    gif = lv_mem_alloc(sizeof(gd_GIF) + 5 * width * height);
-#elif LV_COLOR_DEPTH == 16
     gif = lv_mem_alloc(sizeof(gd_GIF) + 4 * width * height);
-#elif LV_COLOR_DEPTH == 8 || LV_COLOR_DEPTH == 1
+#elif LV_COLOR_DEPTH == 16
     gif = lv_mem_alloc(sizeof(gd_GIF) + 3 * width * height);
+#elif LV_COLOR_DEPTH == 8 || LV_COLOR_DEPTH == 1
+    gif = lv_mem_alloc(sizeof(gd_GIF) + 2 * width * height);
 #endif
 
     if (!gif) goto fail;
@@ -126,39 +164,9 @@ static gd_GIF * gif_open(gd_GIF * gif_base)
     gif->palette = &gif->gct;
     gif->bgindex = bgidx;
     gif->canvas = (uint8_t *) &gif[1];
-#if LV_COLOR_DEPTH == 32
-    gif->frame = &gif->canvas[4 * width * height];
-#elif LV_COLOR_DEPTH == 16
-    gif->frame = &gif->canvas[3 * width * height];
-#elif LV_COLOR_DEPTH == 8 || LV_COLOR_DEPTH == 1
-    gif->frame = &gif->canvas[2 * width * height];
-#endif
-    if (gif->bgindex) {
-        memset(gif->frame, gif->bgindex, gif->width * gif->height);
-    }
-    bgcolor = &gif->palette->colors[gif->bgindex*3];
-
-    for (i = 0; i < gif->width * gif->height; i++) {
-#if LV_COLOR_DEPTH == 32
-        gif->canvas[i*4 + 0] = *(bgcolor + 2);
-        gif->canvas[i*4 + 1] = *(bgcolor + 1);
-        gif->canvas[i*4 + 2] = *(bgcolor + 0);
-        gif->canvas[i*4 + 3] = 0xff;
-#elif LV_COLOR_DEPTH == 16
-        lv_color_t c = lv_color_make(*(bgcolor + 0), *(bgcolor + 1), *(bgcolor + 2));
-        gif->canvas[i*3 + 0] = c.full & 0xff;
-        gif->canvas[i*3 + 1] = (c.full >> 8) & 0xff;
-        gif->canvas[i*3 + 2] = 0xff;
-#elif LV_COLOR_DEPTH == 8
-        lv_color_t c = lv_color_make(*(bgcolor + 0), *(bgcolor + 1), *(bgcolor + 2));
-        gif->canvas[i*2 + 0] = c.full;
-        gif->canvas[i*2 + 1] = 0xff;
-#elif LV_COLOR_DEPTH == 1
-        lv_color_t c = lv_color_make(*(bgcolor + 0), *(bgcolor + 1), *(bgcolor + 2));
-        gif->canvas[i*2 + 0] = c.ch.red > 128 ? 1 : 0;
-        gif->canvas[i*2 + 1] = 0xff;
-#endif
-    }
+    update_native_colors(gif);
+    for (i = 0; i < gif->width * gif->height; i++)
+        set_px(gif, i, gif->native_colors[gif->bgindex], 0xff);
     gif->anim_start = f_gif_seek(gif, 0, LV_FS_SEEK_CUR);
     gif->loop_count = -1;
     goto ok;
@@ -420,6 +428,8 @@ read_image_data(gd_GIF *gif, int interlace)
             key_size = init_key_size;
             table->nentries = (1 << (key_size - 1)) + 2;
             table_is_full = 0;
+            /* A pending key size increment is cancelled by the clear code */
+            ret = 0;
         } else if (!table_is_full) {
             ret = add_entry(&table, str_len + 1, key, entry.suffix);
             if (ret == -1) {
@@ -443,7 +453,10 @@ read_image_data(gd_GIF *gif, int interlace)
             y = p / gif->fw;
             if (interlace)
                 y = interlaced_line_index((int) gif->fh, y);
-            gif->frame[(gif->fy + y) * gif->width + gif->fx + x] = entry.suffix;
+            /* Draw the pixel directly to the canvas. The transparent pixels keep the previous frame. */
+            if ((!gif->gce.transparency || entry.suffix != gif->gce.tindex) && p < frm_size &&
+                gif->fx + x < gif->width && gif->fy + y < gif->height)
+                set_px(gif, (gif->fy + y) * gif->width + gif->fx + x, gif->native_colors[entry.suffix], 0xff);
             if (entry.prefix == 0xFFF)
                 break;
             else
@@ -483,89 +496,37 @@ read_image(gd_GIF *gif)
         gif->palette = &gif->lct;
     } else
         gif->palette = &gif->gct;
+    update_native_colors(gif);
     /* Image Data. */
     return read_image_data(gif, interlace);
 }
 
-static void
-render_frame_rect(gd_GIF *gif, uint8_t *buffer)
-{
-    int i, j, k;
-    uint8_t index, *color;
-    i = gif->fy * gif->width + gif->fx;
-    for (j = 0; j < gif->fh; j++) {
-        for (k = 0; k < gif->fw; k++) {
-            index = gif->frame[(gif->fy + j) * gif->width + gif->fx + k];
-            color = &gif->palette->colors[index*3];
-            if (!gif->gce.transparency || index != gif->gce.tindex) {
-#if LV_COLOR_DEPTH == 32
-                buffer[(i+k)*4 + 0] = *(color + 2);
-                buffer[(i+k)*4 + 1] = *(color + 1);
-                buffer[(i+k)*4 + 2] = *(color + 0);
-                buffer[(i+k)*4 + 3] = 0xFF;
-#elif LV_COLOR_DEPTH == 16
-                lv_color_t c = lv_color_make(*(color + 0), *(color + 1), *(color + 2));
-                buffer[(i+k)*3 + 0] = c.full & 0xff;
-                buffer[(i+k)*3 + 1] = (c.full >> 8) & 0xff;
-                buffer[(i+k)*3 + 2] = 0xff;
-#elif LV_COLOR_DEPTH == 8
-                lv_color_t c = lv_color_make(*(color + 0), *(color + 1), *(color + 2));
-                buffer[(i+k)*2 + 0] = c.full;
-                buffer[(i+k)*2 + 1] = 0xff;
-#elif LV_COLOR_DEPTH == 1
-                uint8_t b = (*(color + 0)) | (*(color + 1)) | (*(color + 2));
-                buffer[(i+k)*2 + 0] = b > 128 ? 1 : 0;
-                buffer[(i+k)*2 + 1] = 0xff;
-#endif
-            }
-        }
-        i += gif->width;
-    }
-}
-
 static void
 dispose(gd_GIF *gif)
 {
-    int i, j, k;
-    uint8_t *bgcolor;
+    int i, j, k, fw, fh;
+    lv_color_t bgcolor;
     switch (gif->gce.disposal) {
     case 2: /* Restore to background color. */
-        bgcolor = &gif->palette->colors[gif->bgindex*3];
+        bgcolor = gif->native_colors[gif->bgindex];
 
         uint8_t opa = 0xff;
         if(gif->gce.transparency) opa = 0x00;
 
+        fw = MIN(gif->fw, gif->width - MIN(gif->fx, gif->width));
+        fh = MIN(gif->fh, gif->height - MIN(gif->fy, gif->height));
         i = gif->fy * gif->width + gif->fx;
-        for (j = 0; j < gif->fh; j++) {
-            for (k = 0; k < gif->fw; k++) {
-#if LV_COLOR_DEPTH == 32
-                gif->canvas[(i+k)*4 + 0] = *(bgcolor + 2);
-                gif->canvas[(i+k)*4 + 1] = *(bgcolor + 1);
-                gif->canvas[(i+k)*4 + 2] = *(bgcolor + 0);
-                gif->canvas[(i+k)*4 + 3] = opa;
-#elif LV_COLOR_DEPTH == 16
-                lv_color_t c = lv_color_make(*(bgcolor + 0), *(bgcolor + 1), *(bgcolor + 2));
-                gif->canvas[(i+k)*3 + 0] = c.full & 0xff;
-                gif->canvas[(i+k)*3 + 1] = (c.full >> 8) & 0xff;
-                gif->canvas[(i+k)*3 + 2] = opa;
-#elif LV_COLOR_DEPTH == 8
-                lv_color_t c = lv_color_make(*(bgcolor + 0), *(bgcolor + 1), *(bgcolor + 2));
-                gif->canvas[(i+k)*2 + 0] = c.full;
-                gif->canvas[(i+k)*2 + 1] = opa;
-#elif LV_COLOR_DEPTH == 1
-                uint8_t b = (*(bgcolor + 0)) | (*(bgcolor + 1)) | (*(bgcolor + 2));
-                gif->canvas[(i+k)*2 + 0] = b > 128 ? 1 : 0;
-                gif->canvas[(i+k)*2 + 1] = opa;
-#endif
-            }
+        for (j = 0; j < fh; j++) {
+            for (k = 0; k < fw; k++)
+                set_px(gif, i + k, bgcolor, opa);
             i += gif->width;
         }
         break;
     case 3: /* Restore to previous, i.e., don't update canvas.*/
         break;
     default:
-        /* Add frame non-transparent pixels to canvas. */
-        render_frame_rect(gif, gif->canvas);
+        /* The non-transparent pixels of the frame are already on the canvas. */
+        break;
     }
 }
 
@@ -597,21 +558,6 @@ gd_get_frame(gd_GIF *gif)
     return 1;
 }
 
-void
-gd_render_frame(gd_GIF *gif, uint8_t *buffer)
-{
-//    uint32_t i;
-//    uint32_t j;
-//    for(i = 0, j = 0; i < gif->width * gif->height * 3; i+= 3, j+=4) {
-//        buffer[j + 0] = gif->canvas[i + 2];
-//        buffer[j + 1] = gif->canvas[i + 1];
-//        buffer[j + 2] = gif->canvas[i + 0];
-//        buffer[j + 3] = 0xFF;
-//    }
-//    memcpy(buffer, gif->canvas, gif->width * gif->height * 3);
-    render_frame_rect(gif, buffer);
-}
-
 void
 gd_rewind(gd_GIF *gif)
 {
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include "../../../misc/lv_fs.h"
+#include "../../../misc/lv_color.h"
 
 #if LV_USE_GIF
 
@@ -42,15 +43,17 @@ typedef struct gd_GIF {
     void (*application)(struct gd_GIF *gif, char id[8], char auth[3]);
     uint16_t fx, fy, fw, fh;
     uint8_t bgindex;
-    uint8_t *canvas, *frame;
+    /* The palette converted to the display's color format */
+    const gd_Palette *native_palette;
+    lv_color_t native_colors[0x100];
+    /* The frames are drawn directly here. RGB565A8 with 16 bit color depth, true color + alpha otherwise. */
+    uint8_t *canvas;
 } gd_GIF;
 
 gd_GIF * gd_open_gif_file(const char *fname);
 
 gd_GIF * gd_open_gif_data(const void *data);
 
-void gd_render_frame(gd_GIF *gif, uint8_t *buffer);
-
 int gd_get_frame(gd_GIF *gif);
 void gd_rewind(gd_GIF *gif);
 void gd_close_gif(gd_GIF *gif);
@@ -26,6 +26,7 @@
 static void lv_gif_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
 static void lv_gif_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
 static void next_frame_task_cb(lv_timer_t * t);
+static void invalidate_frame_area(lv_obj_t * obj, const lv_area_t * area);
 
 /**********************
  *  STATIC VARIABLES
@@ -80,9 +81,14 @@ void lv_gif_set_src(lv_obj_t * obj, const void * src)
 
     gifobj->imgdsc.data = gifobj->gif->canvas;
     gifobj->imgdsc.header.always_zero = 0;
+#if LV_COLOR_DEPTH == 16
+    gifobj->imgdsc.header.cf = LV_IMG_CF_RGB565A8;
+#else
     gifobj->imgdsc.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+#endif
     gifobj->imgdsc.header.h = gifobj->gif->height;
     gifobj->imgdsc.header.w = gifobj->gif->width;
+    gifobj->imgdsc.data_size = (uint32_t)gifobj->gif->width * gifobj->gif->height * LV_IMG_PX_SIZE_ALPHA_BYTE;
     gifobj->last_call = lv_tick_get();
 
     lv_img_set_src(obj, &gifobj->imgdsc);
@@ -136,6 +142,12 @@ static void next_frame_task_cb(lv_timer_t * t)
 
     gifobj->last_call = lv_tick_get();
 
+    /*Only the area of the previous frame (if it's cleared) and the area of the new frame change*/
+    gd_GIF * gif = gifobj->gif;
+    lv_area_t dirty;
+    bool prev_disposed = gif->gce.disposal == 2 && gif->fw && gif->fh;
+    lv_area_set(&dirty, gif->fx, gif->fy, gif->fx + gif->fw - 1, gif->fy + gif->fh - 1);
+
     int has_next = gd_get_frame(gifobj->gif);
     if(has_next == 0) {
         /*It was the last repeat*/
@@ -144,10 +156,40 @@ static void next_frame_task_cb(lv_timer_t * t)
         if(res != LV_FS_RES_OK) return;
     }
 
-    gd_render_frame(gifobj->gif, (uint8_t *)gifobj->imgdsc.data);
+    lv_area_t frame_area;
+    lv_area_set(&frame_area, gif->fx, gif->fy, gif->fx + gif->fw - 1, gif->fy + gif->fh - 1);
+    if(prev_disposed) _lv_area_join(&dirty, &dirty, &frame_area);
+    else lv_area_copy(&dirty, &frame_area);
 
     lv_img_cache_invalidate_src(lv_img_get_src(obj));
-    lv_obj_invalidate(obj);
+    invalidate_frame_area(obj, &dirty);
+}
+
+/**
+ * Invalidate the changed area of the canvas
+ * @param obj   pointer to a gif object
+ * @param area  the changed area relative to the canvas
+ */
+static void invalidate_frame_area(lv_obj_t * obj, const lv_area_t * area)
+{
+    lv_img_t * img = (lv_img_t *)obj;
+
+    /*The position of the pixels is not trivial if the image is transformed or repeated*/
+    if(img->angle || img->zoom != LV_IMG_ZOOM_NONE || img->offset.x || img->offset.y ||
+       lv_obj_get_content_width(obj) != img->w || lv_obj_get_content_height(obj) != img->h) {
+        lv_obj_invalidate(obj);
+        return;
+    }
+
+    lv_area_t canvas_area;
+    lv_area_set(&canvas_area, 0, 0, img->w - 1, img->h - 1);
+    lv_area_t inv_area;
+    if(!_lv_area_intersect(&inv_area, area, &canvas_area)) return;
+
+    lv_coord_t border_width = lv_obj_get_style_border_width(obj, LV_PART_MAIN);
+    lv_area_move(&inv_area, obj->coords.x1 + lv_obj_get_style_pad_left(obj, LV_PART_MAIN) + border_width,
+                 obj->coords.y1 + lv_obj_get_style_pad_top(obj, LV_PART_MAIN) + border_width);
+    lv_obj_invalidate_area(obj, &inv_area);
 }
 
 #endif /*LV_USE_GIF*/
@@ -11,11 +11,17 @@
 
 #include "lv_png.h"
 #include "lodepng.h"
+#include "lv_png_stream.h"
 #include <stdlib.h>
 
 /*********************
  *      DEFINES
  *********************/
+#if LV_PNG_STREAM && (LV_COLOR_DEPTH == 16 || LV_COLOR_DEPTH == 32)
+    #define PNG_STREAM 1
+#else
+    #define PNG_STREAM 0
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -27,6 +33,12 @@
 static lv_res_t decoder_info(struct _lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
 static lv_res_t decoder_open(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc);
 static void decoder_close(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc);
+#if PNG_STREAM
+static lv_res_t decoder_read_line(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                  lv_coord_t len, uint8_t * buf);
+static lv_res_t decoder_read_area(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                  lv_coord_t w, lv_coord_t h, uint8_t * buf);
+#endif
 static void convert_color_depth(uint8_t * img, uint32_t px_cnt);
 
 /**********************
@@ -50,6 +62,10 @@ void lv_png_init(void)
     lv_img_decoder_set_info_cb(dec, decoder_info);
     lv_img_decoder_set_open_cb(dec, decoder_open);
     lv_img_decoder_set_close_cb(dec, decoder_close);
+#if PNG_STREAM
+    lv_img_decoder_set_read_line_cb(dec, decoder_read_line);
+    lv_img_decoder_set_read_area_cb(dec, decoder_read_area);
+#endif
 }
 
 /**********************
@@ -150,6 +166,22 @@ static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t *
 
     uint8_t * img_data = NULL;
 
+#if PNG_STREAM
+    /*Don't decode the image now, just prepare it to be decoded line by line.
+     *Interlaced images can be decoded only at once so they are handled below.*/
+    if(dsc->src_type == LV_IMG_SRC_VARIABLE ||
+       (dsc->src_type == LV_IMG_SRC_FILE && strcmp(lv_fs_get_ext(dsc->src), "png") == 0)) {
+        lv_png_stream_t * stream = _lv_png_stream_open(dsc->src, dsc->src_type);
+        if(stream) {
+            dsc->header.cf = _lv_png_stream_get_cf(stream);
+            dsc->user_data = stream;
+            dsc->img_data = NULL;
+            dsc->mem_size = _lv_png_stream_get_mem_size(stream);
+            return LV_RES_OK;
+        }
+    }
+#endif
+
     /*If it's a PNG file...*/
     if(dsc->src_type == LV_IMG_SRC_FILE) {
         const char * fn = dsc->src;
@@ -222,8 +254,35 @@ static void decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc
         lv_mem_free((uint8_t *)dsc->img_data);
         dsc->img_data = NULL;
     }
+#if PNG_STREAM
+    if(dsc->user_data) {
+        _lv_png_stream_close(dsc->user_data);
+        dsc->user_data = NULL;
+    }
+#endif
 }
 
+#if PNG_STREAM
+static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                  lv_coord_t len, uint8_t * buf)
+{
+    return decoder_read_area(decoder, dsc, x, y, len, 1, buf);
+}
+
+/**
+ * Decode an area of a PNG image opened as a stream.
+ * With 16 bit color depth images with alpha are returned as RGB565A8:
+ * the `w * h` colors are followed by the `w * h` alpha values.
+ */
+static lv_res_t decoder_read_area(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                  lv_coord_t w, lv_coord_t h, uint8_t * buf)
+{
+    LV_UNUSED(decoder);
+    if(dsc->user_data == NULL) return LV_RES_INV;
+    return _lv_png_stream_read_area(dsc->user_data, x, y, w, h, buf);
+}
+#endif
+
 /**
  * If the display is not in 32 bit format (ARGB888) then covert the image to the current color depth
  * @param img the ARGB888 image
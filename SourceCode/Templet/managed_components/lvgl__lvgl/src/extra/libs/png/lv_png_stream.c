@@ -0,0 +1,880 @@
+/**
+ * @file lv_png_stream.c
+ * Decode non-interlaced PNG images line by line.
+ * lodepng can inflate only the whole image at once so the IDAT stream is inflated here
+ * by a small inflater which can stop at any output byte and continue later.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../../lvgl.h"
+#include "lv_png_stream.h"
+#if LV_USE_PNG && LV_PNG_STREAM && (LV_COLOR_DEPTH == 16 || LV_COLOR_DEPTH == 32)
+
+/*********************
+ *      DEFINES
+ *********************/
+#define WINDOW_SIZE     32768
+#define WINDOW_MASK     (WINDOW_SIZE - 1)
+#define MAX_BITS        15      /*Longest Huffman code*/
+#define MAX_LCODES      288     /*Number of literal/length codes*/
+#define MAX_DCODES      30      /*Number of distance codes*/
+#define MAX_CHUNK_LEN   0x7FFFFFFF  /*Longest chunk allowed by the PNG specification*/
+
+#define PNG_GRAY        0
+#define PNG_RGB         2
+#define PNG_PALETTE     3
+#define PNG_GRAY_ALPHA  4
+#define PNG_RGBA        6
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    INFLATE_BLOCK_HEADER,
+    INFLATE_STORED,
+    INFLATE_CODES,
+    INFLATE_DONE,
+} inflate_state_t;
+
+/*Canonical Huffman code: the number of codes of each length and the symbols ordered by their codes*/
+typedef struct {
+    uint16_t count[MAX_BITS + 1];
+    uint16_t symbol[MAX_LCODES];
+} huffman_t;
+
+struct _lv_png_stream_t {
+    /*The content of the IDAT chunks. A zlib stream.*/
+    const uint8_t * idat;
+    uint32_t idat_size;
+    bool idat_allocated;
+
+    /*Inflater*/
+    uint32_t in_pos;
+    uint32_t bit_buf;
+    uint8_t bit_cnt;
+    uint8_t state;
+    bool last_block;
+    bool error;
+    uint16_t stored_left;
+    uint16_t match_len;
+    uint16_t match_dist;
+    uint8_t * window;           /*The last 32 kB of the output for the back references*/
+    uint32_t win_pos;
+    uint32_t win_fill;
+    huffman_t lencode;
+    huffman_t distcode;
+
+    /*Image*/
+    uint32_t w;
+    uint32_t h;
+    uint8_t color_type;
+    uint8_t bit_depth;
+    uint8_t filter_bpp;         /*Bytes of a complete pixel for the filters (at least 1)*/
+    bool has_trns;
+    bool has_alpha;
+    uint16_t trns[3];           /*Transparent gray or RGB value*/
+    lv_color32_t palette[256];
+    uint32_t row_size;          /*Bytes of a row without the filter type byte*/
+    uint8_t * row;              /*Filter type byte + the last inflated row*/
+    uint8_t * prev_row;
+    uint32_t next_row;          /*Index of the next row to inflate*/
+};
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool load_file(lv_png_stream_t * s, const char * fn);
+static bool load_variable(lv_png_stream_t * s, const lv_img_dsc_t * img_dsc);
+static bool parse_chunk(lv_png_stream_t * s, const uint8_t * type, const uint8_t * data, uint32_t len);
+static uint8_t * idat_grow(lv_png_stream_t * s, uint32_t len);
+static bool init_image(lv_png_stream_t * s);
+static void restart(lv_png_stream_t * s);
+static bool read_row(lv_png_stream_t * s);
+static bool unfilter_row(lv_png_stream_t * s);
+static void convert_row(lv_png_stream_t * s, lv_coord_t x, lv_coord_t w, lv_coord_t h, lv_coord_t i, uint8_t * buf);
+static bool inflate_read(lv_png_stream_t * s, uint8_t * buf, uint32_t len);
+static uint32_t get_bits(lv_png_stream_t * s, uint8_t need);
+static int32_t huffman_decode(lv_png_stream_t * s, const huffman_t * h);
+static bool huffman_build(huffman_t * h, const uint8_t * lengths, uint32_t n);
+static bool read_fixed_codes(lv_png_stream_t * s);
+static bool read_dynamic_codes(lv_png_stream_t * s);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const uint8_t png_signature[8] = {0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a};
+
+static const uint16_t len_base[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59,
+                                      67, 83, 99, 115, 131, 163, 195, 227, 258
+                                     };
+static const uint8_t len_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t dist_base[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+                                       1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+                                      };
+static const uint8_t dist_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10,
+                                       11, 11, 12, 12, 13, 13
+                                      };
+
+/**********************
+ *      MACROS
+ **********************/
+#define READ_BE16(p) ((uint16_t)(((uint16_t)(p)[0] << 8) | (p)[1]))
+#define READ_BE32(p) (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 8) | (p)[3])
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_png_stream_t * _lv_png_stream_open(const void * src, lv_img_src_t src_type)
+{
+    lv_png_stream_t * s = lv_mem_alloc(sizeof(lv_png_stream_t));
+    LV_ASSERT_MALLOC(s);
+    if(s == NULL) return NULL;
+    lv_memset_00(s, sizeof(lv_png_stream_t));
+
+    uint32_t i;
+    for(i = 0; i < 256; i++) s->palette[i].ch.alpha = 0xff;
+
+    bool ok = false;
+    if(src_type == LV_IMG_SRC_FILE) ok = load_file(s, src);
+    else if(src_type == LV_IMG_SRC_VARIABLE) ok = load_variable(s, src);
+
+    if(ok) ok = init_image(s);
+
+    if(!ok) {
+        _lv_png_stream_close(s);
+        return NULL;
+    }
+
+    restart(s);
+    return s;
+}
+
+lv_img_cf_t _lv_png_stream_get_cf(const lv_png_stream_t * stream)
+{
+    if(!stream->has_alpha) return LV_IMG_CF_TRUE_COLOR;
+#if LV_COLOR_DEPTH == 16
+    return LV_IMG_CF_RGB565A8;
+#else
+    return LV_IMG_CF_TRUE_COLOR_ALPHA;
+#endif
+}
+
+uint32_t _lv_png_stream_get_mem_size(const lv_png_stream_t * stream)
+{
+    uint32_t size = sizeof(lv_png_stream_t) + WINDOW_SIZE + 2 * (stream->row_size + 1);
+    if(stream->idat_allocated) size += stream->idat_size;
+    return size;
+}
+
+lv_res_t _lv_png_stream_read_area(lv_png_stream_t * stream, lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h,
+                                  uint8_t * buf)
+{
+    lv_png_stream_t * s = stream;
+    if(x < 0 || y < 0 || w <= 0 || h <= 0) return LV_RES_INV;
+    if((uint32_t)x + w > s->w || (uint32_t)y + h > s->h) return LV_RES_INV;
+
+    /*The rows can be inflated only from top to bottom. Start again if a row above the last one is needed.*/
+    if((uint32_t)y + 1 < s->next_row) restart(s);
+
+    lv_coord_t i;
+    for(i = 0; i < h; i++) {
+        while(s->next_row <= (uint32_t)y + i) {
+            if(!read_row(s)) {
+                LV_LOG_WARN("PNG stream: corrupted image data");
+                s->next_row = s->h + 1;     /*Start again on the next read*/
+                return LV_RES_INV;
+            }
+        }
+        convert_row(s, x, w, h, i, buf);
+    }
+
+    return LV_RES_OK;
+}
+
+void _lv_png_stream_close(lv_png_stream_t * stream)
+{
+    if(stream->idat_allocated) lv_mem_free((uint8_t *)stream->idat);
+    if(stream->window) lv_mem_free(stream->window);
+    if(stream->row) lv_mem_free(stream->row);
+    if(stream->prev_row) lv_mem_free(stream->prev_row);
+    lv_mem_free(stream);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Read the header chunks and the IDAT chunks of a file. The other chunks are skipped.
+ */
+static bool load_file(lv_png_stream_t * s, const char * fn)
+{
+    lv_fs_file_t f;
+    if(lv_fs_open(&f, fn, LV_FS_MODE_RD) != LV_FS_RES_OK) return false;
+
+    /*The chunk lengths are checked against the file size to not allocate and read garbage lengths*/
+    uint32_t file_size = 0;
+    if(lv_fs_seek(&f, 0, LV_FS_SEEK_END) == LV_FS_RES_OK) lv_fs_tell(&f, &file_size);
+    lv_fs_seek(&f, 0, LV_FS_SEEK_SET);
+
+    uint8_t hdr[8];
+    uint32_t rn;
+    uint32_t pos;
+    bool ok = false;
+    lv_fs_res_t res = lv_fs_read(&f, hdr, 8, &rn);
+    if(res == LV_FS_RES_OK && rn == 8 && memcmp(hdr, png_signature, 8) == 0) {
+        while(1) {
+            res = lv_fs_read(&f, hdr, 8, &rn);
+            if(res != LV_FS_RES_OK || rn != 8) break;
+            if(lv_fs_tell(&f, &pos) != LV_FS_RES_OK || pos > file_size) break;
+
+            uint32_t len = READ_BE32(hdr);
+            if(len > MAX_CHUNK_LEN || len > file_size - pos) {
+                LV_LOG_WARN("PNG stream: invalid chunk length");
+                break;
+            }
+
+            const uint8_t * type = hdr + 4;
+            if(memcmp(type, "IEND", 4) == 0) {
+                ok = true;
+                break;
+            }
+
+            if(memcmp(type, "IDAT", 4) == 0) {
+                uint8_t * p = idat_grow(s, len);
+                if(p == NULL) break;
+                res = lv_fs_read(&f, p, len, &rn);
+                if(res != LV_FS_RES_OK || rn != len) break;
+            }
+            else if(memcmp(type, "IHDR", 4) == 0 || memcmp(type, "PLTE", 4) == 0 || memcmp(type, "tRNS", 4) == 0) {
+                if(len > 3 * 256) break;
+                uint8_t * data = lv_mem_buf_get(len);
+                if(data == NULL) break;
+                res = lv_fs_read(&f, data, len, &rn);
+                bool chunk_ok = res == LV_FS_RES_OK && rn == len && parse_chunk(s, type, data, len);
+                lv_mem_buf_release(data);
+                if(!chunk_ok) break;
+            }
+            else {
+                lv_fs_seek(&f, len, LV_FS_SEEK_CUR);
+            }
+
+            lv_fs_seek(&f, 4, LV_FS_SEEK_CUR);      /*Skip the CRC*/
+        }
+    }
+
+    lv_fs_close(&f);
+    return ok;
+}
+
+/**
+ * Find the chunks in a C array. A single IDAT chunk is used in place.
+ */
+static bool load_variable(lv_png_stream_t * s, const lv_img_dsc_t * img_dsc)
+{
+    const uint8_t * data = img_dsc->data;
+    uint32_t size = img_dsc->data_size;
+    if(size < 8 || memcmp(data, png_signature, 8)) return false;
+
+    uint32_t pos = 8;
+    while(pos + 12 <= size) {
+        uint32_t len = READ_BE32(data + pos);
+        const uint8_t * type = data + pos + 4;
+        const uint8_t * chunk_data = data + pos + 8;
+        if(len > size - pos - 12) return false;
+
+        if(memcmp(type, "IEND", 4) == 0) return true;
+
+        if(memcmp(type, "IDAT", 4) == 0) {
+            if(s->idat_size == 0) {
+                s->idat = chunk_data;
+                s->idat_size = len;
+            }
+            else {
+                uint8_t * p = idat_grow(s, len);
+                if(p == NULL) return false;
+                lv_memcpy(p, chunk_data, len);
+            }
+        }
+        else if(!parse_chunk(s, type, chunk_data, len)) {
+            return false;
+        }
+
+        pos += len + 12;
+    }
+
+    return false;
+}
+
+static bool parse_chunk(lv_png_stream_t * s, const uint8_t * type, const uint8_t * data, uint32_t len)
+{
+    if(memcmp(type, "IHDR", 4) == 0) {
+        if(len != 13) return false;
+        s->w = READ_BE32(data);
+        s->h = READ_BE32(data + 4);
+        s->bit_depth = data[8];
+        s->color_type = data[9];
+        /*Compression and filter method, interlacing. Interlaced images can't be decoded line by line.*/
+        if(data[10] != 0 || data[11] != 0 || data[12] != 0) return false;
+    }
+    else if(memcmp(type, "PLTE", 4) == 0) {
+        if(len % 3 || len > 3 * 256) return false;
+        uint32_t i;
+        for(i = 0; i < len / 3; i++) {
+            s->palette[i].ch.red = data[i * 3];
+            s->palette[i].ch.green = data[i * 3 + 1];
+            s->palette[i].ch.blue = data[i * 3 + 2];
+        }
+    }
+    else if(memcmp(type, "tRNS", 4) == 0) {
+        if(s->color_type == PNG_PALETTE) {
+            if(len > 256) return false;
+            uint32_t i;
+            for(i = 0; i < len; i++) s->palette[i].ch.alpha = data[i];
+        }
+        else if(s->color_type == PNG_GRAY) {
+            if(len < 2) return false;
+            s->trns[0] = READ_BE16(data);
+        }
+        else if(s->color_type == PNG_RGB) {
+            if(len < 6) return false;
+            s->trns[0] = READ_BE16(data);
+            s->trns[1] = READ_BE16(data + 2);
+            s->trns[2] = READ_BE16(data + 4);
+        }
+        s->has_trns = true;
+    }
+
+    return true;
+}
+
+/**
+ * Make room for `len` more bytes of compressed data
+ * @return pointer to the new bytes or NULL on error
+ */
+static uint8_t * idat_grow(lv_png_stream_t * s, uint32_t len)
+{
+    if(len > MAX_CHUNK_LEN || s->idat_size + len < s->idat_size) return NULL;
+
+    uint8_t * idat;
+    if(s->idat_allocated) {
+        idat = lv_mem_realloc((uint8_t *)s->idat, s->idat_size + len);
+    }
+    else {
+        idat = lv_mem_alloc(s->idat_size + len);
+        if(idat && s->idat_size) lv_memcpy(idat, s->idat, s->idat_size);
+    }
+    LV_ASSERT_MALLOC(idat);
+    if(idat == NULL) return NULL;
+
+    s->idat = idat;
+    s->idat_allocated = true;
+    uint8_t * p = idat + s->idat_size;
+    s->idat_size += len;
+    return p;
+}
+
+/**
+ * Check the header and allocate the buffers for inflating
+ */
+static bool init_image(lv_png_stream_t * s)
+{
+    if(s->w == 0 || s->h == 0 || s->w > LV_COORD_MAX || s->h > LV_COORD_MAX) return false;
+
+    uint32_t channels;
+    bool depth_ok;
+    uint8_t d = s->bit_depth;
+    switch(s->color_type) {
+        case PNG_GRAY:
+            channels = 1;
+            depth_ok = d == 1 || d == 2 || d == 4 || d == 8 || d == 16;
+            break;
+        case PNG_PALETTE:
+            channels = 1;
+            depth_ok = d == 1 || d == 2 || d == 4 || d == 8;
+            break;
+        case PNG_RGB:
+            channels = 3;
+            depth_ok = d == 8 || d == 16;
+            break;
+        case PNG_GRAY_ALPHA:
+            channels = 2;
+            depth_ok = d == 8 || d == 16;
+            break;
+        case PNG_RGBA:
+            channels = 4;
+            depth_ok = d == 8 || d == 16;
+            break;
+        default:
+            return false;
+    }
+    if(!depth_ok) return false;
+
+    uint32_t px_bits = channels * d;
+    s->row_size = (s->w * px_bits + 7) / 8;
+    s->filter_bpp = px_bits < 8 ? 1 : px_bits / 8;
+    s->has_alpha = s->color_type == PNG_GRAY_ALPHA || s->color_type == PNG_RGBA || s->has_trns;
+
+    /*zlib header: deflate compression, no preset dictionary*/
+    if(s->idat_size < 2) return false;
+    uint8_t cmf = s->idat[0];
+    uint8_t flg = s->idat[1];
+    if((cmf & 0x0f) != 8 || (flg & 0x20) || ((cmf << 8) | flg) % 31) return false;
+
+    s->window = lv_mem_alloc(WINDOW_SIZE);
+    s->row = lv_mem_alloc(s->row_size + 1);
+    s->prev_row = lv_mem_alloc(s->row_size + 1);
+    if(s->window == NULL || s->row == NULL || s->prev_row == NULL) {
+        LV_LOG_WARN("PNG stream: out of memory");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Go back to the beginning of the image
+ */
+static void restart(lv_png_stream_t * s)
+{
+    s->in_pos = 2;  /*Skip the zlib header*/
+    s->bit_buf = 0;
+    s->bit_cnt = 0;
+    s->state = INFLATE_BLOCK_HEADER;
+    s->last_block = false;
+    s->error = false;
+    s->stored_left = 0;
+    s->match_len = 0;
+    s->win_pos = 0;
+    s->win_fill = 0;
+    s->next_row = 0;
+
+    /*The first row is filtered with a row of zeros above it*/
+    lv_memset_00(s->row, s->row_size + 1);
+    lv_memset_00(s->prev_row, s->row_size + 1);
+}
+
+/**
+ * Inflate and unfilter the next row
+ */
+static bool read_row(lv_png_stream_t * s)
+{
+    uint8_t * tmp = s->prev_row;
+    s->prev_row = s->row;
+    s->row = tmp;
+
+    if(!inflate_read(s, s->row, s->row_size + 1)) return false;
+    if(!unfilter_row(s)) return false;
+
+    s->next_row++;
+    return true;
+}
+
+static inline uint8_t paeth(uint8_t a, uint8_t b, uint8_t c)
+{
+    int32_t p = (int32_t)a + b - c;
+    int32_t pa = LV_ABS(p - a);
+    int32_t pb = LV_ABS(p - b);
+    int32_t pc = LV_ABS(p - c);
+    if(pa <= pb && pa <= pc) return a;
+    else if(pb <= pc) return b;
+    else return c;
+}
+
+static bool unfilter_row(lv_png_stream_t * s)
+{
+    uint8_t * r = s->row + 1;
+    const uint8_t * p = s->prev_row + 1;
+    uint32_t n = s->row_size;
+    uint32_t bpp = s->filter_bpp;
+    uint32_t i;
+
+    switch(s->row[0]) {
+        case 0: /*None*/
+            break;
+        case 1: /*Sub*/
+            for(i = bpp; i < n; i++) r[i] += r[i - bpp];
+            break;
+        case 2: /*Up*/
+            for(i = 0; i < n; i++) r[i] += p[i];
+            break;
+        case 3: /*Average*/
+            for(i = 0; i < bpp; i++) r[i] += p[i] >> 1;
+            for(i = bpp; i < n; i++) r[i] += (r[i - bpp] + p[i]) >> 1;
+            break;
+        case 4: /*Paeth*/
+            for(i = 0; i < bpp; i++) r[i] += p[i];
+            for(i = bpp; i < n; i++) r[i] += paeth(r[i - bpp], p[i], p[i - bpp]);
+            break;
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Get a gray or palette index sample of 1, 2, 4, 8 or 16 bits
+ */
+static inline uint32_t get_sample(const uint8_t * row, uint32_t x, uint8_t bit_depth)
+{
+    if(bit_depth == 8) return row[x];
+    if(bit_depth == 16) return READ_BE16(row + x * 2);
+
+    uint32_t bit = x * bit_depth;
+    uint32_t shift = 8 - bit_depth - (bit & 0x7);
+    return (row[bit >> 3] >> shift) & ((1 << bit_depth) - 1);
+}
+
+static lv_color32_t get_px(const lv_png_stream_t * s, const uint8_t * row, uint32_t x)
+{
+    lv_color32_t c;
+    c.ch.alpha = 0xff;
+    bool depth16 = s->bit_depth == 16;
+
+    switch(s->color_type) {
+        case PNG_GRAY: {
+                uint32_t v = get_sample(row, x, s->bit_depth);
+                uint8_t g;
+                switch(s->bit_depth) {
+                    case 1:
+                        g = v ? 0xff : 0;
+                        break;
+                    case 2:
+                        g = v * 0x55;
+                        break;
+                    case 4:
+                        g = v * 0x11;
+                        break;
+                    case 16:
+                        g = v >> 8;
+                        break;
+                    default:
+                        g = v;
+                        break;
+                }
+                c.ch.red = g;
+                c.ch.green = g;
+                c.ch.blue = g;
+                if(s->has_trns && v == s->trns[0]) c.ch.alpha = 0;
+                break;
+            }
+        case PNG_PALETTE:
+            c = s->palette[get_sample(row, x, s->bit_depth)];
+            break;
+        case PNG_RGB:
+            if(depth16) {
+                const uint8_t * p = row + x * 6;
+                c.ch.red = p[0];
+                c.ch.green = p[2];
+                c.ch.blue = p[4];
+                if(s->has_trns && READ_BE16(p) == s->trns[0] && READ_BE16(p + 2) == s->trns[1] &&
+                   READ_BE16(p + 4) == s->trns[2]) c.ch.alpha = 0;
+            }
+            else {
+                const uint8_t * p = row + x * 3;
+                c.ch.red = p[0];
+                c.ch.green = p[1];
+                c.ch.blue = p[2];
+                if(s->has_trns && p[0] == s->trns[0] && p[1] == s->trns[1] && p[2] == s->trns[2]) c.ch.alpha = 0;
+            }
+            break;
+        case PNG_GRAY_ALPHA: {
+                const uint8_t * p = depth16 ? row + x * 4 : row + x * 2;
+                c.ch.red = p[0];
+                c.ch.green = p[0];
+                c.ch.blue = p[0];
+                c.ch.alpha = depth16 ? p[2] : p[1];
+                break;
+            }
+        case PNG_RGBA:
+        default:
+            if(depth16) {
+                const uint8_t * p = row + x * 8;
+                c.ch.red = p[0];
+                c.ch.green = p[2];
+                c.ch.blue = p[4];
+                c.ch.alpha = p[6];
+            }
+            else {
+                const uint8_t * p = row + x * 4;
+                c.ch.red = p[0];
+                c.ch.green = p[1];
+                c.ch.blue = p[2];
+                c.ch.alpha = p[3];
+            }
+            break;
+    }
+
+    return c;
+}
+
+/**
+ * Convert the last inflated row to the row `i` of a `w x h` area in `buf`
+ */
+static void convert_row(lv_png_stream_t * s, lv_coord_t x, lv_coord_t w, lv_coord_t h, lv_coord_t i, uint8_t * buf)
+{
+    const uint8_t * row = s->row + 1;
+    lv_color_t * dst = (lv_color_t *)buf + (uint32_t)i * w;
+#if LV_COLOR_DEPTH == 16
+    /*RGB565A8: the alpha values are after the colors of the whole area*/
+    lv_opa_t * dst_a = s->has_alpha ? buf + (uint32_t)w * h * sizeof(lv_color_t) + (uint32_t)i * w : NULL;
+#else
+    LV_UNUSED(h);
+#endif
+
+    lv_coord_t j;
+    for(j = 0; j < w; j++) {
+        lv_color32_t c = get_px(s, row, x + j);
+        dst[j] = lv_color_make(c.ch.red, c.ch.green, c.ch.blue);
+#if LV_COLOR_DEPTH == 16
+        if(dst_a) dst_a[j] = c.ch.alpha;
+#else
+        dst[j].ch.alpha = c.ch.alpha;
+#endif
+    }
+}
+
+static inline void put_byte(lv_png_stream_t * s, uint8_t c)
+{
+    s->window[s->win_pos] = c;
+    s->win_pos = (s->win_pos + 1) & WINDOW_MASK;
+    if(s->win_fill < WINDOW_SIZE) s->win_fill++;
+}
+
+/**
+ * Inflate exactly `len` bytes. Can be called again to continue where the previous call stopped.
+ */
+static bool inflate_read(lv_png_stream_t * s, uint8_t * buf, uint32_t len)
+{
+    while(len > 0) {
+        /*Finish the pending back reference first*/
+        if(s->match_len) {
+            uint32_t n = LV_MIN(len, s->match_len);
+            s->match_len -= n;
+            len -= n;
+            while(n--) {
+                uint8_t c = s->window[(s->win_pos - s->match_dist) & WINDOW_MASK];
+                put_byte(s, c);
+                *buf++ = c;
+            }
+            continue;
+        }
+
+        switch(s->state) {
+            case INFLATE_BLOCK_HEADER: {
+                    s->last_block = get_bits(s, 1);
+                    uint32_t type = get_bits(s, 2);
+                    if(s->error) return false;
+
+                    if(type == 0) {
+                        /*Stored block: byte aligned length and its complement*/
+                        s->bit_buf = 0;
+                        s->bit_cnt = 0;
+                        if(s->in_pos + 4 > s->idat_size) return false;
+                        const uint8_t * p = s->idat + s->in_pos;
+                        uint16_t stored_len = p[0] | (p[1] << 8);
+                        uint16_t stored_nlen = p[2] | (p[3] << 8);
+                        if((stored_len ^ stored_nlen) != 0xffff) return false;
+                        s->in_pos += 4;
+                        s->stored_left = stored_len;
+                        s->state = INFLATE_STORED;
+                    }
+                    else if(type == 1) {
+                        if(!read_fixed_codes(s)) return false;
+                        s->state = INFLATE_CODES;
+                    }
+                    else if(type == 2) {
+                        if(!read_dynamic_codes(s)) return false;
+                        s->state = INFLATE_CODES;
+                    }
+                    else {
+                        return false;
+                    }
+                    break;
+                }
+            case INFLATE_STORED: {
+                    if(s->stored_left == 0) {
+                        s->state = s->last_block ? INFLATE_DONE : INFLATE_BLOCK_HEADER;
+                        break;
+                    }
+                    uint32_t n = LV_MIN(len, s->stored_left);
+                    if(s->in_pos + n > s->idat_size) return false;
+                    s->stored_left -= n;
+                    len -= n;
+                    while(n--) {
+                        uint8_t c = s->idat[s->in_pos++];
+                        put_byte(s, c);
+                        *buf++ = c;
+                    }
+                    break;
+                }
+            case INFLATE_CODES: {
+                    int32_t sym = huffman_decode(s, &s->lencode);
+                    if(sym < 0) return false;
+                    if(sym < 256) {
+                        put_byte(s, sym);
+                        *buf++ = sym;
+                        len--;
+                    }
+                    else if(sym == 256) {
+                        s->state = s->last_block ? INFLATE_DONE : INFLATE_BLOCK_HEADER;
+                    }
+                    else {
+                        sym -= 257;
+                        if(sym >= 29) return false;
+                        uint32_t match_len = len_base[sym] + get_bits(s, len_extra[sym]);
+                        int32_t dist_sym = huffman_decode(s, &s->distcode);
+                        if(dist_sym < 0 || dist_sym >= MAX_DCODES) return false;
+                        uint32_t dist = dist_base[dist_sym] + get_bits(s, dist_extra[dist_sym]);
+                        if(s->error || dist > s->win_fill) return false;
+                        s->match_len = match_len;
+                        s->match_dist = dist;
+                    }
+                    break;
+                }
+            default:
+                /*The compressed data ended before the image*/
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static uint32_t get_bits(lv_png_stream_t * s, uint8_t need)
+{
+    uint32_t val = s->bit_buf;
+    while(s->bit_cnt < need) {
+        if(s->in_pos >= s->idat_size) {
+            s->error = true;
+            return 0;
+        }
+        val |= (uint32_t)s->idat[s->in_pos++] << s->bit_cnt;
+        s->bit_cnt += 8;
+    }
+
+    s->bit_buf = val >> need;
+    s->bit_cnt -= need;
+    return val & ((1UL << need) - 1);
+}
+
+/**
+ * Decode a symbol. The codes are stored with their most significant bit first so read them bit by bit.
+ * @return the symbol or -1 on error
+ */
+static int32_t huffman_decode(lv_png_stream_t * s, const huffman_t * h)
+{
+    int32_t code = 0;   /*The bits read so far*/
+    int32_t first = 0;  /*The first code of the current length*/
+    int32_t index = 0;  /*Index of the first code of the current length in `symbol`*/
+    uint32_t len;
+    for(len = 1; len <= MAX_BITS; len++) {
+        code |= get_bits(s, 1);
+        if(s->error) return -1;
+        int32_t count = h->count[len];
+        if(code - count < first) return h->symbol[index + (code - first)];
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+
+    return -1;
+}
+
+/**
+ * Build a canonical Huffman code from the code lengths of the symbols.
+ * Incomplete codes are accepted, the missing codes are detected while decoding.
+ */
+static bool huffman_build(huffman_t * h, const uint8_t * lengths, uint32_t n)
+{
+    uint16_t offs[MAX_BITS + 1];
+    uint32_t i;
+    lv_memset_00(h->count, sizeof(h->count));
+    for(i = 0; i < n; i++) h->count[lengths[i]]++;
+
+    /*Over-subscribed codes are invalid*/
+    int32_t left = 1;
+    for(i = 1; i <= MAX_BITS; i++) {
+        left <<= 1;
+        left -= h->count[i];
+        if(left < 0) return false;
+    }
+
+    offs[1] = 0;
+    for(i = 1; i < MAX_BITS; i++) offs[i + 1] = offs[i] + h->count[i];
+    for(i = 0; i < n; i++) {
+        if(lengths[i]) h->symbol[offs[lengths[i]]++] = i;
+    }
+
+    return true;
+}
+
+static bool read_fixed_codes(lv_png_stream_t * s)
+{
+    uint8_t lengths[MAX_LCODES];
+    uint32_t i;
+    for(i = 0; i < 144; i++) lengths[i] = 8;
+    for(; i < 256; i++) lengths[i] = 9;
+    for(; i < 280; i++) lengths[i] = 7;
+    for(; i < MAX_LCODES; i++) lengths[i] = 8;
+    if(!huffman_build(&s->lencode, lengths, MAX_LCODES)) return false;
+
+    for(i = 0; i < MAX_DCODES; i++) lengths[i] = 5;
+    return huffman_build(&s->distcode, lengths, MAX_DCODES);
+}
+
+static bool read_dynamic_codes(lv_png_stream_t * s)
+{
+    static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    uint8_t lengths[MAX_LCODES + MAX_DCODES];
+
+    uint32_t nlen = get_bits(s, 5) + 257;
+    uint32_t ndist = get_bits(s, 5) + 1;
+    uint32_t ncode = get_bits(s, 4) + 4;
+    if(s->error || nlen > MAX_LCODES || ndist > MAX_DCODES) return false;
+
+    /*The code lengths of the code length alphabet. `lencode` is used temporarily to decode them.*/
+    uint32_t i;
+    for(i = 0; i < ncode; i++) lengths[order[i]] = get_bits(s, 3);
+    for(; i < 19; i++) lengths[order[i]] = 0;
+    if(s->error || !huffman_build(&s->lencode, lengths, 19)) return false;
+
+    i = 0;
+    while(i < nlen + ndist) {
+        int32_t sym = huffman_decode(s, &s->lencode);
+        if(sym < 0) return false;
+        if(sym < 16) {
+            lengths[i++] = sym;
+            continue;
+        }
+
+        uint8_t len = 0;
+        uint32_t rep;
+        if(sym == 16) {
+            if(i == 0) return false;
+            len = lengths[i - 1];
+            rep = 3 + get_bits(s, 2);
+        }
+        else if(sym == 17) {
+            rep = 3 + get_bits(s, 3);
+        }
+        else {
+            rep = 11 + get_bits(s, 7);
+        }
+        if(s->error || i + rep > nlen + ndist) return false;
+        while(rep--) lengths[i++] = len;
+    }
+
+    /*There must be an end-of-block code*/
+    if(lengths[256] == 0) return false;
+
+    if(!huffman_build(&s->lencode, lengths, nlen)) return false;
+    return huffman_build(&s->distcode, lengths + nlen, ndist);
+}
+
+#endif /*LV_USE_PNG && LV_PNG_STREAM*/
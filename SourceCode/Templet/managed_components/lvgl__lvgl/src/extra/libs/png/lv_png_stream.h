@@ -0,0 +1,89 @@
+/**
+ * @file lv_png_stream.h
+ *
+ */
+
+#ifndef LV_PNG_STREAM_H
+#define LV_PNG_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../../lv_conf_internal.h"
+#if LV_USE_PNG && LV_PNG_STREAM && (LV_COLOR_DEPTH == 16 || LV_COLOR_DEPTH == 32)
+
+#include "../../../draw/lv_img_decoder.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+struct _lv_png_stream_t;
+typedef struct _lv_png_stream_t lv_png_stream_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Prepare a PNG image to be decoded line by line.
+ * Only the compressed image data is loaded, nothing is decompressed yet.
+ * @param src       file name or pointer to an `lv_img_dsc_t` with the PNG data
+ * @param src_type  type of `src`
+ * @return          the new stream or NULL if the image can't be streamed (e.g. it's interlaced or invalid)
+ */
+lv_png_stream_t * _lv_png_stream_open(const void * src, lv_img_src_t src_type);
+
+/**
+ * Get the color format of the lines returned by `_lv_png_stream_read_area`
+ * @param stream    pointer to a stream
+ * @return          `LV_IMG_CF_TRUE_COLOR`, `LV_IMG_CF_TRUE_COLOR_ALPHA` (32 bit) or `LV_IMG_CF_RGB565A8` (16 bit)
+ */
+lv_img_cf_t _lv_png_stream_get_cf(const lv_png_stream_t * stream);
+
+/**
+ * Get the memory used by a stream
+ * @param stream    pointer to a stream
+ * @return          size of the compressed data (if copied from a file), the buffers to decompress it and the stream itself in bytes
+ */
+uint32_t _lv_png_stream_get_mem_size(const lv_png_stream_t * stream);
+
+/**
+ * Decompress an area of the image.
+ * The rows are decompressed from top to bottom so reading a row above the last read row starts from the beginning.
+ * @param stream    pointer to a stream
+ * @param x         x coordinate of the area
+ * @param y         y coordinate of the area
+ * @param w         width of the area
+ * @param h         height of the area
+ * @param buf       store the pixels here. With `LV_IMG_CF_RGB565A8` the `w * h` colors are followed by `w * h` alpha values.
+ * @return          LV_RES_OK: success; LV_RES_INV: invalid area or corrupted image
+ */
+lv_res_t _lv_png_stream_read_area(lv_png_stream_t * stream, lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h,
+                                  uint8_t * buf);
+
+/**
+ * Free a stream
+ * @param stream    pointer to a stream
+ */
+void _lv_png_stream_close(lv_png_stream_t * stream);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_PNG && LV_PNG_STREAM*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_PNG_STREAM_H*/
@@ -52,6 +52,22 @@
 #include "lv_sjpg.h"
 #include "../../../misc/lv_fs.h"
 
+#if LV_SJPG_DECODE_THREAD
+    #if LV_SJPG_DECODE_FREERTOS
+        #ifdef ESP_PLATFORM
+            #include "freertos/FreeRTOS.h"
+            #include "freertos/task.h"
+            #include "freertos/semphr.h"
+        #else
+            #include "FreeRTOS.h"
+            #include "task.h"
+            #include "semphr.h"
+        #endif
+    #else
+        #include <pthread.h>
+    #endif
+#endif
+
 /*********************
  *      DEFINES
  *********************/
@@ -65,6 +81,31 @@
 #define SJPEG_BLOCK_WIDTH_OFFSET        20
 #define SJPEG_FRAME_INFO_ARRAY_OFFSET   22
 
+#if LV_SJPG_FRAGMENT_CACHE_CNT < 1
+    #error "LV_SJPG_FRAGMENT_CACHE_CNT must be at least 1"
+#endif
+
+#if LV_SJPG_DECODE_THREAD
+    #if LV_SJPG_FRAGMENT_CACHE_CNT < 2
+        #error "LV_SJPG_DECODE_THREAD requires LV_SJPG_FRAGMENT_CACHE_CNT >= 2"
+    #endif
+    #if LV_MEM_CUSTOM == 0
+        #error "LV_SJPG_DECODE_THREAD requires LV_MEM_CUSTOM = 1 (a thread safe allocator)"
+    #endif
+
+    #if LV_SJPG_DECODE_FREERTOS
+        /*The mutex is created with the decoder task*/
+        #define LOCK()      do { if(lock) xSemaphoreTake(lock, portMAX_DELAY); } while(0)
+        #define UNLOCK()    do { if(lock) xSemaphoreGive(lock); } while(0)
+    #else
+        #define LOCK()      pthread_mutex_lock(&lock)
+        #define UNLOCK()    pthread_mutex_unlock(&lock)
+    #endif
+#else
+    #define LOCK()
+    #define UNLOCK()
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -85,6 +126,19 @@ typedef struct {
     uint32_t raw_sjpg_data_next_read_pos; //Used for all types.
 } io_source_t;
 
+typedef enum {
+    FRAGMENT_EMPTY,
+    FRAGMENT_READY,
+    FRAGMENT_DECODING,  /**< Being decoded by the helper thread*/
+} fragment_state_t;
+
+typedef struct {
+    uint8_t * buf;                      //RGB888 pixels of the fragment, allocated on first use
+    int frame_index;
+    uint32_t last_use;
+    uint8_t state;
+} sjpeg_fragment_t;
+
 typedef struct {
     uint8_t * sjpeg_data;
     uint32_t sjpeg_data_size;
@@ -92,13 +146,18 @@ typedef struct {
     int sjpeg_y_res;
     int sjpeg_total_frames;
     int sjpeg_single_frame_height;
-    int sjpeg_cache_frame_index;
     uint8_t ** frame_base_array;        //to save base address of each split frames upto sjpeg_total_frames.
     int * frame_base_offset;            //to save base offset for fseek
-    uint8_t * frame_cache;
+    sjpeg_fragment_t fragments[LV_SJPG_FRAGMENT_CACHE_CNT];  //The recently decoded fragments
+    uint32_t fragment_use_cnt;
     uint8_t * workb;                    //JPG work buffer for jpeg library
     JDEC * tjpeg_jd;
     io_source_t io;
+#if LV_SJPG_DECODE_THREAD
+    JDEC * worker_jd;                   //Separate decoder, work buffer and file for the helper thread
+    uint8_t * worker_workb;
+    io_source_t worker_io;
+#endif
 } SJPEG;
 
 /**********************
@@ -108,15 +167,48 @@ static lv_res_t decoder_info(lv_img_decoder_t * decoder, const void * src, lv_im
 static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
 static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
                                   lv_coord_t len, uint8_t * buf);
+static lv_res_t decoder_read_area(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                  lv_coord_t w, lv_coord_t h, uint8_t * buf);
+static lv_res_t fragments_init(SJPEG * sjpeg);
+static const sjpeg_fragment_t * fragment_get(lv_img_decoder_dsc_t * dsc, int frame_index);
+static sjpeg_fragment_t * fragment_find(SJPEG * sjpeg, int frame_index);
+static sjpeg_fragment_t * fragment_alloc(SJPEG * sjpeg, const sjpeg_fragment_t * keep);
+static lv_res_t decode_fragment(SJPEG * sjpeg, JDEC * jd, uint8_t * workb, io_source_t * io, int frame_index,
+                                uint8_t * buf);
+static void convert_row(const uint8_t * cache, uint8_t * buf, lv_coord_t len);
 static void decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
 static size_t input_func(JDEC * jd, uint8_t * buff, size_t ndata);
 static int is_jpg(const uint8_t * raw_data, size_t len);
 static void lv_sjpg_cleanup(SJPEG * sjpeg);
 static void lv_sjpg_free(SJPEG * sjpeg);
+static uint32_t get_mem_size(const SJPEG * sjpeg);
+#if LV_SJPG_DECODE_THREAD
+    static void fragment_prefetch(lv_img_decoder_dsc_t * dsc, int frame_index);
+    static bool worker_init(void);
+    static void worker_wake(void);
+    static void worker_wait(SJPEG * sjpeg);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_SJPG_DECODE_THREAD
+/*The helper decodes one fragment at a time*/
+static SJPEG * worker_sjpeg;
+static sjpeg_fragment_t * worker_fragment;
+static bool worker_inited;
+static bool worker_init_failed;
+#if LV_SJPG_DECODE_FREERTOS
+static SemaphoreHandle_t lock;
+static SemaphoreHandle_t work_sem;
+static TaskHandle_t worker_task_handle;
+#else
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t worker_thread_handle;
+#endif
+#endif
 
 /**********************
  *      MACROS
@@ -132,6 +224,7 @@ void lv_split_jpeg_init(void)
     lv_img_decoder_set_open_cb(dec, decoder_open);
     lv_img_decoder_set_close_cb(dec, decoder_close);
     lv_img_decoder_set_read_line_cb(dec, decoder_read_line);
+    lv_img_decoder_set_read_area_cb(dec, decoder_read_area);
 }
 
 /**********************
@@ -394,14 +487,11 @@ static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t *
                 offset |= *data++ << 8;
                 sjpeg->frame_base_array[i] = sjpeg->frame_base_array[i - 1] + offset;
             }
-            sjpeg->sjpeg_cache_frame_index = -1;
-            sjpeg->frame_cache = (void *)lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3/*2*/);
-            if(! sjpeg->frame_cache) {
+            if(fragments_init(sjpeg) != LV_RES_OK) {
                 lv_sjpg_cleanup(sjpeg);
                 sjpeg = NULL;
                 return LV_RES_INV;
             }
-            sjpeg->io.img_cache_buff = sjpeg->frame_cache;
             sjpeg->io.img_cache_x_res = sjpeg->sjpeg_x_res;
             sjpeg->workb =   lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
             if(! sjpeg->workb) {
@@ -419,6 +509,7 @@ static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t *
             sjpeg->io.type = SJPEG_IO_SOURCE_C_ARRAY;
             sjpeg->io.lv_file.file_d = NULL;
             dsc->img_data = NULL;
+            dsc->mem_size = get_mem_size(sjpeg);
             return lv_ret;
         }
         else if(is_jpg(sjpeg->sjpeg_data, raw_sjpeg_data_size) == true) {
@@ -456,15 +547,12 @@ static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t *
                 uint8_t * img_frame_base = sjpeg->sjpeg_data;
                 sjpeg->frame_base_array[0] = img_frame_base;
 
-                sjpeg->sjpeg_cache_frame_index = -1;
-                sjpeg->frame_cache = (void *)lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3);
-                if(! sjpeg->frame_cache) {
+                if(fragments_init(sjpeg) != LV_RES_OK) {
                     lv_sjpg_cleanup(sjpeg);
                     sjpeg = NULL;
                     return LV_RES_INV;
                 }
 
-                sjpeg->io.img_cache_buff = sjpeg->frame_cache;
                 sjpeg->io.img_cache_x_res = sjpeg->sjpeg_x_res;
                 sjpeg->workb =   lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
                 if(! sjpeg->workb) {
@@ -483,6 +571,7 @@ static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t *
                 sjpeg->io.type = SJPEG_IO_SOURCE_C_ARRAY;
                 sjpeg->io.lv_file.file_d = NULL;
                 dsc->img_data = NULL;
+                dsc->mem_size = get_mem_size(sjpeg);
                 return lv_ret;
             }
             else {
@@ -573,14 +662,11 @@ end:
                     sjpeg->frame_base_offset[i] = sjpeg->frame_base_offset[i - 1] + offset;
                 }
 
-                sjpeg->sjpeg_cache_frame_index = -1; //INVALID AT BEGINNING for a forced compare mismatch at first time.
-                sjpeg->frame_cache = (void *)lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3);
-                if(! sjpeg->frame_cache) {
+                if(fragments_init(sjpeg) != LV_RES_OK) {
                     lv_fs_close(&lv_file);
                     lv_sjpg_cleanup(sjpeg);
                     return LV_RES_INV;
                 }
-                sjpeg->io.img_cache_buff = sjpeg->frame_cache;
                 sjpeg->io.img_cache_x_res = sjpeg->sjpeg_x_res;
                 sjpeg->workb =   lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
                 if(! sjpeg->workb) {
@@ -599,6 +685,7 @@ end:
                 sjpeg->io.type = SJPEG_IO_SOURCE_DISK;
                 sjpeg->io.lv_file = lv_file;
                 dsc->img_data = NULL;
+                dsc->mem_size = get_mem_size(sjpeg);
                 return LV_RES_OK;
             }
         }
@@ -660,15 +747,12 @@ end:
                 int img_frame_start_offset = 0;
                 sjpeg->frame_base_offset[0] = img_frame_start_offset;
 
-                sjpeg->sjpeg_cache_frame_index = -1;
-                sjpeg->frame_cache = (void *)lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3);
-                if(! sjpeg->frame_cache) {
+                if(fragments_init(sjpeg) != LV_RES_OK) {
                     lv_fs_close(&lv_file);
                     lv_sjpg_cleanup(sjpeg);
                     return LV_RES_INV;
                 }
 
-                sjpeg->io.img_cache_buff = sjpeg->frame_cache;
                 sjpeg->io.img_cache_x_res = sjpeg->sjpeg_x_res;
                 sjpeg->workb =   lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
                 if(! sjpeg->workb) {
@@ -687,6 +771,7 @@ end:
                 sjpeg->io.type = SJPEG_IO_SOURCE_DISK;
                 sjpeg->io.lv_file = lv_file;
                 dsc->img_data = NULL;
+                dsc->mem_size = get_mem_size(sjpeg);
                 return LV_RES_OK;
 
             }
@@ -715,143 +800,314 @@ end:
 
 static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
                                   lv_coord_t len, uint8_t * buf)
+{
+    return decoder_read_area(decoder, dsc, x, y, len, 1, buf);
+}
+
+/**
+ * Decode a `w` x `h` area starting from the given `x`, `y` coordinates and store it in `buf`.
+ * The fragment of the image is decoded again only when a row is in an other fragment.
+ * @param decoder pointer to the decoder the function associated with
+ * @param dsc pointer to decoder descriptor
+ * @param x start x coordinate
+ * @param y start y coordinate
+ * @param w width of the area
+ * @param h height of the area
+ * @param buf a buffer to store the decoded pixels
+ * @return LV_RES_OK: ok; LV_RES_INV: failed
+ */
+static lv_res_t decoder_read_area(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                  lv_coord_t w, lv_coord_t h, uint8_t * buf)
 {
     LV_UNUSED(decoder);
-    if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
-        SJPEG * sjpeg = (SJPEG *) dsc->user_data;
-        JRESULT rc;
+    SJPEG * sjpeg = (SJPEG *) dsc->user_data;
+    uint32_t stride = w * sizeof(lv_color_t);
+    const sjpeg_fragment_t * fragment = NULL;
 
-        int sjpeg_req_frame_index = y / sjpeg->sjpeg_single_frame_height;
+    lv_coord_t row;
+    for(row = y; row < y + h; row++) {
+        int sjpeg_req_frame_index = row / sjpeg->sjpeg_single_frame_height;
 
-        /*If line not from cache, refresh cache */
-        if(sjpeg_req_frame_index != sjpeg->sjpeg_cache_frame_index) {
-            sjpeg->io.raw_sjpg_data = sjpeg->frame_base_array[ sjpeg_req_frame_index ];
-            if(sjpeg_req_frame_index == (sjpeg->sjpeg_total_frames - 1)) {
-                /*This is the last frame. */
-                const uint32_t frame_offset = (uint32_t)(sjpeg->io.raw_sjpg_data - sjpeg->sjpeg_data);
-                sjpeg->io.raw_sjpg_data_size = sjpeg->sjpeg_data_size - frame_offset;
-            }
-            else {
-                sjpeg->io.raw_sjpg_data_size =
-                    (uint32_t)(sjpeg->frame_base_array[sjpeg_req_frame_index + 1] - sjpeg->io.raw_sjpg_data);
-            }
-            sjpeg->io.raw_sjpg_data_next_read_pos = 0;
-            rc = jd_prepare(sjpeg->tjpeg_jd, input_func, sjpeg->workb, (size_t)TJPGD_WORKBUFF_SIZE, &(sjpeg->io));
-            if(rc != JDR_OK) return LV_RES_INV;
-            rc = jd_decomp(sjpeg->tjpeg_jd, img_data_cb, 0);
-            if(rc != JDR_OK) return LV_RES_INV;
-            sjpeg->sjpeg_cache_frame_index = sjpeg_req_frame_index;
+        /*If line not from the current fragment, get it from the cache or decode it*/
+        if(fragment == NULL || fragment->frame_index != sjpeg_req_frame_index) {
+            fragment = fragment_get(dsc, sjpeg_req_frame_index);
+            if(fragment == NULL) return LV_RES_INV;
         }
 
-        int offset = 0;
-        uint8_t * cache = (uint8_t *)sjpeg->frame_cache + x * 3 + (y % sjpeg->sjpeg_single_frame_height) * sjpeg->sjpeg_x_res *
-                          3;
+        const uint8_t * cache = fragment->buf + x * 3 +
+                                (row % sjpeg->sjpeg_single_frame_height) * sjpeg->sjpeg_x_res * 3;
+        convert_row(cache, buf, w);
+        buf += stride;
+    }
 
-#if  LV_COLOR_DEPTH == 32
-        for(int i = 0; i < len; i++) {
-            buf[offset + 3] = 0xff;
-            buf[offset + 2] = *cache++;
-            buf[offset + 1] = *cache++;
-            buf[offset + 0] = *cache++;
-            offset += 4;
-        }
+    return LV_RES_OK;
+}
 
-#elif  LV_COLOR_DEPTH == 16
+/**
+ * Allocate the buffer of the first fragment and mark all the fragments empty
+ * @param sjpeg pointer to the image
+ * @return LV_RES_OK: ok; LV_RES_INV: out of memory
+ */
+static lv_res_t fragments_init(SJPEG * sjpeg)
+{
+    uint32_t i;
+    for(i = 0; i < LV_SJPG_FRAGMENT_CACHE_CNT; i++) {
+        sjpeg->fragments[i].frame_index = -1;
+        sjpeg->fragments[i].state = FRAGMENT_EMPTY;
+    }
 
-        for(int i = 0; i < len; i++) {
-            uint16_t col_16bit = (*cache++ & 0xf8) << 8;
-            col_16bit |= (*cache++ & 0xFC) << 3;
-            col_16bit |= (*cache++ >> 3);
-#if  LV_BIG_ENDIAN_SYSTEM == 1 || LV_COLOR_16_SWAP == 1
-            buf[offset++] = col_16bit >> 8;
-            buf[offset++] = col_16bit & 0xff;
-#else
-            buf[offset++] = col_16bit & 0xff;
-            buf[offset++] = col_16bit >> 8;
-#endif // LV_BIG_ENDIAN_SYSTEM
+    sjpeg->fragments[0].buf = lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3);
+    return sjpeg->fragments[0].buf ? LV_RES_OK : LV_RES_INV;
+}
+
+/**
+ * Get a decoded fragment from the cache or decode it now.
+ * With `LV_SJPG_DECODE_THREAD` the next fragment is decoded in the background meanwhile.
+ * @param dsc pointer to decoder descriptor
+ * @param frame_index index of the fragment
+ * @return the decoded fragment or NULL on error
+ */
+static const sjpeg_fragment_t * fragment_get(lv_img_decoder_dsc_t * dsc, int frame_index)
+{
+    SJPEG * sjpeg = (SJPEG *) dsc->user_data;
+
+    LOCK();
+    sjpeg_fragment_t * fragment = fragment_find(sjpeg, frame_index);
+#if LV_SJPG_DECODE_THREAD
+    if(fragment && fragment->state == FRAGMENT_DECODING) {
+        worker_wait(sjpeg);
+        if(fragment->state != FRAGMENT_READY) fragment = NULL;  /*Failed, try it here again*/
+    }
+#endif
+
+    if(fragment == NULL) {
+        fragment = fragment_alloc(sjpeg, NULL);
+#if LV_SJPG_DECODE_THREAD
+        /*All the other buffers are in use by the helper*/
+        if(fragment == NULL) {
+            worker_wait(sjpeg);
+            fragment = fragment_alloc(sjpeg, NULL);
         }
+#endif
+        UNLOCK();
+        if(fragment == NULL) return NULL;
 
-#elif  LV_COLOR_DEPTH == 8
+        /*Only this thread touches the empty fragments*/
+        lv_res_t res = decode_fragment(sjpeg, sjpeg->tjpeg_jd, sjpeg->workb, &sjpeg->io, frame_index, fragment->buf);
+        if(res != LV_RES_OK) return NULL;
+
+        LOCK();
+        fragment->frame_index = frame_index;
+        fragment->state = FRAGMENT_READY;
+    }
 
-        for(int i = 0; i < len; i++) {
-            uint8_t col_8bit = (*cache++ & 0xC0);
-            col_8bit |= (*cache++ & 0xe0) >> 2;
-            col_8bit |= (*cache++ & 0xe0) >> 5;
-            buf[offset++] = col_8bit;
+    fragment->last_use = ++sjpeg->fragment_use_cnt;
+    UNLOCK();
+
+#if LV_SJPG_DECODE_THREAD
+    /*The images are drawn from top to bottom so probably the next fragment will be needed soon*/
+    if(frame_index + 1 < sjpeg->sjpeg_total_frames) fragment_prefetch(dsc, frame_index + 1);
+#endif
+
+    return fragment;
+}
+
+/*Called with the lock held*/
+static sjpeg_fragment_t * fragment_find(SJPEG * sjpeg, int frame_index)
+{
+    uint32_t i;
+    for(i = 0; i < LV_SJPG_FRAGMENT_CACHE_CNT; i++) {
+        sjpeg_fragment_t * fragment = &sjpeg->fragments[i];
+        if(fragment->state != FRAGMENT_EMPTY && fragment->frame_index == frame_index) return fragment;
+    }
+
+    return NULL;
+}
+
+/**
+ * Get an empty fragment or drop the least recently used one. Called with the lock held.
+ * @param sjpeg pointer to the image
+ * @param keep don't drop this fragment (it's being read) or NULL
+ * @return an empty fragment with a buffer or NULL if there is none
+ */
+static sjpeg_fragment_t * fragment_alloc(SJPEG * sjpeg, const sjpeg_fragment_t * keep)
+{
+    /*Never use more buffers than fragments*/
+    uint32_t cnt = LV_MIN(LV_SJPG_FRAGMENT_CACHE_CNT, sjpeg->sjpeg_total_frames);
+
+    sjpeg_fragment_t * lru = NULL;
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        sjpeg_fragment_t * fragment = &sjpeg->fragments[i];
+        if(fragment == keep || fragment->state == FRAGMENT_DECODING) continue;
+
+        if(fragment->buf == NULL) {
+            fragment->buf = lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3);
+            if(fragment->buf == NULL) continue;
         }
-#else
-#error Unsupported LV_COLOR_DEPTH
 
-#endif // LV_COLOR_DEPTH
-        return LV_RES_OK;
+        if(fragment->state == FRAGMENT_EMPTY) return fragment;
+        if(lru == NULL || fragment->last_use < lru->last_use) lru = fragment;
     }
-    else if(dsc->src_type == LV_IMG_SRC_FILE) {
-        SJPEG * sjpeg = (SJPEG *) dsc->user_data;
-        JRESULT rc;
-        int sjpeg_req_frame_index = y / sjpeg->sjpeg_single_frame_height;
 
-        lv_fs_file_t * lv_file_p = &(sjpeg->io.lv_file);
-        if(!lv_file_p) goto end;
+    if(lru) {
+        lru->state = FRAGMENT_EMPTY;
+        lru->frame_index = -1;
+    }
 
-        /*If line not from cache, refresh cache */
-        if(sjpeg_req_frame_index != sjpeg->sjpeg_cache_frame_index) {
-            sjpeg->io.raw_sjpg_data_next_read_pos = (int)(sjpeg->frame_base_offset [ sjpeg_req_frame_index ]);
-            lv_fs_seek(&(sjpeg->io.lv_file), sjpeg->io.raw_sjpg_data_next_read_pos, LV_FS_SEEK_SET);
+    return lru;
+}
 
-            rc = jd_prepare(sjpeg->tjpeg_jd, input_func, sjpeg->workb, (size_t)TJPGD_WORKBUFF_SIZE, &(sjpeg->io));
-            if(rc != JDR_OK) return LV_RES_INV;
+/**
+ * Decode a fragment of the image
+ * @param sjpeg pointer to the image
+ * @param jd the decoder to use
+ * @param workb work buffer of the decoder
+ * @param io the source of the decoder
+ * @param frame_index index of the fragment
+ * @param buf store the RGB888 pixels here
+ * @return LV_RES_OK: ok; LV_RES_INV: failed
+ */
+static lv_res_t decode_fragment(SJPEG * sjpeg, JDEC * jd, uint8_t * workb, io_source_t * io, int frame_index,
+                                uint8_t * buf)
+{
+    JRESULT rc;
+
+    if(io->type == SJPEG_IO_SOURCE_C_ARRAY) {
+        io->raw_sjpg_data = sjpeg->frame_base_array[ frame_index ];
+        if(frame_index == (sjpeg->sjpeg_total_frames - 1)) {
+            /*This is the last frame. */
+            const uint32_t frame_offset = (uint32_t)(io->raw_sjpg_data - sjpeg->sjpeg_data);
+            io->raw_sjpg_data_size = sjpeg->sjpeg_data_size - frame_offset;
+        }
+        else {
+            io->raw_sjpg_data_size =
+                (uint32_t)(sjpeg->frame_base_array[frame_index + 1] - io->raw_sjpg_data);
+        }
+        io->raw_sjpg_data_next_read_pos = 0;
+    }
+    else {
+        io->raw_sjpg_data_next_read_pos = (int)(sjpeg->frame_base_offset [ frame_index ]);
+        lv_fs_seek(&(io->lv_file), io->raw_sjpg_data_next_read_pos, LV_FS_SEEK_SET);
+    }
+
+    io->img_cache_buff = buf;
+    rc = jd_prepare(jd, input_func, workb, (size_t)TJPGD_WORKBUFF_SIZE, io);
+    if(rc != JDR_OK) return LV_RES_INV;
+    rc = jd_decomp(jd, img_data_cb, 0);
+    if(rc != JDR_OK) return LV_RES_INV;
+
+    return LV_RES_OK;
+}
+
+#if LV_SJPG_DECODE_THREAD
+/**
+ * Let the helper decode a fragment if it's idle and the fragment is not cached yet
+ * @param dsc pointer to decoder descriptor
+ * @param frame_index index of the fragment
+ */
+static void fragment_prefetch(lv_img_decoder_dsc_t * dsc, int frame_index)
+{
+    SJPEG * sjpeg = (SJPEG *) dsc->user_data;
+    if(!worker_init()) return;
 
-            rc = jd_decomp(sjpeg->tjpeg_jd, img_data_cb, 0);
-            if(rc != JDR_OK) return LV_RES_INV;
+    LOCK();
+    if(worker_sjpeg != NULL || fragment_find(sjpeg, frame_index)) {
+        UNLOCK();
+        return;
+    }
 
-            sjpeg->sjpeg_cache_frame_index = sjpeg_req_frame_index;
+    /*The helper is idle so it doesn't use the context of this image now*/
+    if(sjpeg->worker_jd == NULL) {
+        sjpeg->worker_jd = lv_mem_alloc(sizeof(JDEC));
+        sjpeg->worker_workb = lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
+        sjpeg->worker_io = sjpeg->io;
+        sjpeg->worker_io.lv_file.file_d = NULL;
+        bool ok = sjpeg->worker_jd && sjpeg->worker_workb;
+        if(ok && sjpeg->io.type == SJPEG_IO_SOURCE_DISK) {
+            ok = lv_fs_open(&sjpeg->worker_io.lv_file, dsc->src, LV_FS_MODE_RD) == LV_FS_RES_OK;
+            if(!ok) sjpeg->worker_io.lv_file.file_d = NULL;
         }
 
-        int offset = 0;
-        uint8_t * cache = (uint8_t *)sjpeg->frame_cache + x * 3 + (y % sjpeg->sjpeg_single_frame_height) * sjpeg->sjpeg_x_res *
-                          3;
-
-#if LV_COLOR_DEPTH == 32
-        for(int i = 0; i < len; i++) {
-            buf[offset + 3] = 0xff;
-            buf[offset + 2] = *cache++;
-            buf[offset + 1] = *cache++;
-            buf[offset + 0] = *cache++;
-            offset += 4;
+        if(!ok) {
+            if(sjpeg->worker_jd) lv_mem_free(sjpeg->worker_jd);
+            if(sjpeg->worker_workb) lv_mem_free(sjpeg->worker_workb);
+            sjpeg->worker_jd = NULL;
+            sjpeg->worker_workb = NULL;
+            UNLOCK();
+            return;
         }
+    }
+
+    /*Keep the most recently used fragment, it's being read*/
+    const sjpeg_fragment_t * keep = NULL;
+    uint32_t i;
+    for(i = 0; i < LV_SJPG_FRAGMENT_CACHE_CNT; i++) {
+        if(keep == NULL || sjpeg->fragments[i].last_use > keep->last_use) keep = &sjpeg->fragments[i];
+    }
+
+    sjpeg_fragment_t * fragment = fragment_alloc(sjpeg, keep);
+    if(fragment == NULL) {
+        UNLOCK();
+        return;
+    }
+
+    fragment->frame_index = frame_index;
+    fragment->state = FRAGMENT_DECODING;
+    worker_sjpeg = sjpeg;
+    worker_fragment = fragment;
+    UNLOCK();
+
+    worker_wake();
+}
+#endif
+
+/**
+ * Convert `len` RGB888 pixels of the frame cache to the current color format
+ * @param cache the first pixel in the frame cache
+ * @param buf store the converted pixels here
+ * @param len number of pixels
+ */
+static void convert_row(const uint8_t * cache, uint8_t * buf, lv_coord_t len)
+{
+    int offset = 0;
+
+#if  LV_COLOR_DEPTH == 32
+    for(int i = 0; i < len; i++) {
+        buf[offset + 3] = 0xff;
+        buf[offset + 2] = *cache++;
+        buf[offset + 1] = *cache++;
+        buf[offset + 0] = *cache++;
+        offset += 4;
+    }
+
 #elif  LV_COLOR_DEPTH == 16
 
-        for(int i = 0; i < len; i++) {
-            uint16_t col_8bit = (*cache++ & 0xf8) << 8;
-            col_8bit |= (*cache++ & 0xFC) << 3;
-            col_8bit |= (*cache++ >> 3);
+    for(int i = 0; i < len; i++) {
+        uint16_t col_16bit = (*cache++ & 0xf8) << 8;
+        col_16bit |= (*cache++ & 0xFC) << 3;
+        col_16bit |= (*cache++ >> 3);
 #if  LV_BIG_ENDIAN_SYSTEM == 1 || LV_COLOR_16_SWAP == 1
-            buf[offset++] = col_8bit >> 8;
-            buf[offset++] = col_8bit & 0xff;
+        buf[offset++] = col_16bit >> 8;
+        buf[offset++] = col_16bit & 0xff;
 #else
-            buf[offset++] = col_8bit & 0xff;
-            buf[offset++] = col_8bit >> 8;
+        buf[offset++] = col_16bit & 0xff;
+        buf[offset++] = col_16bit >> 8;
 #endif // LV_BIG_ENDIAN_SYSTEM
-        }
+    }
 
 #elif  LV_COLOR_DEPTH == 8
 
-        for(int i = 0; i < len; i++) {
-            uint8_t col_8bit = (*cache++ & 0xC0);
-            col_8bit |= (*cache++ & 0xe0) >> 2;
-            col_8bit |= (*cache++ & 0xe0) >> 5;
-            buf[offset++] = col_8bit;
-        }
-
+    for(int i = 0; i < len; i++) {
+        uint8_t col_8bit = (*cache++ & 0xC0);
+        col_8bit |= (*cache++ & 0xe0) >> 2;
+        col_8bit |= (*cache++ & 0xe0) >> 5;
+        buf[offset++] = col_8bit;
+    }
 #else
 #error Unsupported LV_COLOR_DEPTH
 
 #endif // LV_COLOR_DEPTH
-
-        return LV_RES_OK;
-    }
-end:
-    return LV_RES_INV;
 }
 
 /**
@@ -866,6 +1122,13 @@ static void decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc
     SJPEG * sjpeg = (SJPEG *) dsc->user_data;
     if(!sjpeg) return;
 
+#if LV_SJPG_DECODE_THREAD
+    /*Let the helper finish with this image*/
+    LOCK();
+    worker_wait(sjpeg);
+    UNLOCK();
+#endif
+
     switch(dsc->src_type) {
         case LV_IMG_SRC_FILE:
             if(sjpeg->io.lv_file.file_d) {
@@ -892,13 +1155,38 @@ static int is_jpg(const uint8_t * raw_data, size_t len)
 
 static void lv_sjpg_free(SJPEG * sjpeg)
 {
-    if(sjpeg->frame_cache) lv_mem_free(sjpeg->frame_cache);
+    uint32_t i;
+    for(i = 0; i < LV_SJPG_FRAGMENT_CACHE_CNT; i++) {
+        if(sjpeg->fragments[i].buf) lv_mem_free(sjpeg->fragments[i].buf);
+    }
+#if LV_SJPG_DECODE_THREAD
+    if(sjpeg->worker_io.lv_file.file_d) lv_fs_close(&sjpeg->worker_io.lv_file);
+    if(sjpeg->worker_jd) lv_mem_free(sjpeg->worker_jd);
+    if(sjpeg->worker_workb) lv_mem_free(sjpeg->worker_workb);
+#endif
     if(sjpeg->frame_base_array) lv_mem_free(sjpeg->frame_base_array);
     if(sjpeg->frame_base_offset) lv_mem_free(sjpeg->frame_base_offset);
     if(sjpeg->tjpeg_jd) lv_mem_free(sjpeg->tjpeg_jd);
     if(sjpeg->workb) lv_mem_free(sjpeg->workb);
 }
 
+/**
+ * Get the memory used to decode an image: the work buffers, the fragment cache and the offsets of the fragments
+ * @param sjpeg pointer to the image
+ * @return the size in bytes
+ */
+static uint32_t get_mem_size(const SJPEG * sjpeg)
+{
+    uint32_t fragment_cnt = LV_MIN(LV_SJPG_FRAGMENT_CACHE_CNT, sjpeg->sjpeg_total_frames);
+    uint32_t size = sizeof(SJPEG) + sizeof(JDEC) + TJPGD_WORKBUFF_SIZE;
+    size += fragment_cnt * sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3;
+    if(sjpeg->frame_base_array || sjpeg->frame_base_offset) size += sjpeg->sjpeg_total_frames * sizeof(uint8_t *);
+#if LV_SJPG_DECODE_THREAD
+    size += sizeof(JDEC) + TJPGD_WORKBUFF_SIZE;
+#endif
+    return size;
+}
+
 static void lv_sjpg_cleanup(SJPEG * sjpeg)
 {
     if(! sjpeg) return;
@@ -907,4 +1195,136 @@ static void lv_sjpg_cleanup(SJPEG * sjpeg)
     lv_mem_free(sjpeg);
 }
 
+#if LV_SJPG_DECODE_THREAD && LV_SJPG_DECODE_FREERTOS
+
+static void worker_task(void * param)
+{
+    LV_UNUSED(param);
+    while(1) {
+        LOCK();
+        SJPEG * sjpeg = worker_sjpeg;
+        sjpeg_fragment_t * fragment = worker_fragment;
+        UNLOCK();
+        if(sjpeg == NULL) {
+            xSemaphoreTake(work_sem, portMAX_DELAY);
+            continue;
+        }
+
+        lv_res_t res = decode_fragment(sjpeg, sjpeg->worker_jd, sjpeg->worker_workb, &sjpeg->worker_io,
+                                       fragment->frame_index, fragment->buf);
+
+        LOCK();
+        fragment->state = res == LV_RES_OK ? FRAGMENT_READY : FRAGMENT_EMPTY;
+        if(res != LV_RES_OK) fragment->frame_index = -1;
+        worker_sjpeg = NULL;
+        UNLOCK();
+    }
+}
+
+static bool worker_init(void)
+{
+    if(worker_inited) return true;
+    if(worker_init_failed) return false;
+
+    lock = xSemaphoreCreateMutex();
+    work_sem = xSemaphoreCreateBinary();
+    if(lock == NULL || work_sem == NULL) {
+        LV_LOG_WARN("couldn't create the semaphores of the SJPG decoder task. Decoding the fragments while drawing.");
+        worker_init_failed = true;
+        return false;
+    }
+
+    BaseType_t res;
+#if defined(ESP_PLATFORM) && LV_SJPG_DECODE_CORE >= 0
+    res = xTaskCreatePinnedToCore(worker_task, "lv_sjpg_dec", LV_SJPG_DECODE_STACK_SIZE, NULL,
+                                  LV_SJPG_DECODE_TASK_PRIO, &worker_task_handle, LV_SJPG_DECODE_CORE);
+#else
+    res = xTaskCreate(worker_task, "lv_sjpg_dec", LV_SJPG_DECODE_STACK_SIZE, NULL,
+                      LV_SJPG_DECODE_TASK_PRIO, &worker_task_handle);
+#endif
+    if(res != pdPASS) {
+        LV_LOG_WARN("couldn't create the SJPG decoder task. Decoding the fragments while drawing.");
+        worker_init_failed = true;
+        return false;
+    }
+
+    worker_inited = true;
+    return true;
+}
+
+static void worker_wake(void)
+{
+    xSemaphoreGive(work_sem);
+}
+
+/*Called with the lock held*/
+static void worker_wait(SJPEG * sjpeg)
+{
+    while(worker_sjpeg == sjpeg) {
+        UNLOCK();
+        vTaskDelay(1);
+        LOCK();
+    }
+}
+
+#elif LV_SJPG_DECODE_THREAD
+
+static void * worker_thread(void * param)
+{
+    LV_UNUSED(param);
+    LOCK();
+    while(1) {
+        SJPEG * sjpeg = worker_sjpeg;
+        sjpeg_fragment_t * fragment = worker_fragment;
+        if(sjpeg == NULL) {
+            pthread_cond_wait(&work_cond, &lock);
+            continue;
+        }
+        UNLOCK();
+
+        lv_res_t res = decode_fragment(sjpeg, sjpeg->worker_jd, sjpeg->worker_workb, &sjpeg->worker_io,
+                                       fragment->frame_index, fragment->buf);
+
+        LOCK();
+        fragment->state = res == LV_RES_OK ? FRAGMENT_READY : FRAGMENT_EMPTY;
+        if(res != LV_RES_OK) fragment->frame_index = -1;
+        worker_sjpeg = NULL;
+        pthread_cond_broadcast(&done_cond);
+    }
+
+    return NULL;
+}
+
+static bool worker_init(void)
+{
+    if(worker_inited) return true;
+    if(worker_init_failed) return false;
+
+    if(pthread_create(&worker_thread_handle, NULL, worker_thread, NULL) != 0) {
+        LV_LOG_WARN("couldn't create the SJPG decoder thread. Decoding the fragments while drawing.");
+        worker_init_failed = true;
+        return false;
+    }
+
+    worker_inited = true;
+    return true;
+}
+
+static void worker_wake(void)
+{
+    LOCK();
+    pthread_cond_signal(&work_cond);
+    UNLOCK();
+}
+
+/*Called with the lock held*/
+static void worker_wait(SJPEG * sjpeg)
+{
+    while(worker_sjpeg == sjpeg) {
+        pthread_cond_wait(&done_cond, &lock);
+    }
+}
+
+#endif /*LV_SJPG_DECODE_THREAD*/
+
 #endif /*LV_USE_SJPG*/
@@ -34,11 +34,12 @@ static void pinyin_input_proc(lv_obj_t * obj);
 static void pinyin_page_proc(lv_obj_t * obj, uint16_t btn);
 static char * pinyin_search_matching(lv_obj_t * obj, char * py_str, uint16_t * cand_num);
 static void pinyin_ime_clear_data(lv_obj_t * obj);
+static const lv_pinyin_dict_t * dict_get_entry(lv_ime_pinyin_t * pinyin_ime, uint32_t i);
+static bool dict_narrow(lv_ime_pinyin_t * pinyin_ime, uint32_t depth, char c, uint32_t * start, uint32_t * end);
 
 #if LV_IME_PINYIN_USE_K9_MODE
     static void pinyin_k9_init_data(lv_obj_t * obj);
     static void pinyin_k9_get_legal_py(lv_obj_t * obj, char * k9_input, const char * py9_map[]);
-    static bool pinyin_k9_is_valid_py(lv_obj_t * obj, char * py_str);
     static void pinyin_k9_fill_cand(lv_obj_t * obj);
     static void pinyin_k9_cand_page_proc(lv_obj_t * obj, uint16_t dir);
 #endif
@@ -57,14 +58,14 @@ const lv_obj_class_t lv_ime_pinyin_class = {
 };
 
 #if LV_IME_PINYIN_USE_K9_MODE
-static char * lv_btnm_def_pinyin_k9_map[LV_IME_PINYIN_K9_CAND_TEXT_NUM + 20] = {\
+static char * lv_btnm_def_pinyin_k9_map[LV_IME_PINYIN_K9_CAND_TEXT_NUM + 21] = {\
                                                                                 ",\0", "1#\0",  "abc \0", "def\0",  LV_SYMBOL_BACKSPACE"\0", "\n\0",
                                                                                 ".\0", "ghi\0", "jkl\0", "mno\0",  LV_SYMBOL_KEYBOARD"\0", "\n\0",
                                                                                 "?\0", "pqrs\0", "tuv\0", "wxyz\0",  LV_SYMBOL_NEW_LINE"\0", "\n\0",
                                                                                 LV_SYMBOL_LEFT"\0", "\0"
                                                                                };
 
-static lv_btnmatrix_ctrl_t default_kb_ctrl_k9_map[LV_IME_PINYIN_K9_CAND_TEXT_NUM + 16] = { 1 };
+static lv_btnmatrix_ctrl_t default_kb_ctrl_k9_map[LV_IME_PINYIN_K9_CAND_TEXT_NUM + 17] = { 1 };
 static char   lv_pinyin_k9_cand_str[LV_IME_PINYIN_K9_CAND_TEXT_NUM + 2][LV_IME_PINYIN_K9_MAX_INPUT] = {0};
 #endif
 
@@ -215,9 +216,9 @@ lv_pinyin_dict_t lv_ime_pinyin_def_dict[] = {
     { "ling", "另令領" },
     { "liu", "六留流" },
     { "lu", "律路録緑陸履慮" },
-    { "lv", "旅" },
     { "lun", "輪論" },
     { "luo", "落絡" },
+    { "lv", "旅" },
     { "ma", "媽嗎嘛" },
     { "mai", "買売" },
     { "man", "滿" },
@@ -252,13 +253,13 @@ lv_pinyin_dict_t lv_ime_pinyin_def_dict[] = {
     { "o", "" },
     { "ou", "歐" },
     { "pa", "怕" },
-    { "pian", "片便" },
     { "pai", "迫派排" },
     { "pan", "判番" },
     { "pang", "旁" },
     { "pei", "配" },
     { "peng", "朋" },
     { "pi", "疲否" },
+    { "pian", "片便" },
     { "pin", "品貧" },
     { "ping", "平評" },
     { "po", "迫破泊頗" },
@@ -390,10 +391,10 @@ lv_pinyin_dict_t lv_ime_pinyin_def_dict[] = {
     { "zhuo", "着" },
     { "zi", "子自字姉資" },
     { "zong", "總" },
-    { "zuo", "左做昨坐座作" },
+    { "zou", "走" },
     { "zu", "足祖族卒組" },
     { "zui", "最酔" },
-    { "zou", "走" },
+    { "zuo", "左做昨坐座作" },
     {NULL, NULL}
 };
 #endif
@@ -438,6 +439,8 @@ void lv_ime_pinyin_set_keyboard(lv_obj_t * obj, lv_obj_t * kb)
 
 /**
  * Set the dictionary of Pinyin input method.
+ * If the entries are not sorted by their pinyin, a sorted index of them is allocated.
+ * An unsorted dictionary with more than 65535 entries is rejected and the current dictionary is kept.
  * @param obj  pointer to a Pinyin input method object
  * @param dict pointer to a Pinyin input method dictionary
  */
@@ -465,8 +468,8 @@ void lv_ime_pinyin_set_mode(lv_obj_t * obj, lv_ime_pinyin_mode_t mode)
 #if LV_IME_PINYIN_USE_K9_MODE
     if(pinyin_ime->mode == LV_IME_PINYIN_MODE_K9) {
         pinyin_k9_init_data(obj);
-        lv_keyboard_set_map(pinyin_ime->kb, LV_KEYBOARD_MODE_USER_1, (const char *)lv_btnm_def_pinyin_k9_map,
-                            (const)default_kb_ctrl_k9_map);
+        lv_keyboard_set_map(pinyin_ime->kb, LV_KEYBOARD_MODE_USER_1, (const char **)lv_btnm_def_pinyin_k9_map,
+                            default_kb_ctrl_k9_map);
         lv_keyboard_set_mode(pinyin_ime->kb, LV_KEYBOARD_MODE_USER_1);
     }
 #endif
@@ -557,8 +560,9 @@ static void lv_ime_pinyin_constructor(const lv_obj_class_t * class_p, lv_obj_t *
     pinyin_ime->ta_count = 0;
     pinyin_ime->cand_num = 0;
     lv_memset_00(pinyin_ime->input_char, sizeof(pinyin_ime->input_char));
-    lv_memset_00(pinyin_ime->py_num, sizeof(pinyin_ime->py_num));
-    lv_memset_00(pinyin_ime->py_pos, sizeof(pinyin_ime->py_pos));
+    pinyin_ime->dict = NULL;
+    pinyin_ime->dict_index = NULL;
+    pinyin_ime->dict_num = 0;
 
     lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
 
@@ -625,6 +629,13 @@ static void lv_ime_pinyin_destructor(const lv_obj_class_t * class_p, lv_obj_t *
 
     if(lv_obj_is_valid(pinyin_ime->cand_panel))
         lv_obj_del(pinyin_ime->cand_panel);
+
+    if(pinyin_ime->dict_index)
+        lv_mem_free(pinyin_ime->dict_index);
+
+#if LV_IME_PINYIN_USE_K9_MODE
+    _lv_ll_clear(&pinyin_ime->k9_legal_py_ll);
+#endif
 }
 
 static void lv_ime_pinyin_kb_event(lv_event_t * e)
@@ -712,10 +723,10 @@ static void lv_ime_pinyin_kb_event(lv_event_t * e)
         }
         else if(strcmp(txt, LV_SYMBOL_KEYBOARD) == 0) {
             if(pinyin_ime->mode == LV_IME_PINYIN_MODE_K26) {
-                lv_ime_pinyin_set_mode(pinyin_ime, LV_IME_PINYIN_MODE_K9);
+                lv_ime_pinyin_set_mode(obj, LV_IME_PINYIN_MODE_K9);
             }
             else {
-                lv_ime_pinyin_set_mode(pinyin_ime, LV_IME_PINYIN_MODE_K26);
+                lv_ime_pinyin_set_mode(obj, LV_IME_PINYIN_MODE_K26);
                 lv_keyboard_set_mode(pinyin_ime->kb, LV_KEYBOARD_MODE_TEXT_LOWER);
             }
             pinyin_ime_clear_data(obj);
@@ -867,71 +878,121 @@ static void init_pinyin_dict(lv_obj_t * obj, lv_pinyin_dict_t * dict)
 {
     lv_ime_pinyin_t * pinyin_ime = (lv_ime_pinyin_t *)obj;
 
-    char headletter = 'a';
-    uint16_t offset_sum = 0;
-    uint16_t offset_count = 0;
-    uint16_t letter_calc = 0;
+    uint32_t num = 0;
+    bool sorted = true;
+    while(dict[num].py != NULL && dict[num].py_mb != NULL) {
+        if(num > 0 && strcmp(dict[num - 1].py, dict[num].py) > 0) sorted = false;
+        num++;
+    }
 
-    pinyin_ime->dict = dict;
+    /*The index can't address more entries. Keep the current dictionary instead of having no candidates at all.*/
+    if(!sorted && num > UINT16_MAX) {
+        LV_LOG_ERROR("The dictionary is not sorted and has more than %d entries. Sort it by pinyin to use it.",
+                     UINT16_MAX);
+        return;
+    }
 
-    for(uint16_t i = 0; ; i++) {
-        if((NULL == (dict[i].py)) || (NULL == (dict[i].py_mb))) {
-            headletter = dict[i - 1].py[0];
-            letter_calc = headletter - 'a';
-            pinyin_ime->py_num[letter_calc] = offset_count;
-            break;
-        }
+    if(pinyin_ime->dict_index) {
+        lv_mem_free(pinyin_ime->dict_index);
+        pinyin_ime->dict_index = NULL;
+    }
 
-        if(headletter == (dict[i].py[0])) {
-            offset_count++;
-        }
-        else {
-            headletter = dict[i].py[0];
-            letter_calc = headletter - 'a';
-            pinyin_ime->py_num[letter_calc - 1] = offset_count;
-            offset_sum += offset_count;
-            pinyin_ime->py_pos[letter_calc] = offset_sum;
+    pinyin_ime->dict = dict;
+    pinyin_ime->dict_num = 0;
+
+    /*A sorted dictionary is searched directly so it can stay in flash*/
+    if(sorted) {
+        pinyin_ime->dict_num = num;
+        return;
+    }
 
-            offset_count = 1;
+    uint16_t * index = lv_mem_alloc(num * sizeof(uint16_t));
+    LV_ASSERT_MALLOC(index);
+    if(index == NULL) return;
+
+    for(uint32_t i = 0; i < num; i++) index[i] = i;
+
+    /*Shell sort to not need an extra buffer or recursion*/
+    uint32_t gap;
+    for(gap = num / 2; gap > 0; gap /= 2) {
+        for(uint32_t i = gap; i < num; i++) {
+            uint16_t tmp = index[i];
+            uint32_t j = i;
+            while(j >= gap && strcmp(dict[index[j - gap]].py, dict[tmp].py) > 0) {
+                index[j] = index[j - gap];
+                j -= gap;
+            }
+            index[j] = tmp;
         }
     }
+
+    pinyin_ime->dict_index = index;
+    pinyin_ime->dict_num = num;
 }
 
 static char * pinyin_search_matching(lv_obj_t * obj, char * py_str, uint16_t * cand_num)
 {
     lv_ime_pinyin_t * pinyin_ime = (lv_ime_pinyin_t *)obj;
 
-    lv_pinyin_dict_t * cpHZ;
-    uint8_t index, len = 0, offset;
-    volatile uint8_t count = 0;
-
     if(*py_str == '\0')    return NULL;
     if(*py_str == 'i')     return NULL;
     if(*py_str == 'u')     return NULL;
     if(*py_str == 'v')     return NULL;
 
-    offset = py_str[0] - 'a';
-    len = strlen(py_str);
+    /*The entries starting with `py_str` are next to each other in the sorted dictionary*/
+    uint32_t start = 0;
+    uint32_t end = pinyin_ime->dict_num;
+    for(uint32_t i = 0; py_str[i] != '\0'; i++) {
+        if(!dict_narrow(pinyin_ime, i, py_str[i], &start, &end)) return NULL;
+    }
 
-    cpHZ  = &pinyin_ime->dict[pinyin_ime->py_pos[offset]];
-    count = pinyin_ime->py_num[offset];
+    /*The first one is the shortest, i.e. the perfect match if there is any*/
+    const lv_pinyin_dict_t * cpHZ = dict_get_entry(pinyin_ime, start);
 
-    while(count--) {
-        for(index = 0; index < len; index++) {
-            if(*(py_str + index) != *((cpHZ->py) + index)) {
-                break;
-            }
-        }
+    // The Chinese character in UTF-8 encoding format is 3 bytes
+    *cand_num = strlen((const char *)(cpHZ->py_mb)) / 3;
+    return (char *)(cpHZ->py_mb);
+}
 
-        // perfect match
-        if(len == 1 || index == len) {
-            // The Chinese character in UTF-8 encoding format is 3 bytes
-            * cand_num = strlen((const char *)(cpHZ->py_mb)) / 3;
-            return (char *)(cpHZ->py_mb);
-        }
-        cpHZ++;
+static const lv_pinyin_dict_t * dict_get_entry(lv_ime_pinyin_t * pinyin_ime, uint32_t i)
+{
+    if(pinyin_ime->dict_index) i = pinyin_ime->dict_index[i];
+    return &pinyin_ime->dict[i];
+}
+
+/**
+ * Narrow a range of the sorted entries whose first `depth` letters are the same
+ * to the entries having `c` as the next letter.
+ * @param pinyin_ime    pointer to a Pinyin input method object
+ * @param depth         number of letters which are the same in the range
+ * @param c             the next letter
+ * @param start         index of the first entry of the range. Updated to the first entry of the new range.
+ * @param end           index after the last entry of the range. Updated to the end of the new range.
+ * @return              true: the new range is not empty
+ */
+static bool dict_narrow(lv_ime_pinyin_t * pinyin_ime, uint32_t depth, char c, uint32_t * start, uint32_t * end)
+{
+    /*The letter at `depth` is ordered in the range. It's `\0` for the entries of `depth` length*/
+    uint8_t key = (uint8_t)c;
+    uint32_t lo = *start;
+    uint32_t hi = *end;
+    while(lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if((uint8_t)dict_get_entry(pinyin_ime, mid)->py[depth] < key) lo = mid + 1;
+        else hi = mid;
+    }
+
+    uint32_t first = lo;
+    hi = *end;
+    while(lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if((uint8_t)dict_get_entry(pinyin_ime, mid)->py[depth] <= key) lo = mid + 1;
+        else hi = mid;
     }
-    return NULL;
+
+    *start = first;
+    *end = lo;
+    return first < lo;
 }
 
 static void pinyin_ime_clear_data(lv_obj_t * obj)
@@ -960,7 +1021,7 @@ static void pinyin_ime_clear_data(lv_obj_t * obj)
 #if LV_IME_PINYIN_USE_K9_MODE
 static void pinyin_k9_init_data(lv_obj_t * obj)
 {
-    lv_ime_pinyin_t * pinyin_ime = (lv_ime_pinyin_t *)obj;
+    LV_UNUSED(obj);
 
     uint16_t py_str_i = 0;
     uint16_t btnm_i = 0;
@@ -1000,10 +1061,13 @@ static void pinyin_k9_get_legal_py(lv_obj_t * obj, char * k9_input, const char *
     }
 
     char py_comp[LV_IME_PINYIN_K9_MAX_INPUT] = {0};
-    int mark[LV_IME_PINYIN_K9_MAX_INPUT] = {0};
+    uint32_t mark[LV_IME_PINYIN_K9_MAX_INPUT] = {0};
+    /*The range of the dictionary entries starting with the first `index` letters of `py_comp`*/
+    uint32_t range_start[LV_IME_PINYIN_K9_MAX_INPUT + 1];
+    uint32_t range_end[LV_IME_PINYIN_K9_MAX_INPUT + 1];
     int index = 0;
-    int flag = 0;
-    int count = 0;
+    uint32_t flag = 0;
+    uint32_t count = 0;
 
     uint32_t ll_len = 0;
     ime_pinyin_k9_py_str_t * ll_index = NULL;
@@ -1011,27 +1075,36 @@ static void pinyin_k9_get_legal_py(lv_obj_t * obj, char * k9_input, const char *
     ll_len = _lv_ll_get_len(&pinyin_ime->k9_legal_py_ll);
     ll_index = _lv_ll_get_head(&pinyin_ime->k9_legal_py_ll);
 
+    range_start[0] = 0;
+    range_end[0] = pinyin_ime->dict_num;
+
+    /*Walk the letters of the keys but skip the combinations which are not the beginning of any pinyin*/
     while(index != -1) {
         if(index == len) {
-            if(pinyin_k9_is_valid_py(obj, py_comp)) {
-                if((count >= ll_len) || (ll_len == 0)) {
-                    ll_index = _lv_ll_ins_tail(&pinyin_ime->k9_legal_py_ll);
-                    strcpy(ll_index->py_str, py_comp);
-                }
-                else if((count < ll_len)) {
-                    strcpy(ll_index->py_str, py_comp);
-                    ll_index = _lv_ll_get_next(&pinyin_ime->k9_legal_py_ll, ll_index);
-                }
-                count++;
+            if((count >= ll_len) || (ll_len == 0)) {
+                ll_index = _lv_ll_ins_tail(&pinyin_ime->k9_legal_py_ll);
+                strcpy(ll_index->py_str, py_comp);
             }
+            else if((count < ll_len)) {
+                strcpy(ll_index->py_str, py_comp);
+                ll_index = _lv_ll_get_next(&pinyin_ime->k9_legal_py_ll, ll_index);
+            }
+            count++;
             index--;
         }
         else {
             flag = mark[index];
             if(flag < strlen(py9_map[k9_input[index] - '2'])) {
-                py_comp[index] = py9_map[k9_input[index] - '2'][flag];
+                char c = py9_map[k9_input[index] - '2'][flag];
                 mark[index] = mark[index] + 1;
-                index++;
+                range_start[index + 1] = range_start[index];
+                range_end[index + 1] = range_end[index];
+                /*No pinyin starts with these letters*/
+                if(index == 0 && (c == 'i' || c == 'u' || c == 'v')) continue;
+                if(dict_narrow(pinyin_ime, index, c, &range_start[index + 1], &range_end[index + 1])) {
+                    py_comp[index] = c;
+                    index++;
+                }
             }
             else {
                 mark[index] = 0;
@@ -1046,43 +1119,6 @@ static void pinyin_k9_get_legal_py(lv_obj_t * obj, char * k9_input, const char *
     }
 }
 
-/*true: visible; false: not visible*/
-static bool pinyin_k9_is_valid_py(lv_obj_t * obj, char * py_str)
-{
-    lv_ime_pinyin_t * pinyin_ime = (lv_ime_pinyin_t *)obj;
-
-    lv_pinyin_dict_t * cpHZ = NULL;
-    uint8_t index = 0, len = 0, offset = 0;
-    uint16_t ret = 1;
-    volatile uint8_t count = 0;
-
-    if(*py_str == '\0')    return false;
-    if(*py_str == 'i')     return false;
-    if(*py_str == 'u')     return false;
-    if(*py_str == 'v')     return false;
-
-    offset = py_str[0] - 'a';
-    len = strlen(py_str);
-
-    cpHZ  = &pinyin_ime->dict[pinyin_ime->py_pos[offset]];
-    count = pinyin_ime->py_num[offset];
-
-    while(count--) {
-        for(index = 0; index < len; index++) {
-            if(*(py_str + index) != *((cpHZ->py) + index)) {
-                break;
-            }
-        }
-
-        // perfect match
-        if(len == 1 || index == len) {
-            return true;
-        }
-        cpHZ++;
-    }
-    return false;
-}
-
 static void pinyin_k9_fill_cand(lv_obj_t * obj)
 {
     static uint16_t len = 0;
@@ -1130,7 +1166,6 @@ static void pinyin_k9_cand_page_proc(lv_obj_t * obj, uint16_t dir)
 
     if((ll_len > LV_IME_PINYIN_K9_CAND_TEXT_NUM) && (pinyin_ime->k9_legal_py_count > LV_IME_PINYIN_K9_CAND_TEXT_NUM)) {
         ime_pinyin_k9_py_str_t * ll_index = NULL;
-        uint16_t tmp_btn_str_len = 0;
         int count = 0;
 
         ll_index = _lv_ll_get_head(&pinyin_ime->k9_legal_py_ll);
@@ -12,8 +12,18 @@
 
 #include "../lvgl.h"
 #include "../misc/lv_fs.h"
+#include "../misc/lv_hash_lru.h"
 #include "lv_font_loader.h"
 
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    #include "../draw/sw/lv_draw_sw_glyph_cache.h"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LAZY_BUCKET_CNT     32
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -60,16 +70,53 @@ typedef struct cmap_table_bin {
     uint8_t padding;
 } cmap_table_bin_t;
 
+/*A glyph bitmap read from the file*/
+typedef struct {
+    _lv_hash_lru_entry_t lru;           /*Must be the first. Its size is the size of `buf`.*/
+    uint32_t gid;
+    uint8_t * buf;
+} lazy_entry_t;
+
+/*The glyph bitmaps of a lazily loaded font are read from the file when they are drawn*/
+typedef struct {
+    lv_fs_file_t file;                  /*Kept open while the font exists*/
+    uint32_t glyph_start;               /*Position of the glyph table in the file*/
+    uint32_t * glyph_offset;            /*Offset of the glyphs in the glyph table. `glyph_cnt + 1` items*/
+    uint8_t header_bits;                /*Size of the glyph descriptors in bits. The bitmaps follow them.*/
+    _lv_hash_lru_t cache;               /*Cached bitmaps*/
+    _lv_hash_lru_entry_t * buckets[LAZY_BUCKET_CNT];
+    uint32_t cache_size;
+    uint8_t * tmp_buf;                  /*For the bitmaps which don't fit into the cache*/
+    uint32_t tmp_buf_size;
+} lazy_dsc_t;
+
+/*The loaded fonts are allocated with some extra data*/
+typedef struct {
+    lv_font_t font;                     /*Must be the first to use it as `lv_font_t`*/
+    uint32_t load_time;
+    uint32_t glyph_cnt;
+    uint32_t bitmap_size;               /*Size of the loaded bitmaps*/
+    lazy_dsc_t * lazy;                  /*NULL if all the bitmaps are loaded*/
+} loaded_font_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static lv_font_t * font_load(const char * font_name, bool lazy, uint32_t cache_size);
 static bit_iterator_t init_bit_iterator(lv_fs_file_t * fp);
-static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font);
+static bool lvgl_load_font(lv_fs_file_t * fp, loaded_font_t * lf);
 int32_t load_kern(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, uint8_t format, uint32_t start);
 
 static int read_bits_signed(bit_iterator_t * it, int n_bits, lv_fs_res_t * res);
 static unsigned int read_bits(bit_iterator_t * it, int n_bits, lv_fs_res_t * res);
 
+static const uint8_t * lazy_get_glyph_bitmap(const lv_font_t * font, uint32_t letter);
+static const uint8_t * lazy_read_bitmap(loaded_font_t * lf, uint32_t gid);
+static bool lazy_entry_match(const _lv_hash_lru_entry_t * entry, const void * gid);
+static void lazy_entry_free(_lv_hash_lru_entry_t * entry);
+static void lazy_free(lazy_dsc_t * lazy);
+static uint32_t get_mem_size(const loaded_font_t * lf);
+
 /**********************
  *      MACROS
  **********************/
@@ -85,29 +132,19 @@ static unsigned int read_bits(bit_iterator_t * it, int n_bits, lv_fs_res_t * res
  */
 lv_font_t * lv_font_load(const char * font_name)
 {
-    lv_fs_file_t file;
-    lv_fs_res_t res = lv_fs_open(&file, font_name, LV_FS_MODE_RD);
-    if(res != LV_FS_RES_OK)
-        return NULL;
-
-    lv_font_t * font = lv_mem_alloc(sizeof(lv_font_t));
-    if(font) {
-        memset(font, 0, sizeof(lv_font_t));
-        if(!lvgl_load_font(&file, font)) {
-            LV_LOG_WARN("Error loading font file: %s\n", font_name);
-            /*
-            * When `lvgl_load_font` fails it can leak some pointers.
-            * All non-null pointers can be assumed as allocated and
-            * `lv_font_free` should free them correctly.
-            */
-            lv_font_free(font);
-            font = NULL;
-        }
-    }
-
-    lv_fs_close(&file);
+    return font_load(font_name, false, 0);
+}
 
-    return font;
+/**
+ * Load only the metrics, the character maps and the kerning of a binary font file.
+ * The glyph bitmaps are read from the file when they are drawn, so the file is kept open until `lv_font_free()`.
+ * @param font_name     filename where the font file is located
+ * @param cache_size    max. total size of the bitmaps to keep in RAM in bytes
+ * @return              a pointer to the font or NULL in case of error
+ */
+lv_font_t * lv_font_load_lazy(const char * font_name, uint32_t cache_size)
+{
+    return font_load(font_name, true, cache_size);
 }
 
 /**
@@ -117,6 +154,16 @@ lv_font_t * lv_font_load(const char * font_name)
 void lv_font_free(lv_font_t * font)
 {
     if(NULL != font) {
+        loaded_font_t * lf = (loaded_font_t *)font;
+        if(lf->lazy) lazy_free(lf->lazy);
+
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+        lv_draw_sw_glyph_cache_drop_font(font);
+#endif
+#if LV_USE_FONT_COMPRESSED
+        lv_font_fmt_txt_decompr_cache_drop_font(font);
+#endif
+
         lv_font_fmt_txt_dsc_t * dsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
 
         if(NULL != dsc) {
@@ -126,6 +173,8 @@ void lv_font_free(lv_font_t * font)
                     (lv_font_fmt_txt_kern_pair_t *)dsc->kern_dsc;
 
                 if(NULL != kern_dsc) {
+                    _lv_font_fmt_txt_kern_cache_clear();
+
                     if(kern_dsc->glyph_ids)
                         lv_mem_free((void *)kern_dsc->glyph_ids);
 
@@ -153,6 +202,11 @@ void lv_font_free(lv_font_t * font)
                 }
             }
 
+            if(NULL != dsc->cache) {
+                lv_font_fmt_txt_set_lookup(font, false);
+                lv_mem_free(dsc->cache);
+            }
+
             lv_font_fmt_txt_cmap_t * cmaps =
                 (lv_font_fmt_txt_cmap_t *)dsc->cmaps;
 
@@ -178,10 +232,83 @@ void lv_font_free(lv_font_t * font)
     }
 }
 
+/**
+ * Get the load time, the memory usage and the state of the glyph cache of a font.
+ * @param font      a font created by `lv_font_load()` or `lv_font_load_lazy()`
+ * @param info      store the result here
+ */
+void lv_font_loader_get_info(const lv_font_t * font, lv_font_loader_info_t * info)
+{
+    LV_ASSERT_NULL(font);
+    LV_ASSERT_NULL(info);
+
+    const loaded_font_t * lf = (const loaded_font_t *)font;
+    info->load_time = lf->load_time;
+    info->mem_size = get_mem_size(lf);
+    info->glyph_cnt = lf->glyph_cnt;
+    info->cache_size = lf->lazy ? lf->lazy->cache_size : 0;
+    info->cache_used = lf->lazy ? lf->lazy->cache.used : 0;
+    info->hit_cnt = lf->lazy ? lf->lazy->cache.hit_cnt : 0;
+    info->miss_cnt = lf->lazy ? lf->lazy->cache.miss_cnt : 0;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+static lv_font_t * font_load(const char * font_name, bool lazy, uint32_t cache_size)
+{
+    uint32_t t_start = lv_tick_get();
+
+    lv_fs_file_t file;
+    lv_fs_res_t res = lv_fs_open(&file, font_name, LV_FS_MODE_RD);
+    if(res != LV_FS_RES_OK)
+        return NULL;
+
+    loaded_font_t * lf = lv_mem_alloc(sizeof(loaded_font_t));
+    if(lf == NULL) {
+        lv_fs_close(&file);
+        return NULL;
+    }
+    memset(lf, 0, sizeof(loaded_font_t));
+
+    lv_fs_file_t * fp = &file;
+    if(lazy) {
+        lf->lazy = lv_mem_alloc(sizeof(lazy_dsc_t));
+        if(lf->lazy == NULL) {
+            lv_mem_free(lf);
+            lv_fs_close(&file);
+            return NULL;
+        }
+        memset(lf->lazy, 0, sizeof(lazy_dsc_t));
+        _lv_hash_lru_init(&lf->lazy->cache, lf->lazy->buckets, LAZY_BUCKET_CNT, lazy_entry_free);
+        lf->lazy->cache_size = cache_size;
+
+        /*The font owns the file from now and closes it in `lv_font_free`*/
+        lf->lazy->file = file;
+        fp = &lf->lazy->file;
+    }
+
+    if(!lvgl_load_font(fp, lf)) {
+        LV_LOG_WARN("Error loading font file: %s\n", font_name);
+        /*
+        * When `lvgl_load_font` fails it can leak some pointers.
+        * All non-null pointers can be assumed as allocated and
+        * `lv_font_free` should free them correctly.
+        */
+        lv_font_free(&lf->font);
+        if(!lazy) lv_fs_close(&file);
+        return NULL;
+    }
+
+    if(!lazy) lv_fs_close(&file);
+
+    lf->load_time = lv_tick_elaps(t_start);
+    LV_LOG_INFO("%s loaded in %"LV_PRIu32" ms, uses %"LV_PRIu32" bytes", font_name, lf->load_time, get_mem_size(lf));
+
+    return &lf->font;
+}
+
 static bit_iterator_t init_bit_iterator(lv_fs_file_t * fp)
 {
     bit_iterator_t it;
@@ -335,9 +462,11 @@ static int32_t load_cmaps(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, u
     return success ? cmaps_length : -1;
 }
 
-static int32_t load_glyph(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc,
+static int32_t load_glyph(lv_fs_file_t * fp, loaded_font_t * lf,
                           uint32_t start, uint32_t * glyph_offset, uint32_t loca_count, font_header_bin_t * header)
 {
+    lv_font_fmt_txt_dsc_t * font_dsc = (lv_font_fmt_txt_dsc_t *)lf->font.dsc;
+
     int32_t glyph_length = read_label(fp, start, "glyf");
     if(glyph_length < 0) {
         return -1;
@@ -414,9 +543,13 @@ static int32_t load_glyph(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc,
         }
     }
 
+    /*The bitmaps of lazy fonts are read when they are used*/
+    if(lf->lazy) return glyph_length;
+
     uint8_t * glyph_bmp = (uint8_t *)lv_mem_alloc(sizeof(uint8_t) * cur_bmp_size);
 
     font_dsc->glyph_bitmap = glyph_bmp;
+    lf->bitmap_size = cur_bmp_size;
 
     cur_bmp_size = 0;
 
@@ -480,8 +613,9 @@ static int32_t load_glyph(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc,
  * `lv_font_free` will assume that all non-null pointers are allocated and
  * should be freed.
  */
-static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
+static bool lvgl_load_font(lv_fs_file_t * fp, loaded_font_t * lf)
 {
+    lv_font_t * font = &lf->font;
     lv_font_fmt_txt_dsc_t * font_dsc = (lv_font_fmt_txt_dsc_t *)
                                        lv_mem_alloc(sizeof(lv_font_fmt_txt_dsc_t));
 
@@ -489,6 +623,11 @@ static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
 
     font->dsc = font_dsc;
 
+    /*Needed to cache the last letter and for the lookup table*/
+    font_dsc->cache = lv_mem_alloc(sizeof(lv_font_fmt_txt_glyph_cache_t));
+    if(font_dsc->cache == NULL) return false;
+    memset(font_dsc->cache, 0, sizeof(lv_font_fmt_txt_glyph_cache_t));
+
     /*header*/
     int32_t header_length = read_label(fp, 0, "head");
     if(header_length < 0) {
@@ -562,14 +701,26 @@ static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
     /*glyph*/
     uint32_t glyph_start = loca_start + loca_length;
     int32_t glyph_length = load_glyph(
-                               fp, font_dsc, glyph_start, glyph_offset, loca_count, &font_header);
-
-    lv_mem_free(glyph_offset);
+                               fp, lf, glyph_start, glyph_offset, loca_count, &font_header);
 
     if(glyph_length < 0) {
+        lv_mem_free(glyph_offset);
         return false;
     }
 
+    lf->glyph_cnt = loca_count;
+    if(lf->lazy) {
+        /*Keep the offsets to find the bitmaps in the file*/
+        glyph_offset[loca_count] = glyph_length;
+        lf->lazy->glyph_offset = glyph_offset;
+        lf->lazy->glyph_start = glyph_start;
+        lf->lazy->header_bits = font_header.advance_width_bits + 2 * font_header.xy_bits + 2 * font_header.wh_bits;
+        font->get_glyph_bitmap = lazy_get_glyph_bitmap;
+    }
+    else {
+        lv_mem_free(glyph_offset);
+    }
+
     if(font_header.tables_count < 4) {
         font_dsc->kern_dsc = NULL;
         font_dsc->kern_classes = 0;
@@ -581,6 +732,21 @@ static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
 
     int32_t kern_length = load_kern(fp, font_dsc, font_header.glyph_id_format, kern_start);
 
+#if LV_FONT_LOADER_KERN_CLASSES
+    if(kern_length >= 0 && font_dsc->kern_classes == 0) {
+        lv_font_fmt_txt_kern_pair_t * kern_pair = (lv_font_fmt_txt_kern_pair_t *)font_dsc->kern_dsc;
+        lv_font_fmt_txt_kern_classes_t * kern_classes = lv_font_fmt_txt_kern_pairs_to_classes(kern_pair, loca_count);
+        /*Keep the pairs if they can't be converted*/
+        if(kern_classes) {
+            lv_mem_free((void *)kern_pair->glyph_ids);
+            lv_mem_free((void *)kern_pair->values);
+            lv_mem_free(kern_pair);
+            font_dsc->kern_dsc = kern_classes;
+            font_dsc->kern_classes = 1;
+        }
+    }
+#endif
+
     return kern_length >= 0;
 }
 
@@ -679,3 +845,158 @@ int32_t load_kern(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, uint8_t f
 
     return kern_length;
 }
+
+static const uint8_t * lazy_get_glyph_bitmap(const lv_font_t * font, uint32_t letter)
+{
+    loaded_font_t * lf = (loaded_font_t *)font;
+
+    uint32_t gid = _lv_font_fmt_txt_get_glyph_id(font, letter);
+    if(gid == 0) return NULL;
+
+    const uint8_t * bitmap = lazy_read_bitmap(lf, gid);
+    if(bitmap == NULL) return NULL;
+
+    return _lv_font_fmt_txt_get_bitmap_by_id(font, gid, bitmap);
+}
+
+/**
+ * Get the bitmap of a glyph as it's stored in the file (maybe compressed).
+ * Read it from the file if it's not cached.
+ */
+static const uint8_t * lazy_read_bitmap(loaded_font_t * lf, uint32_t gid)
+{
+    lazy_dsc_t * lazy = lf->lazy;
+    const lv_font_fmt_txt_dsc_t * fdsc = (const lv_font_fmt_txt_dsc_t *)lf->font.dsc;
+    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+    if(gdsc->box_w == 0 || gdsc->box_h == 0) return NULL;
+
+    uint32_t hash = _lv_hash_lru_hash(NULL, gid);
+    lazy_entry_t * entry = (lazy_entry_t *)_lv_hash_lru_get(&lazy->cache, hash, lazy_entry_match, &gid);
+    if(entry) return entry->buf;
+
+    uint32_t ofs = lazy->glyph_offset[gid] + lazy->header_bits / 8;
+    uint32_t size = lazy->glyph_offset[gid + 1] - ofs;
+    if(size == 0) return NULL;
+
+    uint8_t * buf;
+    if(size <= lazy->cache_size) {
+        /*Drop the least recently used bitmaps to get space*/
+        _lv_hash_lru_shrink(&lazy->cache, UINT32_MAX, lazy->cache_size - size, NULL);
+
+        buf = lv_mem_alloc(size);
+        if(buf == NULL) {
+            LV_LOG_WARN("Couldn't allocate %"LV_PRIu32" bytes for a glyph", size);
+            return NULL;
+        }
+
+        entry = lv_mem_alloc(sizeof(lazy_entry_t));
+        if(entry == NULL) {
+            lv_mem_free(buf);
+            return NULL;
+        }
+
+        entry->gid = gid;
+        entry->buf = buf;
+        _lv_hash_lru_add(&lazy->cache, &entry->lru, hash, size);
+    }
+    else {
+        /*Too large to cache, use a temporary buffer which is valid until the next call*/
+        if(lazy->tmp_buf_size < size) {
+            uint8_t * tmp = lv_mem_realloc(lazy->tmp_buf, size);
+            if(tmp == NULL) return NULL;
+            lazy->tmp_buf = tmp;
+            lazy->tmp_buf_size = size;
+        }
+        buf = lazy->tmp_buf;
+    }
+
+    if(lv_fs_seek(&lazy->file, lazy->glyph_start + ofs, LV_FS_SEEK_SET) != LV_FS_RES_OK ||
+       lv_fs_read(&lazy->file, buf, size, NULL) != LV_FS_RES_OK) {
+        LV_LOG_WARN("Couldn't read the bitmap of glyph %"LV_PRIu32, gid);
+        if(entry) _lv_hash_lru_drop(&lazy->cache, &entry->lru);
+        return NULL;
+    }
+
+    /*The bitmaps start right after the descriptors which are not byte aligned*/
+    uint32_t shift = lazy->header_bits % 8;
+    if(shift) {
+        uint32_t k;
+        for(k = 0; k + 1 < size; k++) {
+            buf[k] = (uint8_t)((buf[k] << shift) | (buf[k + 1] >> (8 - shift)));
+        }
+        buf[size - 1] = (uint8_t)(buf[size - 1] << shift);
+    }
+
+    return buf;
+}
+
+static bool lazy_entry_match(const _lv_hash_lru_entry_t * entry, const void * gid)
+{
+    return ((const lazy_entry_t *)entry)->gid == *(const uint32_t *)gid;
+}
+
+static void lazy_entry_free(_lv_hash_lru_entry_t * entry)
+{
+    lv_mem_free(((lazy_entry_t *)entry)->buf);
+    lv_mem_free(entry);
+}
+
+static void lazy_free(lazy_dsc_t * lazy)
+{
+    _lv_hash_lru_drop_matching(&lazy->cache, NULL, NULL);
+
+    lv_mem_free(lazy->glyph_offset);
+    lv_mem_free(lazy->tmp_buf);
+    lv_fs_close(&lazy->file);
+    lv_mem_free(lazy);
+}
+
+/**
+ * Sum the size of the allocated structures of a font.
+ * The cached bitmaps and the overhead of the allocator are not included.
+ */
+static uint32_t get_mem_size(const loaded_font_t * lf)
+{
+    uint32_t size = sizeof(loaded_font_t);
+
+    const lv_font_fmt_txt_dsc_t * dsc = (const lv_font_fmt_txt_dsc_t *)lf->font.dsc;
+    if(dsc == NULL) return size;
+
+    size += sizeof(lv_font_fmt_txt_dsc_t);
+    if(dsc->cache) size += sizeof(lv_font_fmt_txt_glyph_cache_t);
+    size += lf->glyph_cnt * sizeof(lv_font_fmt_txt_glyph_dsc_t);
+    size += lf->bitmap_size;
+
+    uint32_t i;
+    for(i = 0; i < dsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &dsc->cmaps[i];
+        size += sizeof(lv_font_fmt_txt_cmap_t);
+        if(cmap->unicode_list) size += cmap->list_length * sizeof(uint16_t);
+        if(cmap->glyph_id_ofs_list) {
+            size += cmap->list_length * (cmap->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL ? 1 : 2);
+        }
+    }
+
+    if(dsc->kern_dsc && dsc->kern_classes == 0) {
+        const lv_font_fmt_txt_kern_pair_t * kern = dsc->kern_dsc;
+        size += sizeof(lv_font_fmt_txt_kern_pair_t);
+        size += kern->pair_cnt * 2 * (kern->glyph_ids_size == 0 ? 1 : 2);
+        size += kern->pair_cnt;
+    }
+    else if(dsc->kern_dsc) {
+        const lv_font_fmt_txt_kern_classes_t * kern = dsc->kern_dsc;
+        size += sizeof(lv_font_fmt_txt_kern_classes_t);
+        size += 2 * lf->glyph_cnt;
+        size += kern->left_class_cnt * kern->right_class_cnt;
+    }
+
+    size += lv_font_fmt_txt_get_lookup_size(&lf->font);
+
+    if(lf->lazy) {
+        size += sizeof(lazy_dsc_t);
+        size += (lf->glyph_cnt + 1) * sizeof(uint32_t);
+        size += lf->lazy->tmp_buf_size;
+    }
+
+    return size;
+}
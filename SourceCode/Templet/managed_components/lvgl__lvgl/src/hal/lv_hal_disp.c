@@ -94,6 +94,7 @@ void lv_disp_drv_init(lv_disp_drv_t * driver)
     driver->antialiasing     = LV_COLOR_DEPTH > 8 ? 1 : 0;
     driver->screen_transp    = 0;
     driver->dpi              = LV_DPI_DEF;
+    driver->flush_cost_px    = 0;
     driver->color_chroma_key = LV_COLOR_CHROMA_KEY;
 
 #if LV_USE_GPU_RA6M3_G2D
@@ -157,6 +158,37 @@ void lv_disp_draw_buf_init(lv_disp_draw_buf_t * draw_buf, void * buf1, void * bu
     draw_buf->size    = size_in_px_cnt;
 }
 
+/**
+ * Initialize a display buffer with a ring of 3 or more draw buffers.
+ * LVGL renders into the next buffer of the ring while the previous ones are still being sent
+ * to the display. `flush_cb` will be called again before the previous buffers are flushed,
+ * so the driver needs to queue the transfers (e.g. DMA descriptors) and
+ * call `lv_disp_flush_ready()` for each buffer in the same order as they were passed to `flush_cb`.
+ * The ring is used only for partial rendering. With `direct_mode` or `full_refresh`
+ * only the first two buffers are used as `buf1` and `buf2`.
+ * @param draw_buf pointer `lv_disp_draw_buf_t` variable to initialize
+ * @param bufs array of `buf_cnt` buffers. Only its pointer is saved so it can't be a local variable.
+ * @param buf_cnt number of buffers in `bufs`. At least 3, for 2 buffers use `lv_disp_draw_buf_init()`.
+ * @param size_in_px_cnt size of each buffer in pixel count.
+ */
+void lv_disp_draw_buf_init_ring(lv_disp_draw_buf_t * draw_buf, void ** bufs, uint32_t buf_cnt,
+                                uint32_t size_in_px_cnt)
+{
+    LV_ASSERT_NULL(bufs);
+    LV_ASSERT_MSG(buf_cnt >= 3, "A draw buffer ring needs at least 3 buffers");
+
+    lv_disp_draw_buf_init(draw_buf, bufs[0], buf_cnt > 1 ? bufs[1] : NULL, size_in_px_cnt);
+
+    /*With less buffers there is nothing to overlap, work as a normal one or two buffered display*/
+    if(buf_cnt < 3) {
+        LV_LOG_WARN("%d buffer(s) are not enough for a ring, using them as normal draw buffers", (int)buf_cnt);
+        return;
+    }
+
+    draw_buf->buf_ring = bufs;
+    draw_buf->buf_ring_cnt = buf_cnt;
+}
+
 /**
  * Register an initialized display driver.
  * Automatically set the first display as active.
@@ -518,19 +550,34 @@ lv_coord_t lv_disp_get_dpi(const lv_disp_t * disp)
  */
 void LV_ATTRIBUTE_FLUSH_READY lv_disp_flush_ready(lv_disp_drv_t * disp_drv)
 {
-    disp_drv->draw_buf->flushing = 0;
-    disp_drv->draw_buf->flushing_last = 0;
+    lv_disp_draw_buf_t * draw_buf = disp_drv->draw_buf;
+    draw_buf->flush_ready_cnt++;
+    if(draw_buf->buf_ring) {
+        /*The other buffers of the ring might be still in flight*/
+        draw_buf->flushing = draw_buf->flush_sent_cnt != draw_buf->flush_ready_cnt;
+    }
+    else {
+        draw_buf->flushing = 0;
+        draw_buf->flushing_last = 0;
+    }
 }
 
 /**
  * Tell if it's the last area of the refreshing process.
  * Can be called from `flush_cb` to execute some special display refreshing if needed when all areas area flushed.
+ * With a buffer ring it tells if the most recently sent area is the last one and it's still in flight,
+ * regardless of the older buffers being completed meanwhile.
  * @param disp_drv pointer to display driver
  * @return true: it's the last area to flush; false: there are other areas too which will be refreshed soon
  */
 bool LV_ATTRIBUTE_FLUSH_READY lv_disp_flush_is_last(lv_disp_drv_t * disp_drv)
 {
-    return disp_drv->draw_buf->flushing_last;
+    lv_disp_draw_buf_t * draw_buf = disp_drv->draw_buf;
+    if(draw_buf->buf_ring) {
+        return draw_buf->flush_last_cnt == draw_buf->flush_sent_cnt &&
+               draw_buf->flush_sent_cnt != draw_buf->flush_ready_cnt;
+    }
+    return draw_buf->flushing_last;
 }
 
 /**
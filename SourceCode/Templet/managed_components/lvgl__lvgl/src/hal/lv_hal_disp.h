@@ -61,6 +61,14 @@ typedef struct _lv_disp_draw_buf_t {
     volatile int flushing_last;
     volatile uint32_t last_area         : 1; /*1: the last area is being rendered*/
     volatile uint32_t last_part         : 1; /*1: the last part of the current area is being rendered*/
+
+    /*Set by `lv_disp_draw_buf_init_ring()`. `buf1` and `buf2` are the first two buffers of the ring*/
+    void ** buf_ring;
+    uint32_t buf_ring_cnt;
+    uint32_t buf_ring_act;              /*Index of `buf_act` in `buf_ring`*/
+    uint32_t flush_sent_cnt;            /*Number of `flush_cb` calls*/
+    volatile uint32_t flush_ready_cnt;  /*Number of `lv_disp_flush_ready()` calls. (Written only from `flush_cb` or IRQ)*/
+    uint32_t flush_last_cnt;            /*Value of `flush_sent_cnt` when the last area of a refresh was sent*/
 } lv_disp_draw_buf_t;
 
 typedef enum {
@@ -102,6 +110,11 @@ typedef struct _lv_disp_drv_t {
 
     uint32_t dpi : 10;              /** DPI (dot per inch) of the display. Default value is `LV_DPI_DEF`.*/
 
+    /** The overhead of a `flush_cb` call (command setup, DMA start, etc.) expressed in pixels.
+     * Invalidated areas are joined if it costs fewer extra pixels to redraw than this.
+     * 0: join only if fewer pixels need to be redrawn.*/
+    uint32_t flush_cost_px;
+
     /** MANDATORY: Write the internal buffer (draw_buf) to the display. 'lv_disp_flush_ready()' has to be
      * called when finished*/
     void (*flush_cb)(struct _lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
@@ -190,6 +203,13 @@ typedef struct _lv_disp_t {
     /** Double buffer sync areas */
     lv_ll_t sync_areas;
 
+#if LV_USE_SCROLL_BLIT
+    /** Area to move by `scroll_blit_ofs` in the frame buffer before the next refresh*/
+    lv_area_t scroll_blit_area;
+    lv_point_t scroll_blit_ofs;
+    uint8_t scroll_blit_pending : 1;
+#endif
+
     /*Miscellaneous data*/
     uint32_t last_activity_time;        /**< Last time when there was activity on this display*/
 } lv_disp_t;
@@ -223,6 +243,22 @@ void lv_disp_drv_init(lv_disp_drv_t * driver);
  */
 void lv_disp_draw_buf_init(lv_disp_draw_buf_t * draw_buf, void * buf1, void * buf2, uint32_t size_in_px_cnt);
 
+/**
+ * Initialize a display buffer with a ring of 3 or more draw buffers.
+ * LVGL renders into the next buffer of the ring while the previous ones are still being sent
+ * to the display. `flush_cb` will be called again before the previous buffers are flushed,
+ * so the driver needs to queue the transfers (e.g. DMA descriptors) and
+ * call `lv_disp_flush_ready()` for each buffer in the same order as they were passed to `flush_cb`.
+ * The ring is used only for partial rendering. With `direct_mode` or `full_refresh`
+ * only the first two buffers are used as `buf1` and `buf2`.
+ * @param draw_buf pointer `lv_disp_draw_buf_t` variable to initialize
+ * @param bufs array of `buf_cnt` buffers. Only its pointer is saved so it can't be a local variable.
+ * @param buf_cnt number of buffers in `bufs`. At least 3, for 2 buffers use `lv_disp_draw_buf_init()`.
+ * @param size_in_px_cnt size of each buffer in pixel count.
+ */
+void lv_disp_draw_buf_init_ring(lv_disp_draw_buf_t * draw_buf, void ** bufs, uint32_t buf_cnt,
+                                uint32_t size_in_px_cnt);
+
 /**
  * Register an initialized display driver.
  * Automatically set the first display as active.
@@ -337,6 +373,8 @@ void /* LV_ATTRIBUTE_FLUSH_READY */ lv_disp_flush_ready(lv_disp_drv_t * disp_drv
 /**
  * Tell if it's the last area of the refreshing process.
  * Can be called from `flush_cb` to execute some special display refreshing if needed when all areas area flushed.
+ * With a buffer ring it tells if the most recently sent area is the last one and it's still in flight,
+ * regardless of the older buffers being completed meanwhile.
  * @param disp_drv pointer to display driver
  * @return true: it's the last area to flush; false: there are other areas too which will be refreshed soon
  */
@@ -0,0 +1,150 @@
+/**
+ * @file lv_hash_lru.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_hash_lru.h"
+#include "lv_assert.h"
+#include "lv_mem.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void list_remove(_lv_hash_lru_t * lru, _lv_hash_lru_entry_t * entry);
+static void list_add_head(_lv_hash_lru_t * lru, _lv_hash_lru_entry_t * entry);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_hash_lru_init(_lv_hash_lru_t * lru, _lv_hash_lru_entry_t ** buckets, uint32_t bucket_cnt,
+                       _lv_hash_lru_free_cb_t free_cb)
+{
+    LV_ASSERT_NULL(lru);
+    LV_ASSERT_NULL(buckets);
+    LV_ASSERT_MSG(bucket_cnt && (bucket_cnt & (bucket_cnt - 1)) == 0, "The bucket count must be a power of 2");
+
+    lv_memset_00(lru, sizeof(_lv_hash_lru_t));
+    lv_memset_00(buckets, bucket_cnt * sizeof(_lv_hash_lru_entry_t *));
+    lru->buckets = buckets;
+    lru->bucket_mask = bucket_cnt - 1;
+    lru->free_cb = free_cb;
+}
+
+_lv_hash_lru_entry_t * _lv_hash_lru_find(const _lv_hash_lru_t * lru, uint32_t hash, _lv_hash_lru_match_cb_t match_cb,
+                                         const void * key)
+{
+    _lv_hash_lru_entry_t * entry = lru->buckets[hash & lru->bucket_mask];
+    while(entry) {
+        if(entry->hash == hash && match_cb(entry, key)) return entry;
+        entry = entry->hash_next;
+    }
+
+    return NULL;
+}
+
+_lv_hash_lru_entry_t * _lv_hash_lru_get(_lv_hash_lru_t * lru, uint32_t hash, _lv_hash_lru_match_cb_t match_cb,
+                                        const void * key)
+{
+    _lv_hash_lru_entry_t * entry = _lv_hash_lru_find(lru, hash, match_cb, key);
+    if(entry == NULL) {
+        lru->miss_cnt++;
+        return NULL;
+    }
+
+    lru->hit_cnt++;
+    if(entry != lru->head) {
+        list_remove(lru, entry);
+        list_add_head(lru, entry);
+    }
+    return entry;
+}
+
+void _lv_hash_lru_add(_lv_hash_lru_t * lru, _lv_hash_lru_entry_t * entry, uint32_t hash, uint32_t size)
+{
+    _lv_hash_lru_entry_t ** bucket = &lru->buckets[hash & lru->bucket_mask];
+    entry->hash = hash;
+    entry->hash_next = *bucket;
+    *bucket = entry;
+
+    entry->size = size;
+    lru->used += size;
+    lru->entry_cnt++;
+    list_add_head(lru, entry);
+}
+
+void _lv_hash_lru_drop(_lv_hash_lru_t * lru, _lv_hash_lru_entry_t * entry)
+{
+    _lv_hash_lru_entry_t ** p = &lru->buckets[entry->hash & lru->bucket_mask];
+    while(*p != entry) p = &(*p)->hash_next;
+    *p = entry->hash_next;
+
+    list_remove(lru, entry);
+    lru->used -= entry->size;
+    lru->entry_cnt--;
+    if(lru->free_cb) lru->free_cb(entry);
+}
+
+void _lv_hash_lru_shrink(_lv_hash_lru_t * lru, uint32_t max_cnt, uint32_t max_size, const _lv_hash_lru_entry_t * keep)
+{
+    _lv_hash_lru_entry_t * entry = lru->tail;
+    while(entry && (lru->entry_cnt > max_cnt || lru->used > max_size)) {
+        _lv_hash_lru_entry_t * prev = entry->prev;
+        if(entry != keep) {
+            _lv_hash_lru_drop(lru, entry);
+            lru->evict_cnt++;
+        }
+        entry = prev;
+    }
+}
+
+void _lv_hash_lru_drop_matching(_lv_hash_lru_t * lru, _lv_hash_lru_match_cb_t match_cb, const void * key)
+{
+    _lv_hash_lru_entry_t * entry = lru->head;
+    while(entry) {
+        _lv_hash_lru_entry_t * next = entry->next;
+        if(match_cb == NULL || match_cb(entry, key)) _lv_hash_lru_drop(lru, entry);
+        entry = next;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void list_remove(_lv_hash_lru_t * lru, _lv_hash_lru_entry_t * entry)
+{
+    if(entry->prev) entry->prev->next = entry->next;
+    else lru->head = entry->next;
+
+    if(entry->next) entry->next->prev = entry->prev;
+    else lru->tail = entry->prev;
+}
+
+static void list_add_head(_lv_hash_lru_t * lru, _lv_hash_lru_entry_t * entry)
+{
+    entry->prev = NULL;
+    entry->next = lru->head;
+    if(lru->head) lru->head->prev = entry;
+    else lru->tail = entry;
+    lru->head = entry;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file lv_profiler.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_profiler.h"
+
+#if LV_USE_PROFILER
+
+#include "lv_printf.h"
+#include "../hal/lv_hal_tick.h"
+
+#ifdef ESP_PLATFORM
+    #include "esp_timer.h"
+#elif defined(__unix__) || defined(__APPLE__)
+    #include <time.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#if LV_PROFILER_BUF_SIZE < 2
+    #error "LV_PROFILER_BUF_SIZE must be at least 2"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const char * tag;
+    uint32_t tick;
+    char type;
+} lv_profiler_item_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t default_tick_cb(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_profiler_item_t items[LV_PROFILER_BUF_SIZE];
+static uint32_t item_start;     /*Index of the oldest item*/
+static uint32_t item_cnt;
+static bool enabled;
+static lv_profiler_tick_cb_t tick_cb;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_profiler_init(void)
+{
+    item_start = 0;
+    item_cnt = 0;
+    enabled = true;
+    tick_cb = default_tick_cb;
+}
+
+void lv_profiler_set_enabled(bool en)
+{
+    enabled = en;
+}
+
+void lv_profiler_set_tick_cb(lv_profiler_tick_cb_t cb)
+{
+    tick_cb = cb ? cb : default_tick_cb;
+}
+
+void lv_profiler_reset(void)
+{
+    item_start = 0;
+    item_cnt = 0;
+}
+
+uint32_t lv_profiler_get_cnt(void)
+{
+    return item_cnt;
+}
+
+void lv_profiler_flush(lv_profiler_flush_cb_t cb)
+{
+    if(cb == NULL) return;
+
+    char buf[128];
+    uint32_t i;
+    for(i = 0; i < item_cnt; i++) {
+        const lv_profiler_item_t * item = &items[(item_start + i) % LV_PROFILER_BUF_SIZE];
+        lv_snprintf(buf, sizeof(buf), "   LVGL-1 [0] %" LV_PRIu32 ".%06" LV_PRIu32 ": tracing_mark_write: %c|1|%s\n",
+                    item->tick / 1000000, item->tick % 1000000, item->type, item->tag);
+        cb(buf);
+    }
+
+    lv_profiler_reset();
+}
+
+void lv_profiler_write(const char * tag, char type)
+{
+    if(!enabled) return;
+
+    /*Overwrite the oldest item if the buffer is full*/
+    uint32_t i = (item_start + item_cnt) % LV_PROFILER_BUF_SIZE;
+    if(item_cnt < LV_PROFILER_BUF_SIZE) item_cnt++;
+    else item_start = (item_start + 1) % LV_PROFILER_BUF_SIZE;
+
+    items[i].tag = tag;
+    items[i].tick = tick_cb();
+    items[i].type = type;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint32_t default_tick_cb(void)
+{
+#ifdef ESP_PLATFORM
+    return (uint32_t)esp_timer_get_time();
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+#else
+    /*Only 1 ms resolution*/
+    return lv_tick_get() * 1000;
+#endif
+}
+
+#endif /*LV_USE_PROFILER*/
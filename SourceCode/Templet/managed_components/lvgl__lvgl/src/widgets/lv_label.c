@@ -48,6 +48,13 @@ static char * lv_label_get_dot_tmp(lv_obj_t * label);
 static void lv_label_dot_tmp_free(lv_obj_t * label);
 static void set_ofs_x_anim(void * obj, int32_t v);
 static void set_ofs_y_anim(void * obj, int32_t v);
+static void get_text_size(lv_obj_t * obj, lv_point_t * size, const lv_font_t * font, lv_coord_t letter_space,
+                          lv_coord_t line_space, lv_coord_t max_w, lv_text_flag_t flag, bool update);
+#if LV_LABEL_LAYOUT_CACHE
+static bool layout_is_up_to_date(lv_obj_t * obj, lv_point_t * size);
+static bool refr_text_edit(lv_obj_t * obj, uint32_t pos, uint32_t del_len, uint32_t ins_len,
+                           const lv_point_t * size_ori);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -645,7 +652,18 @@ void lv_label_ins_text(lv_obj_t * obj, uint32_t pos, const char * txt)
     /*Can not append to static text*/
     if(label->static_txt != 0) return;
 
-    lv_obj_invalidate(obj);
+#if LV_LABEL_LAYOUT_CACHE
+    /*If the line breaks are known only the lines around the new text need to be updated*/
+    lv_point_t size_ori;
+    bool edit_layout = layout_is_up_to_date(obj, &size_ori);
+#if LV_USE_ARABIC_PERSIAN_CHARS
+    /*Non-ASCII letters might need to be processed in `lv_label_set_text`*/
+    uint32_t i;
+    for(i = 0; txt[i] != '\0' && edit_layout; i++) {
+        if((uint8_t)txt[i] >= 0x80) edit_layout = false;
+    }
+#endif
+#endif
 
     /*Allocate space for the new text*/
     size_t old_len = strlen(label->text);
@@ -659,7 +677,17 @@ void lv_label_ins_text(lv_obj_t * obj, uint32_t pos, const char * txt)
         pos = _lv_txt_get_encoded_length(label->text);
     }
 
+#if LV_LABEL_LAYOUT_CACHE
+    uint32_t byte_pos = _lv_txt_encoded_get_byte_id(label->text, pos);
+#endif
+
     _lv_txt_ins(label->text, pos, txt);
+
+#if LV_LABEL_LAYOUT_CACHE
+    if(edit_layout && refr_text_edit(obj, byte_pos, 0, ins_len, &size_ori)) return;
+#endif
+
+    lv_obj_invalidate(obj);
     lv_label_set_text(obj, NULL);
 }
 
@@ -671,13 +699,25 @@ void lv_label_cut_text(lv_obj_t * obj, uint32_t pos, uint32_t cnt)
     /*Can not append to static text*/
     if(label->static_txt != 0) return;
 
-    lv_obj_invalidate(obj);
-
     char * label_txt = lv_label_get_text(obj);
+
+#if LV_LABEL_LAYOUT_CACHE
+    /*If the line breaks are known only the lines around the deleted text need to be updated*/
+    lv_point_t size_ori;
+    bool edit_layout = layout_is_up_to_date(obj, &size_ori);
+    uint32_t byte_pos = _lv_txt_encoded_get_byte_id(label_txt, pos);
+    uint32_t byte_end = _lv_txt_encoded_get_byte_id(label_txt, pos + cnt);
+#endif
+
     /*Delete the characters*/
     _lv_txt_cut(label_txt, pos, cnt);
 
+#if LV_LABEL_LAYOUT_CACHE
+    if(edit_layout && refr_text_edit(obj, byte_pos, byte_end - byte_pos, 0, &size_ori)) return;
+#endif
+
     /*Refresh the label*/
+    lv_obj_invalidate(obj);
     lv_label_refr_text(obj);
 }
 
@@ -706,6 +746,10 @@ static void lv_label_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     label->hint.y          = 0;
 #endif
 
+#if LV_LABEL_LAYOUT_CACHE
+    lv_draw_label_layout_init(&label->layout);
+#endif
+
 #if LV_LABEL_TEXT_SELECTION
     label->sel_start = LV_DRAW_LABEL_NO_TXT_SEL;
     label->sel_end   = LV_DRAW_LABEL_NO_TXT_SEL;
@@ -728,6 +772,10 @@ static void lv_label_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     lv_label_dot_tmp_free(obj);
     if(!label->static_txt) lv_mem_free(label->text);
     label->text = NULL;
+
+#if LV_LABEL_LAYOUT_CACHE
+    lv_draw_label_layout_free(&label->layout);
+#endif
 }
 
 static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
@@ -758,6 +806,10 @@ static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
         lv_event_set_ext_draw_size(e, font_h / 4);
     }
     else if(code == LV_EVENT_SIZE_CHANGED) {
+#if LV_LABEL_LAYOUT_CACHE
+        /*E.g. only the height has changed because of a new line. The object is already invalidated.*/
+        if(layout_is_up_to_date(obj, NULL)) return;
+#endif
         lv_label_revert_dots(obj);
         lv_label_refr_text(obj);
     }
@@ -775,7 +827,7 @@ static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
         if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) w = LV_COORD_MAX;
         else w = lv_obj_get_content_width(obj);
 
-        lv_txt_get_size(&size, label->text, font, letter_space, line_space, w, flag);
+        get_text_size(obj, &size, font, letter_space, line_space, w, flag, false);
 
         lv_point_t * self_size = lv_event_get_param(e);
         self_size->x = LV_MAX(self_size->x, size.x);
@@ -822,12 +874,20 @@ static void draw_main(lv_event_t * e)
     if((label->long_mode == LV_LABEL_LONG_SCROLL || label->long_mode == LV_LABEL_LONG_SCROLL_CIRCULAR) &&
        (label_draw_dsc.align == LV_TEXT_ALIGN_CENTER || label_draw_dsc.align == LV_TEXT_ALIGN_RIGHT)) {
         lv_point_t size;
-        lv_txt_get_size(&size, label->text, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
-                        LV_COORD_MAX, flag);
+        get_text_size(obj, &size, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
+                      LV_COORD_MAX, flag, false);
         if(size.x > lv_area_get_width(&txt_coords)) {
             label_draw_dsc.align = LV_TEXT_ALIGN_LEFT;
         }
     }
+
+#if LV_LABEL_LAYOUT_CACHE
+    /*Calculate the line breaks only if something has changed since the last draw*/
+    if(lv_draw_label_layout_update(&label->layout, label->text, label_draw_dsc.font, label_draw_dsc.letter_space,
+                                   lv_area_get_width(&txt_coords), flag)) {
+        label_draw_dsc.layout = &label->layout;
+    }
+#endif
 #if LV_LABEL_LONG_TXT_HINT
     lv_draw_label_hint_t * hint = &label->hint;
     if(label->long_mode == LV_LABEL_LONG_SCROLL_CIRCULAR || lv_area_get_height(&txt_coords) < LV_LABEL_HINT_HEIGHT_LIMIT)
@@ -862,8 +922,8 @@ static void draw_main(lv_event_t * e)
 
     if(label->long_mode == LV_LABEL_LONG_SCROLL_CIRCULAR) {
         lv_point_t size;
-        lv_txt_get_size(&size, label->text, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
-                        LV_COORD_MAX, flag);
+        get_text_size(obj, &size, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
+                      LV_COORD_MAX, flag, false);
 
         /*Draw the text again on label to the original to make a circular effect */
         if(size.x > lv_area_get_width(&txt_coords)) {
@@ -897,6 +957,9 @@ static void lv_label_refr_text(lv_obj_t * obj)
 #if LV_LABEL_LONG_TXT_HINT
     label->hint.line_start = -1; /*The hint is invalid if the text changes*/
 #endif
+#if LV_LABEL_LAYOUT_CACHE
+    lv_draw_label_layout_invalidate(&label->layout);
+#endif
 
     lv_area_t txt_coords;
     lv_obj_get_content_coords(obj, &txt_coords);
@@ -912,7 +975,7 @@ static void lv_label_refr_text(lv_obj_t * obj)
     if(label->expand != 0) flag |= LV_TEXT_FLAG_EXPAND;
     if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) flag |= LV_TEXT_FLAG_FIT;
 
-    lv_txt_get_size(&size, label->text, font, letter_space, line_space, max_w, flag);
+    get_text_size(obj, &size, font, letter_space, line_space, max_w, flag, true);
 
     lv_obj_refresh_self_size(obj);
 
@@ -1156,6 +1219,9 @@ static void lv_label_refr_text(lv_obj_t * obj)
                 }
                 label->text[byte_id_ori + LV_LABEL_DOT_NUM] = '\0';
                 label->dot_end                              = letter_id + LV_LABEL_DOT_NUM;
+#if LV_LABEL_LAYOUT_CACHE
+                lv_draw_label_layout_invalidate(&label->layout);
+#endif
             }
         }
     }
@@ -1186,6 +1252,10 @@ static void lv_label_revert_dots(lv_obj_t * obj)
     label->text[byte_i + i] = dot_tmp[i];
     lv_label_dot_tmp_free(obj);
 
+#if LV_LABEL_LAYOUT_CACHE
+    lv_draw_label_layout_invalidate(&label->layout);
+#endif
+
     label->dot_end = LV_LABEL_DOT_END_INV;
 }
 
@@ -1266,4 +1336,106 @@ static void set_ofs_y_anim(void * obj, int32_t v)
     lv_obj_invalidate(obj);
 }
 
+/**
+ * Get the size of the text. Use the cached line breaks if they were calculated with the same parameters.
+ * @param update    true: if the cached line breaks can't be used calculate and keep new ones
+ */
+static void get_text_size(lv_obj_t * obj, lv_point_t * size, const lv_font_t * font, lv_coord_t letter_space,
+                          lv_coord_t line_space, lv_coord_t max_w, lv_text_flag_t flag, bool update)
+{
+    lv_label_t * label = (lv_label_t *)obj;
+
+#if LV_LABEL_LAYOUT_CACHE
+    lv_draw_label_layout_t * layout = &label->layout;
+    if(lv_draw_label_layout_is_valid(layout, label->text, font, letter_space, max_w, flag) ||
+       (update && lv_draw_label_layout_update(layout, label->text, font, letter_space, max_w, flag))) {
+        lv_draw_label_layout_get_size(layout, line_space, size);
+        return;
+    }
+#else
+    LV_UNUSED(update);
+#endif
+
+    lv_txt_get_size(size, label->text, font, letter_space, line_space, max_w, flag);
+}
+
+#if LV_LABEL_LAYOUT_CACHE
+/**
+ * Check if the cached line breaks belong to the current text and settings of the label,
+ * so they can be updated after an edit instead of calculating all of them again.
+ * @param size      if the line breaks are up to date store the size of the text here (can be NULL)
+ */
+static bool layout_is_up_to_date(lv_obj_t * obj, lv_point_t * size)
+{
+    lv_label_t * label = (lv_label_t *)obj;
+    if(label->text == NULL) return false;
+
+    /*The other modes depend on the size of the whole text*/
+    if(label->long_mode != LV_LABEL_LONG_WRAP && label->long_mode != LV_LABEL_LONG_CLIP) return false;
+
+    lv_text_flag_t flag = LV_TEXT_FLAG_NONE;
+    if(label->recolor != 0) flag |= LV_TEXT_FLAG_RECOLOR;
+    if(label->expand != 0) flag |= LV_TEXT_FLAG_EXPAND;
+    if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) flag |= LV_TEXT_FLAG_FIT;
+
+    if(!lv_draw_label_layout_is_valid(&label->layout, label->text, lv_obj_get_style_text_font(obj, LV_PART_MAIN),
+                                      lv_obj_get_style_text_letter_space(obj, LV_PART_MAIN),
+                                      lv_obj_get_content_width(obj), flag)) {
+        return false;
+    }
+
+    if(size) lv_draw_label_layout_get_size(&label->layout, lv_obj_get_style_text_line_space(obj, LV_PART_MAIN), size);
+    return true;
+}
+
+/**
+ * Update the line breaks after `del_len` bytes were deleted and `ins_len` bytes were inserted at `pos`
+ * and invalidate only the changed lines.
+ * @param size_ori  the size of the text before the edit
+ * @return false if the whole label needs to be refreshed
+ */
+static bool refr_text_edit(lv_obj_t * obj, uint32_t pos, uint32_t del_len, uint32_t ins_len,
+                           const lv_point_t * size_ori)
+{
+    lv_label_t * label = (lv_label_t *)obj;
+    lv_draw_label_layout_t * layout = &label->layout;
+    lv_coord_t line_space = lv_obj_get_style_text_line_space(obj, LV_PART_MAIN);
+    uint32_t line_cnt_ori = layout->line_cnt;
+
+    uint32_t first_line;
+    uint32_t last_line;
+    if(!lv_draw_label_layout_edit(layout, label->text, pos, del_len, ins_len, &first_line, &last_line)) return false;
+
+#if LV_LABEL_LONG_TXT_HINT
+    label->hint.line_start = -1; /*The hint is invalid if the text changes*/
+#endif
+
+    lv_point_t size;
+    lv_draw_label_layout_get_size(layout, line_space, &size);
+    if(size.x != size_ori->x || size.y != size_ori->y) lv_obj_refresh_self_size(obj);
+
+    /*If the number of lines has changed the lines below the edit are moved too*/
+    int32_t line_h = lv_font_get_line_height(layout->font) + line_space;
+    lv_coord_t ext_size = _lv_obj_get_ext_draw_size(obj);
+    lv_area_t txt_coords;
+    lv_obj_get_content_coords(obj, &txt_coords);
+    int32_t y_ofs = txt_coords.y1;
+    if(label->long_mode == LV_LABEL_LONG_WRAP) y_ofs -= lv_obj_get_scroll_top(obj);
+
+    int32_t y1 = y_ofs + (int32_t)first_line * line_h - ext_size;
+    int32_t y2 = obj->coords.y2 + ext_size;
+    if(layout->line_cnt == line_cnt_ori) y2 = LV_MIN(y2, y_ofs + (int32_t)last_line * line_h + ext_size - 1);
+    if(y1 > y2) return true;
+
+    lv_area_t inv_area;
+    inv_area.x1 = obj->coords.x1 - ext_size;
+    inv_area.y1 = (lv_coord_t)LV_MAX(y1, obj->coords.y1 - ext_size);
+    inv_area.x2 = obj->coords.x2 + ext_size;
+    inv_area.y2 = (lv_coord_t)y2;
+    lv_obj_invalidate_area(obj, &inv_area);
+
+    return true;
+}
+#endif
+
 #endif
@@ -24,6 +24,10 @@ test_options = {
     'OPTIONS_TEST_DEFHEAP': 'Test config, LVGL heap, 32 bit color depth',
 }
 
+# Tests which don't compare screenshots, so they are run in the build only
+# configurations too (e.g. to check the blending of the other color formats).
+build_only_tests = ['test_draw_sw_blend_simd']
+
 
 def is_valid_option_name(option_name):
     return option_name in build_only_options or option_name in test_options
@@ -111,8 +115,10 @@ def build_tests(options_name, build_type, clean):
                            '--parallel', str(os.cpu_count())])
 
 
-def run_tests(options_name):
-    '''Run the tests for the given options name.'''
+def run_tests(options_name, tests=None):
+    '''Run the tests for the given options name.
+
+    When tests is given only the listed tests are run.'''
 
     print()
     print()
@@ -122,8 +128,10 @@ def run_tests(options_name):
     print('=' * len(label), flush=True)
 
     os.chdir(get_build_dir(options_name))
-    subprocess.check_call(
-        ['ctest', '--timeout', '30', '--parallel', str(os.cpu_count()), '--output-on-failure'])
+    cmd = ['ctest', '--timeout', '30', '--parallel', str(os.cpu_count()), '--output-on-failure']
+    if tests:
+        cmd.extend(['--tests-regex', '^(%s)$' % '|'.join(tests)])
+    subprocess.check_call(cmd)
 
 
 def generate_code_coverage_report():
@@ -158,7 +166,8 @@ if __name__ == "__main__":
     epilog = '''This program builds and optionally runs the LVGL test programs.
     There are two types of LVGL tests: "build", and "test". The build-only
     tests, as their name suggests, only verify that the program successfully
-    compiles and links (with various build options). There are also a set of
+    compiles and links (with various build options), only a few tests which
+    don't depend on the configuration are run. There are also a set of
     tests that execute to verify correct LVGL library behavior.
     '''
     parser = argparse.ArgumentParser(
@@ -198,11 +207,13 @@ if __name__ == "__main__":
         is_test = options_name in test_options
         build_type = 'Debug'
         build_tests(options_name, build_type, args.clean)
-        if is_test:
-            try:
+        try:
+            if is_test:
                 run_tests(options_name)
-            except subprocess.CalledProcessError as e:
-                sys.exit(e.returncode)
+            else:
+                run_tests(options_name, build_only_tests)
+        except subprocess.CalledProcessError as e:
+            sys.exit(e.returncode)
 
     if args.report:
         generate_code_coverage_report()
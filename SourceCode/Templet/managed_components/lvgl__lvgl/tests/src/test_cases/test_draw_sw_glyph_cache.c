@@ -0,0 +1,199 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+
+#include "unity/unity.h"
+#include "lv_test_helpers.h"
+
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+
+#define FB_SIZE     (800 * 480)
+
+extern lv_color_t test_fb[];
+
+static lv_color_t ref_fb[FB_SIZE];
+
+static void create_labels(void)
+{
+    static const char * txt = "Lorem ipsum dolor sit amet,\nconsectetur adipiscing elit 0123456789";
+
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_obj_set_pos(label, 10, 10);
+    lv_label_set_text(label, txt);
+
+    label = lv_label_create(lv_scr_act());
+    lv_obj_set_pos(label, 10, 80);
+    lv_obj_set_style_text_font(label, &lv_font_unscii_8, 0);
+    lv_label_set_text(label, txt);
+
+    /*Translucent*/
+    label = lv_label_create(lv_scr_act());
+    lv_obj_set_pos(label, 10, 120);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_24, 0);
+    lv_obj_set_style_text_opa(label, LV_OPA_50, 0);
+    lv_label_set_text(label, txt);
+
+    /*Clipped and masked by the rounded corners of the parent*/
+    lv_obj_t * cont = lv_obj_create(lv_scr_act());
+    lv_obj_set_pos(cont, 10, 220);
+    lv_obj_set_size(cont, 300, 60);
+    lv_obj_set_style_radius(cont, 30, 0);
+    lv_obj_set_style_clip_corner(cont, true, 0);
+    lv_obj_set_style_pad_all(cont, 0, 0);
+    label = lv_label_create(cont);
+    lv_obj_set_pos(label, -5, -3);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_24, 0);
+    lv_label_set_text(label, txt);
+}
+
+static void refresh(void)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    lv_draw_sw_glyph_cache_clear();
+    lv_draw_sw_glyph_cache_set_size(LV_DRAW_SW_GLYPH_CACHE_SIZE);
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    lv_draw_sw_glyph_cache_clear();
+    lv_draw_sw_glyph_cache_set_size(LV_DRAW_SW_GLYPH_CACHE_SIZE);
+    lv_obj_clean(lv_scr_act());
+#endif
+}
+
+void test_draw_sw_glyph_cache_renders_the_same(void)
+{
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    create_labels();
+
+    /*Reference without cache*/
+    lv_draw_sw_glyph_cache_set_size(0);
+    refresh();
+    lv_memcpy(ref_fb, test_fb, sizeof(ref_fb));
+
+    lv_draw_sw_glyph_cache_info_t info;
+    lv_draw_sw_glyph_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(0, info.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, info.hit_cnt);
+
+    lv_draw_sw_glyph_cache_set_size(64 * 1024);
+    refresh();
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+
+    lv_draw_sw_glyph_cache_get_info(&info);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, info.entry_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, info.used);
+    uint32_t miss_cnt = info.miss_cnt;
+
+    /*The second frame is drawn from the cache only*/
+    refresh();
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+    lv_draw_sw_glyph_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(miss_cnt, info.miss_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(miss_cnt, info.hit_cnt);
+#endif
+}
+
+void test_draw_sw_glyph_cache_stays_in_the_budget(void)
+{
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    create_labels();
+    lv_draw_sw_glyph_cache_set_size(0);
+    refresh();
+    lv_memcpy(ref_fb, test_fb, sizeof(ref_fb));
+
+    lv_draw_sw_glyph_cache_set_size(64 * 1024);
+    refresh();
+
+    lv_draw_sw_glyph_cache_info_t info;
+    lv_draw_sw_glyph_cache_get_info(&info);
+    uint32_t entry_cnt = info.entry_cnt;
+
+    /*Shrinking drops the least recently used glyphs*/
+    lv_draw_sw_glyph_cache_set_size(info.used / 2);
+    lv_draw_sw_glyph_cache_get_info(&info);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(info.size, info.used);
+    TEST_ASSERT_LESS_THAN_UINT32(entry_cnt, info.entry_cnt);
+
+    /*Glyphs keep replacing each other but the result is the same*/
+    refresh();
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+    lv_draw_sw_glyph_cache_get_info(&info);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(info.size, info.used);
+#endif
+}
+
+void test_draw_sw_glyph_cache_drops_a_font(void)
+{
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_obj_set_style_text_font(label, &lv_font_unscii_8, 0);
+    lv_label_set_text(label, "ABC");
+    refresh();
+
+    lv_draw_sw_glyph_cache_info_t info;
+    lv_draw_sw_glyph_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(3, info.entry_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, info.used);
+
+    lv_draw_sw_glyph_cache_drop_font(&lv_font_montserrat_14);
+    lv_draw_sw_glyph_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(3, info.entry_cnt);
+
+    lv_draw_sw_glyph_cache_drop_font(&lv_font_unscii_8);
+    lv_draw_sw_glyph_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(0, info.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, info.used);
+#endif
+}
+
+void test_draw_sw_glyph_cache_doesnt_leak(void)
+{
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    create_labels();
+    lv_draw_sw_glyph_cache_set_size(0);
+    refresh();
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    uint32_t used_cnt = mon.used_cnt;
+    LV_UNUSED(used_cnt);
+
+    /*A small budget to keep replacing the glyphs*/
+    lv_draw_sw_glyph_cache_set_size(1024);
+    refresh();
+    uint32_t free_size = lv_test_get_free_mem();
+    LV_UNUSED(free_size);
+    uint32_t i;
+    for(i = 0; i < 5; i++) refresh();
+
+    lv_draw_sw_glyph_cache_info_t info;
+    lv_draw_sw_glyph_cache_get_info(&info);
+    TEST_ASSERT_GREATER_THAN_UINT32(info.entry_cnt, info.miss_cnt);
+
+    /*The glyphs come and go in the pool, the heap doesn't change*/
+    LV_HEAP_CHECK(TEST_ASSERT_EQUAL_UINT32(free_size, lv_test_get_free_mem()));
+
+    lv_draw_sw_glyph_cache_clear();
+    lv_draw_sw_glyph_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(0, info.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, info.used);
+
+    /*All the glyphs and the pool are freed*/
+    lv_draw_sw_glyph_cache_set_size(0);
+    lv_mem_monitor(&mon);
+    LV_HEAP_CHECK(TEST_ASSERT_EQUAL_UINT32(used_cnt, mon.used_cnt));
+#endif
+}
+
+#endif
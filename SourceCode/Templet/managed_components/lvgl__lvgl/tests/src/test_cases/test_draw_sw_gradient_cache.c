@@ -0,0 +1,188 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+extern lv_color_t test_fb[];
+
+static void init_grad(lv_grad_dsc_t * g, lv_color_t c1, lv_color_t c2)
+{
+    lv_memset_00(g, sizeof(*g));
+    g->dir = LV_GRAD_DIR_VER;
+    g->stops_count = 2;
+    g->stops[0].color = c1;
+    g->stops[0].frac = 0;
+    g->stops[1].color = c2;
+    g->stops[1].frac = 255;
+}
+
+/*Overwrite the first computed color to see if the map is recalculated*/
+static void set_marker(lv_grad_t * grad)
+{
+#if _DITHER_GRADIENT
+    grad->hmap[0].full = 0x12345678;
+#else
+    grad->map[0] = lv_color_hex(0x123456);
+#endif
+}
+
+static bool has_marker(lv_grad_t * grad)
+{
+#if _DITHER_GRADIENT
+    return grad->hmap[0].full == 0x12345678;
+#else
+    return grad->map[0].full == lv_color_hex(0x123456).full;
+#endif
+}
+
+/*Get a gradient, mark it and release it*/
+static lv_grad_t * get_marked(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
+{
+    lv_grad_t * grad = lv_gradient_get(g, w, h);
+    TEST_ASSERT_NOT_NULL(grad);
+    bool cached = has_marker(grad);
+    set_marker(grad);
+    lv_gradient_cleanup(grad);
+    return cached ? grad : NULL;
+}
+
+void setUp(void)
+{
+    lv_gradient_free_cache();
+    lv_gradient_set_cache_size(8 * 1024);
+}
+
+void tearDown(void)
+{
+    lv_gradient_free_cache();
+    lv_gradient_set_cache_size(LV_GRAD_CACHE_DEF_SIZE);
+    lv_obj_clean(lv_scr_act());
+}
+
+void test_gradient_cache_uses_the_content_of_the_descriptor(void)
+{
+    lv_grad_dsc_t g1;
+    lv_grad_dsc_t g2;
+    init_grad(&g1, lv_color_hex(0xff0000), lv_color_hex(0x0000ff));
+    init_grad(&g2, lv_color_hex(0xff0000), lv_color_hex(0x0000ff));
+
+    TEST_ASSERT_NULL(get_marked(&g1, 50, 60));
+    TEST_ASSERT_NOT_NULL(get_marked(&g2, 50, 60));
+    TEST_ASSERT_NOT_NULL(get_marked(&g1, 50, 60));
+
+    /*Different size*/
+    TEST_ASSERT_NULL(get_marked(&g1, 51, 60));
+    TEST_ASSERT_NULL(get_marked(&g1, 50, 61));
+
+    /*Different colors, positions and direction*/
+    g2.stops[1].color = lv_color_hex(0x00ff00);
+    TEST_ASSERT_NULL(get_marked(&g2, 50, 60));
+    g2.stops[1].frac = 200;
+    TEST_ASSERT_NULL(get_marked(&g2, 50, 60));
+    g2.dir = LV_GRAD_DIR_HOR;
+    TEST_ASSERT_NULL(get_marked(&g2, 50, 60));
+
+    /*All of them are still there*/
+    TEST_ASSERT_NOT_NULL(get_marked(&g1, 50, 60));
+    TEST_ASSERT_NOT_NULL(get_marked(&g1, 51, 60));
+    TEST_ASSERT_NOT_NULL(get_marked(&g2, 50, 60));
+}
+
+void test_gradient_cache_frees_the_least_recently_used(void)
+{
+    lv_grad_dsc_t g[4];
+    uint32_t i;
+    for(i = 0; i < 4; i++) {
+        init_grad(&g[i], lv_color_hex(0x101010 * i), lv_color_hex(0xffffff));
+    }
+
+    /*About 3 items fit into the cache*/
+    lv_gradient_free_cache();
+    lv_grad_t * grad = lv_gradient_get(&g[0], 100, 100);
+    size_t item_size = (uint8_t *)grad->map - (uint8_t *)grad + 100 * sizeof(lv_color_t);
+#if _DITHER_GRADIENT
+    item_size += 100 * sizeof(lv_color32_t);
+#if LV_DITHER_ERROR_DIFFUSION
+    item_size += 100 * sizeof(lv_scolor24_t);
+#endif
+#endif
+    lv_gradient_cleanup(grad);
+    lv_gradient_free_cache();
+    lv_gradient_set_cache_size(item_size * 3 + item_size / 2);
+
+    for(i = 0; i < 3; i++) {
+        TEST_ASSERT_NULL(get_marked(&g[i], 100, 100));
+    }
+
+    /*Use the first one again so the second is the oldest*/
+    TEST_ASSERT_NOT_NULL(get_marked(&g[0], 100, 100));
+    TEST_ASSERT_NULL(get_marked(&g[3], 100, 100));
+
+    TEST_ASSERT_NOT_NULL(get_marked(&g[0], 100, 100));
+    TEST_ASSERT_NOT_NULL(get_marked(&g[2], 100, 100));
+    TEST_ASSERT_NOT_NULL(get_marked(&g[3], 100, 100));
+    TEST_ASSERT_NULL(get_marked(&g[1], 100, 100));
+
+    /*Shrinking the cache frees the oldest items*/
+    lv_gradient_set_cache_size(item_size + item_size / 2);
+    TEST_ASSERT_NOT_NULL(get_marked(&g[1], 100, 100));
+    TEST_ASSERT_NULL(get_marked(&g[3], 100, 100));
+}
+
+void test_gradient_cache_reuses_the_buffer_of_large_gradients(void)
+{
+    lv_grad_dsc_t g1;
+    lv_grad_dsc_t g2;
+    init_grad(&g1, lv_color_hex(0xff0000), lv_color_hex(0x0000ff));
+    init_grad(&g2, lv_color_hex(0x00ff00), lv_color_hex(0x0000ff));
+
+    lv_gradient_set_cache_size(0);
+    TEST_ASSERT_NULL(get_marked(&g1, 400, 300));
+    lv_grad_t * spare = get_marked(&g1, 400, 300);
+    TEST_ASSERT_NOT_NULL(spare);
+
+    /*Smaller gradients reuse the same buffer*/
+    lv_grad_t * grad = lv_gradient_get(&g2, 200, 300);
+    TEST_ASSERT_EQUAL_PTR(spare, grad);
+    TEST_ASSERT_FALSE(has_marker(grad));
+
+    /*If the buffer is in use a new one is allocated*/
+    lv_grad_t * grad2 = lv_gradient_get(&g1, 200, 300);
+    TEST_ASSERT_NOT_NULL(grad2);
+    TEST_ASSERT_NOT_EQUAL(spare, grad2);
+    lv_gradient_cleanup(grad2);
+    lv_gradient_cleanup(grad);
+
+    TEST_ASSERT_EQUAL_PTR(spare, lv_gradient_get(&g1, 400, 300));
+    lv_gradient_cleanup(spare);
+}
+
+void test_gradient_cache_draws_different_gradients_of_the_same_size(void)
+{
+    lv_obj_t * obj1 = lv_obj_create(lv_scr_act());
+    lv_obj_set_pos(obj1, 10, 10);
+    lv_obj_set_size(obj1, 100, 100);
+    lv_obj_set_style_bg_color(obj1, lv_color_hex(0xff0000), 0);
+    lv_obj_set_style_bg_grad_color(obj1, lv_color_hex(0x000000), 0);
+    lv_obj_set_style_bg_grad_dir(obj1, LV_GRAD_DIR_VER, 0);
+
+    lv_obj_t * obj2 = lv_obj_create(lv_scr_act());
+    lv_obj_set_pos(obj2, 200, 10);
+    lv_obj_set_size(obj2, 100, 100);
+    lv_obj_set_style_bg_color(obj2, lv_color_hex(0x0000ff), 0);
+    lv_obj_set_style_bg_grad_color(obj2, lv_color_hex(0x000000), 0);
+    lv_obj_set_style_bg_grad_dir(obj2, LV_GRAD_DIR_VER, 0);
+
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+
+    /*The same size used to be enough to get the map of the other gradient*/
+    lv_color_t c1 = test_fb[40 * 800 + 60];
+    lv_color_t c2 = test_fb[40 * 800 + 250];
+    TEST_ASSERT_GREATER_THAN(100, c1.ch.red);
+    TEST_ASSERT_EQUAL(0, c1.ch.blue);
+    TEST_ASSERT_GREATER_THAN(100, c2.ch.blue);
+    TEST_ASSERT_EQUAL(0, c2.ch.red);
+}
+
+#endif
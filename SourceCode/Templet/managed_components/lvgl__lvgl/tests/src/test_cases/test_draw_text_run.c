@@ -0,0 +1,174 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+
+#include "unity/unity.h"
+
+#define FB_SIZE     (800 * 480)
+
+#if LV_FONT_MONTSERRAT_24
+    #define LARGE_FONT  (&lv_font_montserrat_24)
+#else
+    #define LARGE_FONT  LV_FONT_DEFAULT
+#endif
+
+extern lv_color_t test_fb[];
+
+static lv_color_t ref_fb[FB_SIZE];
+static uint32_t run_cnt;
+static uint32_t run_glyph_cnt;
+static uint32_t letter_cnt;
+
+static void count_text_run(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                           const lv_draw_label_glyph_t * glyphs, uint32_t glyph_cnt)
+{
+    run_cnt++;
+    run_glyph_cnt += glyph_cnt;
+    lv_draw_sw_text_run(draw_ctx, dsc, glyphs, glyph_cnt);
+}
+
+static void count_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos_p,
+                         uint32_t letter)
+{
+    letter_cnt++;
+    lv_draw_sw_letter(draw_ctx, dsc, pos_p, letter);
+}
+
+static lv_draw_ctx_t * get_draw_ctx(void)
+{
+    return lv_disp_get_default()->driver->draw_ctx;
+}
+
+static void create_labels(void)
+{
+    static const char * txt = "Lorem ipsum dolor sit amet,\nconsectetur adipiscing elit 0123456789";
+
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_obj_set_pos(label, 10, 10);
+    lv_label_set_text(label, txt);
+
+    label = lv_label_create(lv_scr_act());
+    lv_obj_set_pos(label, 10, 60);
+    lv_obj_set_style_text_font(label, &lv_font_unscii_8, 0);
+    lv_label_set_text(label, txt);
+
+    /*Translucent and centered*/
+    label = lv_label_create(lv_scr_act());
+    lv_obj_set_pos(label, 10, 100);
+    lv_obj_set_width(label, 500);
+    lv_obj_set_style_text_font(label, LARGE_FONT, 0);
+    lv_obj_set_style_text_opa(label, LV_OPA_50, 0);
+    lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0);
+    lv_label_set_text(label, txt);
+
+    /*Recolored and underlined*/
+    label = lv_label_create(lv_scr_act());
+    lv_obj_set_pos(label, 10, 180);
+    lv_obj_set_style_text_decor(label, LV_TEXT_DECOR_UNDERLINE, 0);
+    lv_label_set_recolor(label, true);
+    lv_label_set_text(label, "Some #ff0000 red# and #0000ff blue# words");
+
+    /*Selected*/
+    label = lv_label_create(lv_scr_act());
+    lv_obj_set_pos(label, 10, 210);
+    lv_label_set_text(label, txt);
+    lv_label_set_text_sel_start(label, 6);
+    lv_label_set_text_sel_end(label, 17);
+
+    /*Clipped and masked by the rounded corners of the parent*/
+    lv_obj_t * cont = lv_obj_create(lv_scr_act());
+    lv_obj_set_pos(cont, 10, 280);
+    lv_obj_set_size(cont, 300, 60);
+    lv_obj_set_style_radius(cont, 30, 0);
+    lv_obj_set_style_clip_corner(cont, true, 0);
+    lv_obj_set_style_pad_all(cont, 0, 0);
+    label = lv_label_create(cont);
+    lv_obj_set_pos(label, -5, -3);
+    lv_obj_set_style_text_font(label, LARGE_FONT, 0);
+    lv_label_set_text(label, txt);
+}
+
+static void refresh(void)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+void setUp(void)
+{
+    run_cnt = 0;
+    run_glyph_cnt = 0;
+    letter_cnt = 0;
+}
+
+void tearDown(void)
+{
+    get_draw_ctx()->draw_text_run = lv_draw_sw_text_run;
+    get_draw_ctx()->draw_letter = lv_draw_sw_letter;
+    lv_obj_clean(lv_scr_act());
+}
+
+void test_draw_text_run_renders_like_the_letters(void)
+{
+    create_labels();
+
+    /*Reference with the letters drawn one by one*/
+    get_draw_ctx()->draw_text_run = NULL;
+    refresh();
+    lv_memcpy(ref_fb, test_fb, sizeof(ref_fb));
+
+    get_draw_ctx()->draw_text_run = count_text_run;
+    refresh();
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+    TEST_ASSERT_GREATER_THAN_UINT32(0, run_cnt);
+
+#if LV_USE_DRAW_SW_GLYPH_CACHE
+    /*Read the glyphs from the fonts too*/
+    lv_draw_sw_glyph_cache_set_size(0);
+    refresh();
+    lv_draw_sw_glyph_cache_set_size(LV_DRAW_SW_GLYPH_CACHE_SIZE);
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+#endif
+}
+
+void test_draw_text_run_draws_a_line_at_once(void)
+{
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_label_set_text(label, "Hello\nworld!");
+
+    get_draw_ctx()->draw_text_run = count_text_run;
+    refresh();
+
+    TEST_ASSERT_EQUAL_UINT32(2, run_cnt);
+    TEST_ASSERT_EQUAL_UINT32(12, run_glyph_cnt);    /*Including the '\n'*/
+}
+
+void test_draw_text_run_splits_at_color_changes(void)
+{
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_label_set_recolor(label, true);
+    lv_label_set_text(label, "ab #ff0000 cd# ef");
+
+    get_draw_ctx()->draw_text_run = count_text_run;
+    refresh();
+
+    TEST_ASSERT_EQUAL_UINT32(3, run_cnt);
+}
+
+void test_draw_text_run_falls_back_to_letters(void)
+{
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_label_set_text(label, "Hello");
+
+    lv_draw_ctx_t * draw_ctx = get_draw_ctx();
+    draw_ctx->draw_letter = count_letter;
+    refresh();
+    TEST_ASSERT_EQUAL_UINT32(0, letter_cnt);
+
+    /*Without `draw_text_run` the letters are drawn by `draw_letter`*/
+    draw_ctx->draw_text_run = NULL;
+    refresh();
+    TEST_ASSERT_EQUAL_UINT32(5, letter_cnt);
+}
+
+#endif
@@ -0,0 +1,140 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED
+
+#define FONT        (&lv_font_montserrat_28_compressed)
+#define FIRST       'A'
+#define LAST        'z'
+
+static uint8_t ref_bitmaps[LAST - FIRST + 1][64 * 64 / 2];
+
+static uint32_t get_bitmap_size(uint32_t letter)
+{
+    lv_font_glyph_dsc_t g;
+    TEST_ASSERT_TRUE(lv_font_get_glyph_dsc(FONT, &g, letter, 0));
+    TEST_ASSERT_EQUAL_UINT8(4, g.bpp);
+    uint32_t size = ((uint32_t)g.box_w * g.box_h + 1) / 2;
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(sizeof(ref_bitmaps[0]), size);
+    return size;
+}
+
+/*Decompress the glyphs without the cache*/
+static void create_refs(void)
+{
+    lv_font_fmt_txt_decompr_cache_set_size(0);
+    uint32_t letter;
+    for(letter = FIRST; letter <= LAST; letter++) {
+        const uint8_t * bitmap = lv_font_get_glyph_bitmap(FONT, letter);
+        TEST_ASSERT_NOT_NULL(bitmap);
+        lv_memcpy(ref_bitmaps[letter - FIRST], bitmap, get_bitmap_size(letter));
+    }
+}
+
+static void check_bitmaps(void)
+{
+    uint32_t letter;
+    for(letter = FIRST; letter <= LAST; letter++) {
+        const uint8_t * bitmap = lv_font_get_glyph_bitmap(FONT, letter);
+        TEST_ASSERT_NOT_NULL(bitmap);
+        TEST_ASSERT_EQUAL_MEMORY(ref_bitmaps[letter - FIRST], bitmap, get_bitmap_size(letter));
+    }
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_USE_FONT_COMPRESSED
+    lv_font_fmt_txt_decompr_cache_clear();
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_USE_FONT_COMPRESSED
+    lv_font_fmt_txt_decompr_cache_clear();
+    lv_font_fmt_txt_decompr_cache_set_size(LV_FONT_DECOMPR_CACHE_SIZE);
+#endif
+}
+
+void test_font_decompr_cache_keeps_the_glyphs(void)
+{
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED
+    create_refs();
+
+    lv_font_fmt_txt_decompr_cache_info_t info;
+    lv_font_fmt_txt_decompr_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(0, info.entry_cnt);
+
+    lv_font_fmt_txt_decompr_cache_set_size(64 * 1024);
+    check_bitmaps();
+    lv_font_fmt_txt_decompr_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(LAST - FIRST + 1, info.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(LAST - FIRST + 1, info.miss_cnt);
+
+    /*The glyphs are kept after a refresh too*/
+    lv_refr_now(NULL);
+    check_bitmaps();
+    lv_font_fmt_txt_decompr_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(LAST - FIRST + 1, info.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(LAST - FIRST + 1, info.hit_cnt);
+#endif
+}
+
+void test_font_decompr_cache_stays_in_the_budget(void)
+{
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED
+    create_refs();
+
+    lv_font_fmt_txt_decompr_cache_set_size(64 * 1024);
+    check_bitmaps();
+
+    lv_font_fmt_txt_decompr_cache_info_t info;
+    lv_font_fmt_txt_decompr_cache_get_info(&info);
+    uint32_t entry_cnt = info.entry_cnt;
+
+    /*Shrinking drops the least recently used glyphs*/
+    lv_font_fmt_txt_decompr_cache_set_size(info.used / 3);
+    lv_font_fmt_txt_decompr_cache_get_info(&info);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(info.size, info.used);
+    TEST_ASSERT_LESS_THAN_UINT32(entry_cnt, info.entry_cnt);
+
+    /*The most recently used glyph is still there*/
+    uint32_t hit_cnt = info.hit_cnt;
+    lv_font_get_glyph_bitmap(FONT, LAST);
+    lv_font_fmt_txt_decompr_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(hit_cnt + 1, info.hit_cnt);
+
+    /*The glyphs keep replacing each other but the result is the same*/
+    check_bitmaps();
+    lv_font_fmt_txt_decompr_cache_get_info(&info);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(info.size, info.used);
+#endif
+}
+
+void test_font_decompr_cache_drops_a_font(void)
+{
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED
+    lv_font_get_glyph_bitmap(FONT, 'A');
+    lv_font_get_glyph_bitmap(FONT, 'B');
+
+    lv_font_fmt_txt_decompr_cache_info_t info;
+    lv_font_fmt_txt_decompr_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(2, info.entry_cnt);
+
+    /*Not compressed, nothing to drop*/
+    lv_font_fmt_txt_decompr_cache_drop_font(&lv_font_montserrat_14);
+    lv_font_fmt_txt_decompr_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(2, info.entry_cnt);
+
+    lv_font_fmt_txt_decompr_cache_drop_font(FONT);
+    lv_font_fmt_txt_decompr_cache_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(0, info.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, info.used);
+#endif
+}
+
+#endif
@@ -0,0 +1,81 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*Compare the glyphs of all the letters with and without the lookup table*/
+static void check_font(const lv_font_t * font)
+{
+    static lv_font_glyph_dsc_t ref[0x10000];
+    uint32_t letter;
+
+    lv_font_fmt_txt_set_lookup(font, false);
+    for(letter = 0; letter < 0x10000; letter++) {
+        lv_memset_00(&ref[letter], sizeof(lv_font_glyph_dsc_t));
+        lv_font_get_glyph_dsc(font, &ref[letter], letter, 0);
+    }
+
+    lv_font_fmt_txt_set_lookup(font, true);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_font_fmt_txt_get_lookup_size(font));
+
+    for(letter = 0; letter < 0x10000; letter++) {
+        lv_font_glyph_dsc_t g;
+        lv_memset_00(&g, sizeof(g));
+        lv_font_get_glyph_dsc(font, &g, letter, 0);
+        TEST_ASSERT_EQUAL_MEMORY(&ref[letter], &g, sizeof(g));
+    }
+
+    TEST_ASSERT_GREATER_THAN_UINT32(0, lv_font_fmt_txt_get_lookup_size(font));
+}
+
+void setUp(void)
+{
+    /* Function run before every test */
+}
+
+void tearDown(void)
+{
+    lv_font_fmt_txt_set_lookup(&lv_font_montserrat_14, false);
+#if LV_FONT_SIMSUN_16_CJK
+    lv_font_fmt_txt_set_lookup(&lv_font_simsun_16_cjk, false);
+#endif
+}
+
+void test_font_fmt_txt_lookup_finds_the_same_glyphs(void)
+{
+    check_font(&lv_font_montserrat_14);
+    check_font(&lv_font_unscii_8);
+    lv_font_fmt_txt_set_lookup(&lv_font_unscii_8, false);
+
+#if LV_FONT_SIMSUN_16_CJK
+    check_font(&lv_font_simsun_16_cjk);
+#endif
+}
+
+void test_font_fmt_txt_lookup_can_be_freed(void)
+{
+    lv_font_glyph_dsc_t g;
+    lv_font_fmt_txt_set_lookup(&lv_font_montserrat_14, true);
+    lv_font_get_glyph_dsc(&lv_font_montserrat_14, &g, 'A', 'B');
+    uint32_t size = lv_font_fmt_txt_get_lookup_size(&lv_font_montserrat_14);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, size);
+
+    /*Very roughly 8 bytes per letter*/
+    TEST_ASSERT_LESS_THAN_UINT32(64 * 1024, size);
+
+    lv_font_fmt_txt_set_lookup(&lv_font_montserrat_14, false);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_font_fmt_txt_get_lookup_size(&lv_font_montserrat_14));
+
+    /*Works without the table too*/
+    TEST_ASSERT_TRUE(lv_font_get_glyph_dsc(&lv_font_montserrat_14, &g, 'A', 'B'));
+}
+
+void test_font_fmt_txt_lookup_of_a_loaded_font(void)
+{
+    lv_font_t * font = lv_font_load("A:src/test_fonts/font_1.fnt");
+    TEST_ASSERT_NOT_NULL(font);
+    check_font(font);
+    lv_font_free(font);
+}
+
+#endif
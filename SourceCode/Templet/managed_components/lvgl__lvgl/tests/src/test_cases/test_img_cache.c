@@ -0,0 +1,197 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#if LV_IMG_CACHE_DEF_SIZE
+
+#define IMG_W   10
+#define IMG_H   10
+#define IMG_SIZE    (IMG_W * IMG_H * LV_COLOR_SIZE / 8)
+
+static lv_img_decoder_t * decoder;
+static uint32_t open_cnt;
+static uint32_t close_cnt;
+
+/*Handled by the test decoder which allocates the decoded image like the PNG or JPG decoders*/
+static lv_img_dsc_t imgs[4];
+static const uint8_t raw_data[1];
+
+static lv_res_t test_decoder_info(lv_img_decoder_t * dec, const void * src, lv_img_header_t * header)
+{
+    LV_UNUSED(dec);
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_VARIABLE) return LV_RES_INV;
+    const lv_img_dsc_t * img = src;
+    if(img->header.cf != LV_IMG_CF_RAW) return LV_RES_INV;
+
+    header->w = img->header.w;
+    header->h = img->header.h;
+    header->cf = LV_IMG_CF_TRUE_COLOR;
+    return LV_RES_OK;
+}
+
+static lv_res_t test_decoder_open(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(dec);
+    open_cnt++;
+    dsc->img_data = lv_mem_alloc(lv_img_buf_get_img_size(dsc->header.w, dsc->header.h, dsc->header.cf));
+    return dsc->img_data ? LV_RES_OK : LV_RES_INV;
+}
+
+static void test_decoder_close(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(dec);
+    close_cnt++;
+    lv_mem_free((void *)dsc->img_data);
+    dsc->img_data = NULL;
+}
+
+static lv_img_cache_info_t get_info(void)
+{
+    lv_img_cache_info_t info;
+    lv_img_cache_get_info(&info);
+    return info;
+}
+
+static bool is_cached(const void * src)
+{
+    uint32_t miss_cnt = get_info().miss_cnt;
+    _lv_img_cache_open(src, lv_color_black(), 0);
+    return get_info().miss_cnt == miss_cnt;
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_invalidate_src(NULL);
+
+    decoder = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(decoder, test_decoder_info);
+    lv_img_decoder_set_open_cb(decoder, test_decoder_open);
+    lv_img_decoder_set_close_cb(decoder, test_decoder_close);
+
+    uint32_t i;
+    for(i = 0; i < sizeof(imgs) / sizeof(imgs[0]); i++) {
+        imgs[i].header.cf = LV_IMG_CF_RAW;
+        imgs[i].header.w = IMG_W;
+        imgs[i].header.h = IMG_H;
+        imgs[i].data = raw_data;
+        imgs[i].data_size = sizeof(raw_data);
+    }
+
+    open_cnt = 0;
+    close_cnt = 0;
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+    lv_img_cache_set_max_bytes(LV_IMG_CACHE_DEF_BYTES);
+    lv_img_decoder_delete(decoder);
+#endif
+}
+
+void test_img_cache_closes_the_least_recently_used(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_set_size(3);
+    lv_img_cache_info_t start = get_info();
+
+    TEST_ASSERT_FALSE(is_cached(&imgs[0]));
+    TEST_ASSERT_FALSE(is_cached(&imgs[1]));
+    TEST_ASSERT_FALSE(is_cached(&imgs[2]));
+
+    /*Now imgs[1] is the least recently used*/
+    TEST_ASSERT_TRUE(is_cached(&imgs[0]));
+
+    TEST_ASSERT_FALSE(is_cached(&imgs[3]));
+    TEST_ASSERT_TRUE(is_cached(&imgs[0]));
+    TEST_ASSERT_TRUE(is_cached(&imgs[2]));
+    TEST_ASSERT_TRUE(is_cached(&imgs[3]));
+    TEST_ASSERT_FALSE(is_cached(&imgs[1]));
+
+    lv_img_cache_info_t info = get_info();
+    TEST_ASSERT_EQUAL_UINT32(3, info.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(3 * IMG_SIZE, info.used);
+    TEST_ASSERT_EQUAL_UINT32(4, info.hit_cnt - start.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(5, info.miss_cnt - start.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2, info.evict_cnt - start.evict_cnt);
+    TEST_ASSERT_EQUAL_UINT32(5, open_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2, close_cnt);
+
+    /*Shrinking the cache closes the least recently used images*/
+    lv_img_cache_set_size(1);
+    TEST_ASSERT_EQUAL_UINT32(1, get_info().entry_cnt);
+    TEST_ASSERT_TRUE(is_cached(&imgs[1]));
+#endif
+}
+
+void test_img_cache_byte_budget(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_set_max_bytes(IMG_SIZE * 5 / 2);
+
+    TEST_ASSERT_FALSE(is_cached(&imgs[0]));
+    TEST_ASSERT_FALSE(is_cached(&imgs[1]));
+    TEST_ASSERT_FALSE(is_cached(&imgs[2]));
+
+    lv_img_cache_info_t info = get_info();
+    TEST_ASSERT_EQUAL_UINT32(2, info.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2 * IMG_SIZE, info.used);
+    TEST_ASSERT_EQUAL_UINT32(1, close_cnt);
+    TEST_ASSERT_TRUE(is_cached(&imgs[2]));
+    TEST_ASSERT_TRUE(is_cached(&imgs[1]));
+
+    /*The image to draw is kept even if it doesn't fit alone*/
+    lv_img_cache_set_max_bytes(IMG_SIZE / 2);
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().entry_cnt);
+    TEST_ASSERT_FALSE(is_cached(&imgs[3]));
+    TEST_ASSERT_EQUAL_UINT32(1, get_info().entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(IMG_SIZE, get_info().used);
+
+    /*Images used directly from a variable don't count*/
+    lv_img_cache_set_max_bytes(IMG_SIZE);
+    static lv_color_t px[IMG_W * IMG_H];
+    lv_img_dsc_t var_img;
+    lv_memset_00(&var_img, sizeof(var_img));
+    var_img.header.cf = LV_IMG_CF_TRUE_COLOR;
+    var_img.header.w = IMG_W;
+    var_img.header.h = IMG_H;
+    var_img.data = (const uint8_t *)px;
+    var_img.data_size = sizeof(px);
+    TEST_ASSERT_FALSE(is_cached(&var_img));
+    TEST_ASSERT_EQUAL_UINT32(2, get_info().entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(IMG_SIZE, get_info().used);
+    lv_img_cache_invalidate_src(&var_img);
+#endif
+}
+
+void test_img_cache_invalidate_src(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    _lv_img_cache_open(&imgs[0], lv_color_black(), 0);
+    _lv_img_cache_open(&imgs[0], lv_color_white(), 0);
+    _lv_img_cache_open(&imgs[0], lv_color_black(), 1);
+    _lv_img_cache_open(&imgs[1], lv_color_black(), 0);
+    TEST_ASSERT_EQUAL_UINT32(4, get_info().entry_cnt);
+
+    /*All the colors and frames of the source are closed*/
+    lv_img_cache_invalidate_src(&imgs[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, get_info().entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(IMG_SIZE, get_info().used);
+    TEST_ASSERT_EQUAL_UINT32(3, close_cnt);
+    TEST_ASSERT_TRUE(is_cached(&imgs[1]));
+
+    lv_img_cache_invalidate_src(NULL);
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().used);
+    TEST_ASSERT_EQUAL_UINT32(4, close_cnt);
+#endif
+}
+
+#endif
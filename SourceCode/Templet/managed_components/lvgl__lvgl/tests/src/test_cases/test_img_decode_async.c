@@ -0,0 +1,280 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <unistd.h>
+#include <pthread.h>
+
+#if LV_USE_IMG_DECODE_ASYNC
+
+#define IMG_W   20
+#define IMG_H   20
+#define IMG_CNT (LV_IMG_DECODE_ASYNC_QUEUE_LEN + 1)
+
+extern lv_color_t test_fb[];
+
+static lv_img_decoder_t * decoder;
+
+/*Handled by the test decoder which fills the image with green*/
+static lv_img_dsc_t imgs[IMG_CNT];
+static const uint8_t raw_data[1];
+
+/*The order in which the images were decoded*/
+static const void * decoded[IMG_CNT * 2];
+static uint32_t decoded_cnt;
+static uint32_t decoded_on_main_cnt;
+
+/*The decoder thread waits here to let the test queue more images meanwhile*/
+static volatile bool gate_open;
+static pthread_t main_thread;
+
+static lv_res_t test_decoder_info(lv_img_decoder_t * dec, const void * src, lv_img_header_t * header)
+{
+    LV_UNUSED(dec);
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_VARIABLE) return LV_RES_INV;
+    const lv_img_dsc_t * img = src;
+    if(img->header.cf != LV_IMG_CF_RAW) return LV_RES_INV;
+
+    header->w = img->header.w;
+    header->h = img->header.h;
+    header->cf = LV_IMG_CF_TRUE_COLOR;
+    return LV_RES_OK;
+}
+
+static lv_res_t test_decoder_open(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(dec);
+    while(!gate_open && !pthread_equal(pthread_self(), main_thread)) usleep(100);
+
+    decoded[decoded_cnt++] = dsc->src;
+    if(pthread_equal(pthread_self(), main_thread)) decoded_on_main_cnt++;
+
+    uint32_t px_cnt = (uint32_t)dsc->header.w * dsc->header.h;
+    lv_color_t * buf = lv_mem_alloc(px_cnt * sizeof(lv_color_t));
+    if(buf == NULL) return LV_RES_INV;
+    uint32_t i;
+    for(i = 0; i < px_cnt; i++) buf[i] = lv_palette_main(LV_PALETTE_GREEN);
+    dsc->img_data = (const uint8_t *)buf;
+    return LV_RES_OK;
+}
+
+static void test_decoder_close(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(dec);
+    lv_mem_free((void *)dsc->img_data);
+    dsc->img_data = NULL;
+}
+
+static lv_obj_t * img_create(uint32_t idx)
+{
+    lv_obj_t * img = lv_img_create(lv_scr_act());
+    lv_img_set_src(img, &imgs[idx]);
+    lv_obj_set_pos(img, idx * (IMG_W + 10), 10);
+    return img;
+}
+
+static lv_color_t get_px(lv_obj_t * img)
+{
+    lv_area_t a;
+    lv_obj_get_coords(img, &a);
+    return test_fb[(a.y1 + IMG_H / 2) * 800 + a.x1 + IMG_W / 2];
+}
+
+/*The flush callback copies only the refreshed area to `test_fb`, refresh the whole screen to read the pixels*/
+static void refr_all(void)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+/*Let the images to be decoded and added to the cache*/
+static void wait_decoded(void)
+{
+    gate_open = true;
+    uint32_t i;
+    for(i = 0; i < 1000 && lv_img_decode_async_get_pending_cnt(); i++) {
+        lv_timer_handler();
+        lv_tick_inc(10);
+        usleep(1000);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, lv_img_decode_async_get_pending_cnt());
+}
+
+static int32_t get_decode_order(const void * src)
+{
+    uint32_t i;
+    for(i = 0; i < decoded_cnt; i++) {
+        if(decoded[i] == src) return i;
+    }
+    return -1;
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_USE_IMG_DECODE_ASYNC
+    lv_img_cache_invalidate_src(NULL);
+
+    decoder = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(decoder, test_decoder_info);
+    lv_img_decoder_set_open_cb(decoder, test_decoder_open);
+    lv_img_decoder_set_close_cb(decoder, test_decoder_close);
+    lv_img_decode_async_set_thread_safe(decoder, true);
+
+    uint32_t i;
+    for(i = 0; i < IMG_CNT; i++) {
+        imgs[i].header.cf = LV_IMG_CF_RAW;
+        imgs[i].header.w = IMG_W;
+        imgs[i].header.h = IMG_H;
+        imgs[i].data = raw_data;
+        imgs[i].data_size = sizeof(raw_data);
+    }
+
+    decoded_cnt = 0;
+    decoded_on_main_cnt = 0;
+    gate_open = false;
+    main_thread = pthread_self();
+    lv_img_decode_async_set_placeholder(lv_palette_main(LV_PALETTE_RED), LV_OPA_COVER);
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_USE_IMG_DECODE_ASYNC
+    gate_open = true;
+    lv_obj_clean(lv_scr_act());
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_decode_async_set_thread_safe(decoder, false);
+    lv_img_decoder_delete(decoder);
+    lv_img_decode_async_set_placeholder(lv_color_black(), LV_OPA_TRANSP);
+    lv_img_decode_async_set_enabled(true);
+#endif
+}
+
+void test_img_decode_async_draws_a_placeholder(void)
+{
+#if LV_USE_IMG_DECODE_ASYNC
+    lv_obj_t * img = img_create(0);
+    refr_all();
+
+    TEST_ASSERT_NULL(_lv_img_cache_find(&imgs[0], lv_color_black(), 0));
+    TEST_ASSERT_EQUAL_UINT32(1, lv_img_decode_async_get_pending_cnt());
+    TEST_ASSERT_EQUAL_HEX32(lv_palette_main(LV_PALETTE_RED).full, get_px(img).full);
+
+    /*The image is invalidated when it's decoded. Only its area is flushed so it's at the beginning of `test_fb`.*/
+    wait_decoded();
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_HEX32(lv_palette_main(LV_PALETTE_GREEN).full, test_fb[0].full);
+
+    refr_all();
+    TEST_ASSERT_NOT_NULL(_lv_img_cache_find(&imgs[0], lv_color_black(), 0));
+    TEST_ASSERT_EQUAL_HEX32(lv_palette_main(LV_PALETTE_GREEN).full, get_px(img).full);
+    TEST_ASSERT_EQUAL_UINT32(1, decoded_cnt);
+#endif
+}
+
+void test_img_decode_async_visible_first(void)
+{
+#if LV_USE_IMG_DECODE_ASYNC
+    TEST_ASSERT_TRUE(lv_img_decode_async_prefetch(&imgs[0]));
+    TEST_ASSERT_TRUE(lv_img_decode_async_prefetch(&imgs[1]));
+    img_create(2);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(3, lv_img_decode_async_get_pending_cnt());
+
+    wait_decoded();
+    TEST_ASSERT_EQUAL_UINT32(3, decoded_cnt);
+    TEST_ASSERT_LESS_THAN_INT32(get_decode_order(&imgs[1]), get_decode_order(&imgs[2]));
+
+    /*Already cached*/
+    TEST_ASSERT_TRUE(lv_img_decode_async_prefetch(&imgs[0]));
+    TEST_ASSERT_EQUAL_UINT32(0, lv_img_decode_async_get_pending_cnt());
+#endif
+}
+
+void test_img_decode_async_full_queue(void)
+{
+#if LV_USE_IMG_DECODE_ASYNC
+    /*The visible images replace the prefetched ones*/
+    uint32_t i;
+    for(i = 0; i < LV_IMG_DECODE_ASYNC_QUEUE_LEN; i++) {
+        TEST_ASSERT_TRUE(lv_img_decode_async_prefetch(&imgs[i + 1]));
+    }
+    TEST_ASSERT_FALSE(lv_img_decode_async_prefetch(&imgs[0]));
+
+    lv_obj_t * img = img_create(0);
+    refr_all();
+    TEST_ASSERT_NULL(_lv_img_cache_find(&imgs[0], lv_color_black(), 0));
+    TEST_ASSERT_EQUAL_HEX32(lv_palette_main(LV_PALETTE_RED).full, get_px(img).full);
+    TEST_ASSERT_EQUAL_UINT32(LV_IMG_DECODE_ASYNC_QUEUE_LEN, lv_img_decode_async_get_pending_cnt());
+    lv_obj_del(img);
+    wait_decoded();
+
+    /*If the queue is full of visible images the rest is decoded right away*/
+    lv_img_cache_invalidate_src(NULL);
+    decoded_cnt = 0;
+    gate_open = false;
+    lv_obj_t * objs[IMG_CNT];
+    for(i = 0; i < IMG_CNT; i++) objs[i] = img_create(i);
+
+    refr_all();
+    TEST_ASSERT_NOT_NULL(_lv_img_cache_find(&imgs[IMG_CNT - 1], lv_color_black(), 0));
+    TEST_ASSERT_EQUAL_HEX32(lv_palette_main(LV_PALETTE_RED).full, get_px(objs[0]).full);
+    TEST_ASSERT_EQUAL_HEX32(lv_palette_main(LV_PALETTE_GREEN).full, get_px(objs[IMG_CNT - 1]).full);
+
+    wait_decoded();
+    refr_all();
+    for(i = 0; i < IMG_CNT; i++) {
+        TEST_ASSERT_EQUAL_HEX32(lv_palette_main(LV_PALETTE_GREEN).full, get_px(objs[i]).full);
+    }
+#endif
+}
+
+void test_img_decode_async_invalidate_src_cancels(void)
+{
+#if LV_USE_IMG_DECODE_ASYNC
+    img_create(0);
+    img_create(1);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(2, lv_img_decode_async_get_pending_cnt());
+
+    gate_open = true;
+    lv_img_cache_invalidate_src(&imgs[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, lv_img_decode_async_get_pending_cnt());
+    lv_img_cache_invalidate_src(NULL);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_img_decode_async_get_pending_cnt());
+#endif
+}
+
+void test_img_decode_async_disabled(void)
+{
+#if LV_USE_IMG_DECODE_ASYNC
+    lv_img_decode_async_set_enabled(false);
+    lv_obj_t * img = img_create(0);
+    refr_all();
+
+    TEST_ASSERT_EQUAL_UINT32(0, lv_img_decode_async_get_pending_cnt());
+    TEST_ASSERT_EQUAL_HEX32(lv_palette_main(LV_PALETTE_GREEN).full, get_px(img).full);
+#endif
+}
+
+void test_img_decode_async_not_thread_safe_decoder(void)
+{
+#if LV_USE_IMG_DECODE_ASYNC
+    /*Its images are decoded on the main thread from the timer, but still in the background*/
+    lv_img_decode_async_set_thread_safe(decoder, false);
+    lv_obj_t * img = img_create(0);
+    refr_all();
+    TEST_ASSERT_EQUAL_UINT32(1, lv_img_decode_async_get_pending_cnt());
+    TEST_ASSERT_EQUAL_HEX32(lv_palette_main(LV_PALETTE_RED).full, get_px(img).full);
+
+    wait_decoded();
+    refr_all();
+    TEST_ASSERT_EQUAL_HEX32(lv_palette_main(LV_PALETTE_GREEN).full, get_px(img).full);
+    TEST_ASSERT_EQUAL_UINT32(1, decoded_on_main_cnt);
+#endif
+}
+
+#endif
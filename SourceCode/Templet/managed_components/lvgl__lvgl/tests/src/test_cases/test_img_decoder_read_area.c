@@ -0,0 +1,199 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+
+#define IMG_W   20
+#define IMG_H   30
+#define IMG_FILE    "/tmp/lv_test_read_area.bin"
+
+extern lv_color_t test_fb[];
+
+static lv_img_decoder_t * decoder;
+static uint32_t read_line_cnt;
+static uint32_t read_area_cnt;
+static uint32_t read_row_cnt;
+
+/*Handled by the test decoder which can't decode the whole image at once*/
+static lv_img_dsc_t img;
+static const uint8_t raw_data[1];
+
+static lv_color_t get_img_px(lv_coord_t x, lv_coord_t y)
+{
+    return lv_color_make(x * 8, y * 8, 0x80);
+}
+
+static lv_res_t test_decoder_info(lv_img_decoder_t * dec, const void * src, lv_img_header_t * header)
+{
+    LV_UNUSED(dec);
+    if(src != &img) return LV_RES_INV;
+
+    header->w = IMG_W;
+    header->h = IMG_H;
+    header->cf = LV_IMG_CF_TRUE_COLOR;
+    return LV_RES_OK;
+}
+
+static lv_res_t test_decoder_open(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(dec);
+    dsc->img_data = NULL;
+    return LV_RES_OK;
+}
+
+static lv_res_t test_decoder_read_line(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                       lv_coord_t y, lv_coord_t len, uint8_t * buf)
+{
+    LV_UNUSED(dec);
+    LV_UNUSED(dsc);
+    read_line_cnt++;
+    read_row_cnt++;
+    lv_color_t * px = (lv_color_t *)buf;
+    lv_coord_t i;
+    for(i = 0; i < len; i++) px[i] = get_img_px(x + i, y);
+    return LV_RES_OK;
+}
+
+static lv_res_t test_decoder_read_area(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                       lv_coord_t y, lv_coord_t w, lv_coord_t h, uint8_t * buf)
+{
+    LV_UNUSED(dec);
+    LV_UNUSED(dsc);
+    read_area_cnt++;
+    read_row_cnt += h;
+    lv_color_t * px = (lv_color_t *)buf;
+    lv_coord_t i;
+    lv_coord_t j;
+    for(j = 0; j < h; j++) {
+        for(i = 0; i < w; i++) *px++ = get_img_px(x + i, y + j);
+    }
+    return LV_RES_OK;
+}
+
+/*The flush callback copies only the refreshed area to `test_fb`, refresh the whole screen to read the pixels*/
+static void refr_all(void)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+static void check_pixels(lv_obj_t * obj)
+{
+    lv_area_t a;
+    lv_obj_get_coords(obj, &a);
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = 0; y < IMG_H; y++) {
+        for(x = LV_MAX(0, -a.x1); x < IMG_W; x++) {
+            lv_color_t c = test_fb[(a.y1 + y) * 800 + a.x1 + x];
+            TEST_ASSERT_EQUAL_HEX32(get_img_px(x, y).full, c.full);
+        }
+    }
+}
+
+static lv_obj_t * img_create(const void * src, lv_coord_t x, lv_coord_t y)
+{
+    lv_obj_t * obj = lv_img_create(lv_scr_act());
+    lv_img_set_src(obj, src);
+    lv_obj_set_pos(obj, x, y);
+    return obj;
+}
+
+void setUp(void)
+{
+    decoder = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(decoder, test_decoder_info);
+    lv_img_decoder_set_open_cb(decoder, test_decoder_open);
+    lv_img_decoder_set_read_line_cb(decoder, test_decoder_read_line);
+
+    img.header.cf = LV_IMG_CF_RAW;
+    img.header.w = IMG_W;
+    img.header.h = IMG_H;
+    img.data = raw_data;
+    img.data_size = sizeof(raw_data);
+
+    read_line_cnt = 0;
+    read_area_cnt = 0;
+    read_row_cnt = 0;
+
+#if LV_USE_IMG_DECODE_ASYNC
+    lv_img_decode_async_set_enabled(false);
+#endif
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_decoder_delete(decoder);
+
+#if LV_USE_IMG_DECODE_ASYNC
+    lv_img_decode_async_set_enabled(true);
+#endif
+}
+
+void test_img_decoder_read_area_draws_tiles(void)
+{
+    lv_img_decoder_set_read_area_cb(decoder, test_decoder_read_area);
+    lv_obj_t * obj = img_create(&img, 10, 10);
+    refr_all();
+
+    check_pixels(obj);
+    TEST_ASSERT_EQUAL_UINT32(0, read_line_cnt);
+    TEST_ASSERT_EQUAL_UINT32(IMG_H, read_row_cnt);
+    TEST_ASSERT_LESS_THAN_UINT32(IMG_H, read_area_cnt);
+}
+
+void test_img_decoder_read_line_fallback(void)
+{
+    lv_obj_t * obj = img_create(&img, 10, 10);
+    refr_all();
+
+    check_pixels(obj);
+    TEST_ASSERT_EQUAL_UINT32(IMG_H, read_line_cnt);
+    TEST_ASSERT_EQUAL_UINT32(IMG_H, read_row_cnt);
+
+    /*Read directly too*/
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, &img, lv_color_black(), 0));
+    lv_color_t buf[3 * 4];
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_area(&dsc, 5, 7, 3, 4, (uint8_t *)buf));
+    TEST_ASSERT_EQUAL_HEX32(get_img_px(5, 7).full, buf[0].full);
+    TEST_ASSERT_EQUAL_HEX32(get_img_px(7, 10).full, buf[11].full);
+    lv_img_decoder_close(&dsc);
+}
+
+void test_img_decoder_read_area_built_in_file(void)
+{
+    /*A true color image file for the built-in decoder*/
+    lv_img_header_t header;
+    lv_memset_00(&header, sizeof(header));
+    header.cf = LV_IMG_CF_TRUE_COLOR;
+    header.w = IMG_W;
+    header.h = IMG_H;
+
+    FILE * f = fopen(IMG_FILE, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    fwrite(&header, sizeof(header), 1, f);
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = 0; y < IMG_H; y++) {
+        for(x = 0; x < IMG_W; x++) {
+            lv_color_t c = get_img_px(x, y);
+            fwrite(&c, sizeof(c), 1, f);
+        }
+    }
+    fclose(f);
+
+    /*Full width tiles are read at once, the partially visible image row by row*/
+    lv_obj_t * obj1 = img_create("A:" IMG_FILE, 10, 10);
+    lv_obj_t * obj2 = img_create("A:" IMG_FILE, -5, 100);
+    refr_all();
+
+    check_pixels(obj1);
+    check_pixels(obj2);
+    remove(IMG_FILE);
+}
+
+#endif
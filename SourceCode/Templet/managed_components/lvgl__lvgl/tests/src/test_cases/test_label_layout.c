@@ -0,0 +1,310 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#define CANVAS_W    300
+#define CANVAS_H    200
+
+static const char * txt =
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore.\n"
+    "Ut enim ad #ff0000 minim veniam#, quis nostrud exercitation ullamco laboris nisi ut aliquip.\n\n"
+    "Duis aute irure dolor in reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla pariatur.\n";
+
+static lv_color_t canvas_buf[CANVAS_W * CANVAS_H];
+static lv_color_t ref_buf[CANVAS_W * CANVAS_H];
+static lv_obj_t * canvas;
+
+static void draw_text(lv_draw_label_dsc_t * dsc, lv_coord_t y)
+{
+    lv_canvas_fill_bg(canvas, lv_color_white(), LV_OPA_COVER);
+    lv_canvas_draw_text(canvas, 5, y, CANVAS_W - 10, dsc, txt);
+}
+
+/*Draw the text with and without a layout and compare the result*/
+static void check_draw(lv_draw_label_dsc_t * dsc, lv_coord_t y)
+{
+    lv_draw_label_layout_t layout;
+    lv_draw_label_layout_init(&layout);
+    TEST_ASSERT_TRUE(lv_draw_label_layout_update(&layout, txt, dsc->font, dsc->letter_space, CANVAS_W - 10,
+                                                 dsc->flag));
+
+    dsc->layout = NULL;
+    draw_text(dsc, y);
+    lv_memcpy(ref_buf, canvas_buf, sizeof(ref_buf));
+
+    dsc->layout = &layout;
+    draw_text(dsc, y);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, canvas_buf, sizeof(ref_buf));
+
+    /*The size is the same too*/
+    lv_point_t size_ref;
+    lv_point_t size;
+    lv_txt_get_size(&size_ref, txt, dsc->font, dsc->letter_space, dsc->line_space, CANVAS_W - 10, dsc->flag);
+    lv_draw_label_layout_get_size(&layout, dsc->line_space, &size);
+    TEST_ASSERT_EQUAL(size_ref.x, size.x);
+    TEST_ASSERT_EQUAL(size_ref.y, size.y);
+
+    lv_draw_label_layout_free(&layout);
+}
+
+#if LV_LABEL_LAYOUT_CACHE
+/*Compare the layout of a label with a newly calculated one*/
+static void check_label_layout(lv_obj_t * obj)
+{
+    lv_label_t * label = (lv_label_t *)obj;
+    TEST_ASSERT_TRUE(label->layout.valid);
+
+    lv_draw_label_layout_t layout;
+    lv_draw_label_layout_init(&layout);
+    TEST_ASSERT_TRUE(lv_draw_label_layout_update(&layout, label->text, label->layout.font, label->layout.letter_space,
+                                                 label->layout.max_w, label->layout.flag));
+
+    TEST_ASSERT_EQUAL_UINT32(layout.line_cnt, label->layout.line_cnt);
+    TEST_ASSERT_EQUAL(layout.max_line_w, label->layout.max_line_w);
+    uint32_t i;
+    for(i = 0; i <= layout.line_cnt; i++) {
+        TEST_ASSERT_EQUAL_UINT32(layout.lines[i].start, label->layout.lines[i].start);
+        TEST_ASSERT_EQUAL(layout.lines[i].width, label->layout.lines[i].width);
+        TEST_ASSERT_EQUAL_UINT32(layout.lines[i].glyph_cnt, label->layout.lines[i].glyph_cnt);
+    }
+
+    lv_draw_label_layout_free(&layout);
+}
+#endif
+
+void setUp(void)
+{
+    canvas = lv_canvas_create(lv_scr_act());
+    lv_canvas_set_buffer(canvas, canvas_buf, CANVAS_W, CANVAS_H, LV_IMG_CF_TRUE_COLOR);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+void test_label_layout_draws_the_same(void)
+{
+    lv_draw_label_dsc_t dsc;
+    lv_draw_label_dsc_init(&dsc);
+
+    check_draw(&dsc, 0);
+
+    dsc.align = LV_TEXT_ALIGN_CENTER;
+    dsc.letter_space = 2;
+    dsc.line_space = 3;
+    check_draw(&dsc, 0);
+
+    /*Start above the canvas so the first lines are skipped*/
+    dsc.align = LV_TEXT_ALIGN_RIGHT;
+    dsc.flag = LV_TEXT_FLAG_RECOLOR;
+    check_draw(&dsc, -40);
+
+    dsc.align = LV_TEXT_ALIGN_LEFT;
+    dsc.flag = LV_TEXT_FLAG_EXPAND;
+    dsc.sel_start = 10;
+    dsc.sel_end = 150;
+    check_draw(&dsc, 0);
+
+    dsc.flag = LV_TEXT_FLAG_NONE;
+    dsc.font = &lv_font_unscii_8;
+    dsc.decor = LV_TEXT_DECOR_UNDERLINE;
+    check_draw(&dsc, 0);
+}
+
+void test_label_layout_is_not_used_with_other_parameters(void)
+{
+    lv_draw_label_dsc_t dsc;
+    lv_draw_label_dsc_init(&dsc);
+    draw_text(&dsc, 0);
+    lv_memcpy(ref_buf, canvas_buf, sizeof(ref_buf));
+
+    lv_draw_label_layout_t layout;
+    lv_draw_label_layout_init(&layout);
+    TEST_ASSERT_TRUE(lv_draw_label_layout_update(&layout, txt, dsc.font, 0, 100, dsc.flag));
+    TEST_ASSERT_FALSE(lv_draw_label_layout_is_valid(&layout, txt, dsc.font, 0, CANVAS_W - 10, dsc.flag));
+
+    /*Calculated for an other width*/
+    dsc.layout = &layout;
+    draw_text(&dsc, 0);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, canvas_buf, sizeof(ref_buf));
+
+    /*The width doesn't matter if the lines are broken only at new lines*/
+    TEST_ASSERT_TRUE(lv_draw_label_layout_update(&layout, txt, dsc.font, 0, 100, LV_TEXT_FLAG_EXPAND));
+    TEST_ASSERT_TRUE(lv_draw_label_layout_is_valid(&layout, txt, dsc.font, 0, 200, LV_TEXT_FLAG_EXPAND));
+    TEST_ASSERT_EQUAL_UINT32(4, layout.line_cnt);
+
+    lv_draw_label_layout_free(&layout);
+}
+
+void test_label_layout_of_a_label(void)
+{
+#if LV_LABEL_LAYOUT_CACHE
+    lv_obj_t * obj = lv_label_create(lv_scr_act());
+    lv_label_t * label = (lv_label_t *)obj;
+    lv_obj_set_width(obj, 200);
+    lv_label_set_text(obj, txt);
+    lv_refr_now(NULL);
+
+    TEST_ASSERT_TRUE(label->layout.valid);
+    uint32_t line_cnt = label->layout.line_cnt;
+    TEST_ASSERT_GREATER_THAN_UINT32(4, line_cnt);
+
+    lv_point_t size;
+    lv_txt_get_size(&size, txt, LV_FONT_DEFAULT, 0, 0, 200, LV_TEXT_FLAG_NONE);
+    TEST_ASSERT_EQUAL(size.y, lv_obj_get_height(obj));
+
+    /*Redrawing doesn't calculate the lines again*/
+    label->layout.lines[0].glyph_cnt = 12345;
+    lv_obj_invalidate(obj);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(12345, label->layout.lines[0].glyph_cnt);
+
+    /*But a new width does*/
+    lv_obj_set_width(obj, 300);
+    lv_refr_now(NULL);
+    TEST_ASSERT_TRUE(label->layout.valid);
+    TEST_ASSERT_LESS_THAN_UINT32(line_cnt, label->layout.line_cnt);
+    TEST_ASSERT_NOT_EQUAL(12345, label->layout.lines[0].width);
+
+    /*And a new letter space*/
+    line_cnt = label->layout.line_cnt;
+    lv_obj_set_style_text_letter_space(obj, 5, 0);
+    lv_refr_now(NULL);
+    TEST_ASSERT_GREATER_THAN_UINT32(line_cnt, label->layout.line_cnt);
+
+    /*And a new text*/
+    lv_label_set_text(obj, "Hello\nworld");
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(2, label->layout.line_cnt);
+    TEST_ASSERT_EQUAL_UINT32(6, label->layout.lines[0].glyph_cnt);    /*Including the "\n"*/
+    TEST_ASSERT_EQUAL_UINT32(5, label->layout.lines[1].glyph_cnt);
+#endif
+}
+
+void test_label_layout_with_dots(void)
+{
+#if LV_LABEL_LAYOUT_CACHE
+    lv_obj_t * obj = lv_label_create(lv_scr_act());
+    lv_label_t * label = (lv_label_t *)obj;
+    lv_obj_set_size(obj, 200, 50);
+    lv_label_set_long_mode(obj, LV_LABEL_LONG_DOT);
+    lv_label_set_text(obj, txt);
+    lv_refr_now(NULL);
+
+    /*The layout belongs to the text with the dots*/
+    TEST_ASSERT_TRUE(label->layout.valid);
+    TEST_ASSERT_EQUAL_UINT32(strlen(label->text), label->layout.lines[label->layout.line_cnt].start);
+    TEST_ASSERT_LESS_THAN_UINT32(strlen(txt), strlen(label->text));
+
+    /*Reverting the dots makes it invalid*/
+    lv_label_set_long_mode(obj, LV_LABEL_LONG_WRAP);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(strlen(txt), label->layout.lines[label->layout.line_cnt].start);
+#endif
+}
+
+void test_label_layout_is_updated_after_edits(void)
+{
+#if LV_LABEL_LAYOUT_CACHE
+    lv_obj_t * obj = lv_label_create(lv_scr_act());
+    lv_obj_set_width(obj, 200);
+    lv_label_set_text(obj, txt);
+    lv_refr_now(NULL);
+
+    lv_label_ins_text(obj, 0, "Hello ");
+    check_label_layout(obj);
+    lv_label_ins_text(obj, 50, "a");
+    check_label_layout(obj);
+    lv_label_ins_text(obj, LV_LABEL_POS_LAST, "xyz\n");
+    check_label_layout(obj);
+    lv_label_ins_text(obj, 120, "Some longer text with a few words\nand new lines\n");
+    check_label_layout(obj);
+    lv_label_ins_text(obj, 30, "\xC3\x81rv\xC3\xADzt\xC5\xB1r\xC5\x91");
+    check_label_layout(obj);
+    lv_label_cut_text(obj, 10, 80);
+    check_label_layout(obj);
+    lv_label_cut_text(obj, 0, 1);
+    check_label_layout(obj);
+
+    /*Shorten a word broken to more lines. The break of the line before the word depends on it too.*/
+    lv_label_set_text(obj, "Lorem ipsum dolor "
+                      "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz sit amet");
+    lv_refr_now(NULL);
+    lv_label_t * label = (lv_label_t *)obj;
+    TEST_ASSERT_EQUAL_UINT32(18, label->layout.lines[1].start);
+    TEST_ASSERT_LESS_THAN_UINT32(18 + 78, label->layout.lines[2].start);
+    lv_label_cut_text(obj, label->layout.lines[2].start, 70);
+    check_label_layout(obj);
+
+    /*Random edits*/
+    static const char * words[] = {"a", "bc ", " ", "\n", "defghijklmnopqrstuvwxyz", "Lorem ipsum ", "\xC3\xA9",
+                                   "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz"
+                                  };
+    uint32_t seed = 12345;
+    uint32_t i;
+    for(i = 0; i < 300; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t len = _lv_txt_get_encoded_length(lv_label_get_text(obj));
+        uint32_t pos = len ? (seed >> 8) % len : 0;
+        if((seed >> 4) % 3 == 0 && len > 0) {
+            /*Sometimes delete more to shorten the long words*/
+            uint32_t max_del = (seed >> 12) % 4 == 0 ? 40 : 8;
+            lv_label_cut_text(obj, pos, LV_MIN(len - pos, (seed >> 20) % max_del + 1));
+        }
+        else {
+            lv_label_ins_text(obj, pos, words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))]);
+        }
+        check_label_layout(obj);
+    }
+
+    /*The size follows the text*/
+    lv_point_t size;
+    lv_txt_get_size(&size, lv_label_get_text(obj), LV_FONT_DEFAULT, 0, 0, 200, LV_TEXT_FLAG_NONE);
+    lv_obj_update_layout(obj);
+    TEST_ASSERT_EQUAL(size.y, lv_obj_get_height(obj));
+#endif
+}
+
+void test_label_layout_edit_invalidates_the_changed_lines(void)
+{
+#if LV_LABEL_LAYOUT_CACHE
+    lv_obj_t * obj = lv_label_create(lv_scr_act());
+    lv_label_t * label = (lv_label_t *)obj;
+    lv_obj_set_width(obj, 300);
+    lv_label_set_text(obj, txt);
+    lv_label_ins_text(obj, LV_LABEL_POS_LAST, txt);
+    lv_refr_now(NULL);
+
+    lv_coord_t line_h = lv_font_get_line_height(LV_FONT_DEFAULT);
+    lv_coord_t label_h = lv_obj_get_height(obj);
+    TEST_ASSERT_GREATER_THAN(line_h * 10, label_h);
+
+    /*The first lines are not calculated again*/
+    label->layout.lines[0].glyph_cnt = 12345;
+
+    /*Replace a letter in the middle of the text*/
+    lv_disp_t * disp = lv_disp_get_default();
+    uint32_t pos = _lv_txt_get_encoded_length(lv_label_get_text(obj)) / 2;
+    lv_label_cut_text(obj, pos, 1);
+    lv_label_ins_text(obj, pos, "m");
+
+    TEST_ASSERT_EQUAL_UINT32(12345, label->layout.lines[0].glyph_cnt);
+    TEST_ASSERT_GREATER_THAN(0, disp->inv_p);
+    uint32_t i;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(disp->inv_area_joined[i]) continue;
+        TEST_ASSERT_LESS_THAN(label_h / 2, lv_area_get_height(&disp->inv_areas[i]));
+    }
+    lv_refr_now(NULL);
+
+    /*Adding a new line needs to redraw everything below it*/
+    lv_label_ins_text(obj, pos, "\n");
+    TEST_ASSERT_EQUAL_UINT32(12345, label->layout.lines[0].glyph_cnt);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL(label_h + line_h, lv_obj_get_height(obj));
+#endif
+}
+
+#endif
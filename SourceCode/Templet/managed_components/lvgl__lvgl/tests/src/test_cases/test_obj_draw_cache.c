@@ -0,0 +1,252 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#if LV_USE_OBJ_DRAW_CACHE
+
+#define FB_SIZE     (800 * 480)
+
+extern lv_color_t test_fb[];
+
+static lv_color_t ref_fb[FB_SIZE];
+
+static lv_obj_t * create_card(lv_coord_t x, lv_coord_t y)
+{
+    lv_obj_t * card = lv_obj_create(lv_scr_act());
+    lv_obj_set_style_radius(card, 0, 0);
+    lv_obj_set_pos(card, x, y);
+    lv_obj_set_size(card, 150, 100);
+    lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t * label = lv_label_create(card);
+    lv_label_set_text(label, "Cached card");
+
+    lv_obj_t * btn = lv_btn_create(card);
+    lv_obj_set_size(btn, 60, 30);
+    lv_obj_align(btn, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+
+    return card;
+}
+
+/*A 60x30 child without radius and shadow which can be cached without alpha channel*/
+static lv_obj_t * create_opaque_child(lv_obj_t * parent)
+{
+    lv_obj_t * child = lv_obj_create(parent);
+    lv_obj_set_style_radius(child, 0, 0);
+    lv_obj_set_size(child, 60, 30);
+    lv_obj_align(child, LV_ALIGN_TOP_RIGHT, 0, 0);
+    lv_obj_clear_flag(child, LV_OBJ_FLAG_SCROLLABLE);
+    return child;
+}
+
+static void refr_all(void)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+static lv_obj_draw_cache_info_t get_info(void)
+{
+    lv_obj_draw_cache_info_t info;
+    lv_obj_draw_cache_get_info(&info);
+    return info;
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_USE_OBJ_DRAW_CACHE
+    lv_obj_draw_cache_set_size(LV_OBJ_DRAW_CACHE_SIZE);
+    lv_obj_draw_cache_clear();
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_USE_OBJ_DRAW_CACHE
+    lv_obj_clean(lv_scr_act());
+    lv_obj_draw_cache_clear();
+    lv_obj_draw_cache_set_size(LV_OBJ_DRAW_CACHE_SIZE);
+#endif
+}
+
+void test_obj_draw_cache_draws_the_same_pixels(void)
+{
+#if LV_USE_OBJ_DRAW_CACHE
+    lv_obj_t * card = create_card(20, 30);
+    refr_all();
+    lv_memcpy(ref_fb, test_fb, sizeof(ref_fb));
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().entry_cnt);
+
+    lv_obj_add_flag(card, LV_OBJ_FLAG_DRAW_CACHE);
+    refr_all();
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+    TEST_ASSERT_EQUAL_UINT32(1, get_info().entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, get_info().miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(150 * 100 * sizeof(lv_color_t), get_info().used);
+
+    refr_all();
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+    TEST_ASSERT_EQUAL_UINT32(1, get_info().hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, get_info().miss_cnt);
+#endif
+}
+
+void test_obj_draw_cache_is_dropped_if_a_child_changes(void)
+{
+#if LV_USE_OBJ_DRAW_CACHE
+    lv_obj_t * card = create_card(20, 30);
+    lv_obj_add_flag(card, LV_OBJ_FLAG_DRAW_CACHE);
+    refr_all();
+    TEST_ASSERT_EQUAL_UINT32(1, get_info().entry_cnt);
+
+    lv_label_set_text(lv_obj_get_child(card, 0), "Changed");
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().used);
+
+    refr_all();
+    TEST_ASSERT_EQUAL_UINT32(1, get_info().entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2, get_info().miss_cnt);
+
+    /*Compare with the normal rendering*/
+    lv_memcpy(ref_fb, test_fb, sizeof(ref_fb));
+    lv_obj_clear_flag(card, LV_OBJ_FLAG_DRAW_CACHE);
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().entry_cnt);
+    refr_all();
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+
+    /*Restyling drops the cache too*/
+    lv_obj_add_flag(card, LV_OBJ_FLAG_DRAW_CACHE);
+    refr_all();
+    lv_obj_set_style_bg_color(card, lv_palette_main(LV_PALETTE_RED), 0);
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().entry_cnt);
+#endif
+}
+
+void test_obj_draw_cache_drops_the_least_recently_used(void)
+{
+#if LV_USE_OBJ_DRAW_CACHE
+    /*Room for 2 cards*/
+    lv_obj_draw_cache_set_size(2 * 150 * 100 * sizeof(lv_color_t));
+
+    lv_obj_t * card1 = create_card(20, 30);
+    lv_obj_t * card2 = create_card(200, 30);
+    lv_obj_t * card3 = create_card(400, 30);
+    lv_obj_add_flag(card1, LV_OBJ_FLAG_DRAW_CACHE);
+    lv_obj_add_flag(card2, LV_OBJ_FLAG_DRAW_CACHE);
+    lv_obj_add_flag(card3, LV_OBJ_FLAG_DRAW_CACHE);
+
+    /*card1 and card2 are cached first, then card1 is dropped for card3*/
+    refr_all();
+    TEST_ASSERT_EQUAL_UINT32(2, get_info().entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(3, get_info().miss_cnt);
+    TEST_ASSERT_NULL(card1->spec_attr->draw_cache);
+    TEST_ASSERT_NOT_NULL(card2->spec_attr->draw_cache);
+    TEST_ASSERT_NOT_NULL(card3->spec_attr->draw_cache);
+
+    /*Redraw card2 to make card3 the least recently used.
+     *Invalidate only the area as invalidating card2 would drop its image.*/
+    _lv_inv_area(NULL, &card2->coords);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(1, get_info().hit_cnt);
+
+    lv_obj_invalidate(card1);
+    lv_refr_now(NULL);
+    TEST_ASSERT_NOT_NULL(card1->spec_attr->draw_cache);
+    TEST_ASSERT_NOT_NULL(card2->spec_attr->draw_cache);
+    TEST_ASSERT_NULL(card3->spec_attr->draw_cache);
+
+    /*Shrinking the cache drops the images*/
+    lv_obj_draw_cache_set_size(150 * 100 * sizeof(lv_color_t));
+    TEST_ASSERT_EQUAL_UINT32(1, get_info().entry_cnt);
+    TEST_ASSERT_NOT_NULL(card1->spec_attr->draw_cache);
+
+    lv_obj_del(card1);
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().used);
+#endif
+}
+
+void test_obj_draw_cache_child_doesnt_drop_the_parent_being_rendered(void)
+{
+#if LV_USE_OBJ_DRAW_CACHE
+    lv_obj_t * card = create_card(20, 30);
+    lv_obj_t * child = create_opaque_child(card);
+    refr_all();
+    lv_memcpy(ref_fb, test_fb, sizeof(ref_fb));
+
+    /*The child's image would fit only if the card's image was dropped while the card is being rendered*/
+    lv_obj_draw_cache_set_size(150 * 100 * sizeof(lv_color_t) + 60 * 30 * sizeof(lv_color_t) - 1);
+    lv_obj_add_flag(card, LV_OBJ_FLAG_DRAW_CACHE);
+    lv_obj_add_flag(child, LV_OBJ_FLAG_DRAW_CACHE);
+    refr_all();
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+    TEST_ASSERT_EQUAL_UINT32(1, get_info().entry_cnt);
+    TEST_ASSERT_NOT_NULL(card->spec_attr->draw_cache);
+
+    /*Only the child fits into the cache*/
+    lv_obj_draw_cache_clear();
+    lv_obj_draw_cache_set_size(60 * 30 * sizeof(lv_color_t));
+    refr_all();
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+    TEST_ASSERT_EQUAL_UINT32(1, get_info().entry_cnt);
+    TEST_ASSERT_NOT_NULL(child->spec_attr->draw_cache);
+#endif
+}
+
+#if LV_USE_OBJ_DRAW_CACHE
+static void invalidate_event_cb(lv_event_t * e)
+{
+    lv_obj_invalidate(lv_event_get_target(e));
+}
+#endif
+
+void test_obj_draw_cache_invalidate_while_rendering(void)
+{
+#if LV_USE_OBJ_DRAW_CACHE
+    lv_obj_t * card = create_card(20, 30);
+    lv_obj_t * child = create_opaque_child(card);
+    refr_all();
+    lv_memcpy(ref_fb, test_fb, sizeof(ref_fb));
+
+    /*Invalidating the child drops the images of the child and the card while they are rendered*/
+    lv_obj_add_event_cb(child, invalidate_event_cb, LV_EVENT_DRAW_MAIN_END, NULL);
+    lv_obj_add_flag(card, LV_OBJ_FLAG_DRAW_CACHE);
+    lv_obj_add_flag(child, LV_OBJ_FLAG_DRAW_CACHE);
+    refr_all();
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().used);
+    TEST_ASSERT_NULL(card->spec_attr->draw_cache);
+#endif
+}
+
+void test_obj_draw_cache_skips_not_opaque_widgets(void)
+{
+#if LV_USE_OBJ_DRAW_CACHE && LV_COLOR_SCREEN_TRANSP == 0
+    /*Rounded corners would need an alpha channel*/
+    lv_obj_t * card = create_card(20, 30);
+    lv_obj_set_style_radius(card, 10, 0);
+    refr_all();
+    lv_memcpy(ref_fb, test_fb, sizeof(ref_fb));
+
+    lv_obj_add_flag(card, LV_OBJ_FLAG_DRAW_CACHE);
+    TEST_ASSERT_FALSE(lv_obj_has_flag(card, LV_OBJ_FLAG_DRAW_CACHE));
+    refr_all();
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().entry_cnt);
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+
+    /*It's drawn normally if it stops covering its area after the flag was added*/
+    lv_obj_set_style_radius(card, 0, 0);
+    lv_obj_add_flag(card, LV_OBJ_FLAG_DRAW_CACHE);
+    TEST_ASSERT_TRUE(lv_obj_has_flag(card, LV_OBJ_FLAG_DRAW_CACHE));
+    lv_obj_set_style_radius(card, 10, 0);
+    refr_all();
+    TEST_ASSERT_EQUAL_UINT32(0, get_info().entry_cnt);
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+#endif
+}
+
+#endif
@@ -0,0 +1,169 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <string.h>
+#include <stdio.h>
+
+#if LV_USE_PROFILER
+
+static char out[LV_PROFILER_BUF_SIZE * 64];
+static uint32_t out_len;
+static uint32_t line_cnt;
+static uint32_t tick;
+
+static uint32_t test_tick_cb(void)
+{
+    return tick++;
+}
+
+static void test_flush_cb(const char * buf)
+{
+    uint32_t len = strlen(buf);
+    TEST_ASSERT_LESS_THAN(sizeof(out), out_len + len);
+    lv_memcpy(out + out_len, buf, len + 1);
+    out_len += len;
+    line_cnt++;
+}
+
+static uint32_t count(const char * str)
+{
+    uint32_t cnt = 0;
+    const char * p = out;
+    while((p = strstr(p, str)) != NULL) {
+        cnt++;
+        p += strlen(str);
+    }
+    return cnt;
+}
+
+/*Get the timestamp of a line in microseconds*/
+static uint32_t get_us(const char * line)
+{
+    unsigned long sec;
+    unsigned long us;
+    TEST_ASSERT_EQUAL_INT(2, sscanf(line, "   LVGL-1 [0] %lu.%lu:", &sec, &us));
+    return sec * 1000000 + us;
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_USE_PROFILER
+    out[0] = '\0';
+    out_len = 0;
+    line_cnt = 0;
+    tick = 0;
+    lv_profiler_set_tick_cb(test_tick_cb);
+    lv_profiler_reset();
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_USE_PROFILER
+    lv_profiler_set_tick_cb(NULL);
+    lv_profiler_set_enabled(true);
+    lv_profiler_reset();
+    lv_obj_clean(lv_scr_act());
+#endif
+}
+
+void test_profiler_records_the_refresh_phases(void)
+{
+#if LV_USE_PROFILER
+    lv_obj_t * btn = lv_btn_create(lv_scr_act());
+    lv_obj_t * label = lv_label_create(btn);
+    lv_label_set_text(label, "Profiled");
+
+    lv_profiler_reset();
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+
+    uint32_t cnt = lv_profiler_get_cnt();
+    TEST_ASSERT_GREATER_THAN(0, cnt);
+    TEST_ASSERT_LESS_THAN(LV_PROFILER_BUF_SIZE, cnt);
+
+    lv_profiler_flush(test_flush_cb);
+    TEST_ASSERT_EQUAL_UINT32(cnt, line_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_profiler_get_cnt());
+
+    TEST_ASSERT_EQUAL_UINT32(1, count("B|1|_lv_disp_refr_timer\n"));
+    TEST_ASSERT_EQUAL_UINT32(1, count("E|1|_lv_disp_refr_timer\n"));
+    TEST_ASSERT_EQUAL_UINT32(1, count("B|1|layout\n"));
+    TEST_ASSERT_EQUAL_UINT32(1, count("B|1|lv_refr_join_area\n"));
+    TEST_ASSERT_EQUAL_UINT32(1, count("B|1|refr_invalid_areas\n"));
+    TEST_ASSERT_GREATER_THAN(0, count("B|1|refr_area\n"));
+    TEST_ASSERT_GREATER_THAN(0, count("B|1|lv_draw_rect\n"));
+    TEST_ASSERT_GREATER_THAN(0, count("B|1|lv_draw_label\n"));
+    TEST_ASSERT_GREATER_THAN(0, count("B|1|call_flush_cb\n"));
+
+    /*Every event is closed*/
+    TEST_ASSERT_EQUAL_UINT32(count("tracing_mark_write: B|"), count("tracing_mark_write: E|"));
+    TEST_ASSERT_EQUAL_UINT32(count("B|1|refr_area\n"), count("E|1|refr_area\n"));
+    TEST_ASSERT_EQUAL_UINT32(count("B|1|lv_draw_rect\n"), count("E|1|lv_draw_rect\n"));
+
+    /*The first event is the start of the refresh at tick 0*/
+    TEST_ASSERT_EQUAL_STRING_LEN("   LVGL-1 [0] 0.000000: tracing_mark_write: B|1|_lv_disp_refr_timer\n", out,
+                                 strlen("   LVGL-1 [0] 0.000000: tracing_mark_write: B|1|_lv_disp_refr_timer\n"));
+#endif
+}
+
+void test_profiler_overwrites_the_oldest_events(void)
+{
+#if LV_USE_PROFILER
+    uint32_t i;
+    for(i = 0; i < LV_PROFILER_BUF_SIZE + 3; i++) {
+        LV_PROFILER_BEGIN_TAG("test");
+    }
+    TEST_ASSERT_EQUAL_UINT32(LV_PROFILER_BUF_SIZE, lv_profiler_get_cnt());
+
+    lv_profiler_flush(test_flush_cb);
+    TEST_ASSERT_EQUAL_UINT32(LV_PROFILER_BUF_SIZE, line_cnt);
+
+    /*The first 3 events (tick 0..2) are dropped*/
+    TEST_ASSERT_EQUAL_STRING_LEN("   LVGL-1 [0] 0.000003: tracing_mark_write: B|1|test\n", out,
+                                 strlen("   LVGL-1 [0] 0.000003: tracing_mark_write: B|1|test\n"));
+#endif
+}
+
+void test_profiler_can_be_disabled(void)
+{
+#if LV_USE_PROFILER
+    lv_profiler_set_enabled(false);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_profiler_get_cnt());
+
+    lv_profiler_set_enabled(true);
+    LV_PROFILER_BEGIN_TAG("test");
+    LV_PROFILER_END_TAG("test");
+    TEST_ASSERT_EQUAL_UINT32(2, lv_profiler_get_cnt());
+
+    lv_profiler_reset();
+    TEST_ASSERT_EQUAL_UINT32(0, lv_profiler_get_cnt());
+#endif
+}
+
+void test_profiler_default_time_source_has_us_resolution(void)
+{
+#if LV_USE_PROFILER && (defined(__unix__) || defined(__APPLE__))
+    /*The tick doesn't advance in the tests so only a real clock can change between 2 events*/
+    lv_profiler_set_tick_cb(NULL);
+    uint32_t diff = 0;
+    uint32_t i;
+    for(i = 0; i < 100000 && diff == 0; i++) {
+        out_len = 0;
+        LV_PROFILER_BEGIN_TAG("test");
+        LV_PROFILER_END_TAG("test");
+        lv_profiler_flush(test_flush_cb);
+        diff = get_us(strchr(out, '\n') + 1) - get_us(out);
+    }
+
+    TEST_ASSERT_GREATER_THAN(0, diff);
+    TEST_ASSERT_LESS_THAN(1000, diff);
+#endif
+}
+
+#endif
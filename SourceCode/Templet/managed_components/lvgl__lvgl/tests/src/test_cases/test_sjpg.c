@@ -0,0 +1,188 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+
+#if LV_USE_SJPG
+
+/*320x240, 15 fragments of 16 lines*/
+#define IMG_PATH        "../examples/libs/sjpg/small_image.sjpg"
+#define IMG_W           320
+#define IMG_H           240
+#define FRAGMENT_H      16
+#define ROW_SIZE        (IMG_W * sizeof(lv_color_t))
+
+/*A file system driver counting the reads to see when the fragments are decoded*/
+static lv_fs_drv_t drv;
+static volatile uint32_t read_cnt;
+
+static uint8_t * ref_buf;
+static uint8_t * buf;
+
+static void * fs_open(lv_fs_drv_t * d, const char * path, lv_fs_mode_t mode)
+{
+    LV_UNUSED(d);
+    LV_UNUSED(mode);
+    return fopen(path, "rb");
+}
+
+static lv_fs_res_t fs_close(lv_fs_drv_t * d, void * file_p)
+{
+    LV_UNUSED(d);
+    fclose(file_p);
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t fs_read(lv_fs_drv_t * d, void * file_p, void * b, uint32_t btr, uint32_t * br)
+{
+    LV_UNUSED(d);
+    read_cnt++;
+    *br = fread(b, 1, btr, file_p);
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t fs_seek(lv_fs_drv_t * d, void * file_p, uint32_t pos, lv_fs_whence_t whence)
+{
+    LV_UNUSED(d);
+    int w = whence == LV_FS_SEEK_SET ? SEEK_SET : whence == LV_FS_SEEK_CUR ? SEEK_CUR : SEEK_END;
+    fseek(file_p, pos, w);
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t fs_tell(lv_fs_drv_t * d, void * file_p, uint32_t * pos_p)
+{
+    LV_UNUSED(d);
+    *pos_p = ftell(file_p);
+    return LV_FS_RES_OK;
+}
+
+static void read_rows(lv_img_decoder_dsc_t * dsc, lv_coord_t y, lv_coord_t h)
+{
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_area(dsc, 0, y, IMG_W, h, buf + y * ROW_SIZE));
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_USE_SJPG
+    if(drv.letter == 0) {
+        lv_fs_drv_init(&drv);
+        drv.letter = 'C';
+        drv.open_cb = fs_open;
+        drv.close_cb = fs_close;
+        drv.read_cb = fs_read;
+        drv.seek_cb = fs_seek;
+        drv.tell_cb = fs_tell;
+        lv_fs_drv_register(&drv);
+    }
+
+    ref_buf = lv_mem_alloc(IMG_H * ROW_SIZE);
+    buf = lv_mem_alloc(IMG_H * ROW_SIZE);
+    TEST_ASSERT_NOT_NULL(ref_buf);
+    TEST_ASSERT_NOT_NULL(buf);
+    lv_memset_00(buf, IMG_H * ROW_SIZE);
+
+    /*Read all the lines from top to bottom*/
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, "C:" IMG_PATH, lv_color_black(), 0));
+    TEST_ASSERT_EQUAL(IMG_W, dsc.header.w);
+    TEST_ASSERT_EQUAL(IMG_H, dsc.header.h);
+    lv_coord_t y;
+    for(y = 0; y < IMG_H; y++) {
+        TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, 0, y, IMG_W, ref_buf + y * ROW_SIZE));
+    }
+    lv_img_decoder_close(&dsc);
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_USE_SJPG
+    lv_mem_free(ref_buf);
+    lv_mem_free(buf);
+#endif
+}
+
+void test_sjpg_cached_fragments_are_not_decoded_again(void)
+{
+#if LV_USE_SJPG
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, "C:" IMG_PATH, lv_color_black(), 0));
+
+    /*The last 3 fragments. There is no next fragment to decode in the background after the last one.*/
+    read_rows(&dsc, 12 * FRAGMENT_H, 1);
+    read_rows(&dsc, 13 * FRAGMENT_H, 1);
+    read_rows(&dsc, 14 * FRAGMENT_H, 1);
+    uint32_t read_cnt_start = read_cnt;
+
+    read_rows(&dsc, 13 * FRAGMENT_H + 5, 7);
+    read_rows(&dsc, 14 * FRAGMENT_H + 1, FRAGMENT_H - 1);
+    read_rows(&dsc, 12 * FRAGMENT_H + 1, 2 * FRAGMENT_H - 1);
+    TEST_ASSERT_EQUAL_UINT32(read_cnt_start, read_cnt);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf + 12 * FRAGMENT_H * ROW_SIZE, buf + 12 * FRAGMENT_H * ROW_SIZE,
+                             3 * FRAGMENT_H * ROW_SIZE);
+
+    /*An other fragment needs to be decoded*/
+    read_rows(&dsc, 0, 1);
+    TEST_ASSERT_GREATER_THAN_UINT32(read_cnt_start, read_cnt);
+
+    lv_img_decoder_close(&dsc);
+#endif
+}
+
+void test_sjpg_read_order(void)
+{
+#if LV_USE_SJPG
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, "C:" IMG_PATH, lv_color_black(), 0));
+
+    /*From bottom to top, then jumping between the fragments*/
+    lv_coord_t y;
+    for(y = IMG_H - 1; y >= 0; y--) read_rows(&dsc, y, 1);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, buf, IMG_H * ROW_SIZE);
+
+    lv_memset_00(buf, IMG_H * ROW_SIZE);
+    for(y = 0; y < FRAGMENT_H; y++) {
+        lv_coord_t i;
+        for(i = 0; i < IMG_H / FRAGMENT_H; i++) read_rows(&dsc, ((i * 7) % (IMG_H / FRAGMENT_H)) * FRAGMENT_H + y, 1);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, buf, IMG_H * ROW_SIZE);
+    lv_img_decoder_close(&dsc);
+#endif
+}
+
+void test_sjpg_from_variable(void)
+{
+#if LV_USE_SJPG
+    FILE * f = fopen(IMG_PATH, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t * data = lv_mem_alloc(size);
+    TEST_ASSERT_NOT_NULL(data);
+    TEST_ASSERT_EQUAL(size, fread(data, 1, size, f));
+    fclose(f);
+
+    lv_img_dsc_t img;
+    lv_memset_00(&img, sizeof(img));
+    img.header.cf = LV_IMG_CF_RAW;
+    img.header.w = IMG_W;
+    img.header.h = IMG_H;
+    img.data = data;
+    img.data_size = size;
+
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, &img, lv_color_black(), 0));
+    read_rows(&dsc, 8, IMG_H - 8);
+    read_rows(&dsc, 0, 8);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, buf, IMG_H * ROW_SIZE);
+    lv_img_decoder_close(&dsc);
+
+    lv_mem_free(data);
+#endif
+}
+
+#endif
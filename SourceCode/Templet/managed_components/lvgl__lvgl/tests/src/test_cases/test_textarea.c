@@ -104,4 +104,58 @@ void test_textarea_in_one_line_mode_should_ignore_line_break_characters(void)
     TEST_ASSERT_EQUAL_STRING(textarea_default_text, lv_textarea_get_text(textarea));
 }
 
+void test_textarea_typing_updates_the_label(void)
+{
+    static const char * txt = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut "
+                              "labore et dolore magna aliqua.\nUt enim ad minim veniam, quis nostrud exercitation ullamco.";
+
+    lv_obj_set_size(textarea, 300, 200);
+    lv_textarea_set_text(textarea, txt);
+    lv_textarea_set_cursor_pos(textarea, 6);
+    lv_refr_now(NULL);
+
+    lv_textarea_add_text(textarea, "Hello world ");
+    lv_textarea_add_char(textarea, '\n');
+    lv_textarea_del_char(textarea);
+    lv_textarea_del_char(textarea);
+    lv_textarea_add_char(textarea, 'x');
+    lv_textarea_set_cursor_pos(textarea, 0);
+    lv_textarea_del_char_forward(textarea);
+    lv_refr_now(NULL);
+
+    const char * exp_txt = "orem Hello worldxipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor "
+                           "incididunt ut labore et dolore magna aliqua.\nUt enim ad minim veniam, quis nostrud "
+                           "exercitation ullamco.";
+    TEST_ASSERT_EQUAL_STRING(exp_txt, lv_textarea_get_text(textarea));
+
+    /*The size of the label is the same as if the text was set at once*/
+    lv_obj_t * label = lv_textarea_get_label(textarea);
+    lv_point_t size;
+    lv_txt_get_size(&size, exp_txt, lv_obj_get_style_text_font(label, LV_PART_MAIN),
+                    lv_obj_get_style_text_letter_space(label, LV_PART_MAIN),
+                    lv_obj_get_style_text_line_space(label, LV_PART_MAIN),
+                    lv_obj_get_content_width(label), LV_TEXT_FLAG_NONE);
+    TEST_ASSERT_EQUAL(size.y, lv_obj_get_content_height(label));
+
+#if LV_LABEL_LAYOUT_CACHE
+    lv_label_t * label_p = (lv_label_t *)label;
+    TEST_ASSERT_TRUE(label_p->layout.valid);
+    TEST_ASSERT_EQUAL_PTR(label_p->text, label_p->layout.txt);
+    TEST_ASSERT_EQUAL_UINT32(strlen(exp_txt), label_p->layout.lines[label_p->layout.line_cnt].start);
+#endif
+}
+
+void test_textarea_deleting_shapes_the_arabic_letters_again(void)
+{
+#if LV_USE_ARABIC_PERSIAN_CHARS
+    /*The first letter changes from initial to isolated form*/
+    lv_textarea_set_text(textarea, "\u0628\u0628");
+    lv_textarea_del_char(textarea);
+
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_label_set_text(label, "\u0628");
+    TEST_ASSERT_EQUAL_STRING(lv_label_get_text(label), lv_textarea_get_text(textarea));
+#endif
+}
+
 #endif